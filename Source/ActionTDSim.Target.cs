@@ -0,0 +1,29 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+using UnrealBuildTool;
+using System.Collections.Generic;
+
+// Headless console program running the match rules (ActionTowerDefenseCore)
+// without the engine, for tests and benchmarks:
+//   Build.sh ActionTDSim Linux Development -Project=<path>/ActionTowerDefense.uproject
+[SupportedPlatforms(UnrealPlatformClass.Desktop)]
+public class ActionTDSimTarget : TargetRules
+{
+	public ActionTDSimTarget(TargetInfo Target) : base(Target)
+	{
+		Type = TargetType.Program;
+		LinkType = TargetLinkType.Monolithic;
+		DefaultBuildSettings = BuildSettingsVersion.V6;
+		IncludeOrderVersion = EngineIncludeOrderVersion.Unreal5_7;
+		LaunchModuleName = "ActionTDSim";
+
+		bBuildDeveloperTools = false;
+		bCompileAgainstEngine = false;
+		bCompileAgainstCoreUObject = false;
+		bCompileAgainstApplicationCore = false;
+		bCompileWithPluginSupport = false;
+		bCompileICU = false;
+		bUseLoggingInShipping = true;
+		bIsBuildingConsoleApplication = true;
+	}
+}
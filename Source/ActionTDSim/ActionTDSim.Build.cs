@@ -0,0 +1,20 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+using UnrealBuildTool;
+
+public class ActionTDSim : ModuleRules
+{
+    public ActionTDSim(ReadOnlyTargetRules Target) : base(Target)
+    {
+        PublicIncludePathModuleNames.Add("Launch");
+
+        PrivateDependencyModuleNames.AddRange(
+            new string[]
+            {
+                "Core",
+                "Projects",
+                "ActionTowerDefenseCore"
+            }
+        );
+    }
+}
@@ -0,0 +1,168 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+// ========================================================
+// ActionTDSim: the match rules without the engine
+// ========================================================
+//
+// Runs a generated match on STCore::FSim as fast as it will go and reports
+// simulated steps per second. Options:
+//
+//   -Waves=N       waves in the match (default 10)
+//   -Enemies=N     enemies per wave (default 200)
+//   -Towers=N      attack towers along the path (default 16)
+//   -Seed=N        spawn jitter seed (default 0)
+//   -Speed=X       game speed used for scoring (default 1)
+//   -Runs=N        run the match N times (default 3); every run must end with
+//                  the same state hash, or the program fails
+//
+// Exit code 0 when every run matched, 1 otherwise.
+
+#include "RequiredProgramMainCPPInclude.h"
+#include "STCoreSim.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogActionTDSim, Log, All);
+
+IMPLEMENT_APPLICATION(ActionTDSim, "ActionTDSim");
+
+namespace ActionTDSim
+{
+    /** Zig-zag path across the map with a tower beside every other bend. */
+    STCore::FSimConfig MakeConfig(int32 NumWaves, int32 EnemiesPerWave, int32 NumTowers, int32 Seed, float Speed)
+    {
+        constexpr int32 NumBends = 8;
+        constexpr float LegLength = 2000.f;
+
+        STCore::FSimConfig Config;
+
+        TArray<FVector> Points;
+        for (int32 Bend = 0; Bend <= NumBends; ++Bend)
+        {
+            Points.Add(FVector(Bend * LegLength, (Bend % 2) ? LegLength : 0.f, 0.f));
+        }
+        Config.Path = STCore::FPath(MoveTemp(Points));
+
+        for (int32 Wave = 0; Wave < NumWaves; ++Wave)
+        {
+            STCore::FWaveSpec& WaveSpec = Config.Waves.AddDefaulted_GetRef();
+            WaveSpec.TimeBeforeWave = 5.f;
+
+            // Two lanes: a steady stream and a jittered one
+            STCore::FLaneSpec& Steady = WaveSpec.Lanes.AddDefaulted_GetRef();
+            Steady.NumToSpawn = EnemiesPerWave / 2;
+            Steady.Interval = 0.25f;
+
+            STCore::FLaneSpec& Jittered = WaveSpec.Lanes.AddDefaulted_GetRef();
+            Jittered.NumToSpawn = EnemiesPerWave - Steady.NumToSpawn;
+            Jittered.FirstSpawnDelay = 1.f;
+            Jittered.Interval = 0.3f;
+            Jittered.Jitter = 0.1f;
+        }
+
+        const float PathLength = Config.Path.GetLength();
+        for (int32 Tower = 0; Tower < NumTowers; ++Tower)
+        {
+            const float Distance = PathLength * (Tower + 1) / (NumTowers + 1);
+            const FVector Side = FVector::CrossProduct(Config.Path.GetDirectionAtDistance(Distance), FVector::UpVector);
+
+            STCore::FTowerSpec& TowerSpec = Config.Towers.AddDefaulted_GetRef();
+            TowerSpec.Location = Config.Path.GetLocationAtDistance(Distance) + Side * ((Tower % 2) ? 300.f : -300.f);
+            TowerSpec.Range = 900.f;
+            TowerSpec.FireRate = 2.f;
+            TowerSpec.Damage = 20.f;
+        }
+
+        Config.Enemy.MaxHealth = 200.f;
+        Config.Lives = EnemiesPerWave * NumWaves;
+        Config.RandomSeed = Seed;
+        Config.GameSpeed = Speed;
+
+        return Config;
+    }
+}
+
+INT32_MAIN_INT32_ARGC_TCHAR_ARGV()
+{
+    FTaskTagScope Scope(ETaskTag::EGameThread);
+    ON_SCOPE_EXIT
+    {
+        RequestEngineExit(TEXT("ActionTDSim exiting"));
+        FEngineLoop::AppPreExit();
+        FModuleManager::Get().UnloadModulesAtShutdown();
+        FEngineLoop::AppExit();
+    };
+
+    if (int32 Ret = GEngineLoop.PreInit(ArgC, ArgV))
+    {
+        return Ret;
+    }
+
+    int32 NumWaves = 10;
+    int32 EnemiesPerWave = 200;
+    int32 NumTowers = 16;
+    int32 Seed = 0;
+    int32 NumRuns = 3;
+    float Speed = 1.f;
+
+    const TCHAR* CmdLine = FCommandLine::Get();
+    FParse::Value(CmdLine, TEXT("Waves="), NumWaves);
+    FParse::Value(CmdLine, TEXT("Enemies="), EnemiesPerWave);
+    FParse::Value(CmdLine, TEXT("Towers="), NumTowers);
+    FParse::Value(CmdLine, TEXT("Seed="), Seed);
+    FParse::Value(CmdLine, TEXT("Runs="), NumRuns);
+    FParse::Value(CmdLine, TEXT("Speed="), Speed);
+
+    const STCore::FSimConfig Config = ActionTDSim::MakeConfig(
+        FMath::Max(NumWaves, 1),
+        FMath::Max(EnemiesPerWave, 1),
+        FMath::Max(NumTowers, 0),
+        Seed,
+        Speed);
+
+    UE_LOG(LogActionTDSim, Display, TEXT("%d waves x %d enemies, %d towers, seed %d, speed %.1f"),
+        Config.Waves.Num(), EnemiesPerWave, Config.Towers.Num(), Seed, Speed);
+
+    TOptional<uint32> FirstHash;
+    bool bDeterministic = true;
+
+    for (int32 Run = 0; Run < FMath::Max(NumRuns, 1); ++Run)
+    {
+        STCore::FSim Sim(Config);
+
+        const double StartSeconds = FPlatformTime::Seconds();
+        while (!Sim.IsFinished())
+        {
+            Sim.Step();
+        }
+        const double WallSeconds = FMath::Max(FPlatformTime::Seconds() - StartSeconds, UE_DOUBLE_SMALL_NUMBER);
+
+        const uint32 Hash = Sim.GetStateHash();
+
+        UE_LOG(LogActionTDSim, Display,
+            TEXT("Run %d: %lld steps (%.0f game s) in %.3f s = %.0f steps/s | %s, spawned %d killed %d leaked %d shots %d score %.0f | hash %08x"),
+            Run,
+            Sim.GetStepNumber(),
+            Sim.GetGameTime(),
+            WallSeconds,
+            Sim.GetStepNumber() / WallSeconds,
+            Sim.IsVictory() ? TEXT("victory") : TEXT("defeat"),
+            Sim.GetNumSpawned(),
+            Sim.GetNumKilled(),
+            Sim.GetNumLeaked(),
+            Sim.GetNumShots(),
+            Sim.GetScore(),
+            Hash);
+
+        if (!FirstHash.IsSet())
+        {
+            FirstHash = Hash;
+        }
+        else if (Hash != FirstHash.GetValue())
+        {
+            bDeterministic = false;
+            UE_LOG(LogActionTDSim, Error, TEXT("Run %d ended in a different state (%08x, first run %08x)"),
+                Run, Hash, FirstHash.GetValue());
+        }
+    }
+
+    return bDeterministic ? 0 : 1;
+}
@@ -39,7 +39,7 @@ USceneComponent* AMinigunTower::GetCurrentMuzzleComponent() const
 
 void AMinigunTower::FireProjectile()
 {
-    if (!AttackComponent || !ProjectileClass)
+    if (!AttackComponent || (!ProjectileClass && !bUseScheduledImpact))
         return;
 
     AActor* Target = AttackComponent->GetCurrentTarget();
@@ -50,69 +50,12 @@ void AMinigunTower::FireProjectile()
     if (!Muzzle)
     {
         // Fallback to base MuzzlePoint or actor location if something is wrong
-        const FVector FallbackLocation = MuzzlePoint
-            ? MuzzlePoint->GetComponentLocation()
-            : GetActorLocation();
-
-        const FVector TargetLocation = Target->GetActorLocation();
-        const FRotator FallbackRotation = (TargetLocation - FallbackLocation).Rotation();
-
-        FActorSpawnParameters Params;
-        Params.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn;
-        Params.Owner = this;
-        Params.Instigator = GetInstigator();
-
-        AProjectile* Projectile = GetWorld()->SpawnActor<AProjectile>(
-            ProjectileClass,
-            FallbackLocation,
-            FallbackRotation,
-            Params
-        );
-
-        if (Projectile)
-        {
-            Projectile->InitProjectile(
-                Target,
-                ProjectileDamage,
-                ProjectileSpeed,
-                bUseHoming,
-                ProjectileHomingAcceleration
-            );
-
-            BP_OnAttackFired();
-        }
-
+        LaunchProjectileFrom(GetSimMuzzleLocation(MuzzlePoint), Target);
         return;
     }
 
-    const FVector SpawnLocation = Muzzle->GetComponentLocation();
-    const FVector TargetLocation = Target->GetActorLocation();
-    const FRotator SpawnRotation = (TargetLocation - SpawnLocation).Rotation();
-
-    FActorSpawnParameters Params;
-    Params.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn;
-    Params.Owner = this;
-    Params.Instigator = GetInstigator();
-
-    AProjectile* Projectile = GetWorld()->SpawnActor<AProjectile>(
-        ProjectileClass,
-        SpawnLocation,
-        SpawnRotation,
-        Params
-    );
-
-    if (Projectile)
-    {
-        Projectile->InitProjectile(
-            Target,
-            ProjectileDamage,
-            ProjectileSpeed,
-            bUseHoming,
-            ProjectileHomingAcceleration
-        );
-
-        BP_OnAttackFired(); // same BP event as CannonTower
-    }
+    // Same pooled launch + BP_OnAttackFired as CannonTower
+    LaunchProjectileFrom(GetSimMuzzleLocation(Muzzle), Target);
 
     // Cycle to next muzzle: 0 → 1 → 2 → 0 → ...
     CurrentMuzzleIndex = (CurrentMuzzleIndex + 1) % 3;
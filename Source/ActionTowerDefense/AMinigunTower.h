@@ -32,4 +32,6 @@ protected:
 
     // Helper to get the current muzzle component
     USceneComponent* GetCurrentMuzzleComponent() const;
+
+    friend class USTRewindHistory;
 };
\ No newline at end of file
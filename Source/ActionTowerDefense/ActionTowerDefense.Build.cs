@@ -17,7 +17,8 @@ public class ActionTowerDefense : ModuleRules
                 "InputCore",
                 "Niagara",
                 "EnhancedInput",
-                "UMG"          // 👈 for UUserWidget / UMG
+                "UMG",         // 👈 for UUserWidget / UMG
+                "ActionTowerDefenseCore" // match rules shared with the ActionTDSim program
             }
         );
 
@@ -25,7 +26,8 @@ public class ActionTowerDefense : ModuleRules
             new string[]
             {
                 "Slate",       // 👈 for UI
-                "SlateCore"    // 👈 for UI
+                "SlateCore",   // 👈 for UI
+                "Json"         // match stats export
             }
         );
 
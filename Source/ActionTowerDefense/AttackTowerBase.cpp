@@ -4,12 +4,23 @@
 #include "AttackTowerBase.h"
 #include "Components/SphereComponent.h"
 #include "Projectile.h"
+#include "EnemyBase.h"
 #include "DamageableTarget.h"
 #include "Engine/Engine.h"
 #include "NiagaraComponent.h"
 #include "NiagaraSystem.h"
-#include "STGameSpeedHelpers.h"
+#include "NiagaraFunctionLibrary.h"
+#include "STSimulationClock.h"
+#include "STProjectilePool.h"
+#include "STGameEventScheduler.h"
+#include "STTargetPrediction.h"
 #include "TowerAttackComponent.h"
+#include "STMatchStats.h"
+#include "STTrace.h"
+#include "STStatGroup.h"
+#include "STMemoryTags.h"
+#include "STMatchRecorder.h"
+#include "STCosmeticGovernor.h"
 
 // ========================================================
 // Constructor / BeginPlay
@@ -17,17 +28,19 @@
 
 AAttackTowerBase::AAttackTowerBase()
 {
+    ST_LLM_SCOPE(Towers);
+
     PrimaryActorTick.bCanEverTick = true;
 
     // Attack range collider
     AttackRangeSphere = CreateDefaultSubobject<USphereComponent>(TEXT("AttackRangeSphere"));
     AttackRangeSphere->SetupAttachment(MeshComp);
     AttackRangeSphere->SetSphereRadius(1000.f);
-    AttackRangeSphere->SetCollisionEnabled(ECollisionEnabled::QueryOnly);
-    AttackRangeSphere->SetGenerateOverlapEvents(true);
 
-    AttackRangeSphere->SetCollisionResponseToAllChannels(ECR_Ignore);
-    AttackRangeSphere->SetCollisionResponseToChannel(ECC_GameTraceChannel1, ECR_Overlap);
+    // Range only: targets are found by distance against simulated enemy
+    // locations every substep, not by (frame-rate dependent) overlap events
+    AttackRangeSphere->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+    AttackRangeSphere->SetGenerateOverlapEvents(false);
 
     // Muzzle
     MuzzlePoint = CreateDefaultSubobject<USceneComponent>(TEXT("MuzzlePoint"));
@@ -52,10 +65,8 @@ void AAttackTowerBase::BeginPlay()
         CaptureRange = AttackRangeSphere->GetScaledSphereRadius();
     }
 
-    AttackRangeSphere->OnComponentBeginOverlap.AddDynamic(
-        this, &AAttackTowerBase::OnAttackRangeBeginOverlap);
-    AttackRangeSphere->OnComponentEndOverlap.AddDynamic(
-        this, &AAttackTowerBase::OnAttackRangeEndOverlap);
+    SimRotation = GetActorRotation();
+    PrevSimRotation = SimRotation;
 
     if (CaptureBeamComponent && CaptureBeamSystem)
     {
@@ -71,32 +82,60 @@ void AAttackTowerBase::BeginPlay()
 
         ApplyFireRateToAttackComponent();
     }
+
+    ReserveProjectilePool();
 }
 
 // ========================================================
-// Tick
+// Tick (presentation) / SimStep (gameplay)
 // ========================================================
 
 void AAttackTowerBase::Tick(float DeltaSeconds)
 {
-    // Base class handles capture
+    // Base class handles capture beam shutdown on pause
     Super::Tick(DeltaSeconds);
 
-    const float Speed = FSTGameSpeedHelpers::GetGameSpeed(this);
-    if (Speed <= 0.f)
+    UpdateCaptureBeam();
+
+    // Fast-forward frames that are not drawn
+    if (SimClock && !SimClock->IsPresentationFrame())
     {
-        // No attacking during pause/rewind
-        UpdateCaptureBeam();
         return;
     }
 
-    const float EffectiveDelta = DeltaSeconds * Speed;
-    TickAttack(EffectiveDelta);
+    // Turn smoothly between the last two simulated facings
+    const float Alpha = SimClock ? SimClock->GetInterpAlpha() : 1.f;
+    SetActorRotation(FQuat::Slerp(PrevSimRotation.Quaternion(), SimRotation.Quaternion(), Alpha));
+}
+
+void AAttackTowerBase::SimStep(float StepSeconds)
+{
+    PrevSimRotation = SimRotation;
+
+    // Base class handles capture
+    Super::SimStep(StepSeconds);
+
+    // No attacking during rewind
+    if (StepSeconds <= 0.f)
+    {
+        return;
+    }
+
+    TickAttack(StepSeconds);
+
+    // Targets come and go (and die) during the attack step
+    NotifyAwakeChanged();
+}
+
+bool AAttackTowerBase::IsAwake() const
+{
+    return Super::IsAwake() || (AttackComponent && AttackComponent->GetCurrentTarget());
 }
 
 void AAttackTowerBase::TickAttack(float DeltaSeconds)
 {
-    UpdateCaptureBeam();
+    ST_TRACE_CPUSCOPE(ActionTD_AttackTower_TickAttack);
+
     UpdateOrderState(DeltaSeconds);
 
     if (!AttackComponent)
@@ -104,7 +143,10 @@ void AAttackTowerBase::TickAttack(float DeltaSeconds)
         return;
     }
 
-    // Rotate towards current target
+    RefreshTargetsInRange();
+
+    // Rotate towards current target (or where it will be)
+    UpdateAimPoint();
     RotateTowardsTarget(DeltaSeconds);
 
     const bool bIsAimed = IsAimedAtTarget();
@@ -121,43 +163,34 @@ void AAttackTowerBase::TickAttack(float DeltaSeconds)
 }
 
 // ========================================================
-// Target handling: overlaps → component queue
+// Target handling: range query → component queue
 // ========================================================
 
-void AAttackTowerBase::OnAttackRangeBeginOverlap(
-    UPrimitiveComponent* OverlappedComp,
-    AActor* OtherActor,
-    UPrimitiveComponent* OtherComp,
-    int32 OtherBodyIndex,
-    bool bFromSweep,
-    const FHitResult& SweepResult)
+void AAttackTowerBase::RefreshTargetsInRange()
 {
-    if (!AttackComponent)
+    if (!AttackComponent || !SimClock || !AttackRangeSphere)
         return;
 
-    if (!OtherActor || OtherActor == this)
-        return;
+    const FVector Center = AttackRangeSphere->GetComponentLocation();
+    const float Range = AttackRangeSphere->GetScaledSphereRadius();
 
-    // Ignore towers
-    if (Cast<ATowerBase>(OtherActor))
-        return;
+    // Only the enemies in grid cells the range covers are tested
+    TargetsInRangeScratch.Reset();
+    const int32 NumTested = SimClock->QueryEnemiesInReach(Center, Range, TargetsInRangeScratch);
+
+    INC_DWORD_STAT_BY(STAT_ActionTD_RangeChecks, NumTested);
 
-    AttackComponent->AddTarget(OtherActor);
+    AttackComponent->SyncTargetsInRange(TargetsInRangeScratch);
 }
 
-void AAttackTowerBase::OnAttackRangeEndOverlap(
-    UPrimitiveComponent* OverlappedComp,
-    AActor* OtherActor,
-    UPrimitiveComponent* OtherComp,
-    int32 OtherBodyIndex)
+FVector AAttackTowerBase::GetSimMuzzleLocation(const USceneComponent* Muzzle) const
 {
-    if (!AttackComponent)
-        return;
-
-    if (!OtherActor)
-        return;
+    if (!Muzzle)
+        return GetActorLocation();
 
-    AttackComponent->RemoveTarget(OtherActor);
+    // Muzzles hang off the root mesh; place them using the simulated facing
+    const FTransform SimTransform(SimRotation, GetActorLocation(), GetActorScale3D());
+    return SimTransform.TransformPosition(Muzzle->GetRelativeLocation());
 }
 
 // ========================================================
@@ -271,6 +304,9 @@ void AAttackTowerBase::OrderCaptureTower(ATowerBase* NeutralTower)
     if (NeutralTower->GetTeam() != ETowerTeam::Neutral)
         return;
 
+    if (!USTMatchRecorder::ShouldRunCommand(this, ESTPlayerCommand::OrderCaptureTower, this, NeutralTower->GetSimId()))
+        return;
+
     SetOrderState(ETowerOrderState::CaptureTower, NeutralTower);
 }
 
@@ -284,6 +320,9 @@ void AAttackTowerBase::OrderAttackBonus(AActor* BonusActor)
 
 void AAttackTowerBase::OrderStopCurrentAction()
 {
+    if (!USTMatchRecorder::ShouldRunCommand(this, ESTPlayerCommand::OrderStopCurrentAction, this))
+        return;
+
     SetOrderState(ETowerOrderState::AttackEnemies, nullptr);
 }
 
@@ -291,8 +330,10 @@ void AAttackTowerBase::OrderStopCurrentAction()
 // Rotation / Aiming
 // ========================================================
 
-void AAttackTowerBase::RotateTowardsTarget(float DeltaSeconds)
+void AAttackTowerBase::UpdateAimPoint()
 {
+    bHasAimPoint = false;
+
     if (!AttackComponent)
         return;
 
@@ -300,7 +341,24 @@ void AAttackTowerBase::RotateTowardsTarget(float DeltaSeconds)
     if (!Target)
         return;
 
-    FVector ToTarget = Target->GetActorLocation() - GetActorLocation();
+    CurrentAimPoint = FSTTargetPrediction::GetTargetSimLocation(Target);
+    bHasAimPoint = true;
+
+    if (bLeadTarget && !bUseHoming)
+    {
+        const FVector Origin = GetSimMuzzleLocation(MuzzlePoint);
+
+        float TimeToImpact = 0.f;
+        FSTTargetPrediction::SolveIntercept(Origin, Target, ProjectileSpeed, CurrentAimPoint, TimeToImpact);
+    }
+}
+
+void AAttackTowerBase::RotateTowardsTarget(float DeltaSeconds)
+{
+    if (!bHasAimPoint)
+        return;
+
+    FVector ToTarget = CurrentAimPoint - GetActorLocation();
 
     if (bUseYawOnly)
     {
@@ -310,7 +368,7 @@ void AAttackTowerBase::RotateTowardsTarget(float DeltaSeconds)
     if (ToTarget.IsNearlyZero())
         return;
 
-    FRotator CurrentRot = GetActorRotation();
+    FRotator CurrentRot = SimRotation;
     FRotator DesiredRot = ToTarget.Rotation();
 
     if (bUseYawOnly)
@@ -326,20 +384,16 @@ void AAttackTowerBase::RotateTowardsTarget(float DeltaSeconds)
         RotationSpeedDegPerSec
     );
 
-    SetActorRotation(NewRot);
+    SimRotation = NewRot;
 }
 
 bool AAttackTowerBase::IsAimedAtTarget() const
 {
-    if (!AttackComponent)
+    if (!bHasAimPoint)
         return false;
 
-    AActor* Target = AttackComponent->GetCurrentTarget();
-    if (!Target)
-        return false;
-
-    FVector Forward = GetActorForwardVector();
-    FVector ToTarget = Target->GetActorLocation() - GetActorLocation();
+    FVector Forward = SimRotation.Vector();
+    FVector ToTarget = CurrentAimPoint - GetActorLocation();
 
     if (bUseYawOnly)
     {
@@ -371,30 +425,54 @@ void AAttackTowerBase::HandleAttackReadyToFire()
 
 void AAttackTowerBase::FireProjectile()
 {
-    if (!AttackComponent || !ProjectileClass)
+    ST_LLM_SCOPE(Projectiles);
+
+    if (!AttackComponent || (!ProjectileClass && !bUseScheduledImpact))
         return;
 
     AActor* Target = AttackComponent->GetCurrentTarget();
     if (!Target)
         return;
 
-    const FVector SpawnLoc = MuzzlePoint
-        ? MuzzlePoint->GetComponentLocation()
-        : GetActorLocation();
+    LaunchProjectileFrom(GetSimMuzzleLocation(MuzzlePoint), Target);
+}
 
-    const FVector TargetLoc = Target->GetActorLocation();
-    const FRotator SpawnRot = (TargetLoc - SpawnLoc).Rotation();
+AProjectile* AAttackTowerBase::LaunchProjectileFrom(const FVector& SpawnLoc, AActor* Target)
+{
+    ST_LLM_SCOPE(Projectiles);
+
+    if (!Target)
+        return nullptr;
+
+    if (bUseScheduledImpact && TryScheduleImpact(SpawnLoc, Target))
+    {
+        NotifyAttackFired();
+        return nullptr;
+    }
+
+    if (!ProjectileClass)
+        return nullptr;
 
-    FActorSpawnParameters Params;
-    Params.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn;
-    Params.Owner = this;
-    Params.Instigator = GetInstigator();
+    USTProjectilePoolSubsystem* Pool = USTProjectilePoolSubsystem::Get(this);
+    if (!Pool)
+        return nullptr;
 
-    AProjectile* Projectile = GetWorld()->SpawnActor<AProjectile>(
+    // Straight lead shot unless this tower is a homing one
+    const bool bFireLeadShot = bLeadTarget && !bUseHoming;
+
+    FVector TargetLoc = FSTTargetPrediction::GetTargetSimLocation(Target);
+    if (bFireLeadShot)
+    {
+        float TimeToImpact = 0.f;
+        FSTTargetPrediction::SolveIntercept(SpawnLoc, Target, ProjectileSpeed, TargetLoc, TimeToImpact);
+    }
+
+    const FRotator SpawnRot = (TargetLoc - SpawnLoc).Rotation();
+
+    AProjectile* Projectile = Pool->AcquireProjectile(
+        this,
         ProjectileClass,
-        SpawnLoc,
-        SpawnRot,
-        Params
+        FTransform(SpawnRot, SpawnLoc)
     );
 
     if (Projectile)
@@ -407,8 +485,95 @@ void AAttackTowerBase::FireProjectile()
             ProjectileHomingAcceleration
         );
 
-        BP_OnAttackFired();
+        NotifyAttackFired();
     }
+
+    return Projectile;
+}
+
+void AAttackTowerBase::NotifyAttackFired()
+{
+    if (USTMatchStats* Stats = USTMatchStats::Get(this))
+    {
+        Stats->RecordShot(this);
+    }
+
+    if (!SimClock || SimClock->ShouldRunCosmetics())
+    {
+        // Thinned out while the frame budget is blown
+        USTCosmeticGovernor* Governor = USTCosmeticGovernor::Get(this);
+        if (!Governor || Governor->ShouldPlayEffect())
+        {
+            BP_OnAttackFired();
+        }
+    }
+}
+
+bool AAttackTowerBase::TryScheduleImpact(const FVector& SpawnLoc, AActor* Target)
+{
+    if (!Target || ProjectileSpeed <= 0.f)
+        return false;
+
+    // Slow shots against fast enemies still fly for real
+    const float TargetSpeed = FSTTargetPrediction::GetTargetPathSpeed(Target);
+    if (TargetSpeed > 0.f && ProjectileSpeed / TargetSpeed < ScheduledImpactMinSpeedRatio)
+        return false;
+
+    if (!Target->GetClass()->ImplementsInterface(UDamageableTarget::StaticClass()))
+        return false;
+
+    USTGameEventScheduler* Scheduler = USTGameEventScheduler::Get(this);
+    if (!Scheduler)
+        return false;
+
+    FVector ImpactPoint;
+    float TimeToImpact = 0.f;
+    if (!FSTTargetPrediction::SolveIntercept(SpawnLoc, Target, ProjectileSpeed, ImpactPoint, TimeToImpact))
+        return false;
+
+    Scheduler->ScheduleImpact(TimeToImpact, Target, this, ProjectileDamage);
+
+    // Cosmetic only: nothing reads back from the tracer. Skipped in fast-forward and
+    // seek replays, and thinned out like other effects while the frame budget is blown
+    if (ScheduledImpactTracerSystem && (!SimClock || SimClock->ShouldRunCosmetics()))
+    {
+        USTCosmeticGovernor* Governor = USTCosmeticGovernor::Get(this);
+        if (!Governor || Governor->ShouldPlayEffect())
+        {
+            if (UNiagaraComponent* Tracer = UNiagaraFunctionLibrary::SpawnSystemAtLocation(
+                this,
+                ScheduledImpactTracerSystem,
+                SpawnLoc,
+                (ImpactPoint - SpawnLoc).Rotation()))
+            {
+                Tracer->SetVariableVec3(TEXT("User.StartPosition"), SpawnLoc);
+                Tracer->SetVariableVec3(TEXT("User.EndPosition"), ImpactPoint);
+            }
+        }
+    }
+
+    return true;
+}
+
+void AAttackTowerBase::ReserveProjectilePool()
+{
+    // Scheduled-impact towers only fall back to real projectiles occasionally;
+    // let the pool grow on demand for them.
+    if (bUseScheduledImpact)
+        return;
+
+    if (!ProjectileClass || ProjectileSpeed <= 0.f || FireRate <= 0.f)
+        return;
+
+    USTProjectilePoolSubsystem* Pool = USTProjectilePoolSubsystem::Get(this);
+    if (!Pool)
+        return;
+
+    // Worst case a shot flies the full attack range before it lands
+    const float ExpectedFlightTime = GetAttackRange() / ProjectileSpeed;
+    const int32 InFlight = FMath::CeilToInt(FireRate * ExpectedFlightTime);
+
+    Pool->ReservePool(GetClass(), ProjectileClass, InFlight + ProjectilePoolSlack);
 }
 
 // ========================================================
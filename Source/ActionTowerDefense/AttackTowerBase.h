@@ -31,6 +31,8 @@ class ACTIONTOWERDEFENSE_API AAttackTowerBase : public ATowerBase
 public:
     AAttackTowerBase();
     virtual void Tick(float DeltaSeconds) override;
+    virtual void SimStep(float StepSeconds) override;
+    virtual bool IsAwake() const override;
 
     // --- Orders exposed to PlayerController / BP ---
     UFUNCTION(BlueprintCallable, Category = "Tower|Orders")
@@ -71,12 +73,44 @@ protected:
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Attack|Projectile")
     float ProjectileSpeed = 2000.f;
 
+    /**
+     * Fire straight shots at the predicted intercept point along the target's path.
+     * Ignored when bUseHoming is set (homing stays available for special towers).
+     */
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Attack|Projectile")
-    bool bUseHoming = true;
+    bool bLeadTarget = true;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Attack|Projectile")
+    bool bUseHoming = false;
 
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Attack|Projectile", meta = (EditCondition = "bUseHoming"))
     float ProjectileHomingAcceleration = 8000.f;
 
+    /**
+     * Resolve shots analytically instead of flying a projectile: time-to-impact is
+     * computed from the target's path progress and damage lands as a game-time event.
+     * Only used while ProjectileSpeed / target MoveSpeed >= ScheduledImpactMinSpeedRatio.
+     */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Attack|Projectile")
+    bool bUseScheduledImpact = false;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Attack|Projectile", meta = (EditCondition = "bUseScheduledImpact", ClampMin = "1.0"))
+    float ScheduledImpactMinSpeedRatio = 5.f;
+
+    /** Optional purely cosmetic tracer for scheduled shots (User.StartPosition / User.EndPosition). */
+    UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Attack|Projectile", meta = (EditCondition = "bUseScheduledImpact"))
+    UNiagaraSystem* ScheduledImpactTracerSystem = nullptr;
+
+    /** Schedule damage on Target instead of launching a projectile. Returns false to fall back. */
+    bool TryScheduleImpact(const FVector& SpawnLoc, AActor* Target);
+
+    /** Extra pooled projectiles on top of FireRate x expected flight time. */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Attack|Projectile")
+    int32 ProjectilePoolSlack = 2;
+
+    /** Reserve this tower's share of the projectile pool. */
+    void ReserveProjectilePool();
+
     // --- Rotation ---
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Attack|Aiming")
     float RotationSpeedDegPerSec = 90.f;   // how fast the tower turns
@@ -95,29 +129,37 @@ protected:
     UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Tower|Orders")
     ETowerOrderState CurrentOrderState = ETowerOrderState::AttackEnemies;
 
-    // Overlap callbacks
-    UFUNCTION()
-    void OnAttackRangeBeginOverlap(UPrimitiveComponent* OverlappedComp,
-        AActor* OtherActor,
-        UPrimitiveComponent* OtherComp,
-        int32 OtherBodyIndex,
-        bool bFromSweep,
-        const FHitResult& SweepResult);
-
-    UFUNCTION()
-    void OnAttackRangeEndOverlap(UPrimitiveComponent* OverlappedComp,
-        AActor* OtherActor,
-        UPrimitiveComponent* OtherComp,
-        int32 OtherBodyIndex);
-
     // ================================
-    // Internal Tick helpers
+    // Internal SimStep helpers
     // ================================
     void TickAttack(float DeltaSeconds);
+
+    /** Feed enemies whose simulated location is inside the range sphere to the attack queue. */
+    void RefreshTargetsInRange();
+
+    /** Reused result buffer of the range query. */
+    TArray<AActor*> TargetsInRangeScratch;
+
+    /** Muzzle location for the simulated tower rotation (the actor renders interpolated). */
+    FVector GetSimMuzzleLocation(const USceneComponent* Muzzle) const;
     void UpdateOrderState(float DeltaSeconds);
     void RotateTowardsTarget(float DeltaSeconds);   
     bool IsAimedAtTarget() const;
 
+    /** Refresh CurrentAimPoint (lead point or current target location). */
+    void UpdateAimPoint();
+
+    /** Where the tower is aiming this substep. */
+    FVector CurrentAimPoint = FVector::ZeroVector;
+    bool bHasAimPoint = false;
+
+    /** Facing as of the latest substep, and the one before it (render interpolation). */
+    FRotator SimRotation = FRotator::ZeroRotator;
+    FRotator PrevSimRotation = FRotator::ZeroRotator;
+
+    friend class USTRewindHistory;
+    friend class USTSimulateMatchCommandlet;
+
     // Order/state helpers
     void SetOrderState(ETowerOrderState NewState, AActor* NewForcedTarget);
     bool IsCaptureOrderCompleted() const;
@@ -132,7 +174,7 @@ protected:
     UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Capture|VFX")
     UNiagaraComponent* CaptureBeamComponent = nullptr;
 
-    void UpdateCaptureBeam(); // helper called from Tick
+    void UpdateCaptureBeam(); // presentation helper called from Tick
 
 public:
     // For muzzle flash, sound etc.
@@ -140,9 +182,15 @@ public:
     void BP_OnAttackFired();
 
 protected:
+    /** Fires BP_OnAttackFired unless cosmetics are off (fast-forward, seek replays). */
+    void NotifyAttackFired();
+
     // Allow child towers (e.g. Minigun) to customize the actual shot
     virtual void FireProjectile();
 
+    /** Take a projectile from the pool and launch it from SpawnLoc at Target. */
+    AProjectile* LaunchProjectileFrom(const FVector& SpawnLoc, AActor* Target);
+
     UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Attack")
     UTowerAttackComponent* AttackComponent = nullptr;
 
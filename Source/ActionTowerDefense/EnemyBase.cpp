@@ -5,11 +5,19 @@
 #include "Components/StaticMeshComponent.h"
 #include "Components/SplineComponent.h"
 #include "STEnemyLifeComponent.h"
-#include "STGameSpeedHelpers.h"
-#include "STGameController.h" 
+#include "STSimulationClock.h"
+#include "STCosmeticGovernor.h"
+#include "STWorldRegistry.h"
+#include "STMatchStats.h"
+#include "STTrace.h"
+#include "STStatGroup.h"
+#include "STMemoryTags.h"
+#include "STCoreRules.h"
 
 ASTEnemyBase::ASTEnemyBase()
 {
+    ST_LLM_SCOPE(Enemies);
+
     PrimaryActorTick.bCanEverTick = true;
 
     MeshComp = CreateDefaultSubobject<UStaticMeshComponent>(TEXT("MeshComp"));
@@ -25,33 +33,80 @@ void ASTEnemyBase::BeginPlay()
     // Start at full health
     CurrentHealth = MaxHealth;
 
+    SimLocation = GetActorLocation();
+    SimCollisionRadius = GetSimpleCollisionRadius();
+
     if (SplineActor)
     {
-        CachedSpline = SplineActor->FindComponentByClass<USplineComponent>();
+        CachedSpline = FindPathSpline(SplineActor);
         if (!CachedSpline)
         {
             UE_LOG(LogTemp, Warning,
                 TEXT("EnemyBase: SplineActor %s has no USplineComponent"),
                 *SplineActor->GetName());
         }
+        RefreshSimLocation();
+    }
+
+    CosmeticGovernor = USTCosmeticGovernor::Get(this);
+
+    SimClock = USTSimulationClock::Get(this);
+    if (SimClock)
+    {
+        SimClock->RegisterEnemy(this);
     }
 }
 
+void ASTEnemyBase::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+    if (SimClock)
+    {
+        SimClock->UnregisterEnemy(this);
+    }
+
+    Super::EndPlay(EndPlayReason);
+}
+
 void ASTEnemyBase::Tick(float DeltaSeconds)
 {
     Super::Tick(DeltaSeconds);
 
-    const float Speed = FSTGameSpeedHelpers::GetGameSpeed(this);
+    // No clock (should not happen in game worlds): step once per frame
+    if (!SimClock)
+    {
+        SimStep(DeltaSeconds);
+    }
 
-    // Pause when speed is effectively 0 (0x)
-    if (FMath::IsNearlyZero(Speed))
+    // Not ticked at all while paused (USTSimulationClock suspends simulation actors);
+    // fast-forward frames that are not drawn skip presentation
+    if (!CachedSpline || (SimClock && !SimClock->IsPresentationFrame()))
     {
         return;
     }
 
-    // Scale by game speed (1x, 3x, 5x, -3x, etc.)
-    const float EffectiveDelta = DeltaSeconds * Speed;
-    UpdateMovement(EffectiveDelta);
+    // Under frame pressure the governor moves half the enemies each frame
+    if (CosmeticGovernor && !CosmeticGovernor->ShouldUpdateEnemyVisual(SimId))
+    {
+        return;
+    }
+
+    const float Alpha = SimClock ? SimClock->GetInterpAlpha() : 1.f;
+    const float RenderDistance = FMath::Lerp(PrevDistanceAlongSpline, DistanceAlongSpline, Alpha);
+
+    SetActorLocation(
+        CachedSpline->GetLocationAtDistanceAlongSpline(RenderDistance, ESplineCoordinateSpace::World));
+
+    if (bOrientRotationToSpline)
+    {
+        SetActorRotation(
+            CachedSpline->GetRotationAtDistanceAlongSpline(RenderDistance, ESplineCoordinateSpace::World));
+    }
+}
+
+void ASTEnemyBase::SimStep(float StepSeconds)
+{
+    PrevDistanceAlongSpline = DistanceAlongSpline;
+    UpdateMovement(StepSeconds);
 }
 
 void ASTEnemyBase::SetSplineActor(AActor* InSplineActor)
@@ -59,68 +114,83 @@ void ASTEnemyBase::SetSplineActor(AActor* InSplineActor)
     SplineActor = InSplineActor;
     CachedSpline = nullptr;
 
-    UE_LOG(LogTemp, Warning, TEXT("EnemyBase: SetSplineActor called on %s, InSplineActor=%s"),
-        *GetName(),
-        SplineActor ? *SplineActor->GetName() : TEXT("NULL"));
-
     if (SplineActor)
     {
-        CachedSpline = SplineActor->FindComponentByClass<USplineComponent>();
+        CachedSpline = FindPathSpline(SplineActor);
+
+        // Called for every spawn; the registry already warned once for this path
         if (!CachedSpline)
         {
-            UE_LOG(LogTemp, Warning,
+            UE_LOG(LogTemp, Verbose,
                 TEXT("EnemyBase::SetSplineActor: SplineActor %s has no USplineComponent"),
                 *SplineActor->GetName());
         }
-        else
-        {
-            UE_LOG(LogTemp, Warning,
-                TEXT("EnemyBase: CachedSpline is VALID on %s"),
-                *GetName());
-        }
     }
+
+    PrevDistanceAlongSpline = DistanceAlongSpline;
+    RefreshSimLocation();
 }
 
+USplineComponent* ASTEnemyBase::FindPathSpline(AActor* PathActor) const
+{
+    if (USTWorldRegistrySubsystem* Registry = USTWorldRegistrySubsystem::Get(this))
+    {
+        const FSTPathInfo* Info = Registry->RegisterPath(PathActor);
+        return Info ? Info->Spline.Get() : nullptr;
+    }
 
-void ASTEnemyBase::UpdateMovement(float DeltaSeconds)
+    // No registry (non-game world)
+    return PathActor ? PathActor->FindComponentByClass<USplineComponent>() : nullptr;
+}
+
+void ASTEnemyBase::RefreshSimLocation()
 {
     if (!CachedSpline)
     {
         return;
     }
 
-    // Move forward/backward along the spline depending on sign of DeltaSeconds
-    DistanceAlongSpline += MoveSpeed * DeltaSeconds;
+    SimLocation = CachedSpline->GetLocationAtDistanceAlongSpline(
+        DistanceAlongSpline,
+        ESplineCoordinateSpace::World
+    );
+}
 
-    const float SplineLength = CachedSpline->GetSplineLength();
 
-    // Clamp so we never go below 0 or beyond the spline length
-    DistanceAlongSpline = FMath::Clamp(DistanceAlongSpline, 0.f, SplineLength);
+void ASTEnemyBase::UpdateMovement(float DeltaSeconds)
+{
+    ST_TRACE_CPUSCOPE(ActionTD_Enemy_UpdateMovement);
 
-    // If weve just reached the end going forward, treat it as a leak.
-    if (DistanceAlongSpline >= SplineLength - KINDA_SMALL_NUMBER)
+    if (!CachedSpline)
     {
-        HandleReachedGoal();
         return;
     }
 
-    const FVector NewLocation =
-        CachedSpline->GetLocationAtDistanceAlongSpline(
-            DistanceAlongSpline,
-            ESplineCoordinateSpace::World
-        );
+    // Move forward/backward along the spline depending on sign of DeltaSeconds;
+    // reaching the end going forward is a leak
+    if (STCore::AdvanceAlongPath(DistanceAlongSpline, MoveSpeed, DeltaSeconds, CachedSpline->GetSplineLength()))
+    {
+        HandleReachedGoal();
+        return;
+    }
 
-    SetActorLocation(NewLocation);
+    // Simulation state only; Tick moves the actor for rendering
+    RefreshSimLocation();
+}
 
-    if (bOrientRotationToSpline)
+FVector ASTEnemyBase::PredictLocationAfter(float GameSeconds) const
+{
+    if (!CachedSpline)
     {
-        const FRotator NewRotation =
-            CachedSpline->GetRotationAtDistanceAlongSpline(
-                DistanceAlongSpline,
-                ESplineCoordinateSpace::World
-            );
-        SetActorRotation(NewRotation);
+        return GetActorLocation();
     }
+
+    const float FutureDistance = STCore::PredictDistance(
+        DistanceAlongSpline, MoveSpeed, GameSeconds, CachedSpline->GetSplineLength());
+
+    return CachedSpline->GetLocationAtDistanceAlongSpline(
+        FutureDistance,
+        ESplineCoordinateSpace::World);
 }
 
 void ASTEnemyBase::HandleReachedGoal()
@@ -131,26 +201,36 @@ void ASTEnemyBase::HandleReachedGoal()
 
 void ASTEnemyBase::KillEnemy(bool bReachedGoal)
 {
-    // Notify GameController via life component
+    // Notify GameController via life component (queues the removal and, for kills, the score)
     if (LifeComponent)
     {
-        LifeComponent->MarkEnemyRemoved(bReachedGoal);
+        LifeComponent->MarkEnemyRemoved(bReachedGoal, BaseScoreValue);
     }
 
     if (bReachedGoal)
     {
+        ST_FLIGHT_EVENT(Leak, SimId);
+
+        if (USTMatchStats* Stats = USTMatchStats::Get(this))
+        {
+            Stats->RecordLeak();
+        }
+
         // leaked through to the end  no score
         BP_OnReachedGoal();
     }
     else
     {
-        // killed by towers  award score
-        if (ASTGameController* GC = ASTGameController::Get(this))
+        ST_STAT_KILL();
+        ST_FLIGHT_EVENT(Kill, SimId);
+
+        // Cosmetic only: skipped in fast-forward and seek replays
+        // and thinned out while the frame budget is blown
+        if ((!SimClock || SimClock->ShouldRunCosmetics())
+            && (!CosmeticGovernor || CosmeticGovernor->ShouldPlayEffect()))
         {
-            GC->AwardScoreForEnemy(BaseScoreValue);
+            BP_OnKilled();
         }
-
-        BP_OnKilled();
     }
 
     Destroy();
@@ -158,26 +238,27 @@ void ASTEnemyBase::KillEnemy(bool bReachedGoal)
 
 void ASTEnemyBase::ApplyDamage(float Amount)
 {
-    if (Amount <= 0.f)
+    // Nothing lands on the dead
+    const STCore::FDamageResult Result = STCore::ApplyDamage(CurrentHealth, Amount);
+    if (Result.Dealt <= 0.f)
     {
         return;
     }
 
-    if (CurrentHealth <= 0.f)
+    USTMatchStats* Stats = USTMatchStats::Get(this);
+    if (Stats)
     {
-        // Already dead
-        return;
+        Stats->RecordHit(Result.Dealt);
     }
 
-    CurrentHealth -= Amount;
-
-    // Optional debug
-    UE_LOG(LogTemp, Log,
-        TEXT("Enemy %s took %.1f damage, health now %.1f"),
-        *GetName(), Amount, CurrentHealth);
-
-    if (CurrentHealth <= 0.f)
+    if (Result.bKilled)
     {
+        // Enemies spawn at the start of the path and move at a constant speed
+        if (Stats)
+        {
+            Stats->RecordKill(MoveSpeed > 0.f ? DistanceAlongSpline / MoveSpeed : 0.f);
+        }
+
         // Killed by tower damage
         KillEnemy(false);
     }
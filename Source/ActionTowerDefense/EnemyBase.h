@@ -10,6 +10,8 @@
 class UStaticMeshComponent;
 class USplineComponent;
 class USTEnemyLifeComponent;
+class USTSimulationClock;
+class USTCosmeticGovernor;
 
 UCLASS()
 class ACTIONTOWERDEFENSE_API ASTEnemyBase : public AActor, public IDamageableTarget          
@@ -19,10 +21,15 @@ class ACTIONTOWERDEFENSE_API ASTEnemyBase : public AActor, public IDamageableTar
 public:
     ASTEnemyBase();
 
+    /** Presentation only: places the actor between its last two simulation states. */
     virtual void Tick(float DeltaSeconds) override;
 
+    /** Advance path progress by one fixed simulation substep (negative while rewinding). */
+    void SimStep(float StepSeconds);
+
 protected:
     virtual void BeginPlay() override;
+    virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
     // --- Components ---
     UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Components")
@@ -54,6 +61,24 @@ protected:
     UPROPERTY(VisibleInstanceOnly, BlueprintReadOnly, Category = "Movement")
     float DistanceAlongSpline = 0.f;
 
+    /** DistanceAlongSpline before the latest substep (render interpolation). */
+    float PrevDistanceAlongSpline = 0.f;
+
+    /** World location at DistanceAlongSpline (what towers and projectiles test against). */
+    FVector SimLocation = FVector::ZeroVector;
+
+    /** Bounding radius used for simulated projectile hits. */
+    float SimCollisionRadius = 0.f;
+
+    /** Slot in USTSimulationClock's enemy list. */
+    int32 SimIndex = INDEX_NONE;
+
+    /** Stable id across rewinds (a resurrected enemy gets its old id back). */
+    int32 SimId = INDEX_NONE;
+
+    friend class USTSimulationClock;
+    friend class USTRewindHistory;
+
     /** The actor that owns the spline (e.g. BP_Path), set by spawner. */
     UPROPERTY(EditInstanceOnly, BlueprintReadOnly, Category = "Movement")
     AActor* SplineActor = nullptr;
@@ -62,9 +87,23 @@ protected:
     UPROPERTY(Transient)
     USplineComponent* CachedSpline = nullptr;
 
+    /** Cached simulation clock (game speed / scaled delta). */
+    UPROPERTY(Transient)
+    USTSimulationClock* SimClock = nullptr;
+
+    /** Cached cosmetic governor (presentation rate under frame pressure). */
+    UPROPERTY(Transient)
+    USTCosmeticGovernor* CosmeticGovernor = nullptr;
+
     void UpdateMovement(float DeltaSeconds);
     void HandleReachedGoal();
 
+    /** Recompute SimLocation from DistanceAlongSpline. */
+    void RefreshSimLocation();
+
+    /** Spline of a path actor, resolved once per path through the world registry. */
+    USplineComponent* FindPathSpline(AActor* PathActor) const;
+
     // Handle taking damage
     void ApplyDamage(float Amount);
 
@@ -76,6 +115,26 @@ public:
     UFUNCTION(BlueprintCallable, Category = "Movement")
     void SetSplineActor(AActor* InSplineActor);
 
+    // --- Path progress queries (used for target prediction) ---
+
+    UFUNCTION(BlueprintPure, Category = "Movement")
+    FORCEINLINE float GetDistanceAlongSpline() const { return DistanceAlongSpline; }
+
+    UFUNCTION(BlueprintPure, Category = "Movement")
+    FORCEINLINE float GetMoveSpeed() const { return MoveSpeed; }
+
+    FORCEINLINE USplineComponent* GetPathSpline() const { return CachedSpline; }
+
+    /** Location as of the latest simulation substep (the actor itself renders interpolated). */
+    FORCEINLINE const FVector& GetSimLocation() const { return SimLocation; }
+
+    FORCEINLINE float GetSimCollisionRadius() const { return SimCollisionRadius; }
+
+    FORCEINLINE int32 GetSimId() const { return SimId; }
+
+    /** World location this enemy will be at after GameSeconds of forward movement. */
+    FVector PredictLocationAfter(float GameSeconds) const;
+
     /** Kill this enemy, notify GameController via LifeComponent, then destroy. */
     UFUNCTION(BlueprintCallable, Category = "Enemy")
     void KillEnemy(bool bReachedGoal);
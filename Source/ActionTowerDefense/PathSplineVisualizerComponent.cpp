@@ -5,6 +5,8 @@
 
 #include "Components/SplineComponent.h"
 #include "Components/SplineMeshComponent.h"
+#include "STMemoryTags.h"
+#include "STCosmeticGovernor.h"
 
 UPathSplineVisualizerComponent::UPathSplineVisualizerComponent()
 {
@@ -14,6 +16,8 @@ UPathSplineVisualizerComponent::UPathSplineVisualizerComponent()
     PathMaterial = nullptr;
     PathWidth = 100.f;   // default width
     bShowPath = true;
+    SegmentLength = 100.f;
+    CoarseSegmentFactor = 4;
 }
 
 void UPathSplineVisualizerComponent::OnRegister()
@@ -34,7 +38,7 @@ void UPathSplineVisualizerComponent::OnRegister()
 
     if (CachedSpline.IsValid())
     {
-        BuildSplineMeshes();
+        BuildSplineMeshes(SegmentLength, SplineMeshComponents);
     }
 }
 
@@ -44,6 +48,68 @@ void UPathSplineVisualizerComponent::OnUnregister()
     Super::OnUnregister();
 }
 
+void UPathSplineVisualizerComponent::BeginPlay()
+{
+    Super::BeginPlay();
+
+    // Follow the cosmetic governor: coarse path while the frame budget is blown
+    if (USTCosmeticGovernor* Governor = USTCosmeticGovernor::Get(this))
+    {
+        CosmeticGovernor = Governor;
+        CosmeticLevelHandle = Governor->OnLevelChanged.AddUObject(
+            this, &UPathSplineVisualizerComponent::HandleCosmeticLevelChanged);
+
+        SetCoarse(Governor->UseCoarsePathVisuals());
+    }
+}
+
+void UPathSplineVisualizerComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+    if (USTCosmeticGovernor* Governor = CosmeticGovernor.Get())
+    {
+        Governor->OnLevelChanged.Remove(CosmeticLevelHandle);
+    }
+
+    Super::EndPlay(EndPlayReason);
+}
+
+void UPathSplineVisualizerComponent::HandleCosmeticLevelChanged(int32 NewLevel)
+{
+    const USTCosmeticGovernor* Governor = CosmeticGovernor.Get();
+    SetCoarse(Governor && Governor->UseCoarsePathVisuals());
+}
+
+void UPathSplineVisualizerComponent::SetCoarse(bool bInCoarse)
+{
+    if (bCoarse == bInCoarse || SplineMeshComponents.Num() == 0)
+    {
+        return;
+    }
+
+    if (bInCoarse && CoarseSplineMeshComponents.Num() == 0)
+    {
+        BuildSplineMeshes(SegmentLength * CoarseSegmentFactor, CoarseSplineMeshComponents);
+    }
+
+    bCoarse = bInCoarse;
+
+    for (USplineMeshComponent* Comp : SplineMeshComponents)
+    {
+        if (Comp)
+        {
+            Comp->SetVisibility(!bCoarse);
+        }
+    }
+
+    for (USplineMeshComponent* Comp : CoarseSplineMeshComponents)
+    {
+        if (Comp)
+        {
+            Comp->SetVisibility(bCoarse);
+        }
+    }
+}
+
 void UPathSplineVisualizerComponent::ClearSplineMeshes()
 {
     for (USplineMeshComponent* Comp : SplineMeshComponents)
@@ -54,15 +120,28 @@ void UPathSplineVisualizerComponent::ClearSplineMeshes()
         }
     }
     SplineMeshComponents.Empty();
+
+    for (USplineMeshComponent* Comp : CoarseSplineMeshComponents)
+    {
+        if (Comp)
+        {
+            Comp->DestroyComponent();
+        }
+    }
+    CoarseSplineMeshComponents.Empty();
+
+    bCoarse = false;
 }
 
-void UPathSplineVisualizerComponent::BuildSplineMeshes()
+void UPathSplineVisualizerComponent::BuildSplineMeshes(float InSegmentLength, TArray<USplineMeshComponent*>& OutMeshes)
 {
+    ST_LLM_SCOPE(PathVisuals);
+
     USplineComponent* SplineComp = CachedSpline.Get();
     if (!SplineComp || !PathMesh || !PathMaterial) return;
 
     const float SplineLength = SplineComp->GetSplineLength();
-    const float SegmentLength = 100.f; // adjust for smoothness
+    const float SegmentStep = FMath::Max(InSegmentLength, 10.f);
 
     // Use the actual mesh width so PathWidth is in UU
     const float MeshNativeWidth =
@@ -77,7 +156,7 @@ void UPathSplineVisualizerComponent::BuildSplineMeshes()
 
     while (Distance < SplineLength)
     {
-        const float NextDistance = FMath::Min(Distance + SegmentLength, SplineLength);
+        const float NextDistance = FMath::Min(Distance + SegmentStep, SplineLength);
 
         USplineMeshComponent* SplineMesh =
             NewObject<USplineMeshComponent>(GetOwner(), USplineMeshComponent::StaticClass());
@@ -118,7 +197,7 @@ void UPathSplineVisualizerComponent::BuildSplineMeshes()
 
         SplineMesh->UpdateMesh();
 
-        SplineMeshComponents.Add(SplineMesh);
+        OutMeshes.Add(SplineMesh);
 
         Distance = NextDistance;
     }
@@ -10,6 +10,7 @@ class USplineComponent;
 class USplineMeshComponent;
 class UStaticMesh;
 class UMaterialInterface;
+class USTCosmeticGovernor;
 
 UCLASS(ClassGroup = (Custom), meta = (BlueprintSpawnableComponent))
 class ACTIONTOWERDEFENSE_API UPathSplineVisualizerComponent : public UActorComponent
@@ -22,6 +23,8 @@ public:
 protected:
     virtual void OnRegister() override;
     virtual void OnUnregister() override;
+    virtual void BeginPlay() override;
+    virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
     // Mesh used along the path (e.g. Engine/BasicShapes/Plane)
     UPROPERTY(EditAnywhere, Category = "Path Visual")
@@ -39,6 +42,14 @@ protected:
     UPROPERTY(EditAnywhere, Category = "Path Visual")
     bool bShowPath;
 
+    // Segment length of the full-detail path (cm)
+    UPROPERTY(EditAnywhere, Category = "Path Visual", meta = (ClampMin = "10.0"))
+    float SegmentLength;
+
+    // Coarse path (cosmetic governor level 2+): segments this many times longer
+    UPROPERTY(EditAnywhere, Category = "Path Visual", meta = (ClampMin = "1"))
+    int32 CoarseSegmentFactor;
+
 private:
     // The spline we visualize
     TWeakObjectPtr<USplineComponent> CachedSpline;
@@ -47,6 +58,19 @@ private:
     UPROPERTY(Transient)
     TArray<USplineMeshComponent*> SplineMeshComponents;
 
+    // Coarse set, built the first time the governor asks for it
+    UPROPERTY(Transient)
+    TArray<USplineMeshComponent*> CoarseSplineMeshComponents;
+
+    bool bCoarse = false;
+
+    FDelegateHandle CosmeticLevelHandle;
+    TWeakObjectPtr<USTCosmeticGovernor> CosmeticGovernor;
+
     void ClearSplineMeshes();
-    void BuildSplineMeshes();
+    void BuildSplineMeshes(float InSegmentLength, TArray<USplineMeshComponent*>& OutMeshes);
+
+    // Show the coarse or the full-detail set
+    void SetCoarse(bool bInCoarse);
+    void HandleCosmeticLevelChanged(int32 NewLevel);
 };
@@ -7,12 +7,20 @@
 #include "GameFramework/ProjectileMovementComponent.h"
 #include "DamageableTarget.h"
 #include "STGameState.h"
-#include "STGameSpeedHelpers.h" 
+#include "STProjectilePool.h"
+#include "STGameEventScheduler.h"
+#include "STTargetPrediction.h"
+#include "EnemyBase.h"
+#include "TowerBase.h"
+#include "STMatchStats.h"
+#include "STSimulationClock.h"
+#include "STTrace.h"
 
 
 AProjectile::AProjectile()
 {
-    PrimaryActorTick.bCanEverTick = true;
+    // Moved in fixed substeps by USTProjectilePoolSubsystem; no per-frame tick
+    PrimaryActorTick.bCanEverTick = false;
 
     // ---- Collision ----
     CollisionComp = CreateDefaultSubobject<USphereComponent>(TEXT("CollisionComp"));
@@ -22,17 +30,11 @@ AProjectile::AProjectile()
     // This projectile itself is of type ProjectileChannel
     CollisionComp->SetCollisionObjectType(ECC_GameTraceChannel2);
 
-    // We want real hit events (not overlaps) against enemies
-    CollisionComp->SetCollisionEnabled(ECollisionEnabled::QueryOnly);
-    CollisionComp->SetCollisionResponseToAllChannels(ECR_Ignore);
-    CollisionComp->SetCollisionResponseToChannel(ECC_GameTraceChannel1, ECR_Block);
-
-    // No overlaps needed for this class
+    // Hits are resolved in SimStep (swept segment vs. enemies), so the sphere
+    // only provides the radius: no physics queries, no hit / overlap events
+    CollisionComp->SetCollisionEnabled(ECollisionEnabled::NoCollision);
     CollisionComp->SetGenerateOverlapEvents(false);
 
-    // Required for OnComponentHit with query-only collision
-    CollisionComp->SetNotifyRigidBodyCollision(true);
-
     // ---- Visual mesh ----
     MeshComp = CreateDefaultSubobject<UStaticMeshComponent>(TEXT("MeshComp"));
     MeshComp->SetupAttachment(CollisionComp);
@@ -46,16 +48,19 @@ AProjectile::AProjectile()
     MovementComp->bShouldBounce = false;
     MovementComp->ProjectileGravityScale = 0.f;
 
-    // Safety timeout
-    InitialLifeSpan = 5.f;
+    // Kept for Blueprint defaults (speeds); SimStep does the actual moving
+    MovementComp->bAutoActivate = false;
+
+    // Safety timeout is a game-time event (MaxLifetime), so pooled
+    // projectiles never go through the actor lifespan timer.
+    InitialLifeSpan = 0.f;
 }
 
 void AProjectile::BeginPlay()
 {
     Super::BeginPlay();
 
-    // Bind hit event
-    CollisionComp->OnComponentHit.AddDynamic(this, &AProjectile::OnProjectileHit);
+    SimClock = USTSimulationClock::Get(this);
 }
 
 void AProjectile::InitProjectile(AActor* InTarget,
@@ -69,111 +74,203 @@ void AProjectile::InitProjectile(AActor* InTarget,
 
     BaseSpeed = InSpeed;
 
-    // Apply speed from tower
+    // Apply speed from tower (mirrored on the component for Blueprint readers)
     MovementComp->InitialSpeed = InSpeed;
     MovementComp->MaxSpeed = InSpeed;
 
-    // If you want to force an initial velocity in the forward direction:
-    MovementComp->Velocity = GetActorForwardVector() * InSpeed;
+    // Straight out of the muzzle; game speed only changes how many substeps run
+    SimLocation = GetActorLocation();
+    PrevSimLocation = SimLocation;
+    SimVelocity = GetActorForwardVector() * InSpeed;
+    MovementComp->Velocity = SimVelocity;
 
     // Homing setup
-    if (bInUseHoming && TargetActor.IsValid())
-    {
-        MovementComp->bIsHomingProjectile = true;
-        MovementComp->HomingAccelerationMagnitude = InHomingAcceleration;
-        MovementComp->HomingTargetComponent = TargetActor->GetRootComponent();
-        bWasHomingProjectile = true;
-    }
-    else
+    bWasHomingProjectile = bInUseHoming && TargetActor.IsValid();
+    HomingAcceleration = InHomingAcceleration;
+
+    Age = 0.f;
+    ScheduleLifetime(0.f);
+}
+
+void AProjectile::ScheduleLifetime(float AlreadyElapsed)
+{
+    // Game-time expiry: fires after MaxLifetime of game time, or returns the
+    // projectile early if a rewind carries it back past its firing point.
+    if (USTGameEventScheduler* Scheduler = USTGameEventScheduler::Get(this))
     {
-        MovementComp->bIsHomingProjectile = false;
-        MovementComp->HomingTargetComponent = nullptr;
-        bWasHomingProjectile = false;
+        Scheduler->CancelEvent(LifetimeEventId);
+
+        TWeakObjectPtr<AProjectile> WeakThis = this;
+        auto Expire = [WeakThis]()
+            {
+                if (AProjectile* Projectile = WeakThis.Get())
+                {
+                    Projectile->LifetimeEventId = INDEX_NONE;
+                    Projectile->ReturnToPool();
+                }
+            };
+
+        LifetimeEventId = Scheduler->ScheduleEvent(MaxLifetime, this, Expire, Expire, AlreadyElapsed);
     }
 }
 
-void AProjectile::OnProjectileHit(UPrimitiveComponent* HitComp,
-    AActor* OtherActor,
-    UPrimitiveComponent* OtherComp,
-    FVector NormalImpulse,
-    const FHitResult& Hit)
+void AProjectile::SimStep(float StepSeconds)
 {
-    // Ignore self and our owner (the tower)
-    if (!OtherActor || OtherActor == this || OtherActor == GetOwner())
+    ST_TRACE_CPUSCOPE(ActionTD_Projectile_SimStep);
+
+    if (!bIsActive)
     {
         return;
     }
 
-    // Optional debug
-    if (GEngine)
+    PrevSimLocation = SimLocation;
+
+    AActor* Target = TargetActor.Get();
+    const bool bForward = StepSeconds > 0.f;
+
+    // Homing only while time runs forward
+    if (bForward && bWasHomingProjectile && Target)
     {
-        GEngine->AddOnScreenDebugMessage(
-            -1, 1.5f, FColor::Yellow,
-            FString::Printf(TEXT("Projectile hit: %s"), *GetNameSafe(OtherActor))
-        );
+        const FVector ToTarget =
+            (FSTTargetPrediction::GetTargetSimLocation(Target) - SimLocation).GetSafeNormal();
+
+        SimVelocity = (SimVelocity + ToTarget * HomingAcceleration * StepSeconds)
+            .GetClampedToMaxSize(BaseSpeed);
     }
 
-    // Apply damage if target implements our interface
-    if (OtherActor->GetClass()->ImplementsInterface(UDamageableTarget::StaticClass()))
+    SimLocation += SimVelocity * StepSeconds;
+
+    if (bForward)
     {
-        IDamageableTarget::Execute_ReceiveTowerDamage(OtherActor, Damage);
+        Age += StepSeconds;
     }
 
-    Destroy();
+    if (!bForward)
+    {
+        return;
+    }
+
+    // Swept test over the whole substep, so fast shots at 5x cannot tunnel: the
+    // first enemy on the path takes the hit, whether or not it was the target
+    const float Radius = CollisionComp->GetScaledSphereRadius();
+    AActor* HitActor = SimClock ? SimClock->FindFirstEnemyAlongSegment(PrevSimLocation, SimLocation, Radius) : nullptr;
+
+    // Targets outside the enemy grid (bonus actors) are tested on their own
+    if (Target && !HitActor && !Target->IsA<ASTEnemyBase>())
+    {
+        const float HitRadius = Radius + Target->GetSimpleCollisionRadius();
+        const FVector TargetLoc = FSTTargetPrediction::GetTargetSimLocation(Target);
+
+        if (FMath::PointDistToSegmentSquared(TargetLoc, PrevSimLocation, SimLocation) <= HitRadius * HitRadius)
+        {
+            HitActor = Target;
+        }
+    }
+
+    if (HitActor)
+    {
+        HandleSimHit(HitActor);
+    }
 }
 
-void AProjectile::Tick(float DeltaSeconds)
+void AProjectile::UpdatePresentation(float Alpha)
 {
-    Super::Tick(DeltaSeconds);
-
-    if (!MovementComp)
+    if (!bIsActive)
     {
         return;
     }
 
-    const float Speed = FSTGameSpeedHelpers::GetGameSpeed(this);
+    const FVector RenderLocation = FMath::Lerp(PrevSimLocation, SimLocation, Alpha);
+    const FRotator RenderRotation = SimVelocity.IsNearlyZero() ? GetActorRotation() : SimVelocity.Rotation();
+
+    SetActorLocationAndRotation(RenderLocation, RenderRotation);
+}
+
+void AProjectile::HandleSimHit(AActor* OtherActor)
+{
+    ST_TRACE_CPUSCOPE(ActionTD_Projectile_HandleSimHit);
 
-    if (FMath::IsNearlyZero(Speed))
+    // Already handed back to the pool earlier this step
+    if (!bIsActive)
     {
-        // Pause projectile
-        MovementComp->Velocity = FVector::ZeroVector;
         return;
     }
 
-    const float AbsSpeed = FMath::Abs(Speed);
+    // Ignore self and our owner (the tower)
+    if (!OtherActor || OtherActor == this || OtherActor == GetOwner())
+    {
+        return;
+    }
 
-    if (Speed > 0.f)
+    // Apply damage if target implements our interface
+    if (OtherActor->GetClass()->ImplementsInterface(UDamageableTarget::StaticClass()))
     {
-        // Normal / fast-forward
-        MovementComp->MaxSpeed = BaseSpeed * AbsSpeed;
-        MovementComp->InitialSpeed = BaseSpeed * AbsSpeed;
+        USTMatchStats::FDamageSourceScope DamageSource(USTMatchStats::Get(this), Cast<ATowerBase>(GetOwner()));
+        IDamageableTarget::Execute_ReceiveTowerDamage(OtherActor, Damage);
+    }
+
+    ReturnToPool();
+}
+
+// ========================================================
+// Pooling
+// ========================================================
+
+void AProjectile::ActivateFromPool(const FTransform& SpawnTransform, AActor* InOwner, APawn* InInstigator)
+{
+    bIsActive = true;
+
+    SetOwner(InOwner);
+    SetInstigator(InInstigator);
+    SetActorTransform(SpawnTransform, false, nullptr, ETeleportType::ResetPhysics);
+
+    SimLocation = SpawnTransform.GetLocation();
+    PrevSimLocation = SimLocation;
+    SimVelocity = FVector::ZeroVector;
 
-        FVector Dir = MovementComp->Velocity.IsNearlyZero()
-            ? GetActorForwardVector()
-            : MovementComp->Velocity.GetSafeNormal();
+    // Re-arm visuals
+    SetActorHiddenInGame(false);
+}
 
-        MovementComp->Velocity = Dir * MovementComp->InitialSpeed;
+void AProjectile::DeactivateToPool()
+{
+    bIsActive = false;
 
-        // Restore homing if we had it originally
-        if (bWasHomingProjectile && TargetActor.IsValid())
+    if (LifetimeEventId != INDEX_NONE)
+    {
+        if (USTGameEventScheduler* Scheduler = USTGameEventScheduler::Get(this))
         {
-            MovementComp->bIsHomingProjectile = true;
-            MovementComp->HomingTargetComponent = TargetActor->GetRootComponent();
+            Scheduler->CancelEvent(LifetimeEventId);
         }
+        LifetimeEventId = INDEX_NONE;
     }
-    else // Speed < 0 => rewind
-    {
-        // Turn off homing while rewinding
-        MovementComp->bIsHomingProjectile = false;
-        MovementComp->HomingTargetComponent = nullptr;
 
-        FVector Dir = MovementComp->Velocity.IsNearlyZero()
-            ? -GetActorForwardVector()
-            : -MovementComp->Velocity.GetSafeNormal();
+    TargetActor = nullptr;
+    bWasHomingProjectile = false;
+    SimVelocity = FVector::ZeroVector;
 
-        MovementComp->MaxSpeed = BaseSpeed * AbsSpeed;
-        MovementComp->InitialSpeed = BaseSpeed * AbsSpeed;
-        MovementComp->Velocity = Dir * MovementComp->InitialSpeed;
-    }
+    MovementComp->StopMovementImmediately();
+
+    SetActorHiddenInGame(true);
+    SetOwner(nullptr);
 }
 
+void AProjectile::ReturnToPool()
+{
+    if (!bIsActive)
+    {
+        return;
+    }
+
+    if (PoolBucketIndex != INDEX_NONE)
+    {
+        if (USTProjectilePoolSubsystem* Pool = USTProjectilePoolSubsystem::Get(this))
+        {
+            Pool->ReleaseProjectile(this);
+            return;
+        }
+    }
+
+    // Not pooled (e.g. placed in the level by hand)
+    Destroy();
+}
@@ -9,6 +9,7 @@
 class USphereComponent;
 class UStaticMeshComponent;
 class UProjectileMovementComponent;
+class USTSimulationClock;
 
 UCLASS()
 class ACTIONTOWERDEFENSE_API AProjectile : public AActor
@@ -25,9 +26,32 @@ public:
         bool bInUseHoming,
         float InHomingAcceleration);
 
+    // --- Pooling (driven by USTProjectilePoolSubsystem) ---
+
+    /** Wake a pooled projectile up at the given transform and re-arm collision. */
+    void ActivateFromPool(const FTransform& SpawnTransform, AActor* InOwner, APawn* InInstigator);
+
+    /** Hide, disarm and park this projectile until it is acquired again. */
+    void DeactivateToPool();
+
+    /** Hand this projectile back to the pool (or destroy it if it was not pooled). */
+    void ReturnToPool();
+
+    FORCEINLINE bool IsActiveInPool() const { return bIsActive; }
+
+    FORCEINLINE UProjectileMovementComponent* GetProjectileMovement() const { return MovementComp; }
+
+    /**
+     * Advance by one fixed simulation substep (driven by USTProjectilePoolSubsystem).
+     * Velocity never changes with game speed; rewinding passes a negative step.
+     */
+    void SimStep(float StepSeconds);
+
+    /** Place the actor between its last two simulated positions for rendering. */
+    void UpdatePresentation(float Alpha);
+
 protected:
     virtual void BeginPlay() override;
-    virtual void Tick(float DeltaSeconds) override;  // ← add this
 
     // Components
     UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Components")
@@ -46,17 +70,53 @@ protected:
     UPROPERTY()
     TWeakObjectPtr<AActor> TargetActor;
 
-    // Base speed from tower – used to scale with global speed
+    // Speed from tower (units per game-second)
     float BaseSpeed = 2000.f;
 
     // Remember if this projectile was homing at spawn
     bool bWasHomingProjectile = false;
 
-    // Hit callback
-    UFUNCTION()
-    void OnProjectileHit(UPrimitiveComponent* HitComp,
-        AActor* OtherActor,
-        UPrimitiveComponent* OtherComp,
-        FVector NormalImpulse,
-        const FHitResult& Hit);
+    float HomingAcceleration = 0.f;
+
+    /** Game-time seconds before an unhit projectile returns to the pool. */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Combat")
+    float MaxLifetime = 5.f;
+
+    /** Simulated state: position after the latest substep and the one before it. */
+    FVector SimLocation = FVector::ZeroVector;
+    FVector PrevSimLocation = FVector::ZeroVector;
+
+    /** Velocity when time runs forward (units per game-second). */
+    FVector SimVelocity = FVector::ZeroVector;
+
+    /** Cached simulation clock (its enemy grid resolves hits). */
+    UPROPERTY(Transient)
+    USTSimulationClock* SimClock = nullptr;
+
+    /** Pending MaxLifetime expiry in USTGameEventScheduler. */
+    int32 LifetimeEventId = INDEX_NONE;
+
+    /** False while parked in the pool. */
+    bool bIsActive = true;
+
+    /** Bucket in USTProjectilePoolSubsystem, INDEX_NONE if spawned outside the pool. */
+    int32 PoolBucketIndex = INDEX_NONE;
+
+    /** Slot in USTProjectilePoolSubsystem's in-flight list, INDEX_NONE while parked. */
+    int32 ActiveIndex = INDEX_NONE;
+
+    /** Id of this flight (new on every acquire; kept across rewinds). */
+    int32 SimId = INDEX_NONE;
+
+    /** Game-seconds since launch. */
+    float Age = 0.f;
+
+    /** (Re)schedule the MaxLifetime expiry, AlreadyElapsed seconds in. */
+    void ScheduleLifetime(float AlreadyElapsed);
+
+    friend class USTProjectilePoolSubsystem;
+    friend class USTRewindHistory;
+
+    /** Apply damage to OtherActor and go back to the pool. */
+    void HandleSimHit(AActor* OtherActor);
 };
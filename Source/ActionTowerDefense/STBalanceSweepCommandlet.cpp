@@ -0,0 +1,457 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "STBalanceSweepCommandlet.h"
+#include "HAL/PlatformMisc.h"
+#include "HAL/PlatformProcess.h"
+#include "Misc/DateTime.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Parse.h"
+#include "Misc/Paths.h"
+#include "Dom/JsonObject.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonWriter.h"
+#include "Serialization/JsonSerializer.h"
+
+namespace STBalanceSweep
+{
+    /** Batches per worker when -BatchSize is not given (evens out slow matches). */
+    constexpr int32 BatchesPerWorker = 4;
+
+    static TArray<FString> ReadStrings(const FJsonObject& Sweep, const TCHAR* Field, const FString& Default)
+    {
+        TArray<FString> Values;
+        Sweep.TryGetStringArrayField(Field, Values);
+        if (Values.Num() == 0)
+        {
+            Values.Add(Default);
+        }
+        return Values;
+    }
+
+    /** A missing field is one unset value: the level's own. */
+    static TArray<TOptional<float>> ReadNumbers(const FJsonObject& Sweep, const TCHAR* Field)
+    {
+        TArray<TOptional<float>> Values;
+
+        const TArray<TSharedPtr<FJsonValue>>* Array = nullptr;
+        if (Sweep.TryGetArrayField(Field, Array))
+        {
+            for (const TSharedPtr<FJsonValue>& Value : *Array)
+            {
+                Values.Add(static_cast<float>(Value->AsNumber()));
+            }
+        }
+
+        if (Values.Num() == 0)
+        {
+            Values.AddDefaulted();
+        }
+        return Values;
+    }
+
+    static FString ToString(const TOptional<float>& Value)
+    {
+        return Value.IsSet() ? FString::SanitizeFloat(Value.GetValue()) : FString();
+    }
+
+    /** Per combination totals. */
+    struct FAggregate
+    {
+        const FSTSweepJob* FirstJob = nullptr;
+
+        int32 Matches = 0;
+        int32 Failed = 0;
+        int32 Finished = 0;
+        int32 Victories = 0;
+
+        double ScoreSum = 0.0;
+        double ScoreMin = TNumericLimits<double>::Max();
+        double ScoreMax = TNumericLimits<double>::Lowest();
+
+        double LeaksSum = 0.0;
+        double LeaksMin = TNumericLimits<double>::Max();
+        double LeaksMax = TNumericLimits<double>::Lowest();
+
+        double GameSecondsSum = 0.0;
+        double SubstepsPerSecondSum = 0.0;
+
+        void Add(double Score, double Leaks)
+        {
+            ScoreSum += Score;
+            ScoreMin = FMath::Min(ScoreMin, Score);
+            ScoreMax = FMath::Max(ScoreMax, Score);
+
+            LeaksSum += Leaks;
+            LeaksMin = FMath::Min(LeaksMin, Leaks);
+            LeaksMax = FMath::Max(LeaksMax, Leaks);
+        }
+
+        int32 NumWithResults() const { return Matches - Failed; }
+        double Mean(double Sum) const { return NumWithResults() > 0 ? Sum / NumWithResults() : 0.0; }
+        double OrZero(double Value) const { return NumWithResults() > 0 ? Value : 0.0; }
+    };
+}
+
+FString FSTSweepJob::ToMatchParams(const FString& Speed, double MaxGameSeconds) const
+{
+    FString Params = FString::Printf(TEXT("-Map=%s -Seed=%d -Speed=%s -MaxGameSeconds=%.0f -Json=\"%s\""),
+        *Map, Seed, *Speed, MaxGameSeconds, *ResultPath);
+
+    if (!Layout.IsEmpty())
+    {
+        Params += FString::Printf(TEXT(" -Script=\"%s\""), *Layout);
+    }
+    if (!WaveSet.IsEmpty())
+    {
+        Params += FString::Printf(TEXT(" -WaveSet=%s"), *WaveSet);
+    }
+    if (FireRate.IsSet())
+    {
+        Params += FString::Printf(TEXT(" -FireRate=%g"), FireRate.GetValue());
+    }
+    if (ProjectileDamage.IsSet())
+    {
+        Params += FString::Printf(TEXT(" -ProjectileDamage=%g"), ProjectileDamage.GetValue());
+    }
+    if (RotationSpeedDegPerSec.IsSet())
+    {
+        Params += FString::Printf(TEXT(" -RotationSpeedDegPerSec=%g"), RotationSpeedDegPerSec.GetValue());
+    }
+
+    return Params;
+}
+
+USTBalanceSweepCommandlet::USTBalanceSweepCommandlet()
+{
+    IsClient = false;
+    IsServer = false;
+    LogToConsole = true;
+}
+
+// ========================================================
+// Main
+// ========================================================
+
+int32 USTBalanceSweepCommandlet::Main(const FString& Params)
+{
+    using namespace STBalanceSweep;
+
+    FString SweepPath;
+    if (!FParse::Value(*Params, TEXT("Sweep="), SweepPath))
+    {
+        UE_LOG(LogTemp, Error, TEXT("Sweep: usage -run=STBalanceSweep -Sweep=<file.json> [-Workers=N] [-BatchSize=N]"));
+        return 1;
+    }
+
+    SweepPath = FPaths::ConvertRelativePathToFull(SweepPath);
+
+    FString SweepText;
+    TSharedPtr<FJsonObject> Sweep;
+    if (!FFileHelper::LoadFileToString(SweepText, *SweepPath)
+        || !FJsonSerializer::Deserialize(TJsonReaderFactory<>::Create(SweepText), Sweep)
+        || !Sweep.IsValid())
+    {
+        UE_LOG(LogTemp, Error, TEXT("Sweep: could not read %s"), *SweepPath);
+        return 1;
+    }
+
+    OutputDir = FPaths::ConvertRelativePathToFull(FPaths::ProjectSavedDir() / TEXT("ActionTD") / TEXT("Sweeps")
+        / FString::Printf(TEXT("%s_%s"), *FPaths::GetBaseFilename(SweepPath), *FDateTime::Now().ToString()));
+
+    if (!BuildJobs(*Sweep, FPaths::GetPath(SweepPath)) || Jobs.Num() == 0)
+    {
+        UE_LOG(LogTemp, Error, TEXT("Sweep: %s has no matches to run"), *SweepPath);
+        return 1;
+    }
+
+    NumWorkers = FPlatformMisc::NumberOfCores();
+    FParse::Value(*Params, TEXT("Workers="), NumWorkers);
+    NumWorkers = FMath::Clamp(NumWorkers, 1, Jobs.Num());
+
+    int32 BatchSize = FMath::DivideAndRoundUp(Jobs.Num(), NumWorkers * BatchesPerWorker);
+    FParse::Value(*Params, TEXT("BatchSize="), BatchSize);
+    BatchSize = FMath::Max(BatchSize, 1);
+
+    UE_LOG(LogTemp, Display, TEXT("Sweep: %d combinations x %d seeds = %d matches on %d workers (batches of %d) -> %s"),
+        NumCombinations, Jobs.Num() / FMath::Max(NumCombinations, 1), Jobs.Num(), NumWorkers, BatchSize, *OutputDir);
+
+    const double StartSeconds = FPlatformTime::Seconds();
+
+    TArray<FSTSweepWorker> Running;
+    int32 NextJob = 0;
+    int32 NumJobsDone = 0;
+    bool bLaunchFailed = false;
+
+    while ((!bLaunchFailed && NextJob < Jobs.Num()) || Running.Num() > 0)
+    {
+        while (!bLaunchFailed && Running.Num() < NumWorkers && NextJob < Jobs.Num())
+        {
+            FSTSweepWorker Worker;
+            if (!StartWorker(NextJob, FMath::Min(BatchSize, Jobs.Num() - NextJob), Worker))
+            {
+                // Let the running ones finish; the report covers what ran
+                bLaunchFailed = true;
+                break;
+            }
+
+            NextJob += Worker.NumJobs;
+            Running.Add(Worker);
+        }
+
+        for (int32 Index = Running.Num() - 1; Index >= 0; --Index)
+        {
+            FSTSweepWorker& Worker = Running[Index];
+            if (FPlatformProcess::IsProcRunning(Worker.Process))
+            {
+                continue;
+            }
+
+            int32 ReturnCode = 0;
+            FPlatformProcess::GetProcReturnCode(Worker.Process, &ReturnCode);
+            FPlatformProcess::CloseProc(Worker.Process);
+
+            NumJobsDone += Worker.NumJobs;
+            UE_LOG(LogTemp, Display, TEXT("Sweep: %d / %d matches | matches %d-%d took %.1f s (exit %d)"),
+                NumJobsDone, Jobs.Num(), Worker.FirstJob, Worker.FirstJob + Worker.NumJobs - 1,
+                FPlatformTime::Seconds() - Worker.StartSeconds, ReturnCode);
+
+            Running.RemoveAtSwap(Index);
+        }
+
+        FPlatformProcess::Sleep(0.1f);
+    }
+
+    const double WallSeconds = FPlatformTime::Seconds() - StartSeconds;
+    const int32 NumFailed = WriteReports(WallSeconds);
+
+    UE_LOG(LogTemp, Display, TEXT("Sweep: %d matches in %.1f s (%.1f matches/min), %d without results | %s"),
+        Jobs.Num(), WallSeconds, Jobs.Num() * 60.0 / FMath::Max(WallSeconds, UE_DOUBLE_SMALL_NUMBER), NumFailed,
+        *(OutputDir / TEXT("Report.csv")));
+
+    return (bLaunchFailed || NumFailed > 0) ? 1 : 0;
+}
+
+// ========================================================
+// Jobs
+// ========================================================
+
+bool USTBalanceSweepCommandlet::BuildJobs(const FJsonObject& Sweep, const FString& SweepDir)
+{
+    using namespace STBalanceSweep;
+
+    const TArray<FString> Maps = ReadStrings(Sweep, TEXT("maps"), TEXT("TestLevel"));
+    const TArray<FString> Layouts = ReadStrings(Sweep, TEXT("layouts"), FString());
+    const TArray<FString> WaveSets = ReadStrings(Sweep, TEXT("waveSets"), FString());
+    const TArray<TOptional<float>> FireRates = ReadNumbers(Sweep, TEXT("fireRate"));
+    const TArray<TOptional<float>> Damages = ReadNumbers(Sweep, TEXT("projectileDamage"));
+    const TArray<TOptional<float>> RotationSpeeds = ReadNumbers(Sweep, TEXT("rotationSpeedDegPerSec"));
+
+    int32 NumSeeds = 1;
+    int32 FirstSeed = 1;
+    Sweep.TryGetNumberField(TEXT("seeds"), NumSeeds);
+    Sweep.TryGetNumberField(TEXT("firstSeed"), FirstSeed);
+    Sweep.TryGetStringField(TEXT("speed"), Speed);
+    Sweep.TryGetNumberField(TEXT("maxGameSeconds"), MaxGameSeconds);
+
+    for (const FString& Map : Maps)
+    for (const FString& Layout : Layouts)
+    for (const FString& WaveSet : WaveSets)
+    for (const TOptional<float>& FireRate : FireRates)
+    for (const TOptional<float>& Damage : Damages)
+    for (const TOptional<float>& RotationSpeed : RotationSpeeds)
+    {
+        for (int32 Run = 0; Run < FMath::Max(NumSeeds, 1); ++Run)
+        {
+            FSTSweepJob& Job = Jobs.AddDefaulted_GetRef();
+            Job.Index = Jobs.Num() - 1;
+            Job.Combination = NumCombinations;
+            Job.Seed = FirstSeed + Job.Index; // distinct across the whole sweep
+            Job.Map = Map;
+            // Layout scripts are relative to the sweep file; workers run from elsewhere
+            Job.Layout = Layout.IsEmpty() ? FString() : FPaths::ConvertRelativePathToFull(SweepDir, Layout);
+            Job.WaveSet = WaveSet;
+            Job.FireRate = FireRate;
+            Job.ProjectileDamage = Damage;
+            Job.RotationSpeedDegPerSec = RotationSpeed;
+            Job.ResultPath = OutputDir / TEXT("results") / FString::Printf(TEXT("Match_%05d.json"), Job.Index);
+        }
+
+        ++NumCombinations;
+    }
+
+    return true;
+}
+
+bool USTBalanceSweepCommandlet::StartWorker(int32 FirstJob, int32 NumJobs, FSTSweepWorker& OutWorker)
+{
+    const FString BatchName = FString::Printf(TEXT("Batch_%04d"), NumBatches++);
+    const FString BatchPath = OutputDir / TEXT("batches") / BatchName + TEXT(".txt");
+    const FString LogPath = OutputDir / TEXT("logs") / BatchName + TEXT(".log");
+
+    TArray<FString> Lines;
+    for (int32 Index = FirstJob; Index < FirstJob + NumJobs; ++Index)
+    {
+        Lines.Add(Jobs[Index].ToMatchParams(Speed, MaxGameSeconds));
+    }
+
+    if (!FFileHelper::SaveStringArrayToFile(Lines, *BatchPath))
+    {
+        UE_LOG(LogTemp, Error, TEXT("Sweep: could not write %s"), *BatchPath);
+        return false;
+    }
+
+    const FString Args = FString::Printf(
+        TEXT("\"%s\" -run=STSimulateMatch -Jobs=\"%s\" -abslog=\"%s\" -nullrhi -unattended -nosplash -nosound -nopause"),
+        *FPaths::ConvertRelativePathToFull(FPaths::GetProjectFilePath()), *BatchPath, *LogPath);
+
+    OutWorker.Process = FPlatformProcess::CreateProc(FPlatformProcess::ExecutablePath(), *Args,
+        false /*bLaunchDetached*/, true /*bLaunchHidden*/, true /*bLaunchReallyHidden*/,
+        nullptr, 0, nullptr, nullptr);
+
+    if (!OutWorker.Process.IsValid())
+    {
+        UE_LOG(LogTemp, Error, TEXT("Sweep: could not start a worker (%s %s)"), FPlatformProcess::ExecutablePath(), *Args);
+        return false;
+    }
+
+    OutWorker.FirstJob = FirstJob;
+    OutWorker.NumJobs = NumJobs;
+    OutWorker.StartSeconds = FPlatformTime::Seconds();
+    return true;
+}
+
+// ========================================================
+// Reports
+// ========================================================
+
+int32 USTBalanceSweepCommandlet::WriteReports(double WallSeconds) const
+{
+    using namespace STBalanceSweep;
+
+    TArray<FAggregate> Aggregates;
+    Aggregates.SetNum(NumCombinations);
+
+    TArray<FString> MatchRows;
+    MatchRows.Add(TEXT("match,combination,map,layout,waveSet,fireRate,projectileDamage,rotationSpeedDegPerSec,seed,result,score,leaks,gameSeconds,wallSeconds,substepsPerSecond"));
+
+    int32 NumFailed = 0;
+
+    for (const FSTSweepJob& Job : Jobs)
+    {
+        FAggregate& Aggregate = Aggregates[Job.Combination];
+        Aggregate.FirstJob = Aggregate.FirstJob ? Aggregate.FirstJob : &Job;
+        ++Aggregate.Matches;
+
+        const FString Dimensions = FString::Printf(TEXT("%d,%d,%s,\"%s\",%s,%s,%s,%s,%d"),
+            Job.Index, Job.Combination, *Job.Map, *FPaths::GetBaseFilename(Job.Layout), *FPaths::GetBaseFilename(Job.WaveSet),
+            *ToString(Job.FireRate), *ToString(Job.ProjectileDamage), *ToString(Job.RotationSpeedDegPerSec), Job.Seed);
+
+        FString ResultText;
+        TSharedPtr<FJsonObject> Result;
+        if (!FFileHelper::LoadFileToString(ResultText, *Job.ResultPath)
+            || !FJsonSerializer::Deserialize(TJsonReaderFactory<>::Create(ResultText), Result)
+            || !Result.IsValid())
+        {
+            ++Aggregate.Failed;
+            ++NumFailed;
+            MatchRows.Add(Dimensions + TEXT(",failed,,,,,"));
+            continue;
+        }
+
+        const bool bFinished = Result->GetBoolField(TEXT("finished"));
+        const bool bVictory = Result->GetBoolField(TEXT("victory"));
+        const double Score = Result->GetNumberField(TEXT("score"));
+        const double Leaks = Result->GetNumberField(TEXT("leaks"));
+        const double GameSeconds = Result->GetNumberField(TEXT("gameSeconds"));
+        const double SubstepsPerSecond = Result->GetNumberField(TEXT("substepsPerSecond"));
+
+        Aggregate.Finished += bFinished ? 1 : 0;
+        Aggregate.Victories += bVictory ? 1 : 0;
+        Aggregate.Add(Score, Leaks);
+        Aggregate.GameSecondsSum += GameSeconds;
+        Aggregate.SubstepsPerSecondSum += SubstepsPerSecond;
+
+        MatchRows.Add(Dimensions + FString::Printf(TEXT(",%s,%.0f,%.0f,%.1f,%.3f,%.0f"),
+            bVictory ? TEXT("victory") : bFinished ? TEXT("defeat") : TEXT("timeout"),
+            Score, Leaks, GameSeconds, Result->GetNumberField(TEXT("wallSeconds")), SubstepsPerSecond));
+    }
+
+    TArray<FString> ReportRows;
+    ReportRows.Add(TEXT("combination,map,layout,waveSet,fireRate,projectileDamage,rotationSpeedDegPerSec,matches,failed,victories,winRate,scoreMean,scoreMin,scoreMax,leaksMean,leaksMin,leaksMax,gameSecondsMean,substepsPerSecondMean"));
+
+    TArray<TSharedPtr<FJsonValue>> CombinationValues;
+
+    for (int32 Combination = 0; Combination < Aggregates.Num(); ++Combination)
+    {
+        const FAggregate& Aggregate = Aggregates[Combination];
+        const FSTSweepJob& Job = *Aggregate.FirstJob;
+        const double WinRate = Aggregate.Matches > 0 ? static_cast<double>(Aggregate.Victories) / Aggregate.Matches : 0.0;
+
+        ReportRows.Add(FString::Printf(TEXT("%d,%s,\"%s\",%s,%s,%s,%s,%d,%d,%d,%.3f,%.0f,%.0f,%.0f,%.2f,%.0f,%.0f,%.1f,%.0f"),
+            Combination, *Job.Map, *FPaths::GetBaseFilename(Job.Layout), *FPaths::GetBaseFilename(Job.WaveSet),
+            *ToString(Job.FireRate), *ToString(Job.ProjectileDamage), *ToString(Job.RotationSpeedDegPerSec),
+            Aggregate.Matches, Aggregate.Failed, Aggregate.Victories, WinRate,
+            Aggregate.Mean(Aggregate.ScoreSum), Aggregate.OrZero(Aggregate.ScoreMin), Aggregate.OrZero(Aggregate.ScoreMax),
+            Aggregate.Mean(Aggregate.LeaksSum), Aggregate.OrZero(Aggregate.LeaksMin), Aggregate.OrZero(Aggregate.LeaksMax),
+            Aggregate.Mean(Aggregate.GameSecondsSum), Aggregate.Mean(Aggregate.SubstepsPerSecondSum)));
+
+        TSharedRef<FJsonObject> Object = MakeShared<FJsonObject>();
+        Object->SetNumberField(TEXT("combination"), Combination);
+        Object->SetStringField(TEXT("map"), Job.Map);
+        Object->SetStringField(TEXT("layout"), Job.Layout);
+        Object->SetStringField(TEXT("waveSet"), Job.WaveSet);
+        if (Job.FireRate.IsSet())
+        {
+            Object->SetNumberField(TEXT("fireRate"), Job.FireRate.GetValue());
+        }
+        if (Job.ProjectileDamage.IsSet())
+        {
+            Object->SetNumberField(TEXT("projectileDamage"), Job.ProjectileDamage.GetValue());
+        }
+        if (Job.RotationSpeedDegPerSec.IsSet())
+        {
+            Object->SetNumberField(TEXT("rotationSpeedDegPerSec"), Job.RotationSpeedDegPerSec.GetValue());
+        }
+        Object->SetNumberField(TEXT("matches"), Aggregate.Matches);
+        Object->SetNumberField(TEXT("failed"), Aggregate.Failed);
+        Object->SetNumberField(TEXT("finished"), Aggregate.Finished);
+        Object->SetNumberField(TEXT("victories"), Aggregate.Victories);
+        Object->SetNumberField(TEXT("winRate"), WinRate);
+        Object->SetNumberField(TEXT("scoreMean"), Aggregate.Mean(Aggregate.ScoreSum));
+        Object->SetNumberField(TEXT("scoreMin"), Aggregate.OrZero(Aggregate.ScoreMin));
+        Object->SetNumberField(TEXT("scoreMax"), Aggregate.OrZero(Aggregate.ScoreMax));
+        Object->SetNumberField(TEXT("leaksMean"), Aggregate.Mean(Aggregate.LeaksSum));
+        Object->SetNumberField(TEXT("leaksMin"), Aggregate.OrZero(Aggregate.LeaksMin));
+        Object->SetNumberField(TEXT("leaksMax"), Aggregate.OrZero(Aggregate.LeaksMax));
+        Object->SetNumberField(TEXT("gameSecondsMean"), Aggregate.Mean(Aggregate.GameSecondsSum));
+        Object->SetNumberField(TEXT("substepsPerSecondMean"), Aggregate.Mean(Aggregate.SubstepsPerSecondSum));
+        CombinationValues.Add(MakeShared<FJsonValueObject>(Object));
+    }
+
+    TSharedRef<FJsonObject> Root = MakeShared<FJsonObject>();
+    Root->SetStringField(TEXT("time"), FDateTime::UtcNow().ToIso8601());
+    Root->SetNumberField(TEXT("matches"), Jobs.Num());
+    Root->SetNumberField(TEXT("failed"), NumFailed);
+    Root->SetNumberField(TEXT("combinations"), NumCombinations);
+    Root->SetNumberField(TEXT("workers"), NumWorkers);
+    Root->SetNumberField(TEXT("batches"), NumBatches);
+    Root->SetNumberField(TEXT("wallSeconds"), WallSeconds);
+    Root->SetNumberField(TEXT("matchesPerMinute"), Jobs.Num() * 60.0 / FMath::Max(WallSeconds, UE_DOUBLE_SMALL_NUMBER));
+    Root->SetStringField(TEXT("speed"), Speed);
+    Root->SetArrayField(TEXT("combinations"), CombinationValues);
+
+    FString Json;
+    const TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&Json);
+    const bool bWritten = FJsonSerializer::Serialize(Root, Writer)
+        && FFileHelper::SaveStringToFile(Json, *(OutputDir / TEXT("Report.json")))
+        && FFileHelper::SaveStringArrayToFile(ReportRows, *(OutputDir / TEXT("Report.csv")))
+        && FFileHelper::SaveStringArrayToFile(MatchRows, *(OutputDir / TEXT("Matches.csv")));
+
+    if (!bWritten)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("Sweep: could not write the reports to %s"), *OutputDir);
+    }
+
+    return NumFailed;
+}
@@ -0,0 +1,106 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "STBalanceSweepCommandlet.generated.h"
+
+class FJsonObject;
+
+/** One match of a sweep: a combination of the sweep's dimensions and a seed. */
+struct FSTSweepJob
+{
+    int32 Index = 0;
+    int32 Combination = 0;
+    int32 Seed = 0;
+
+    FString Map;
+    FString Layout;
+    FString WaveSet;
+    TOptional<float> FireRate;
+    TOptional<float> ProjectileDamage;
+    TOptional<float> RotationSpeedDegPerSec;
+
+    /** Where the worker writes this match's results. */
+    FString ResultPath;
+
+    /** USTSimulateMatchCommandlet options for this match. */
+    FString ToMatchParams(const FString& Speed, double MaxGameSeconds) const;
+};
+
+/** A running worker process and the jobs it was given. */
+struct FSTSweepWorker
+{
+    FProcHandle Process;
+    int32 FirstJob = 0;
+    int32 NumJobs = 0;
+    double StartSeconds = 0.0;
+};
+
+/**
+ * Runs a balance sweep: every combination of tower layout, tower parameters and
+ * wave set in a sweep file, several seeds each, as headless matches in parallel
+ * worker processes, aggregated into one report.
+ *
+ *   UnrealEditor-Cmd ActionTowerDefense.uproject -run=STBalanceSweep -Sweep=<file.json>
+ *       [-Workers=N] [-BatchSize=N] -nullrhi -unattended
+ *
+ * The sweep file (every array optional; a missing one keeps the level's value):
+ *
+ *   {
+ *     "maps": ["TestLevel", "TestLevel2"],
+ *     "layouts": ["", "Sweeps/TwoCaptures.txt"],        // USTSimulateMatchCommandlet scripts, "" = as placed
+ *     "waveSets": ["", "/Game/Blueprints/WaveManagement/WS_Hard.WS_Hard"],
+ *     "fireRate": [0.75, 1.0, 1.5],
+ *     "projectileDamage": [15, 20, 30],
+ *     "rotationSpeedDegPerSec": [90, 180],
+ *     "seeds": 10,          // matches per combination
+ *     "firstSeed": 1,       // match N of the sweep runs with firstSeed + N
+ *     "speed": "Unlimited",
+ *     "maxGameSeconds": 7200
+ *   }
+ *
+ * Matches are handed out in batches of -BatchSize (default: about four batches per
+ * worker) to -Workers processes (default: one per physical core), each running
+ * -run=STSimulateMatch -Jobs=<batch>, so a worker pays the engine start once per
+ * batch and fast workers pick up the slack of slow ones. A new batch starts as soon
+ * as a worker exits.
+ *
+ * Output goes to Saved/ActionTD/Sweeps/<sweep>_<time>/: batches/, results/ (one
+ * JSON per match), logs/ (one per batch), Matches.csv (one row per match) and
+ * Report.json / Report.csv (per combination: matches, victories, win rate, score
+ * and leaks mean / min / max, game seconds, substeps per second).
+ *
+ * Returns 1 when the sweep could not run or a match produced no results.
+ */
+UCLASS()
+class ACTIONTOWERDEFENSE_API USTBalanceSweepCommandlet : public UCommandlet
+{
+    GENERATED_BODY()
+
+public:
+    USTBalanceSweepCommandlet();
+
+    virtual int32 Main(const FString& Params) override;
+
+protected:
+    /** Expand the sweep file (in SweepDir) into Jobs. */
+    bool BuildJobs(const FJsonObject& Sweep, const FString& SweepDir);
+
+    /** Write the next batch's job file and start a worker on it. */
+    bool StartWorker(int32 FirstJob, int32 NumJobs, FSTSweepWorker& OutWorker);
+
+    /** Read every match's results and write the reports; returns the number of matches without results. */
+    int32 WriteReports(double WallSeconds) const;
+
+    TArray<FSTSweepJob> Jobs;
+    int32 NumCombinations = 0;
+
+    FString Speed = TEXT("Unlimited");
+    double MaxGameSeconds = 7200.0;
+
+    FString OutputDir;
+    int32 NumWorkers = 1;
+    int32 NumBatches = 0;
+};
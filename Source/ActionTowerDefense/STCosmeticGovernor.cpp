@@ -0,0 +1,195 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "STCosmeticGovernor.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "STSimulationClock.h"
+#include "STStatGroup.h"
+
+static TAutoConsoleVariable<int32> CVarSTCosmeticGovernor(
+    TEXT("ActionTD.CosmeticGovernor"),
+    1,
+    TEXT("1: lower cosmetic work (effects, path detail, enemy visual rate, HUD rate) while frames run over ActionTD.CosmeticBudgetMs."));
+
+static TAutoConsoleVariable<float> CVarSTCosmeticBudgetMs(
+    TEXT("ActionTD.CosmeticBudgetMs"),
+    1000.f / 60.f,
+    TEXT("Frame time (ms) the cosmetic governor keeps frames under."));
+
+static TAutoConsoleVariable<int32> CVarSTCosmeticLevel(
+    TEXT("ActionTD.CosmeticLevel"),
+    -1,
+    TEXT("Force the cosmetic level (0 = full quality .. 4); -1 lets the governor pick it."));
+
+namespace STCosmeticGovernor
+{
+    /** Weight of the newest frame in the smoothed frame time. */
+    constexpr float SmoothingAlpha = 0.1f;
+
+    /** Frames longer than this (loading, a debugger break) are not load. */
+    constexpr float MaxSampleMs = 250.f;
+}
+
+void USTCosmeticGovernor::Initialize(FSubsystemCollectionBase& Collection)
+{
+    Super::Initialize(Collection);
+
+    SimClock = Collection.InitializeDependency<USTSimulationClock>();
+    if (SimClock)
+    {
+        FrameStartHandle = SimClock->OnFrameStart.AddUObject(this, &USTCosmeticGovernor::HandleFrameStart);
+    }
+}
+
+void USTCosmeticGovernor::Deinitialize()
+{
+    if (SimClock)
+    {
+        SimClock->OnFrameStart.Remove(FrameStartHandle);
+    }
+
+    Super::Deinitialize();
+}
+
+bool USTCosmeticGovernor::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+    return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+USTCosmeticGovernor* USTCosmeticGovernor::Get(const UObject* WorldContextObject)
+{
+    if (!WorldContextObject)
+    {
+        return nullptr;
+    }
+
+    UWorld* World = WorldContextObject->GetWorld();
+    if (!World)
+    {
+        return nullptr;
+    }
+
+    return World->GetSubsystem<USTCosmeticGovernor>();
+}
+
+// ========================================================
+// Frame time
+// ========================================================
+
+void USTCosmeticGovernor::HandleFrameStart(uint64 FrameNumber)
+{
+    using namespace STCosmeticGovernor;
+
+    CurrentFrame = FrameNumber;
+
+    const double NowSeconds = FPlatformTime::Seconds();
+    const float FrameMs = LastFrameStartSeconds > 0.0 ? static_cast<float>((NowSeconds - LastFrameStartSeconds) * 1000.0) : 0.f;
+    LastFrameStartSeconds = NowSeconds;
+
+    if (FrameMs > 0.f && FrameMs < MaxSampleMs)
+    {
+        SmoothedFrameMs = SmoothedFrameMs > 0.f ? FMath::Lerp(SmoothedFrameMs, FrameMs, SmoothingAlpha) : FrameMs;
+    }
+
+    SET_DWORD_STAT(STAT_ActionTD_CosmeticLevel, Level);
+    SET_FLOAT_STAT(STAT_ActionTD_SmoothedFrameMs, SmoothedFrameMs);
+    CSV_CUSTOM_STAT(ActionTD, CosmeticLevel, Level, ECsvCustomStatOp::Set);
+
+    const int32 ForcedLevel = CVarSTCosmeticLevel.GetValueOnGameThread();
+    if (ForcedLevel >= 0)
+    {
+        SetLevel(FMath::Min(ForcedLevel, MaxLevel));
+        return;
+    }
+
+    if (CVarSTCosmeticGovernor.GetValueOnGameThread() <= 0)
+    {
+        SetLevel(0);
+        return;
+    }
+
+    // Fast-forward fills its frames with substeps by design; the level holds
+    if (!SimClock || SimClock->IsFastForwarding())
+    {
+        FramesOverBudget = 0;
+        FramesWithHeadroom = 0;
+        return;
+    }
+
+    const float BudgetMs = CVarSTCosmeticBudgetMs.GetValueOnGameThread();
+
+    if (SmoothedFrameMs > BudgetMs)
+    {
+        FramesWithHeadroom = 0;
+        if (++FramesOverBudget >= DemoteFrames && Level < MaxLevel)
+        {
+            SetLevel(Level + 1);
+        }
+    }
+    else if (SmoothedFrameMs < BudgetMs * PromoteHeadroom)
+    {
+        FramesOverBudget = 0;
+        if (++FramesWithHeadroom >= PromoteFrames && Level > 0)
+        {
+            SetLevel(Level - 1);
+        }
+    }
+    else
+    {
+        FramesOverBudget = 0;
+        FramesWithHeadroom = 0;
+    }
+}
+
+void USTCosmeticGovernor::SetLevel(int32 NewLevel)
+{
+    // Each step gets its own window before the next one
+    FramesOverBudget = 0;
+    FramesWithHeadroom = 0;
+
+    if (NewLevel == Level)
+    {
+        return;
+    }
+
+    UE_LOG(LogTemp, Log, TEXT("CosmeticGovernor: level %d -> %d (%.1f ms smoothed)"), Level, NewLevel, SmoothedFrameMs);
+    ST_FLIGHT_EVENT(CosmeticLevel, INDEX_NONE, NewLevel);
+
+    Level = NewLevel;
+    EffectCounter = 0;
+
+    OnLevelChanged.Broadcast(Level);
+}
+
+// ========================================================
+// Steps
+// ========================================================
+
+bool USTCosmeticGovernor::ShouldPlayEffect()
+{
+    if (Level <= 0)
+    {
+        return true;
+    }
+
+    // A counter, not a random stream: the simulation's streams stay untouched
+    const uint32 KeepOneIn = 1u << FMath::Min(Level, 3);
+    return (EffectCounter++ % KeepOneIn) == 0;
+}
+
+bool USTCosmeticGovernor::ShouldUpdateEnemyVisual(int32 SimId) const
+{
+    if (Level < 3)
+    {
+        return true;
+    }
+
+    // Half the enemies move on even frames, half on odd ones
+    return ((CurrentFrame + static_cast<uint64>(SimId)) & 1) == 0;
+}
+
+bool USTCosmeticGovernor::ShouldRefreshHUD() const
+{
+    return Level < 4 || (CurrentFrame % HUDRefreshInterval) == 0;
+}
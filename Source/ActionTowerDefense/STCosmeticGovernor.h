@@ -0,0 +1,101 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "STCosmeticGovernor.generated.h"
+
+class USTSimulationClock;
+
+/** The governor moved to a new cosmetic level. */
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnCosmeticLevelChanged, int32 /*NewLevel*/);
+
+/**
+ * Trades cosmetic work for frame time when the frame budget is blown.
+ *
+ * Watches wall-clock frame time (smoothed) against ActionTD.CosmeticBudgetMs and
+ * steps the cosmetic level up after DemoteFrames frames over budget, back down
+ * after PromoteFrames frames with headroom. Each level adds one step:
+ *
+ *   1  thin BP_OnAttackFired / BP_OnKilled: one in 2 fire (one in 4 at level 2,
+ *      one in 8 from level 3)
+ *   2  coarse path visuals (UPathSplineVisualizerComponent: fewer, longer segments)
+ *   3  enemies move their rendered actor every other frame (staggered by sim id)
+ *   4  the HUD refreshes every HUDRefreshInterval frames
+ *
+ * Only presentation reads the level: simulation state, substeps, rewind
+ * snapshots and match checksums are the same at every level. Fast-forward frames
+ * (which spend their budget on substeps on purpose) hold the level.
+ *
+ * The level shows in "stat ActionTD" (Cosmetic level, smoothed frame ms), as the
+ * ActionTD/CosmeticLevel CSV column and as a flight recorder event.
+ * ActionTD.CosmeticLevel forces a level (-1: automatic).
+ */
+UCLASS()
+class ACTIONTOWERDEFENSE_API USTCosmeticGovernor : public UWorldSubsystem
+{
+    GENERATED_BODY()
+
+public:
+    virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+    virtual void Deinitialize() override;
+
+    /** Convenience helper so other classes can find the governor. */
+    static USTCosmeticGovernor* Get(const UObject* WorldContextObject);
+
+    static constexpr int32 MaxLevel = 4;
+
+    /** Consecutive frames over budget before the level goes up. */
+    static constexpr int32 DemoteFrames = 20;
+
+    /** Consecutive frames under PromoteHeadroom x budget before it comes back down. */
+    static constexpr int32 PromoteFrames = 120;
+    static constexpr float PromoteHeadroom = 0.75f;
+
+    /** Frames between HUD refreshes at level 4. */
+    static constexpr int32 HUDRefreshInterval = 6;
+
+    FORCEINLINE int32 GetLevel() const { return Level; }
+    FORCEINLINE float GetSmoothedFrameMs() const { return SmoothedFrameMs; }
+
+    /** A one-shot cosmetic effect (BP_OnAttackFired, BP_OnKilled) wants to play. */
+    bool ShouldPlayEffect();
+
+    /** Level 2+: path visuals use their coarse segments. */
+    FORCEINLINE bool UseCoarsePathVisuals() const { return Level >= 2; }
+
+    /** Level 3+: the enemy with SimId moves its rendered actor this frame. */
+    bool ShouldUpdateEnemyVisual(int32 SimId) const;
+
+    /** Level 4: the HUD refreshes this frame. */
+    bool ShouldRefreshHUD() const;
+
+    FOnCosmeticLevelChanged OnLevelChanged;
+
+protected:
+    virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+    void HandleFrameStart(uint64 FrameNumber);
+
+    void SetLevel(int32 NewLevel);
+
+    UPROPERTY(Transient)
+    USTSimulationClock* SimClock = nullptr;
+
+    FDelegateHandle FrameStartHandle;
+
+    int32 Level = 0;
+
+    float SmoothedFrameMs = 0.f;
+    double LastFrameStartSeconds = 0.0;
+
+    int32 FramesOverBudget = 0;
+    int32 FramesWithHeadroom = 0;
+
+    /** Frame the level-dependent rates count from. */
+    uint64 CurrentFrame = 0;
+
+    /** Effects asked for since the level changed (thinning keeps every Nth). */
+    uint32 EffectCounter = 0;
+};
@@ -0,0 +1,152 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "STEnemyGrid.h"
+#include "Algo/Sort.h"
+#include "EnemyBase.h"
+#include "STCoreRules.h"
+
+void FSTEnemyGrid::Build(TConstArrayView<ASTEnemyBase*> Enemies)
+{
+    Entries.Reset();
+    NumX = 0;
+    NumY = 0;
+    MaxRadius = 0.f;
+
+    // --- Bounds ---
+    FVector2D Min(TNumericLimits<float>::Max());
+    FVector2D Max(TNumericLimits<float>::Lowest());
+    int32 NumEnemies = 0;
+
+    for (const ASTEnemyBase* Enemy : Enemies)
+    {
+        if (!Enemy)
+        {
+            continue;
+        }
+
+        const FVector2D Location(Enemy->GetSimLocation());
+        Min = FVector2D::Min(Min, Location);
+        Max = FVector2D::Max(Max, Location);
+        MaxRadius = FMath::Max(MaxRadius, Enemy->GetSimCollisionRadius());
+        ++NumEnemies;
+    }
+
+    if (NumEnemies == 0)
+    {
+        CellStart.Reset();
+        return;
+    }
+
+    // Enemies spread over a huge area: coarser cells instead of a huge table
+    float EffectiveCellSize = FMath::Max(CellSize, 1.f);
+    const FVector2D Extent = Max - Min;
+    const double NumCellsAtSize = (Extent.X / EffectiveCellSize + 1.0) * (Extent.Y / EffectiveCellSize + 1.0);
+    if (NumCellsAtSize > MaxCells)
+    {
+        EffectiveCellSize *= FMath::Sqrt(static_cast<float>(NumCellsAtSize / MaxCells)) + 0.01f;
+    }
+
+    Origin = Min;
+    InvCellSize = 1.f / EffectiveCellSize;
+    NumX = FMath::FloorToInt32(Extent.X * InvCellSize) + 1;
+    NumY = FMath::FloorToInt32(Extent.Y * InvCellSize) + 1;
+
+    const int32 NumCells = NumX * NumY;
+
+    // --- Counting sort: count per cell, prefix sum, place (list order kept within a cell) ---
+    CellStart.Reset();
+    CellStart.SetNumZeroed(NumCells + 1);
+    CellOfEnemy.SetNumUninitialized(Enemies.Num());
+
+    for (int32 Index = 0; Index < Enemies.Num(); ++Index)
+    {
+        const ASTEnemyBase* Enemy = Enemies[Index];
+        if (!Enemy)
+        {
+            CellOfEnemy[Index] = INDEX_NONE;
+            continue;
+        }
+
+        const FVector& Location = Enemy->GetSimLocation();
+        const int32 CellX = FMath::Min(FMath::FloorToInt32((Location.X - Origin.X) * InvCellSize), NumX - 1);
+        const int32 CellY = FMath::Min(FMath::FloorToInt32((Location.Y - Origin.Y) * InvCellSize), NumY - 1);
+        const int32 Cell = CellY * NumX + CellX;
+
+        CellOfEnemy[Index] = Cell;
+        ++CellStart[Cell + 1];
+    }
+
+    for (int32 Cell = 0; Cell < NumCells; ++Cell)
+    {
+        CellStart[Cell + 1] += CellStart[Cell];
+    }
+
+    CellCursor.SetNumUninitialized(NumCells);
+    FMemory::Memcpy(CellCursor.GetData(), CellStart.GetData(), NumCells * sizeof(int32));
+    Entries.SetNumUninitialized(NumEnemies);
+
+    for (int32 Index = 0; Index < Enemies.Num(); ++Index)
+    {
+        const int32 Cell = CellOfEnemy[Index];
+        if (Cell == INDEX_NONE)
+        {
+            continue;
+        }
+
+        FSTEnemyGridEntry& Entry = Entries[CellCursor[Cell]++];
+        Entry.Location = Enemies[Index]->GetSimLocation();
+        Entry.Radius = Enemies[Index]->GetSimCollisionRadius();
+        Entry.Index = Index;
+    }
+}
+
+int32 FSTEnemyGrid::Query(const FVector& Center, float Range, TArray<int32>& OutIndices) const
+{
+    if (Entries.Num() == 0)
+    {
+        return 0;
+    }
+
+    // Cells the range can touch, widened by the biggest enemy
+    const float Reach = Range + MaxRadius;
+    const int32 MinX = FMath::FloorToInt32((Center.X - Reach - Origin.X) * InvCellSize);
+    const int32 MaxX = FMath::FloorToInt32((Center.X + Reach - Origin.X) * InvCellSize);
+    const int32 MinY = FMath::FloorToInt32((Center.Y - Reach - Origin.Y) * InvCellSize);
+    const int32 MaxY = FMath::FloorToInt32((Center.Y + Reach - Origin.Y) * InvCellSize);
+
+    if (MaxX < 0 || MaxY < 0 || MinX >= NumX || MinY >= NumY)
+    {
+        return 0;
+    }
+
+    const int32 FirstOut = OutIndices.Num();
+    int32 NumTested = 0;
+
+    for (int32 CellY = FMath::Max(MinY, 0); CellY <= FMath::Min(MaxY, NumY - 1); ++CellY)
+    {
+        // A row of cells is one contiguous run of entries
+        const int32 RowStart = CellY * NumX;
+        const int32 First = CellStart[RowStart + FMath::Max(MinX, 0)];
+        const int32 Last = CellStart[RowStart + FMath::Min(MaxX, NumX - 1) + 1];
+
+        NumTested += Last - First;
+
+        for (int32 EntryIndex = First; EntryIndex < Last; ++EntryIndex)
+        {
+            const FSTEnemyGridEntry& Entry = Entries[EntryIndex];
+            if (STCore::IsInReach(Center, Range, Entry.Location, Entry.Radius))
+            {
+                OutIndices.Add(Entry.Index);
+            }
+        }
+    }
+
+    // Cells interleave list order; hand results back in list (= step) order
+    if (OutIndices.Num() - FirstOut > 1)
+    {
+        Algo::Sort(MakeArrayView(OutIndices.GetData() + FirstOut, OutIndices.Num() - FirstOut));
+    }
+
+    return NumTested;
+}
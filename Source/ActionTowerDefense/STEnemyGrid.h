@@ -0,0 +1,64 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class ASTEnemyBase;
+
+/** One enemy as the grid saw it when it was built. */
+struct FSTEnemyGridEntry
+{
+    FVector Location = FVector::ZeroVector;
+    float Radius = 0.f;
+
+    /** Slot in the enemy list the grid was built from. */
+    int32 Index = INDEX_NONE;
+};
+
+/**
+ * Uniform XY grid over the simulated enemy locations, rebuilt by
+ * USTSimulationClock once per substep so tower range queries only test the
+ * enemies in the cells their range covers instead of every enemy.
+ *
+ * Built with a counting sort into flat arrays (no per-cell allocations, buffers
+ * are reused between builds). Within a cell, entries keep enemy list order and
+ * queries return list slots in ascending order, so target queues fill in the
+ * same order as a full scan of the list would.
+ */
+struct ACTIONTOWERDEFENSE_API FSTEnemyGrid
+{
+    /** Cell edge in world units (about half a typical tower range). */
+    float CellSize = 500.f;
+
+    /** Cells are made bigger rather than exceed this many. */
+    static constexpr int32 MaxCells = 64 * 1024;
+
+    /** Bucket every non-null enemy in Enemies by its simulated location. */
+    void Build(TConstArrayView<ASTEnemyBase*> Enemies);
+
+    /**
+     * Append the list slot of every enemy whose bounds the sphere (Center, Range)
+     * touches, ascending. Returns the number of enemies tested.
+     */
+    int32 Query(const FVector& Center, float Range, TArray<int32>& OutIndices) const;
+
+    FORCEINLINE int32 GetNumEntries() const { return Entries.Num(); }
+
+private:
+    FVector2D Origin = FVector2D::ZeroVector;
+    float InvCellSize = 0.f;
+    int32 NumX = 0;
+    int32 NumY = 0;
+
+    /** Largest enemy radius: queries widen their cell range by it. */
+    float MaxRadius = 0.f;
+
+    /** Entries of cell C are Entries[CellStart[C] .. CellStart[C + 1]). */
+    TArray<int32> CellStart;
+    TArray<FSTEnemyGridEntry> Entries;
+
+    /** Build scratch: cell per enemy slot and the write cursor per cell. */
+    TArray<int32> CellOfEnemy;
+    TArray<int32> CellCursor;
+};
@@ -3,13 +3,14 @@
 
 #include "STEnemyLifeComponent.h"
 #include "GameFramework/Actor.h"
+#include "STGameController.h"
 
 USTEnemyLifeComponent::USTEnemyLifeComponent()
 {
     PrimaryComponentTick.bCanEverTick = false;
 }
 
-void USTEnemyLifeComponent::MarkEnemyRemoved(bool bReachedGoal)
+void USTEnemyLifeComponent::MarkEnemyRemoved(bool bReachedGoal, float ScoreValue)
 {
     if (bHasBeenRemoved)
     {
@@ -18,13 +19,15 @@ void USTEnemyLifeComponent::MarkEnemyRemoved(bool bReachedGoal)
 
     bHasBeenRemoved = true;
 
-    AActor* OwnerActor = GetOwner();
-
-    UE_LOG(LogTemp, Log,
-        TEXT("LifeComp: MarkEnemyRemoved called on %s, ReachedGoal=%s"),
-        OwnerActor ? *OwnerActor->GetName() : TEXT("nullptr"),
-        bReachedGoal ? TEXT("true") : TEXT("false"));
+    // Queued; the controller processes all of this frame's removals at once
+    if (ASTGameController* GC = ASTGameController::Get(this))
+    {
+        GC->NotifyEnemyRemoved(bReachedGoal, ScoreValue);
+    }
 
-    OnEnemyRemoved.Broadcast(OwnerActor, bReachedGoal);
+    if (OnEnemyRemoved.IsBound())
+    {
+        OnEnemyRemoved.Broadcast(GetOwner(), bReachedGoal);
+    }
 }
 
@@ -17,7 +17,9 @@ DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(
 /**
  * Simple lifecycle component for enemies (works with BP-only enemies).
  * - BP calls MarkEnemyRemoved(true/false) when it dies or reaches goal
- * - GameController (and others) can bind to OnEnemyRemoved
+ * - the removal is queued on the GameController, which applies the frame's
+ *   removals in one pass (ASTGameController::ProcessEnemyRemovals)
+ * - others can bind to OnEnemyRemoved for per-enemy events
  */
 UCLASS(ClassGroup = (Custom), meta = (BlueprintSpawnableComponent))
 class ACTIONTOWERDEFENSE_API USTEnemyLifeComponent : public UActorComponent
@@ -31,9 +33,9 @@ public:
     UPROPERTY(BlueprintAssignable, Category = "Enemy|Events")
     FOnEnemyRemoved OnEnemyRemoved;
 
-    /** Called from BP when enemy dies or reaches goal. */
+    /** Called from BP when enemy dies or reaches goal. ScoreValue is the base score for a kill. */
     UFUNCTION(BlueprintCallable, Category = "Enemy|Life")
-    void MarkEnemyRemoved(bool bReachedGoal);
+    void MarkEnemyRemoved(bool bReachedGoal, float ScoreValue = 0.f);
 
 protected:
     /** Ensure we only broadcast once. */
@@ -0,0 +1,330 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "STFlightRecorder.h"
+
+#if ST_FLIGHT_RECORDER_ENABLED
+
+#include <atomic>
+#include "HAL/IConsoleManager.h"
+#include "Misc/CoreDelegates.h"
+#include "Misc/DelayedAutoRegister.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Tasks/Task.h"
+#include "UObject/UObjectGlobals.h"
+
+static TAutoConsoleVariable<float> CVarSTHitchBudgetMs(
+    TEXT("ActionTD.HitchBudgetMs"),
+    50.f,
+    TEXT("Frames longer than this (ms) dump the flight recorder to Saved/ActionTD/Hitches. 0 disables."));
+
+static TAutoConsoleVariable<float> CVarSTHitchDumpSeconds(
+    TEXT("ActionTD.HitchDumpSeconds"),
+    5.f,
+    TEXT("Seconds of events and frame timings written per hitch dump."));
+
+static TAutoConsoleVariable<float> CVarSTHitchDumpCooldown(
+    TEXT("ActionTD.HitchDumpCooldown"),
+    10.f,
+    TEXT("Minimum seconds between two automatic hitch dumps."));
+
+namespace STFlightRecorder
+{
+    struct FEvent
+    {
+        double Seconds = 0.0;
+        uint64 Frame = 0;
+        float Value = 0.f;
+        int32 Id = INDEX_NONE;
+        ESTFlightEvent Type = ESTFlightEvent::Spawn;
+    };
+
+    /**
+     * Sequence is Index + 1 once the event for Index is fully written, 0 while a
+     * writer is in it. Readers copy the event and keep it only if Sequence was
+     * the expected value before and after the copy.
+     */
+    struct FEventSlot
+    {
+        std::atomic<uint64> Sequence{ 0 };
+        FEvent Event;
+    };
+
+    struct FFrame
+    {
+        double StartSeconds = 0.0;
+        uint64 Frame = 0;
+        float FrameMs = 0.f;
+        float PhaseMs[static_cast<int32>(ESTFlightPhase::Num)] = {};
+    };
+
+    static_assert(FMath::IsPowerOfTwo(EventCapacity) && FMath::IsPowerOfTwo(FrameCapacity), "Ring sizes must be powers of two");
+
+    // Static storage: recording never allocates
+    static FEventSlot GEvents[EventCapacity];
+    static std::atomic<uint64> GNextEvent{ 0 };
+
+    // Game thread only
+    static FFrame GFrames[FrameCapacity];
+    static uint64 GNumFrames = 0;
+    static uint64 GPhaseCycles[static_cast<int32>(ESTFlightPhase::Num)] = {};
+    static double GFrameStartSeconds = 0.0;
+    static double GLastDumpSeconds = -DBL_MAX;
+    static double GGCStartSeconds = 0.0;
+
+    static const TCHAR* LexToString(ESTFlightEvent Type)
+    {
+        switch (Type)
+        {
+        case ESTFlightEvent::WaveStart:      return TEXT("WaveStart");
+        case ESTFlightEvent::Spawn:          return TEXT("Spawn");
+        case ESTFlightEvent::Kill:           return TEXT("Kill");
+        case ESTFlightEvent::Leak:           return TEXT("Leak");
+        case ESTFlightEvent::ProjectileShot: return TEXT("ProjectileShot");
+        case ESTFlightEvent::PoolGrow:       return TEXT("PoolGrow");
+        case ESTFlightEvent::SpeedChange:    return TEXT("SpeedChange");
+        case ESTFlightEvent::Capture:        return TEXT("Capture");
+        case ESTFlightEvent::GarbageCollect: return TEXT("GarbageCollect");
+        case ESTFlightEvent::Hitch:          return TEXT("Hitch");
+        case ESTFlightEvent::CosmeticLevel:  return TEXT("CosmeticLevel");
+        }
+        return TEXT("Unknown");
+    }
+
+    static const TCHAR* LexToString(ESTFlightPhase Phase)
+    {
+        switch (Phase)
+        {
+        case ESTFlightPhase::ClockFrame:             return TEXT("ClockFrame");
+        case ESTFlightPhase::StepSpawners:           return TEXT("StepSpawners");
+        case ESTFlightPhase::StepEnemies:            return TEXT("StepEnemies");
+        case ESTFlightPhase::StepTowers:             return TEXT("StepTowers");
+        case ESTFlightPhase::StepProjectiles:        return TEXT("StepProjectiles");
+        case ESTFlightPhase::ScheduledEvents:        return TEXT("ScheduledEvents");
+        case ESTFlightPhase::RewindRecord:           return TEXT("RewindRecord");
+        case ESTFlightPhase::RewindRestore:          return TEXT("RewindRestore");
+        case ESTFlightPhase::Seek:                   return TEXT("Seek");
+        case ESTFlightPhase::ProjectilePresentation: return TEXT("ProjectilePresentation");
+        case ESTFlightPhase::RemovalBatch:           return TEXT("RemovalBatch");
+        case ESTFlightPhase::HUDTick:                return TEXT("HUDTick");
+        default:                                     break;
+        }
+        return TEXT("Unknown");
+    }
+
+    // ========================================================
+    // Recording
+    // ========================================================
+
+    void Record(ESTFlightEvent Type, int32 Id, float Value)
+    {
+        const uint64 Index = GNextEvent.fetch_add(1, std::memory_order_relaxed);
+        FEventSlot& Slot = GEvents[Index & (EventCapacity - 1)];
+
+        Slot.Sequence.store(0, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        Slot.Event.Seconds = FPlatformTime::Seconds();
+        Slot.Event.Frame = GFrameCounter;
+        Slot.Event.Value = Value;
+        Slot.Event.Id = Id;
+        Slot.Event.Type = Type;
+
+        Slot.Sequence.store(Index + 1, std::memory_order_release);
+    }
+
+    FPhaseScope::~FPhaseScope()
+    {
+        GPhaseCycles[static_cast<int32>(Phase)] += FPlatformTime::Cycles64() - StartCycles;
+    }
+
+    // ========================================================
+    // Dump
+    // ========================================================
+
+    /** Events newer than SinceSeconds, oldest first. Skips slots being rewritten. */
+    static void CopyEvents(double SinceSeconds, TArray<FEvent>& Out)
+    {
+        const uint64 End = GNextEvent.load(std::memory_order_acquire);
+        const uint64 Begin = End > EventCapacity ? End - EventCapacity : 0;
+
+        Out.Reserve(static_cast<int32>(End - Begin));
+        for (uint64 Index = Begin; Index < End; ++Index)
+        {
+            const FEventSlot& Slot = GEvents[Index & (EventCapacity - 1)];
+
+            if (Slot.Sequence.load(std::memory_order_acquire) != Index + 1)
+            {
+                continue;
+            }
+
+            const FEvent Event = Slot.Event;
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (Slot.Sequence.load(std::memory_order_relaxed) != Index + 1)
+            {
+                continue;
+            }
+
+            if (Event.Seconds >= SinceSeconds)
+            {
+                Out.Add(Event);
+            }
+        }
+    }
+
+    static void CopyFrames(double SinceSeconds, TArray<FFrame>& Out)
+    {
+        const uint64 Begin = GNumFrames > FrameCapacity ? GNumFrames - FrameCapacity : 0;
+        for (uint64 Index = Begin; Index < GNumFrames; ++Index)
+        {
+            const FFrame& Frame = GFrames[Index & (FrameCapacity - 1)];
+            if (Frame.StartSeconds >= SinceSeconds)
+            {
+                Out.Add(Frame);
+            }
+        }
+    }
+
+    static void Write(const TArray<FEvent>& Events, const TArray<FFrame>& Frames, double BaseSeconds,
+        const FString& Reason, const FString& Path)
+    {
+        // Hand-written JSON: one line per frame / event keeps big dumps diffable and greppable
+        TStringBuilder<16384> Json;
+        Json.Appendf(TEXT("{\n\"reason\": \"%s\",\n\"frames\": [\n"), *Reason);
+
+        for (int32 Index = 0; Index < Frames.Num(); ++Index)
+        {
+            const FFrame& Frame = Frames[Index];
+            Json.Appendf(TEXT("  {\"t\": %.4f, \"frame\": %llu, \"ms\": %.3f"),
+                Frame.StartSeconds - BaseSeconds, Frame.Frame, Frame.FrameMs);
+
+            for (int32 Phase = 0; Phase < static_cast<int32>(ESTFlightPhase::Num); ++Phase)
+            {
+                if (Frame.PhaseMs[Phase] > 0.f)
+                {
+                    Json.Appendf(TEXT(", \"%s\": %.3f"), LexToString(static_cast<ESTFlightPhase>(Phase)), Frame.PhaseMs[Phase]);
+                }
+            }
+            Json.Append(Index + 1 < Frames.Num() ? TEXT("},\n") : TEXT("}\n"));
+        }
+
+        Json.Append(TEXT("],\n\"events\": [\n"));
+
+        for (int32 Index = 0; Index < Events.Num(); ++Index)
+        {
+            const FEvent& Event = Events[Index];
+            Json.Appendf(TEXT("  {\"t\": %.4f, \"frame\": %llu, \"type\": \"%s\", \"id\": %d, \"value\": %g}%s\n"),
+                Event.Seconds - BaseSeconds, Event.Frame, LexToString(Event.Type), Event.Id, Event.Value,
+                Index + 1 < Events.Num() ? TEXT(",") : TEXT(""));
+        }
+
+        Json.Append(TEXT("]\n}\n"));
+
+        if (FFileHelper::SaveStringToFile(Json.ToView(), *Path))
+        {
+            UE_LOG(LogTemp, Warning, TEXT("FlightRecorder: %s -> %s"), *Reason, *Path);
+        }
+        else
+        {
+            UE_LOG(LogTemp, Warning, TEXT("FlightRecorder: could not write %s"), *Path);
+        }
+    }
+
+    FString Dump(double Seconds, const TCHAR* Reason)
+    {
+        const double Now = FPlatformTime::Seconds();
+        const double Since = Now - Seconds;
+
+        TArray<FEvent> Events;
+        TArray<FFrame> Frames;
+        CopyEvents(Since, Events);
+        CopyFrames(Since, Frames);
+
+        FString Path = FPaths::ProjectSavedDir() / TEXT("ActionTD") / TEXT("Hitches")
+            / FString::Printf(TEXT("Hitch_%s_%llu.json"), *FDateTime::Now().ToString(), GFrameCounter);
+
+        // Formatting and disk I/O off the game thread: the dump must not add to the hitch
+        UE::Tasks::Launch(UE_SOURCE_LOCATION,
+            [Events = MoveTemp(Events), Frames = MoveTemp(Frames), Since, Reason = FString(Reason), Path]()
+            {
+                Write(Events, Frames, Since, Reason, Path);
+            });
+
+        return Path;
+    }
+
+    // ========================================================
+    // Frames / hitches / GC
+    // ========================================================
+
+    static void HandleBeginFrame()
+    {
+        const double Now = FPlatformTime::Seconds();
+
+        if (GFrameStartSeconds > 0.0)
+        {
+            FFrame& Frame = GFrames[GNumFrames & (FrameCapacity - 1)];
+            Frame.StartSeconds = GFrameStartSeconds;
+            Frame.Frame = GFrameCounter - 1;
+            Frame.FrameMs = static_cast<float>((Now - GFrameStartSeconds) * 1000.0);
+
+            for (int32 Phase = 0; Phase < static_cast<int32>(ESTFlightPhase::Num); ++Phase)
+            {
+                Frame.PhaseMs[Phase] = static_cast<float>(FPlatformTime::ToMilliseconds64(GPhaseCycles[Phase]));
+                GPhaseCycles[Phase] = 0;
+            }
+            ++GNumFrames;
+
+            const float BudgetMs = CVarSTHitchBudgetMs.GetValueOnGameThread();
+            if (BudgetMs > 0.f && Frame.FrameMs > BudgetMs
+                && Now - GLastDumpSeconds >= CVarSTHitchDumpCooldown.GetValueOnGameThread())
+            {
+                GLastDumpSeconds = Now;
+                Record(ESTFlightEvent::Hitch, INDEX_NONE, Frame.FrameMs);
+                Dump(CVarSTHitchDumpSeconds.GetValueOnGameThread(),
+                    *FString::Printf(TEXT("Hitch: frame %llu took %.1f ms (budget %.1f ms)"), Frame.Frame, Frame.FrameMs, BudgetMs));
+            }
+        }
+
+        GFrameStartSeconds = Now;
+    }
+
+    static void HandlePreGarbageCollect()
+    {
+        GGCStartSeconds = FPlatformTime::Seconds();
+    }
+
+    static void HandlePostGarbageCollect()
+    {
+        Record(ESTFlightEvent::GarbageCollect, INDEX_NONE,
+            static_cast<float>((FPlatformTime::Seconds() - GGCStartSeconds) * 1000.0));
+    }
+
+    static FDelayedAutoRegisterHelper GRegisterDelegates(EDelayedRegisterRunPhase::EndOfEngineInit, []()
+        {
+            FCoreDelegates::OnBeginFrame.AddStatic(&HandleBeginFrame);
+            FCoreUObjectDelegates::GetPreGarbageCollectDelegate().AddStatic(&HandlePreGarbageCollect);
+            FCoreUObjectDelegates::GetPostGarbageCollect().AddStatic(&HandlePostGarbageCollect);
+        });
+}
+
+// ========================================================
+// Console
+// ========================================================
+
+#if !UE_BUILD_SHIPPING
+
+static FAutoConsoleCommand GSTFlightDumpCommand(
+    TEXT("ActionTD.FlightDump"),
+    TEXT("Write the flight recorder's last [Seconds=ActionTD.HitchDumpSeconds] of events and frame timings to Saved/ActionTD/Hitches."),
+    FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+        {
+            const double Seconds = Args.Num() > 0 ? FCString::Atod(*Args[0]) : CVarSTHitchDumpSeconds.GetValueOnGameThread();
+            STFlightRecorder::Dump(Seconds, TEXT("Manual dump"));
+        }));
+
+#endif // !UE_BUILD_SHIPPING
+
+#endif // ST_FLIGHT_RECORDER_ENABLED
@@ -0,0 +1,105 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+// ========================================================
+// Gameplay flight recorder / hitch detector
+// ========================================================
+//
+// Always on, in every build configuration, and allocation-free:
+//
+// - ST_FLIGHT_EVENT(Type, Id, Value) copies one fixed-size event into a lock-free
+//   ring (any thread): spawns, kills, leaks, projectile shots and pool growth,
+//   speed changes, capture completions, wave starts, GC runs
+// - ST_SCOPE_TIMER scopes (STStatGroup.h) also add their time to the current
+//   frame's per-phase totals (game thread)
+// - at the start of every engine frame the previous frame is closed: its wall
+//   time and phase totals go into a second ring
+//
+// When a frame takes longer than ActionTD.HitchBudgetMs, the events and frame
+// timings of the last ActionTD.HitchDumpSeconds are copied out and written on a
+// background task to Saved/ActionTD/Hitches/Hitch_<time>_<frame>.json, at most
+// once per ActionTD.HitchDumpCooldown seconds. ActionTD.FlightDump writes one on
+// demand (development builds).
+//
+// Define ST_FLIGHT_RECORDER_ENABLED=0 (e.g. from the target) to compile it out.
+
+#ifndef ST_FLIGHT_RECORDER_ENABLED
+#define ST_FLIGHT_RECORDER_ENABLED 1
+#endif
+
+enum class ESTFlightEvent : uint8
+{
+    WaveStart,       // Id = wave index, Value = total waves
+    Spawn,           // Id = wave index, Value = lane index
+    Kill,            // Id = enemy sim id
+    Leak,            // Id = enemy sim id
+    ProjectileShot,  // Id = pool bucket, Value = projectiles active after it (rewind restores too)
+    PoolGrow,        // Id = pool bucket: a projectile actor had to be spawned
+    SpeedChange,     // Value = new speed
+    Capture,         // Id = capturing tower sim id, Value = capture seconds
+    GarbageCollect,  // Value = milliseconds
+    Hitch,           // Value = frame milliseconds
+    CosmeticLevel,   // Value = new USTCosmeticGovernor level
+};
+
+/** Phases timed per frame; same names as the ST_SCOPE_TIMER stats. */
+enum class ESTFlightPhase : uint8
+{
+    ClockFrame,
+    StepSpawners,
+    StepEnemies,
+    StepTowers,
+    StepProjectiles,
+    ScheduledEvents,
+    RewindRecord,
+    RewindRestore,
+    Seek,
+    ProjectilePresentation,
+    RemovalBatch,
+    HUDTick,
+
+    Num
+};
+
+#if ST_FLIGHT_RECORDER_ENABLED
+
+namespace STFlightRecorder
+{
+    /** Events kept (power of two). */
+    constexpr int32 EventCapacity = 16384;
+
+    /** Frames kept (power of two): ~8 s at 240 fps. */
+    constexpr int32 FrameCapacity = 2048;
+
+    ACTIONTOWERDEFENSE_API void Record(ESTFlightEvent Type, int32 Id = INDEX_NONE, float Value = 0.f);
+
+    /** Write the last Seconds of events and frames now. Returns the file path. */
+    ACTIONTOWERDEFENSE_API FString Dump(double Seconds, const TCHAR* Reason);
+
+    /** Adds its lifetime to the current frame's total for Phase (game thread only). */
+    struct ACTIONTOWERDEFENSE_API FPhaseScope
+    {
+        explicit FPhaseScope(ESTFlightPhase InPhase)
+            : Phase(InPhase), StartCycles(FPlatformTime::Cycles64())
+        {
+        }
+
+        ~FPhaseScope();
+
+        ESTFlightPhase Phase;
+        uint64 StartCycles;
+    };
+}
+
+#define ST_FLIGHT_EVENT(Type, ...) STFlightRecorder::Record(ESTFlightEvent::Type, ##__VA_ARGS__)
+#define ST_FLIGHT_PHASE(Name) STFlightRecorder::FPhaseScope PREPROCESSOR_JOIN(FlightPhase_, Name)(ESTFlightPhase::Name)
+
+#else
+
+#define ST_FLIGHT_EVENT(Type, ...)
+#define ST_FLIGHT_PHASE(Name)
+
+#endif // ST_FLIGHT_RECORDER_ENABLED
@@ -7,10 +7,19 @@
 #include "STGameController.h"
 #include "STGameState.h"
 #include "STSpawner.h"
-#include "EngineUtils.h"
 #include "USTEndGameWidget.h"
 #include "Blueprint/UserWidget.h"
 #include "STEnemyLifeComponent.h"
+#include "STSimulationClock.h"
+#include "STRewindHistory.h"
+#include "STWorldRegistry.h"
+#include "STMatchStats.h"
+#include "STTrace.h"
+#include "STStatGroup.h"
+#include "STPerfCapture.h"
+#include "STMemoryTags.h"
+#include "STCoreRules.h"
+#include "STMatchRecorder.h"
 
 ASTGameController::ASTGameController()
 {
@@ -21,6 +30,12 @@ void ASTGameController::BeginPlay()
 {
     Super::BeginPlay();
 
+    USTWorldRegistrySubsystem* Registry = USTWorldRegistrySubsystem::Get(this);
+    if (Registry)
+    {
+        Registry->RegisterGameController(this);
+    }
+
     // Cache GameState
     if (UWorld* World = GetWorld())
     {
@@ -43,39 +58,76 @@ void ASTGameController::BeginPlay()
     bPlayerWon = false;
     NumEnemiesAlive = 0;
 
-    if (!SpawnerRef)
+    if (!SpawnerRef && Registry)
     {
-        if (UWorld* World = GetWorld())
-        {
-            for (TActorIterator<ASTSpawner> It(World); It; ++It)
-            {
-                SpawnerRef = *It;
-                break; // use the first one found
-            }
-        }
+        SpawnerRef = Registry->GetPrimarySpawner(); // first one registered
     }
 
-    // Bind to spawner events if we have a reference
     if (SpawnerRef)
     {
-        UE_LOG(LogTemp, Log, TEXT("GC: Binding to spawner %s"), *SpawnerRef->GetName());
+        BindToSpawner();
+    }
+    else if (Registry)
+    {
+        // Spawner has not begun play yet: bind when it registers
+        SpawnerRegisteredHandle = Registry->OnSpawnerRegistered.AddUObject(
+            this, &ASTGameController::HandleSpawnerRegistered);
+    }
+    else
+    {
+        UE_LOG(LogTemp, Warning, TEXT("GC: No SpawnerRef found in BeginPlay!"));
+    }
 
-        SpawnerRef->OnWaveStarted.AddDynamic(
-            this, &ASTGameController::HandleWaveStarted);
+    // Initial HUD values
+    if (STGameStateRef)
+    {
+        STGameStateRef->CurrentSpeed = CurrentSpeed;
+    }
 
-        SpawnerRef->OnNextWaveScheduled.AddDynamic(
-            this, &ASTGameController::HandleNextWaveScheduled);
+    if (USTSimulationClock* Clock = USTSimulationClock::Get(this))
+    {
+        Clock->SetGameSpeed(CurrentSpeed);
+    }
 
-        SpawnerRef->OnEnemySpawned.AddDynamic(
-            this, &ASTGameController::HandleEnemySpawned);
+    if (USTRewindHistory* History = USTRewindHistory::Get(this))
+    {
+        History->SetBudget(RewindHistorySeconds, static_cast<int64>(RewindMemoryBudgetMB) * 1024 * 1024);
+        History->SetMatchKeyframeSeconds(SeekKeyframeSeconds);
     }
-    else
+}
+
+void ASTGameController::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+    if (USTWorldRegistrySubsystem* Registry = USTWorldRegistrySubsystem::Get(this))
     {
-        UE_LOG(LogTemp, Warning, TEXT("GC: No SpawnerRef found in BeginPlay!"));
+        Registry->OnSpawnerRegistered.Remove(SpawnerRegisteredHandle);
+        Registry->UnregisterGameController(this);
     }
+    SpawnerRegisteredHandle.Reset();
+
+    Super::EndPlay(EndPlayReason);
+}
+
+void ASTGameController::BindToSpawner()
+{
+    if (!SpawnerRef)
+    {
+        return;
+    }
+
+    UE_LOG(LogTemp, Log, TEXT("GC: Binding to spawner %s"), *SpawnerRef->GetName());
+
+    SpawnerRef->OnWaveStarted.AddUniqueDynamic(
+        this, &ASTGameController::HandleWaveStarted);
+
+    SpawnerRef->OnNextWaveScheduled.AddUniqueDynamic(
+        this, &ASTGameController::HandleNextWaveScheduled);
+
+    SpawnerRef->OnEnemySpawned.AddUniqueDynamic(
+        this, &ASTGameController::HandleEnemySpawned);
 
     // Initial HUD values
-    if (SpawnerRef && STGameStateRef)
+    if (STGameStateRef)
     {
         const int32 NumWaves = SpawnerRef->GetNumWaves();
         if (NumWaves > 0)
@@ -88,15 +140,39 @@ void ASTGameController::BeginPlay()
         {
             STGameStateRef->TimeToNextWave = InitialDelay;
         }
+    }
+}
 
-        STGameStateRef->CurrentSpeed = CurrentSpeed;
+void ASTGameController::HandleSpawnerRegistered(ASTSpawner* Spawner)
+{
+    if (SpawnerRef || !Spawner)
+    {
+        return;
     }
+
+    SpawnerRef = Spawner;
+    BindToSpawner();
+
+    if (USTWorldRegistrySubsystem* Registry = USTWorldRegistrySubsystem::Get(this))
+    {
+        Registry->OnSpawnerRegistered.Remove(SpawnerRegisteredHandle);
+    }
+    SpawnerRegisteredHandle.Reset();
 }
 
 void ASTGameController::Tick(float DeltaSeconds)
 {
     Super::Tick(DeltaSeconds);
 
+    // Replayed commands for this half of the frame run before we look at anything
+    if (USTMatchRecorder* Recorder = USTMatchRecorder::Get(this))
+    {
+        Recorder->NotifyControllerTick();
+    }
+
+    // Removals from this frame's substeps (the clock steps before any actor ticks)
+    ProcessEnemyRemovals();
+
     if (STGameStateRef && SpawnerRef)
     {
         STGameStateRef->TimeToNextWave = SpawnerRef->GetTimeUntilNextWave();
@@ -109,12 +185,19 @@ void ASTGameController::Tick(float DeltaSeconds)
 
     if (bIsReversing)
     {
-        CurrentReverseMeter -= ReverseDrainPerSecond * DeltaSeconds;
+        if (STCore::DrainMeter(CurrentReverseMeter, ReverseDrainPerSecond, DeltaSeconds))
+        {
+            EndReverse(); // auto-stop
+        }
+    }
 
-        if (CurrentReverseMeter <= 0.f)
+    // Ran out of recorded history: nothing left to rewind into
+    if (bIsReversing)
+    {
+        const USTRewindHistory* History = USTRewindHistory::Get(this);
+        if (!History || !History->CanRewind())
         {
-            CurrentReverseMeter = 0.f;
-            StopReverse(); // auto-stop
+            EndReverse();
         }
     }
 
@@ -128,22 +211,18 @@ ASTGameController* ASTGameController::Get(const UObject* WorldContextObject)
         return nullptr;
     }
 
-    UWorld* World = WorldContextObject->GetWorld();
-    if (!World)
-    {
-        return nullptr;
-    }
-
-    for (TActorIterator<ASTGameController> It(World); It; ++It)
-    {
-        return *It; // assume only one
-    }
-
-    return nullptr;
+    // Registered in BeginPlay (only one per world)
+    const USTWorldRegistrySubsystem* Registry = USTWorldRegistrySubsystem::Get(WorldContextObject);
+    return Registry ? Registry->GetGameController() : nullptr;
 }
 
 void ASTGameController::SetSpeedMode(EGameSpeedMode NewMode)
 {
+    if (!USTMatchRecorder::ShouldRunCommand(this, ESTPlayerCommand::SetSpeedMode, nullptr, static_cast<int32>(NewMode)))
+    {
+        return;
+    }
+
     if (bIsGameOver)
     {
         return;
@@ -151,15 +230,28 @@ void ASTGameController::SetSpeedMode(EGameSpeedMode NewMode)
 
     SpeedMode = NewMode;
 
+    float NewSpeed = 1.f;
+
     switch (SpeedMode)
     {
-    case EGameSpeedMode::Reverse:  CurrentSpeed = -3.f; break;
-    case EGameSpeedMode::Normal:   CurrentSpeed = 1.f; break;
-    case EGameSpeedMode::Fast:     CurrentSpeed = 3.f; break;
-    case EGameSpeedMode::VeryFast: CurrentSpeed = 5.f; break;
-    default:                       CurrentSpeed = 1.f; break;
+    case EGameSpeedMode::Reverse:  NewSpeed = -3.f; break;
+    case EGameSpeedMode::Normal:   NewSpeed = 1.f; break;
+    case EGameSpeedMode::Fast:     NewSpeed = 3.f; break;
+    case EGameSpeedMode::VeryFast: NewSpeed = 5.f; break;
+    case EGameSpeedMode::Ultra20:  NewSpeed = 20.f; break;
+    case EGameSpeedMode::Ultra50:  NewSpeed = 50.f; break;
+    case EGameSpeedMode::Unlimited: NewSpeed = USTSimulationClock::UnlimitedSpeed; break;
+    default:                       NewSpeed = 1.f; break;
     }
 
+    ApplyCurrentSpeed(NewSpeed);
+}
+
+void ASTGameController::ApplyCurrentSpeed(float NewSpeed)
+{
+    const float OldSpeed = CurrentSpeed;
+    CurrentSpeed = NewSpeed;
+
     // Mirror to GameState for HUD
     if (!STGameStateRef)
     {
@@ -173,10 +265,26 @@ void ASTGameController::SetSpeedMode(EGameSpeedMode NewMode)
     {
         STGameStateRef->CurrentSpeed = CurrentSpeed;
     }
+
+    // Clock latches the new speed at the start of the next frame
+    if (USTSimulationClock* Clock = USTSimulationClock::Get(this))
+    {
+        Clock->SetGameSpeed(CurrentSpeed);
+    }
+
+    if (OldSpeed != NewSpeed)
+    {
+        ST_TRACE_SPEED_CHANGE(OldSpeed, NewSpeed);
+        ST_FLIGHT_EVENT(SpeedChange, INDEX_NONE, NewSpeed);
+        OnGameSpeedChanged.Broadcast(NewSpeed, OldSpeed);
+    }
 }
 
 void ASTGameController::StartReverse()
 {
+    if (!USTMatchRecorder::ShouldRunCommand(this, ESTPlayerCommand::StartReverse))
+        return;
+
     if (bIsGameOver)
         return;
 
@@ -191,55 +299,49 @@ void ASTGameController::StartReverse()
     // store what we return to afterwards
     PreviousNonReverseSpeed = CurrentSpeed;
 
-    CurrentSpeed = ReverseSpeed;
-
-    // Mirror to GameState
-    if (STGameStateRef)
-    {
-        STGameStateRef->CurrentSpeed = CurrentSpeed;
-    }
+    ApplyCurrentSpeed(ReverseSpeed);
 }
 
 void ASTGameController::StopReverse()
+{
+    if (!USTMatchRecorder::ShouldRunCommand(this, ESTPlayerCommand::StopReverse))
+        return;
+
+    EndReverse();
+}
+
+void ASTGameController::EndReverse()
 {
     if (!bIsReversing)
         return;
 
     bIsReversing = false;
 
-    CurrentSpeed = PreviousNonReverseSpeed;
-
-    if (STGameStateRef)
-    {
-        STGameStateRef->CurrentSpeed = CurrentSpeed;
-    }
+    ApplyCurrentSpeed(PreviousNonReverseSpeed);
 }
 
 void ASTGameController::Command_SetGameSpeed(float NewSpeed)
 {
-    if (bIsGameOver)
-    {
-        return; // ignore UI input after game end
-    }
-    
-    CurrentSpeed = NewSpeed;
-
-    if (!STGameStateRef)
+    if (!USTMatchRecorder::ShouldRunCommand(this, ESTPlayerCommand::SetGameSpeed, nullptr, INDEX_NONE, NewSpeed))
     {
-        if (UWorld* World = GetWorld())
-        {
-            STGameStateRef = World->GetGameState<ASTGameState>();
-        }
+        return;
     }
 
-    if (STGameStateRef)
+    if (bIsGameOver)
     {
-        STGameStateRef->CurrentSpeed = NewSpeed;
+        return; // ignore UI input after game end
     }
+    
+    ApplyCurrentSpeed(NewSpeed);
 }
 
 void ASTGameController::Command_RequestNextWave()
 {
+    if (!USTMatchRecorder::ShouldRunCommand(this, ESTPlayerCommand::RequestNextWave))
+    {
+        return;
+    }
+
     if (SpawnerRef)
     {
         SpawnerRef->RequestNextWaveNow();
@@ -262,6 +364,19 @@ void ASTGameController::HandleWaveStarted(int32 WaveIndex, int32 TotalWaves)
         STGameStateRef->TotalWaves = TotalWaves;
         STGameStateRef->TimeToNextWave = 0.f;
     }
+
+    // Seek target for "start of wave N"
+    if (USTRewindHistory* History = USTRewindHistory::Get(this))
+    {
+        History->MarkWaveStart(WaveIndex);
+    }
+
+    // The previous wave is over: export its stats in the background
+    const USTSimulationClock* Clock = USTSimulationClock::Get(this);
+    if (USTMatchStats* Stats = USTMatchStats::Get(this); Stats && !(Clock && Clock->IsReplaying()))
+    {
+        Stats->NotifyWaveEnded();
+    }
 }
 
 void ASTGameController::HandleNextWaveScheduled(float TimeUntilNextWave)
@@ -280,6 +395,89 @@ void ASTGameController::HandleNextWaveScheduled(float TimeUntilNextWave)
     }
 }
 
+// ========================================================
+// Timeline seeking
+// ========================================================
+
+bool ASTGameController::SeekToSimStep(uint64 TargetStep)
+{
+    if (bIsGameOver)
+    {
+        return false;
+    }
+
+    USTSimulationClock* Clock = USTSimulationClock::Get(this);
+    if (!Clock)
+    {
+        return false;
+    }
+
+    if (bIsReversing)
+    {
+        EndReverse();
+    }
+
+    // Only what has been played can be replayed
+    if (!Clock->SeekToStep(FMath::Min(TargetStep, Clock->GetSimStepNumber())))
+    {
+        return false;
+    }
+
+    ProcessEnemyRemovals();
+
+    if (STGameStateRef && SpawnerRef)
+    {
+        STGameStateRef->TimeToNextWave = SpawnerRef->GetTimeUntilNextWave();
+    }
+
+    SyncScoreToGameState();
+    return true;
+}
+
+bool ASTGameController::SeekToGameTime(float TargetGameTime)
+{
+    if (!USTMatchRecorder::ShouldRunCommand(this, ESTPlayerCommand::SeekToGameTime, nullptr, INDEX_NONE, TargetGameTime))
+    {
+        return false;
+    }
+
+    const USTRewindHistory* History = USTRewindHistory::Get(this);
+    if (!History)
+    {
+        return false;
+    }
+
+    return SeekToSimStep(History->GetStepForGameTime(TargetGameTime));
+}
+
+bool ASTGameController::SeekToWaveStart(int32 WaveIndex)
+{
+    if (!USTMatchRecorder::ShouldRunCommand(this, ESTPlayerCommand::SeekToWaveStart, nullptr, WaveIndex))
+    {
+        return false;
+    }
+
+    const USTRewindHistory* History = USTRewindHistory::Get(this);
+
+    uint64 WaveStartStep = 0;
+    if (!History || !History->FindWaveStartStep(WaveIndex, WaveStartStep))
+    {
+        return false;
+    }
+
+    return SeekToSimStep(WaveStartStep);
+}
+
+void ASTGameController::GetTimelineRange(float& OutStartTime, float& OutEndTime) const
+{
+    const USTRewindHistory* History = USTRewindHistory::Get(this);
+    const USTSimulationClock* Clock = USTSimulationClock::Get(this);
+
+    OutStartTime = History ? static_cast<float>(History->GetTimelineStartTime()) : 0.f;
+    OutEndTime = Clock ? static_cast<float>(Clock->GetGameTime()) : 0.f;
+    OutEndTime = FMath::Max(OutStartTime, OutEndTime);
+}
+
 void ASTGameController::ApplyReverseScoreCost(float DeltaSeconds)
 {
     if (CurrentSpeed >= 0.f)
@@ -295,6 +493,7 @@ void ASTGameController::ApplyReverseScoreCost(float DeltaSeconds)
     const float SpeedMagnitude = FMath::Abs(CurrentSpeed); // -3 -> 3
     const float Drain = ReverseScoreCostPerSecond * SpeedMagnitude * DeltaSeconds;
 
+    ReverseScorePaid += Drain;
     AddRawScore(-Drain);
 }
 
@@ -334,92 +533,135 @@ void ASTGameController::AddRawScore(float ScoreDelta)
     */
 }
 
-void ASTGameController::AwardScoreForEnemy(float BaseEnemyScore)
+void ASTGameController::RestoreRewoundState(float GrossScore, int32 Lives, int32 InNumEnemiesAlive)
 {
-    if (BaseEnemyScore <= 0.f)
+    ScoreInternal = GrossScore - ReverseScorePaid;
+    NumEnemiesAlive = FMath::Max(0, InNumEnemiesAlive);
+
+    // Queued removals belong to the timeline being replaced (the snapshot counted its own)
+    PendingRemovals = FSTEnemyRemovalBatch();
+
+    if (STGameStateRef)
     {
-        return;
+        STGameStateRef->Lives = Lives;
+
+        if (SpawnerRef)
+        {
+            STGameStateRef->CurrentWaveIndex = SpawnerRef->GetCurrentWaveIndex();
+        }
     }
 
-    // Rule: no score when rewinding or paused
-    if (CurrentSpeed <= 0.f)
+    SyncScoreToGameState();
+}
+
+void ASTGameController::GetSimCounters(float& OutGrossScore, int32& OutLives, int32& OutNumEnemiesAlive) const
+{
+    OutGrossScore = GetGrossScore() + PendingRemovals.Score;
+    OutNumEnemiesAlive = FMath::Max(0, NumEnemiesAlive - PendingRemovals.NumKilled - PendingRemovals.NumLeaked);
+    OutLives = STGameStateRef
+        ? (bIsGameOver ? STGameStateRef->Lives : FMath::Max(0, STGameStateRef->Lives - PendingRemovals.NumLeaked))
+        : 0;
+}
+
+bool ASTGameController::ComputeKillScore(float BaseEnemyScore, float& OutScore, bool& bOutRefillsMeter) const
+{
+    bOutRefillsMeter = false;
+
+    // Seek replays score at the speed the step originally ran at
+    const USTSimulationClock* Clock = USTSimulationClock::Get(this);
+    const bool bReplaying = Clock && Clock->IsReplaying();
+
+    if (!STCore::ComputeKillScore(BaseEnemyScore, bReplaying ? Clock->GetGameSpeed() : CurrentSpeed, MaxScoreSpeedFactor, OutScore))
     {
-        return;
+        return false;
     }
 
-    // Speed-based multiplier: 1x / 3x / 5x etc.
-    const float SpeedFactor = CurrentSpeed;
-    const float ScoreToAdd = BaseEnemyScore * SpeedFactor;
+    // The meter is not part of the timeline: replayed kills do not refill it
+    bOutRefillsMeter = !bReplaying;
+    return true;
+}
+
+void ASTGameController::AwardScoreForEnemy(float BaseEnemyScore)
+{
+    float ScoreToAdd = 0.f;
+    bool bRefillsMeter = false;
+    if (!ComputeKillScore(BaseEnemyScore, ScoreToAdd, bRefillsMeter))
+    {
+        return;
+    }
 
     AddRawScore(ScoreToAdd);
 
-    CurrentReverseMeter = FMath::Clamp(
-        CurrentReverseMeter + ReverseGainPerKill,
-        0.f,
-        MaxReverseMeter
-    );
+    if (bRefillsMeter)
+    {
+        CurrentReverseMeter = STCore::AddMeterKills(CurrentReverseMeter, ReverseGainPerKill, 1, MaxReverseMeter);
+    }
 }
 
 void ASTGameController::NotifyEnemySpawned()
 {
-    UE_LOG(LogTemp, Warning, TEXT("NotifyEnemySpawned() CALLED"));
-
     if (bIsGameOver)
     {
         return;
     }
 
+    // Live count is on "stat ActionTD"
     ++NumEnemiesAlive;
-
-    GEngine->AddOnScreenDebugMessage(
-            -1,                     // Key (-1 = create new line each time)
-            5.0f,                   // Display time in seconds
-            FColor::Yellow,         // Text color
-            FString::Printf(TEXT("Number of Enemies: %d"), NumEnemiesAlive) // Message
-        );
 }
 
-void ASTGameController::NotifyEnemyRemoved(bool bReachedGoal)
+void ASTGameController::NotifyEnemyRemoved(bool bReachedGoal, float BaseEnemyScore)
 {
-    if (NumEnemiesAlive > 0)
+    if (bReachedGoal)
     {
-        --NumEnemiesAlive;
+        // leaked through to the end: no score
+        ++PendingRemovals.NumLeaked;
+        return;
     }
 
-    if (bReachedGoal)
+    ++PendingRemovals.NumKilled;
+
+    // Scored now: the speed (or the replayed step's speed) may differ by the time the batch is processed
+    float Score = 0.f;
+    bool bRefillsMeter = false;
+    if (ComputeKillScore(BaseEnemyScore, Score, bRefillsMeter))
     {
-        LoseLife(1);
+        PendingRemovals.Score += Score;
+        PendingRemovals.NumMeterKills += bRefillsMeter ? 1 : 0;
     }
+}
 
-    // Life loss may have just ended the game
-    if (bIsGameOver)
+void ASTGameController::ProcessEnemyRemovals()
+{
+    ST_SCOPE_TIMER(RemovalBatch);
+
+    if (PendingRemovals.IsEmpty())
     {
         return;
     }
 
-    // Victory check: no more waves AND no enemies alive
-    if (!SpawnerRef || !STGameStateRef)
+    const FSTEnemyRemovalBatch Batch = PendingRemovals;
+    PendingRemovals = FSTEnemyRemovalBatch();
+
+    NumEnemiesAlive = FMath::Max(0, NumEnemiesAlive - Batch.NumKilled - Batch.NumLeaked);
+
+    AddRawScore(Batch.Score);
+
+    if (Batch.NumMeterKills > 0)
     {
-        return;
+        CurrentReverseMeter = STCore::AddMeterKills(CurrentReverseMeter, ReverseGainPerKill, Batch.NumMeterKills, MaxReverseMeter);
     }
 
-    const bool bWaveRunning = SpawnerRef->IsWaveRunning();
-    const bool bHasMoreWaves = SpawnerRef->HasMoreWaves();
+    // May end the game (defeat)
+    LoseLife(Batch.NumLeaked);
 
-    const bool bNoMoreWaves = !bWaveRunning && !bHasMoreWaves;
-    const bool bNoEnemiesLeft = (NumEnemiesAlive == 0);
-
-    if (bNoMoreWaves && NumEnemiesAlive == 0)
+    // Victory check: no more waves AND no enemies alive
+    if (!bIsGameOver && SpawnerRef && STGameStateRef && NumEnemiesAlive == 0
+        && !SpawnerRef->IsWaveRunning() && !SpawnerRef->HasMoreWaves())
     {
         HandleVictory();
     }
 
-    GEngine->AddOnScreenDebugMessage(
-        -1,                     // Key (-1 = create new line each time)
-        5.0f,                   // Display time in seconds
-        FColor::Yellow,         // Text color
-        FString::Printf(TEXT("Number of Enemies: %d"), NumEnemiesAlive) // Message
-    );
+    OnEnemyRemovalsProcessed.Broadcast(Batch.NumKilled, Batch.NumLeaked, Batch.Score);
 }
 
 void ASTGameController::LoseLife(int32 Amount)
@@ -448,14 +690,29 @@ void ASTGameController::HandleVictory()
     bPlayerWon = true;
 
     // Freeze time
-    CurrentSpeed = 0.f;
+    ApplyCurrentSpeed(0.f);
     if (STGameStateRef)
     {
-        STGameStateRef->CurrentSpeed = 0.f;
         STGameStateRef->bIsGameOver = true;
         STGameStateRef->bPlayerWon = true;
     }
 
+    // The last wave is over too
+    if (USTMatchStats* Stats = USTMatchStats::Get(this))
+    {
+        Stats->NotifyWaveEnded();
+    }
+
+    if (USTPerfCapture* PerfCapture = USTPerfCapture::Get(this))
+    {
+        PerfCapture->NotifyMatchEnded();
+    }
+
+    if (USTMatchRecorder* Recorder = USTMatchRecorder::Get(this))
+    {
+        Recorder->NotifyMatchEnded();
+    }
+
     ShowEndGameScreen(true);
 }
 
@@ -469,19 +726,36 @@ void ASTGameController::HandleDefeat()
     bIsGameOver = true;
     bPlayerWon = false;
 
-    CurrentSpeed = 0.f;
+    ApplyCurrentSpeed(0.f);
     if (STGameStateRef)
     {
-        STGameStateRef->CurrentSpeed = 0.f;
         STGameStateRef->bIsGameOver = true;
         STGameStateRef->bPlayerWon = false;
     }
 
+    // The last wave is over too
+    if (USTMatchStats* Stats = USTMatchStats::Get(this))
+    {
+        Stats->NotifyWaveEnded();
+    }
+
+    if (USTPerfCapture* PerfCapture = USTPerfCapture::Get(this))
+    {
+        PerfCapture->NotifyMatchEnded();
+    }
+
+    if (USTMatchRecorder* Recorder = USTMatchRecorder::Get(this))
+    {
+        Recorder->NotifyMatchEnded();
+    }
+
     ShowEndGameScreen(false);
 }
 
 void ASTGameController::ShowEndGameScreen(bool bInPlayerWon)
 {
+    ST_LLM_SCOPE(UI);
+
     if (EndGameWidgetInstance || !EndGameWidgetClass)
     {
         // Already shown, or no class set
@@ -538,39 +812,13 @@ void ASTGameController::ShowEndGameScreen(bool bInPlayerWon)
 
 void ASTGameController::HandleEnemySpawned(AActor* SpawnedEnemy)
 {
-    // Count this enemy
+    // Count this enemy; its USTEnemyLifeComponent reports the removal
     NotifyEnemySpawned();
 
-    if (!SpawnedEnemy)
-    {
-        return;
-    }
-
-    // Attach to this enemy's lifecycle component if present
-    if (USTEnemyLifeComponent* LifeComp = SpawnedEnemy->FindComponentByClass<USTEnemyLifeComponent>())
-    {
-        UE_LOG(LogTemp, Log,
-            TEXT("GC: Bound to enemy life component on %s"),
-            *SpawnedEnemy->GetName());
-
-        LifeComp->OnEnemyRemoved.AddDynamic(
-            this,
-            &ASTGameController::HandleEnemyRemoved);
-    }
-    else
+    if (SpawnedEnemy && !SpawnedEnemy->FindComponentByClass<USTEnemyLifeComponent>())
     {
         UE_LOG(LogTemp, Warning,
             TEXT("GC: Spawned enemy %s has NO STEnemyLifeComponent"),
             *SpawnedEnemy->GetName());
     }
 }
-
-void ASTGameController::HandleEnemyRemoved(AActor* EnemyActor, bool bReachedGoal)
-{
-    UE_LOG(LogTemp, Log,
-        TEXT("GC: HandleEnemyRemoved called for %s, ReachedGoal=%s"),
-        EnemyActor ? *EnemyActor->GetName() : TEXT("nullptr"),
-        bReachedGoal ? TEXT("true") : TEXT("false"));
-
-    NotifyEnemyRemoved(bReachedGoal);
-}
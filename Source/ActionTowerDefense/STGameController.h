@@ -17,6 +17,32 @@ enum class EGameSpeedMode : uint8
     Normal      UMETA(DisplayName = "1x"),
     Fast        UMETA(DisplayName = "3x"),
     VeryFast    UMETA(DisplayName = "5x"),
+
+    // Test / grinding modes: budgeted substeps, decimated rendering (see USTSimulationClock)
+    Ultra20     UMETA(DisplayName = "20x"),
+    Ultra50     UMETA(DisplayName = "50x"),
+    Unlimited   UMETA(DisplayName = "Max"),
+};
+
+// Fired once whenever CurrentSpeed actually changes (speed mode, reverse, pause on game over)
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnGameSpeedChanged, float, NewSpeed, float, OldSpeed);
+
+// Fired once per frame in which enemies were removed, after score / lives / victory were updated
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_ThreeParams(FOnEnemyRemovalsProcessed, int32, NumKilled, int32, NumLeaked, float, ScoreAwarded);
+
+/** Enemy removals queued since the last ProcessEnemyRemovals, as running totals. */
+struct FSTEnemyRemovalBatch
+{
+    int32 NumKilled = 0;
+    int32 NumLeaked = 0;
+
+    /** Kill score, already scaled by the speed each kill happened at. */
+    float Score = 0.f;
+
+    /** Kills that refill the reverse meter (replayed kills do not). */
+    int32 NumMeterKills = 0;
+
+    FORCEINLINE bool IsEmpty() const { return NumKilled == 0 && NumLeaked == 0; }
 };
 
 UCLASS()
@@ -29,6 +55,7 @@ public:
 
 protected:
     virtual void BeginPlay() override;
+    virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
     virtual void Tick(float DeltaSeconds) override;   // ← ADD THIS
 
     // NEW: handlers for spawner events
@@ -42,6 +69,14 @@ protected:
     UFUNCTION()
     void HandleEnemySpawned(AActor* SpawnedEnemy);
 
+    /** Subscribe to SpawnerRef's events and seed the HUD wave values from it. */
+    void BindToSpawner();
+
+    /** Registry callback when no spawner had begun play yet in our BeginPlay. */
+    void HandleSpawnerRegistered(ASTSpawner* Spawner);
+
+    FDelegateHandle SpawnerRegisteredHandle;
+
 public:
     UPROPERTY(BlueprintReadOnly, Category = "Refs")
     ASTGameState* STGameStateRef = nullptr;
@@ -81,6 +116,36 @@ public:
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Reverse")
     float ReverseGainPerKill = 5.f;
 
+    // ---- Rewind history (USTRewindHistory) ----
+
+    /** Game-seconds of snapshots kept for rewinding. */
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Reverse")
+    float RewindHistorySeconds = 30.f;
+
+    /** Hard memory cap for the snapshot ring buffer; the oldest frames go first. */
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Reverse", meta = (ClampMin = "1"))
+    int32 RewindMemoryBudgetMB = 32;
+
+    /** Game-seconds between whole-match keyframes; a seek re-simulates at most this much. */
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Timeline", meta = (ClampMin = "0.1"))
+    float SeekKeyframeSeconds = 5.f;
+
+    /**
+     * Jump back to TargetGameTime (clamped to what has been played): restores the
+     * nearest earlier keyframe and re-simulates the rest within this call.
+     * Whatever was played after the target is discarded.
+     */
+    UFUNCTION(BlueprintCallable, Category = "Timeline")
+    bool SeekToGameTime(float TargetGameTime);
+
+    /** Jump back to the most recent start of WaveIndex (0-based). */
+    UFUNCTION(BlueprintCallable, Category = "Timeline")
+    bool SeekToWaveStart(int32 WaveIndex);
+
+    /** Game-time range SeekToGameTime can reach (start of the match .. now). */
+    UFUNCTION(BlueprintPure, Category = "Timeline")
+    void GetTimelineRange(float& OutStartTime, float& OutEndTime) const;
+
     UFUNCTION(BlueprintCallable, Category = "Reverse")
     void StartReverse();
 
@@ -95,6 +160,14 @@ public:
     UFUNCTION(BlueprintPure, Category = "Game Speed")
     FORCEINLINE float GetGameSpeed() const { return CurrentSpeed; }
 
+    /** Fired when the speed changes; USTSimulationClock picks the new value up next frame. */
+    UPROPERTY(BlueprintAssignable, Category = "Game Speed")
+    FOnGameSpeedChanged OnGameSpeedChanged;
+
+    /** Summary of the removals processed this frame (one broadcast per frame, not per enemy). */
+    UPROPERTY(BlueprintAssignable, Category = "Game|Enemies")
+    FOnEnemyRemovalsProcessed OnEnemyRemovalsProcessed;
+
     // Convenience helper so other classes can find the controller
     static ASTGameController* Get(const UObject* WorldContextObject);
 
@@ -116,6 +189,10 @@ public:
     //      SCORE SYSTEM
     // ======================
 
+    /** Kill score multiplier cap: fast-forward test modes score like the fastest regular speed. */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Score")
+    float MaxScoreSpeedFactor = 5.f;
+
     /** How many score points we lose per second of rewind at 1x reverse speed.
      *  Actual drain = ReverseScoreCostPerSecond * |CurrentSpeed| * DeltaSeconds when speed < 0.
      */
@@ -136,6 +213,21 @@ public:
     UFUNCTION(BlueprintCallable, Category = "Score")
     void AddRawScore(float ScoreDelta);
 
+    /** Score before rewind costs. */
+    FORCEINLINE float GetGrossScore() const { return ScoreInternal + ReverseScorePaid; }
+
+    /**
+     * Gross score, lives and enemies alive including removals queued but not yet
+     * processed: the state as of the last substep, which is what rewind snapshots record.
+     */
+    void GetSimCounters(float& OutGrossScore, int32& OutLives, int32& OutNumEnemiesAlive) const;
+
+    /**
+     * Apply score / lives / enemy count from a rewind snapshot.
+     * Rewind costs already paid stay paid.
+     */
+    void RestoreRewoundState(float GrossScore, int32 Lives, int32 InNumEnemiesAlive);
+
     // ======================
     //      LIVES / STATE
     // ======================
@@ -159,12 +251,20 @@ public:
     UFUNCTION(BlueprintCallable, Category = "Game|Enemies")
     void NotifyEnemySpawned();
 
-    // Called whenever an enemy is removed from play
-    // bReachedGoal = true if it leaked through to the end
+    // Called whenever an enemy is removed from play (USTEnemyLifeComponent does this)
+    // bReachedGoal = true if it leaked through to the end; BaseEnemyScore is awarded for kills.
+    // Only queued: ProcessEnemyRemovals applies the frame's removals in one pass.
     UFUNCTION(BlueprintCallable, Category = "Game|Enemies")
-    void NotifyEnemyRemoved(bool bReachedGoal);
+    void NotifyEnemyRemoved(bool bReachedGoal, float BaseEnemyScore = 0.f);
+
+    /**
+     * Apply the queued removals (enemy count, score, reverse meter, lives), check for
+     * victory / defeat once and broadcast OnEnemyRemovalsProcessed. Runs from Tick
+     * and after seeks.
+     */
+    void ProcessEnemyRemovals();
 
-    // Explicit life loss; in practice only used from NotifyEnemyRemoved
+    // Explicit life loss; in practice only used from ProcessEnemyRemovals
     UFUNCTION(BlueprintCallable, Category = "Game")
     void LoseLife(int32 Amount = 1);
 
@@ -182,13 +282,31 @@ public:
     UPROPERTY()
     USTEndGameWidget* EndGameWidgetInstance = nullptr;
 
-    UFUNCTION()
-    void HandleEnemyRemoved(AActor* EnemyActor, bool bReachedGoal);
-
 protected:
+    /**
+     * Score for killing an enemy worth BaseEnemyScore at the current speed (the logged
+     * speed during seek replays). False if the kill scores nothing (reverse / paused).
+     */
+    bool ComputeKillScore(float BaseEnemyScore, float& OutScore, bool& bOutRefillsMeter) const;
+
+    /** Removals since the last ProcessEnemyRemovals. */
+    FSTEnemyRemovalBatch PendingRemovals;
+
+    /** Single place that writes CurrentSpeed: mirrors to GameState and broadcasts OnGameSpeedChanged. */
+    void ApplyCurrentSpeed(float NewSpeed);
+
     /** Internal helper to apply rewind score cost every tick. */
     void ApplyReverseScoreCost(float DeltaSeconds);
 
+    /** Shared by the Seek* functions. */
+    bool SeekToSimStep(uint64 TargetStep);
+
+    /** StopReverse without the player command (auto-stop, seeks). */
+    void EndReverse();
+
+    /** Total score spent on rewinding (survives rewind restores). */
+    float ReverseScorePaid = 0.f;
+
     /** Internal helper to push ScoreInternal -> GameState->Score. */
     void SyncScoreToGameState();
 
@@ -0,0 +1,179 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "STGameEventScheduler.h"
+#include "Engine/World.h"
+#include "Algo/Sort.h"
+#include "DamageableTarget.h"
+#include "STMatchStats.h"
+#include "TowerBase.h"
+
+void USTGameEventScheduler::Deinitialize()
+{
+    PendingEvents.Reset();
+
+    Super::Deinitialize();
+}
+
+bool USTGameEventScheduler::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+    return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+USTGameEventScheduler* USTGameEventScheduler::Get(const UObject* WorldContextObject)
+{
+    if (!WorldContextObject)
+    {
+        return nullptr;
+    }
+
+    UWorld* World = WorldContextObject->GetWorld();
+    if (!World)
+    {
+        return nullptr;
+    }
+
+    return World->GetSubsystem<USTGameEventScheduler>();
+}
+
+int32 USTGameEventScheduler::ScheduleEvent(float GameDelay, const UObject* BoundObject, TFunction<void()> OnFire,
+    TFunction<void()> OnRewound, float AlreadyElapsed)
+{
+    FSTScheduledGameEvent& Event = PendingEvents.AddDefaulted_GetRef();
+    Event.Id = NextEventId++;
+    Event.Delay = FMath::Max(GameDelay, 0.f);
+    Event.Elapsed = FMath::Max(AlreadyElapsed, 0.f);
+    Event.BoundObject = BoundObject;
+    Event.OnFire = MoveTemp(OnFire);
+    Event.OnRewound = MoveTemp(OnRewound);
+
+    return Event.Id;
+}
+
+int32 USTGameEventScheduler::ScheduleImpact(float GameDelay, AActor* Target, const ATowerBase* SourceTower, float Damage,
+    float AlreadyElapsed)
+{
+    // The event is bound to the target: if it dies first the event is released untouched
+    TWeakObjectPtr<AActor> WeakTarget = Target;
+    TWeakObjectPtr<const ATowerBase> WeakSource = SourceTower;
+
+    const int32 EventId = ScheduleEvent(GameDelay, Target,
+        [WeakTarget, WeakSource, Damage]()
+        {
+            if (AActor* HitActor = WeakTarget.Get())
+            {
+                USTMatchStats::FDamageSourceScope DamageSource(USTMatchStats::Get(HitActor), WeakSource.Get());
+                IDamageableTarget::Execute_ReceiveTowerDamage(HitActor, Damage);
+            }
+        },
+        nullptr, AlreadyElapsed);
+
+    FSTScheduledGameEvent& Event = PendingEvents.Last();
+    Event.bImpact = true;
+    Event.ImpactSource = SourceTower;
+    Event.ImpactDamage = Damage;
+
+    return EventId;
+}
+
+void USTGameEventScheduler::GetPendingImpacts(TArray<const FSTScheduledGameEvent*>& OutImpacts) const
+{
+    OutImpacts.Reset();
+    for (const FSTScheduledGameEvent& Event : PendingEvents)
+    {
+        if (Event.bImpact && Event.BoundObject.IsValid())
+        {
+            OutImpacts.Add(&Event);
+        }
+    }
+
+    // Swap-removal shuffles PendingEvents; ids are handed out in scheduling order
+    Algo::SortBy(OutImpacts, [](const FSTScheduledGameEvent* Event) { return Event->Id; });
+}
+
+void USTGameEventScheduler::GetPendingEvents(TArray<const FSTScheduledGameEvent*>& OutEvents) const
+{
+    OutEvents.Reset();
+    for (const FSTScheduledGameEvent& Event : PendingEvents)
+    {
+        if (Event.BoundObject.IsValid())
+        {
+            OutEvents.Add(&Event);
+        }
+    }
+
+    Algo::SortBy(OutEvents, [](const FSTScheduledGameEvent* Event) { return Event->Id; });
+}
+
+void USTGameEventScheduler::CancelAllImpacts()
+{
+    PendingEvents.RemoveAllSwap(
+        [](const FSTScheduledGameEvent& Event)
+        {
+            return Event.bImpact;
+        });
+}
+
+void USTGameEventScheduler::CancelEvent(int32 EventId)
+{
+    PendingEvents.RemoveAllSwap(
+        [EventId](const FSTScheduledGameEvent& Event)
+        {
+            return Event.Id == EventId;
+        });
+}
+
+void USTGameEventScheduler::AdvanceEvents(float StepSeconds)
+{
+    // Paused frames run no substeps, so nothing moves
+    if (PendingEvents.Num() == 0 || StepSeconds == 0.f)
+    {
+        return;
+    }
+
+    // Collect first, fire after: callbacks may schedule new events
+    TArray<TPair<int32, TFunction<void()>>, TInlineAllocator<16>> ReadyToFire;
+
+    for (int32 Index = PendingEvents.Num() - 1; Index >= 0; --Index)
+    {
+        FSTScheduledGameEvent& Event = PendingEvents[Index];
+
+        // Bound object died before impact: release without side effects
+        if (!Event.BoundObject.IsValid())
+        {
+            PendingEvents.RemoveAtSwap(Index, EAllowShrinking::No);
+            continue;
+        }
+
+        Event.Elapsed += StepSeconds;
+
+        // Rewound to before the event was scheduled
+        if (Event.Elapsed < 0.f)
+        {
+            if (Event.OnRewound)
+            {
+                ReadyToFire.Emplace(Event.Id, MoveTemp(Event.OnRewound));
+            }
+            PendingEvents.RemoveAtSwap(Index, EAllowShrinking::No);
+            continue;
+        }
+
+        if (Event.Elapsed >= Event.Delay)
+        {
+            ReadyToFire.Emplace(Event.Id, MoveTemp(Event.OnFire));
+            PendingEvents.RemoveAtSwap(Index, EAllowShrinking::No);
+        }
+    }
+
+    // Scheduling order, not array order: two impacts on one enemy must resolve
+    // the same way in a replay or after a rewind restore re-created them
+    Algo::SortBy(ReadyToFire, [](const TPair<int32, TFunction<void()>>& Ready) { return Ready.Key; });
+
+    for (TPair<int32, TFunction<void()>>& Ready : ReadyToFire)
+    {
+        if (Ready.Value)
+        {
+            Ready.Value();
+        }
+    }
+}
@@ -0,0 +1,99 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "STGameEventScheduler.generated.h"
+
+class AActor;
+class ATowerBase;
+
+/** One event waiting for game time to reach it. */
+struct FSTScheduledGameEvent
+{
+    int32 Id = INDEX_NONE;
+
+    /** Game-seconds between scheduling and firing. */
+    float Delay = 0.f;
+
+    /** Game-seconds elapsed since scheduling (goes down while rewinding). */
+    float Elapsed = 0.f;
+
+    /** Event is silently released once this object is gone (e.g. target died). */
+    TWeakObjectPtr<const UObject> BoundObject;
+
+    TFunction<void()> OnFire;
+
+    /** Optional: run when the event is rewound past its scheduling point. */
+    TFunction<void()> OnRewound;
+
+    /** Scheduled-impact shot (ScheduleImpact): BoundObject is the target. Rewind snapshots re-create these. */
+    bool bImpact = false;
+    TWeakObjectPtr<const ATowerBase> ImpactSource;
+    float ImpactDamage = 0.f;
+};
+
+/**
+ * Runs callbacks after a delay measured in *game* time:
+ *  - advanced by USTSimulationClock once per fixed substep (3x / 5x fire sooner)
+ *  - holds still while paused
+ *  - runs backwards while rewinding; an event rewound past its scheduling
+ *    point is dropped (running OnRewound if given), as if it was never scheduled
+ */
+UCLASS()
+class ACTIONTOWERDEFENSE_API USTGameEventScheduler : public UWorldSubsystem
+{
+    GENERATED_BODY()
+
+public:
+    virtual void Deinitialize() override;
+
+    /** Convenience helper so other classes can find the scheduler. */
+    static USTGameEventScheduler* Get(const UObject* WorldContextObject);
+
+    /**
+     * Call OnFire after GameDelay game-seconds, unless BoundObject is destroyed first.
+     * AlreadyElapsed re-creates an event part-way through (rewind restores).
+     * Returns a handle usable with CancelEvent.
+     */
+    int32 ScheduleEvent(float GameDelay, const UObject* BoundObject, TFunction<void()> OnFire,
+        TFunction<void()> OnRewound = nullptr, float AlreadyElapsed = 0.f);
+
+    /**
+     * Deal Damage to Target after GameDelay game-seconds, credited to SourceTower
+     * (scheduled-impact shots). Released untouched if Target dies first.
+     */
+    int32 ScheduleImpact(float GameDelay, AActor* Target, const ATowerBase* SourceTower, float Damage,
+        float AlreadyElapsed = 0.f);
+
+    /** Pending scheduled impacts, in scheduling order. */
+    void GetPendingImpacts(TArray<const FSTScheduledGameEvent*>& OutImpacts) const;
+
+    /** Every pending event whose bound object is still alive, in scheduling order. */
+    void GetPendingEvents(TArray<const FSTScheduledGameEvent*>& OutEvents) const;
+
+    /** Drop every pending impact without running it (rewind restores re-create them). */
+    void CancelAllImpacts();
+
+    /** Drop a pending event without running it. */
+    void CancelEvent(int32 EventId);
+
+    /** Drop every pending event without running it (timeline seeks start from a clean slate). */
+    void CancelAllEvents() { PendingEvents.Reset(); }
+
+    int32 GetNumPendingEvents() const { return PendingEvents.Num(); }
+
+    /**
+     * Advance all pending events by one simulation substep (negative while rewinding).
+     * Events due in the same substep run in scheduling order.
+     */
+    void AdvanceEvents(float StepSeconds);
+
+protected:
+    virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+    TArray<FSTScheduledGameEvent> PendingEvents;
+
+    int32 NextEventId = 0;
+};
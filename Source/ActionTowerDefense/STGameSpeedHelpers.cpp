@@ -2,16 +2,16 @@
 
 
 #include "STGameSpeedHelpers.h"
-#include "STGameState.h"
+#include "STSimulationClock.h"
 
 float FSTGameSpeedHelpers::GetGameSpeed(const UObject* WorldContextObject)
 {
-    if (ASTGameState* GS = ASTGameState::Get(WorldContextObject))
+    if (const USTSimulationClock* Clock = USTSimulationClock::Get(WorldContextObject))
     {
-        return GS->GetCurrentSpeed();
+        return Clock->GetGameSpeed();
     }
 
-    // Fallback if no GameState (e.g., in menus / tests)
+    // Fallback if no simulation clock (e.g., in menus / editor worlds)
     return 1.f;
 }
 
@@ -23,6 +23,10 @@ float FSTGameSpeedHelpers::GetPositiveSpeed(const UObject* WorldContextObject)
 
 float FSTGameSpeedHelpers::GetScaledDeltaSeconds(const UObject* WorldContextObject, float DeltaSeconds)
 {
-    const float Speed = GetGameSpeed(WorldContextObject);
-    return DeltaSeconds * Speed;
+    if (const USTSimulationClock* Clock = USTSimulationClock::Get(WorldContextObject))
+    {
+        return Clock->IsPaused() ? 0.f : DeltaSeconds * Clock->GetGameSpeed();
+    }
+
+    return DeltaSeconds;
 }
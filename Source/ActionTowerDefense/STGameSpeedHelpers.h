@@ -8,7 +8,8 @@ class UObject;
 
 /**
  * Small helper struct for querying game speed and scaled delta time.
- * Centralizes all interaction with ASTGameState::Get().
+ * Thin wrappers over USTSimulationClock for code without a cached clock;
+ * hot paths should cache the clock and use its inline accessors.
  */
 struct FSTGameSpeedHelpers
 {
@@ -18,6 +19,6 @@ struct FSTGameSpeedHelpers
     /** Get the current game speed, but clamped to be non-negative. */
     static float GetPositiveSpeed(const UObject* WorldContextObject);
 
-    /** Get DeltaSeconds scaled by current game speed. */
+    /** Get DeltaSeconds scaled by this frame's game speed. */
     static float GetScaledDeltaSeconds(const UObject* WorldContextObject, float DeltaSeconds);
 };
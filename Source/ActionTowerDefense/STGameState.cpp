@@ -4,6 +4,7 @@
 #include "STGameState.h"
 #include "STGameController.h"
 #include "Engine/World.h"
+#include "STWorldRegistry.h"
 
 
 // Sets default values
@@ -15,6 +16,21 @@ ASTGameState::ASTGameState()
 void ASTGameState::BeginPlay()
 {
     Super::BeginPlay();
+
+    if (USTWorldRegistrySubsystem* Registry = USTWorldRegistrySubsystem::Get(this))
+    {
+        Registry->RegisterGameState(this);
+    }
+}
+
+void ASTGameState::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+    if (USTWorldRegistrySubsystem* Registry = USTWorldRegistrySubsystem::Get(this))
+    {
+        Registry->UnregisterGameState(this);
+    }
+
+    Super::EndPlay(EndPlayReason);
 }
 
 void ASTGameState::Tick(float DeltaSeconds)
@@ -32,6 +48,15 @@ ASTGameState* ASTGameState::Get(const UObject* WorldContextObject)
         return nullptr;
     }
 
+    // Registered in BeginPlay; before that, ask the world directly
+    if (const USTWorldRegistrySubsystem* Registry = USTWorldRegistrySubsystem::Get(WorldContextObject))
+    {
+        if (ASTGameState* Registered = Registry->GetGameState())
+        {
+            return Registered;
+        }
+    }
+
     UWorld* World = WorldContextObject->GetWorld();
     if (!World)
     {
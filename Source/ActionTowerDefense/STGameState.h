@@ -44,6 +44,7 @@ public:
     ASTGameState();
 
     virtual void BeginPlay() override;
+    virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
     virtual void Tick(float DeltaSeconds) override;
 
     // --- Convenience accessors for game speed ---
@@ -0,0 +1,680 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "STMatchRecorder.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "Kismet/GameplayStatics.h"
+#include "Misc/App.h"
+#include "Misc/CommandLine.h"
+#include "Misc/DateTime.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Parse.h"
+#include "Misc/Paths.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+#include "STSimulationClock.h"
+#include "STRewindHistory.h"
+#include "STGameController.h"
+#include "STPlayerController.h"
+#include "STSpawner.h"
+#include "TowerBase.h"
+#include "AttackTowerBase.h"
+#include "STMemoryTags.h"
+
+static TAutoConsoleVariable<int32> CVarSTRecordMatch(
+    TEXT("ActionTD.RecordMatch"),
+    0,
+    TEXT("1: record the next match (seed, frame timings, player commands) to Saved/ActionTD/Replays/ (read when the level starts)."));
+
+/** Set by StartReplay for the world it opens. */
+static FString GSTPendingReplayPath;
+
+/** -ActionTDReplay= only applies to the first world that starts. */
+static bool GSTCommandLineReplayTaken = false;
+
+// ========================================================
+// File format
+// ========================================================
+
+namespace STMatchReplayFile
+{
+    constexpr uint32 Magic = 0x52445441; // "ATDR"
+    constexpr int32 Version = 1;
+}
+
+static FArchive& operator<<(FArchive& Ar, FSTRecordedFrame& Frame)
+{
+    Ar << Frame.DeltaSeconds;
+    Ar << Frame.NumSubsteps;
+    Ar << Frame.Checksum;
+    return Ar;
+}
+
+static FArchive& operator<<(FArchive& Ar, FSTPlayerCommand& Command)
+{
+    uint8 Type = static_cast<uint8>(Command.Type);
+
+    Ar << Command.Slot;
+    Ar << Type;
+    Ar << Command.TowerId;
+    Ar << Command.Arg;
+    Ar << Command.Value;
+
+    Command.Type = static_cast<ESTPlayerCommand>(Type);
+    return Ar;
+}
+
+FArchive& operator<<(FArchive& Ar, FSTMatchRecording& Recording)
+{
+    uint32 Magic = STMatchReplayFile::Magic;
+    int32 Version = STMatchReplayFile::Version;
+
+    Ar << Magic;
+    Ar << Version;
+
+    if (Ar.IsLoading() && (Magic != STMatchReplayFile::Magic || Version != STMatchReplayFile::Version))
+    {
+        Ar.SetError();
+        return Ar;
+    }
+
+    Ar << Recording.MapName;
+    Ar << Recording.SpawnerSeeds;
+    Ar << Recording.FixedStepSeconds;
+    Ar << Recording.Frames;
+    Ar << Recording.Commands;
+    return Ar;
+}
+
+bool FSTMatchRecording::SaveToFile(const FString& Path) const
+{
+    TArray<uint8> Bytes;
+    FMemoryWriter Writer(Bytes);
+    Writer << const_cast<FSTMatchRecording&>(*this);
+
+    return FFileHelper::SaveArrayToFile(Bytes, *Path);
+}
+
+bool FSTMatchRecording::LoadFromFile(const FString& Path)
+{
+    TArray<uint8> Bytes;
+    if (!FFileHelper::LoadFileToArray(Bytes, *Path))
+    {
+        return false;
+    }
+
+    FMemoryReader Reader(Bytes);
+    Reader << *this;
+
+    return !Reader.IsError();
+}
+
+// ========================================================
+// Subsystem
+// ========================================================
+
+void USTMatchRecorder::Initialize(FSubsystemCollectionBase& Collection)
+{
+    Super::Initialize(Collection);
+
+    SimClock = Collection.InitializeDependency<USTSimulationClock>();
+    RewindHistory = Collection.InitializeDependency<USTRewindHistory>();
+
+    if (SimClock)
+    {
+        FrameStartHandle = SimClock->OnFrameStart.AddUObject(this, &USTMatchRecorder::HandleFrameStart);
+    }
+
+    if (RewindHistory)
+    {
+        RewindHistory->SetMatchRecorder(this);
+    }
+
+    // A replay requested for this world wins over recording it
+    ReplayPath = GSTPendingReplayPath;
+    GSTPendingReplayPath.Reset();
+
+    if (ReplayPath.IsEmpty() && !GSTCommandLineReplayTaken)
+    {
+        GSTCommandLineReplayTaken = true;
+        FParse::Value(FCommandLine::Get(), TEXT("ActionTDReplay="), ReplayPath);
+    }
+
+    if (!ReplayPath.IsEmpty())
+    {
+        bPlayingBack = Recording.LoadFromFile(ReplayPath);
+        if (!bPlayingBack)
+        {
+            UE_LOG(LogTemp, Warning, TEXT("MatchRecorder: could not read replay %s"), *ReplayPath);
+        }
+        return;
+    }
+
+    bRecording = CVarSTRecordMatch.GetValueOnGameThread() > 0 || FParse::Param(FCommandLine::Get(), TEXT("ActionTDRecord"));
+}
+
+void USTMatchRecorder::Deinitialize()
+{
+    if (SimClock)
+    {
+        SimClock->OnFrameStart.Remove(FrameStartHandle);
+    }
+
+    if (RewindHistory)
+    {
+        RewindHistory->SetMatchRecorder(nullptr);
+    }
+
+    // Left mid-match: keep what was played
+    if (bRecording && !bSaved)
+    {
+        SaveRecording();
+    }
+
+    if (bPlayingBack)
+    {
+        FinishPlayback();
+    }
+
+    Super::Deinitialize();
+}
+
+bool USTMatchRecorder::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+    return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+USTMatchRecorder* USTMatchRecorder::Get(const UObject* WorldContextObject)
+{
+    if (!WorldContextObject)
+    {
+        return nullptr;
+    }
+
+    UWorld* World = WorldContextObject->GetWorld();
+    if (!World)
+    {
+        return nullptr;
+    }
+
+    return World->GetSubsystem<USTMatchRecorder>();
+}
+
+void USTMatchRecorder::OnWorldBeginPlay(UWorld& InWorld)
+{
+    Super::OnWorldBeginPlay(InWorld);
+
+    const FString MapName = UWorld::RemovePIEPrefix(InWorld.GetOutermost()->GetName());
+
+    if (bRecording)
+    {
+        Recording.MapName = MapName;
+        Recording.FixedStepSeconds = SimClock ? SimClock->GetFixedStepSeconds() : 0.f;
+
+        UE_LOG(LogTemp, Log, TEXT("MatchRecorder: recording %s"), *MapName);
+        return;
+    }
+
+    if (!bPlayingBack)
+    {
+        return;
+    }
+
+    if (Recording.MapName != MapName)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("MatchRecorder: %s was recorded on %s, not %s; not playing it back"),
+            *ReplayPath, *Recording.MapName, *MapName);
+        bPlayingBack = false;
+        return;
+    }
+
+    if (SimClock && Recording.FixedStepSeconds > 0.f && Recording.FixedStepSeconds != SimClock->GetFixedStepSeconds())
+    {
+        SimClock->SetFixedStepSeconds(Recording.FixedStepSeconds);
+    }
+
+    UE_LOG(LogTemp, Log, TEXT("MatchRecorder: playing back %s (%d frames, %d commands)"),
+        *ReplayPath, Recording.Frames.Num(), Recording.Commands.Num());
+
+    // The first frame's delta is taken before any of our callbacks run
+    FeedNextDelta(0);
+}
+
+// ========================================================
+// Frames
+// ========================================================
+
+void USTMatchRecorder::HandleFrameStart(uint64 FrameNumber)
+{
+    // Recordings stop at the end of the match
+    const bool bRecordingFrames = bRecording && !bSaved;
+    if (!bRecordingFrames && !bPlayingBack)
+    {
+        return;
+    }
+
+    ++FrameIndex;
+
+    if (bRecordingFrames)
+    {
+        if (FrameIndex == 0)
+        {
+            CaptureSpawnerSeeds();
+        }
+        else
+        {
+            // The clock still holds what the previous frame ran
+            FSTRecordedFrame& Frame = Recording.Frames.AddDefaulted_GetRef();
+            Frame.DeltaSeconds = SimClock->GetRealDeltaSeconds();
+            Frame.NumSubsteps = SimClock->GetNumSubstepsThisFrame();
+            Frame.Checksum = ComputeChecksum();
+        }
+    }
+    else
+    {
+        const double NowSeconds = FPlatformTime::Seconds();
+
+        if (FrameIndex == 0)
+        {
+            ApplySpawnerSeeds();
+            PlaybackStartSeconds = NowSeconds;
+        }
+        else
+        {
+            MaxFrameMs = FMath::Max(MaxFrameMs, (NowSeconds - LastFrameStartSeconds) * 1000.0);
+
+            const int32 PreviousFrame = FrameIndex - 1;
+            if (ComputeChecksum() != Recording.Frames[PreviousFrame].Checksum)
+            {
+                if (NumDivergedFrames == 0)
+                {
+                    FirstDivergedFrame = PreviousFrame;
+                    UE_LOG(LogTemp, Error, TEXT("MatchRecorder: playback diverged from the recording at frame %d (step %llu)"),
+                        PreviousFrame, SimClock->GetSimStepNumber());
+                }
+                ++NumDivergedFrames;
+            }
+        }
+
+        LastFrameStartSeconds = NowSeconds;
+
+        if (FrameIndex >= Recording.Frames.Num())
+        {
+            FinishPlayback();
+            return;
+        }
+
+        ApplyCommandsUpTo(2 * static_cast<uint64>(FrameIndex));
+
+        SimClock->ForceSubstepsThisFrame(Recording.Frames[FrameIndex].NumSubsteps);
+        FeedNextDelta(FrameIndex + 1);
+    }
+
+    CurrentSlot = 2 * static_cast<uint64>(FrameIndex) + 1;
+}
+
+void USTMatchRecorder::NotifyControllerTick()
+{
+    if (bPlayingBack)
+    {
+        ApplyCommandsUpTo(CurrentSlot);
+    }
+
+    // Anything from here on is seen by the next frame's substeps first
+    CurrentSlot = 2 * static_cast<uint64>(FrameIndex + 1);
+}
+
+uint32 USTMatchRecorder::ComputeChecksum() const
+{
+    uint32 Crc = RewindHistory ? RewindHistory->ComputeStateChecksum() : 0;
+
+    // Controller state the rewind snapshots leave out
+    if (const ASTGameController* Controller = ASTGameController::Get(this))
+    {
+        Crc = FCrc::MemCrc32(&Controller->CurrentReverseMeter, sizeof(Controller->CurrentReverseMeter), Crc);
+        Crc = FCrc::MemCrc32(&Controller->CurrentSpeed, sizeof(Controller->CurrentSpeed), Crc);
+    }
+
+    return Crc;
+}
+
+void USTMatchRecorder::RecordStepChecksum(uint64 SimStepNumber, uint32 Checksum)
+{
+    ST_LLM_SCOPE(Stats);
+
+    TArray<uint32>& Checksums = Recording.StepChecksums;
+
+    // Steps come in order; an earlier one means a rewind or seek abandoned the ones after it
+    if (Checksums.Num() == 0 || SimStepNumber < Recording.FirstChecksumStep
+        || SimStepNumber > Recording.FirstChecksumStep + Checksums.Num())
+    {
+        Checksums.Reset();
+        Recording.FirstChecksumStep = SimStepNumber;
+    }
+    else
+    {
+        Checksums.SetNum(static_cast<int32>(SimStepNumber - Recording.FirstChecksumStep), EAllowShrinking::No);
+    }
+
+    Checksums.Add(Checksum);
+}
+
+bool USTMatchRecorder::FindStepChecksum(uint64 SimStepNumber, uint32& OutChecksum) const
+{
+    const TArray<uint32>& Checksums = Recording.StepChecksums;
+    if (SimStepNumber < Recording.FirstChecksumStep
+        || SimStepNumber - Recording.FirstChecksumStep >= static_cast<uint64>(Checksums.Num()))
+    {
+        return false;
+    }
+
+    OutChecksum = Checksums[static_cast<int32>(SimStepNumber - Recording.FirstChecksumStep)];
+    return true;
+}
+
+void USTMatchRecorder::FeedNextDelta(int32 InFrameIndex)
+{
+    if (!Recording.Frames.IsValidIndex(InFrameIndex))
+    {
+        return;
+    }
+
+    // Unthrottled: the engine takes this delta without waiting for it to pass
+    FApp::SetUseFixedTimeStep(true);
+    FApp::SetFixedDeltaTime(Recording.Frames[InFrameIndex].DeltaSeconds);
+}
+
+// ========================================================
+// Commands
+// ========================================================
+
+bool USTMatchRecorder::ShouldRunCommand(const UObject* WorldContextObject, ESTPlayerCommand Type,
+    const ATowerBase* Tower, int32 Arg, float Value)
+{
+    USTMatchRecorder* Recorder = Get(WorldContextObject);
+
+    // Live input would fork the replayed match
+    if (Recorder && Recorder->bPlayingBack && !Recorder->bApplyingCommand)
+    {
+        return false;
+    }
+
+    // Selection changes nothing in the simulation
+    if (Type != ESTPlayerCommand::SelectTower)
+    {
+        if (USTRewindHistory* History = USTRewindHistory::Get(WorldContextObject))
+        {
+            History->RequestMatchKeyframe();
+        }
+    }
+
+    if (Recorder && Recorder->bRecording && !Recorder->bSaved)
+    {
+        ST_LLM_SCOPE(Stats);
+
+        FSTPlayerCommand& Command = Recorder->Recording.Commands.AddDefaulted_GetRef();
+        Command.Slot = Recorder->CurrentSlot;
+        Command.Type = Type;
+        Command.TowerId = Tower ? Tower->GetSimId() : INDEX_NONE;
+        Command.Arg = Arg;
+        Command.Value = Value;
+    }
+
+    return true;
+}
+
+void USTMatchRecorder::ApplyCommandsUpTo(uint64 Slot)
+{
+    while (Recording.Commands.IsValidIndex(NextCommand) && Recording.Commands[NextCommand].Slot <= Slot)
+    {
+        ApplyCommand(Recording.Commands[NextCommand++]);
+    }
+}
+
+void USTMatchRecorder::ApplyCommand(const FSTPlayerCommand& Command)
+{
+    TGuardValue<bool> ApplyingGuard(bApplyingCommand, true);
+
+    ASTGameController* Controller = ASTGameController::Get(this);
+
+    switch (Command.Type)
+    {
+    case ESTPlayerCommand::SetSpeedMode:
+        if (Controller)
+        {
+            Controller->SetSpeedMode(static_cast<EGameSpeedMode>(Command.Arg));
+        }
+        break;
+
+    case ESTPlayerCommand::SetGameSpeed:
+        if (Controller)
+        {
+            Controller->Command_SetGameSpeed(Command.Value);
+        }
+        break;
+
+    case ESTPlayerCommand::StartReverse:
+        if (Controller)
+        {
+            Controller->StartReverse();
+        }
+        break;
+
+    case ESTPlayerCommand::StopReverse:
+        if (Controller)
+        {
+            Controller->StopReverse();
+        }
+        break;
+
+    case ESTPlayerCommand::RequestNextWave:
+        if (Controller)
+        {
+            Controller->Command_RequestNextWave();
+        }
+        break;
+
+    case ESTPlayerCommand::SeekToGameTime:
+        if (Controller)
+        {
+            Controller->SeekToGameTime(Command.Value);
+        }
+        break;
+
+    case ESTPlayerCommand::SeekToWaveStart:
+        if (Controller)
+        {
+            Controller->SeekToWaveStart(Command.Arg);
+        }
+        break;
+
+    case ESTPlayerCommand::OrderCaptureTower:
+        if (AAttackTowerBase* Tower = Cast<AAttackTowerBase>(FindTower(Command.TowerId)))
+        {
+            Tower->OrderCaptureTower(FindTower(Command.Arg));
+        }
+        break;
+
+    case ESTPlayerCommand::OrderStopCurrentAction:
+        if (AAttackTowerBase* Tower = Cast<AAttackTowerBase>(FindTower(Command.TowerId)))
+        {
+            Tower->OrderStopCurrentAction();
+        }
+        break;
+
+    case ESTPlayerCommand::UpgradeTower:
+        if (ATowerBase* Tower = FindTower(Command.TowerId))
+        {
+            Tower->UpgradeTower();
+        }
+        break;
+
+    case ESTPlayerCommand::SelectTower:
+        if (ASTPlayerController* PlayerController = Cast<ASTPlayerController>(GetWorld()->GetFirstPlayerController()))
+        {
+            PlayerController->SetSelectedTower(FindTower(Command.TowerId));
+        }
+        break;
+    }
+}
+
+ATowerBase* USTMatchRecorder::FindTower(int32 SimId) const
+{
+    if (!SimClock || SimId == INDEX_NONE)
+    {
+        return nullptr;
+    }
+
+    for (ATowerBase* Tower : SimClock->GetTowers())
+    {
+        if (Tower && Tower->GetSimId() == SimId)
+        {
+            return Tower;
+        }
+    }
+
+    return nullptr;
+}
+
+// ========================================================
+// Seeds
+// ========================================================
+
+void USTMatchRecorder::CaptureSpawnerSeeds()
+{
+    Recording.SpawnerSeeds.Reset();
+
+    for (const ASTSpawner* Spawner : SimClock->GetSpawners())
+    {
+        Recording.SpawnerSeeds.Add(Spawner ? Spawner->RandomSeed : 0);
+    }
+}
+
+void USTMatchRecorder::ApplySpawnerSeeds()
+{
+    const TArray<ASTSpawner*>& Spawners = SimClock->GetSpawners();
+    if (Spawners.Num() != Recording.SpawnerSeeds.Num())
+    {
+        UE_LOG(LogTemp, Warning, TEXT("MatchRecorder: recorded %d spawners, level has %d"),
+            Recording.SpawnerSeeds.Num(), Spawners.Num());
+    }
+
+    // Nothing has spawned yet: restarting the streams changes nothing but the seed
+    for (int32 Index = 0; Index < FMath::Min(Spawners.Num(), Recording.SpawnerSeeds.Num()); ++Index)
+    {
+        if (ASTSpawner* Spawner = Spawners[Index])
+        {
+            Spawner->RandomSeed = Recording.SpawnerSeeds[Index];
+            Spawner->RandomStream.Initialize(Spawner->RandomSeed);
+        }
+    }
+}
+
+// ========================================================
+// Start / end
+// ========================================================
+
+void USTMatchRecorder::NotifyMatchEnded()
+{
+    if (bRecording && !bSaved)
+    {
+        SaveRecording();
+    }
+}
+
+void USTMatchRecorder::SaveRecording()
+{
+    ST_LLM_SCOPE(Stats);
+
+    bSaved = true;
+
+    if (Recording.Frames.Num() == 0)
+    {
+        return;
+    }
+
+    const FString Path = FPaths::ProjectSavedDir() / TEXT("ActionTD") / TEXT("Replays")
+        / FString::Printf(TEXT("%s_%s.atdreplay"),
+            *FPaths::GetBaseFilename(Recording.MapName),
+            *FDateTime::Now().ToString(TEXT("%Y%m%d_%H%M%S")));
+
+    if (Recording.SaveToFile(Path))
+    {
+        UE_LOG(LogTemp, Log, TEXT("MatchRecorder: %d frames, %d commands -> %s"),
+            Recording.Frames.Num(), Recording.Commands.Num(), *Path);
+    }
+    else
+    {
+        UE_LOG(LogTemp, Warning, TEXT("MatchRecorder: could not write %s"), *Path);
+    }
+}
+
+void USTMatchRecorder::FinishPlayback()
+{
+    bPlayingBack = false;
+    FApp::SetUseFixedTimeStep(false);
+
+    const int32 NumFrames = FMath::Max(FrameIndex, 0);
+    const double WallSeconds = FPlatformTime::Seconds() - PlaybackStartSeconds;
+
+    if (NumDivergedFrames == 0 && NumFrames >= Recording.Frames.Num())
+    {
+        UE_LOG(LogTemp, Log,
+            TEXT("MatchRecorder: replay matched all %d frames | %.2f s wall, %.2f ms/frame avg, %.2f ms max"),
+            NumFrames, WallSeconds, NumFrames > 0 ? WallSeconds * 1000.0 / NumFrames : 0.0, MaxFrameMs);
+    }
+    else
+    {
+        UE_LOG(LogTemp, Warning,
+            TEXT("MatchRecorder: replay ended after %d / %d frames, %d diverged (first at frame %d)"),
+            NumFrames, Recording.Frames.Num(), NumDivergedFrames, FirstDivergedFrame);
+    }
+
+    if (FParse::Param(FCommandLine::Get(), TEXT("ActionTDReplayExit")))
+    {
+        FPlatformMisc::RequestExit(false, TEXT("USTMatchRecorder::FinishPlayback"));
+    }
+}
+
+bool USTMatchRecorder::StartReplay(UWorld* World, const FString& Path)
+{
+    FSTMatchRecording Header;
+    if (!World || !Header.LoadFromFile(Path))
+    {
+        UE_LOG(LogTemp, Warning, TEXT("MatchRecorder: could not read replay %s"), *Path);
+        return false;
+    }
+
+    // Picked up by the recorder of the world this opens
+    QueueReplay(Path);
+    UGameplayStatics::OpenLevel(World, FName(*Header.MapName));
+    return true;
+}
+
+void USTMatchRecorder::QueueReplay(const FString& Path)
+{
+    GSTPendingReplayPath = Path;
+}
+
+// ========================================================
+// Console
+// ========================================================
+
+#if !UE_BUILD_SHIPPING
+
+static FAutoConsoleCommandWithWorldAndArgs GSTReplayMatchCommand(
+    TEXT("ActionTD.ReplayMatch"),
+    TEXT("Open the map of a match recording (.atdreplay) and play it back, checking every frame against the recording."),
+    FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+        {
+            if (Args.Num() == 0)
+            {
+                UE_LOG(LogTemp, Warning, TEXT("MatchRecorder: usage ActionTD.ReplayMatch <File.atdreplay>"));
+                return;
+            }
+
+            USTMatchRecorder::StartReplay(World, Args[0]);
+        }));
+
+#endif // !UE_BUILD_SHIPPING
@@ -0,0 +1,195 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "STMatchRecorder.generated.h"
+
+class ATowerBase;
+class USTSimulationClock;
+class USTRewindHistory;
+
+/** Player commands a match recording carries (everything else follows from them). */
+enum class ESTPlayerCommand : uint8
+{
+    SetSpeedMode,            // Arg = EGameSpeedMode
+    SetGameSpeed,            // Value = speed
+    StartReverse,
+    StopReverse,
+    RequestNextWave,
+    SeekToGameTime,          // Value = game time
+    SeekToWaveStart,         // Arg = wave index
+    OrderCaptureTower,       // TowerId = ordered tower, Arg = neutral tower's sim id
+    OrderStopCurrentAction,  // TowerId = ordered tower
+    UpgradeTower,            // TowerId = tower being replaced
+    SelectTower,             // TowerId = new selection (INDEX_NONE: cleared)
+};
+
+/**
+ * One command and when it was issued.
+ *
+ * Slot is the half-frame the command was first seen in: 2 * Frame when it came
+ * before that frame's substeps (UI clicks, input before the clock ticked),
+ * 2 * Frame + 1 when it came after them but before ASTGameController ticked.
+ * Frames count from the first frame after BeginPlay.
+ */
+struct FSTPlayerCommand
+{
+    uint64 Slot = 0;
+    ESTPlayerCommand Type = ESTPlayerCommand::SetSpeedMode;
+    int32 TowerId = INDEX_NONE;
+    int32 Arg = INDEX_NONE;
+    float Value = 0.f;
+};
+
+/** What a frame ran, and the state it ended in. */
+struct FSTRecordedFrame
+{
+    float DeltaSeconds = 0.f;
+    int32 NumSubsteps = 0;
+    uint32 Checksum = 0;
+};
+
+/** A whole match: the map, its spawners' seeds, every frame's timing and every command. */
+struct FSTMatchRecording
+{
+    FString MapName;
+    TArray<int32> SpawnerSeeds;
+    float FixedStepSeconds = 0.f;
+    TArray<FSTRecordedFrame> Frames;
+    TArray<FSTPlayerCommand> Commands;
+
+    /** State checksum of every step from FirstChecksumStep on, for seek replays to check against (not saved). */
+    uint64 FirstChecksumStep = 0;
+    TArray<uint32> StepChecksums;
+
+    bool SaveToFile(const FString& Path) const;
+    bool LoadFromFile(const FString& Path);
+
+    friend FArchive& operator<<(FArchive& Ar, FSTMatchRecording& Recording);
+};
+
+/**
+ * Records a match as seed + frame-stamped player commands, and plays one back.
+ *
+ * Recording (ActionTD.RecordMatch 1 or -ActionTDRecord): every command entry
+ * point (ASTGameController speed / reverse / wave / seek commands, tower orders
+ * and upgrades, selection) reports through ShouldRunCommand, and every frame's
+ * delta, substep count and state checksum (USTRewindHistory::ComputeStateChecksum
+ * plus reverse meter and speed) are kept. The file is written when the match ends (or the
+ * world goes away) to Saved/ActionTD/Replays/<map>_<time>.atdreplay.
+ *
+ * Playback (-ActionTDReplay=<file>, or ActionTD.ReplayMatch <file>, which opens
+ * the recorded map): the engine runs on a fixed time step fed the recorded
+ * deltas, the clock runs the recorded substep counts, live player commands are
+ * ignored and the recorded ones go through the same entry points at the same
+ * half-frame. Every frame's checksum is compared against the recording; the first
+ * divergence is logged with its frame. Frames are not throttled, so a played
+ * back session is a repeatable perf workload (run it with ActionTD.PerfCapture
+ * for per-wave CSVs); add -ActionTDReplayExit to quit when it ends.
+ */
+UCLASS()
+class ACTIONTOWERDEFENSE_API USTMatchRecorder : public UWorldSubsystem
+{
+    GENERATED_BODY()
+
+public:
+    virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+    virtual void Deinitialize() override;
+
+    /** Convenience helper so other classes can find the recorder. */
+    static USTMatchRecorder* Get(const UObject* WorldContextObject);
+
+    /**
+     * Called first thing by every command entry point. Records the command when
+     * recording; during playback only the recorder's own commands may run.
+     * Tower is the tower the command is for (its sim id is recorded).
+     * Commands that run also ask for a match keyframe at the next step, so timeline
+     * seeks never have to replay across one.
+     */
+    static bool ShouldRunCommand(const UObject* WorldContextObject, ESTPlayerCommand Type,
+        const ATowerBase* Tower = nullptr, int32 Arg = INDEX_NONE, float Value = 0.f);
+
+    /** ASTGameController::Tick is about to run (the second half of the frame). */
+    void NotifyControllerTick();
+
+    /** The match is over: write the recording. */
+    void NotifyMatchEnded();
+
+    FORCEINLINE bool IsRecording() const { return bRecording; }
+    FORCEINLINE bool IsPlayingBack() const { return bPlayingBack; }
+
+    /** True while steps are checksummed (recording, or playing back). */
+    FORCEINLINE bool WantsStepChecksums() const { return (bRecording && !bSaved) || bPlayingBack; }
+
+    /** Keep the checksum of a freshly simulated step; steps after it (a rewound future) are dropped. */
+    void RecordStepChecksum(uint64 SimStepNumber, uint32 Checksum);
+
+    /** Checksum kept for SimStepNumber, if there is one. */
+    bool FindStepChecksum(uint64 SimStepNumber, uint32& OutChecksum) const;
+
+    /** Open Path's map and play it back there. */
+    static bool StartReplay(UWorld* World, const FString& Path);
+
+    /** Play Path back in the next world that starts (StartReplay, headless runs). */
+    static void QueueReplay(const FString& Path);
+
+protected:
+    virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+    virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+
+    void HandleFrameStart(uint64 FrameNumber);
+
+    /** State checksum at the end of the previous frame. */
+    uint32 ComputeChecksum() const;
+
+    /** Run the recorded commands of every slot up to Slot. */
+    void ApplyCommandsUpTo(uint64 Slot);
+    void ApplyCommand(const FSTPlayerCommand& Command);
+
+    ATowerBase* FindTower(int32 SimId) const;
+
+    void CaptureSpawnerSeeds();
+    void ApplySpawnerSeeds();
+
+    /** Engine frame delta for the next frame of the playback. */
+    void FeedNextDelta(int32 FrameIndex);
+
+    void SaveRecording();
+    void FinishPlayback();
+
+    UPROPERTY(Transient)
+    USTSimulationClock* SimClock = nullptr;
+
+    UPROPERTY(Transient)
+    USTRewindHistory* RewindHistory = nullptr;
+
+    FDelegateHandle FrameStartHandle;
+
+    FSTMatchRecording Recording;
+    FString ReplayPath;
+
+    bool bRecording = false;
+    bool bPlayingBack = false;
+    bool bSaved = false;
+
+    /** Set while a recorded command runs (the entry points let it through). */
+    bool bApplyingCommand = false;
+
+    /** Frames since BeginPlay (INDEX_NONE until the first one). */
+    int32 FrameIndex = INDEX_NONE;
+
+    /** Slot a command issued now belongs to. */
+    uint64 CurrentSlot = 0;
+
+    /** Next recorded command to run. */
+    int32 NextCommand = 0;
+
+    /** Playback results. */
+    int32 NumDivergedFrames = 0;
+    int32 FirstDivergedFrame = INDEX_NONE;
+    double PlaybackStartSeconds = 0.0;
+    double MaxFrameMs = 0.0;
+    double LastFrameStartSeconds = 0.0;
+};
@@ -0,0 +1,469 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "STMatchStats.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Dom/JsonObject.h"
+#include "Serialization/JsonWriter.h"
+#include "Serialization/JsonSerializer.h"
+#include "STSimulationClock.h"
+#include "STWorldRegistry.h"
+#include "STSpawner.h"
+#include "TowerBase.h"
+#include "STMemoryTags.h"
+
+// ========================================================
+// Aggregation (export tasks only)
+// ========================================================
+
+/** Totals for one wave or one tower. */
+struct FSTStatTotals
+{
+    int32 Shots = 0;
+    int32 Hits = 0;
+    int32 Kills = 0;
+    int32 Leaks = 0;
+    double Damage = 0.0;
+    TArray<float> TimeToKill;
+    TArray<float> CaptureSeconds;
+
+    void Add(const FSTStatRecord& Record)
+    {
+        switch (Record.Type)
+        {
+        case ESTStatEvent::Shot:    ++Shots; break;
+        case ESTStatEvent::Hit:     ++Hits; Damage += Record.Value; break;
+        case ESTStatEvent::Kill:    ++Kills; TimeToKill.Add(Record.Value); break;
+        case ESTStatEvent::Leak:    ++Leaks; break;
+        case ESTStatEvent::Capture: CaptureSeconds.Add(Record.Value); break;
+        }
+    }
+};
+
+struct FSTMatchStatsAggregate
+{
+    TMap<int32, FSTStatTotals> Waves;
+    TMap<int32, FSTStatTotals> Towers;
+    TMap<int32, FString> TowerClasses;
+    int64 NumRecords = 0;
+
+    void Add(const TArray<FSTStatRecord>& Batch)
+    {
+        for (const FSTStatRecord& Record : Batch)
+        {
+            Waves.FindOrAdd(Record.WaveIndex).Add(Record);
+
+            if (Record.TowerSimId != INDEX_NONE)
+            {
+                Towers.FindOrAdd(Record.TowerSimId).Add(Record);
+            }
+        }
+
+        NumRecords += Batch.Num();
+    }
+};
+
+namespace STMatchStatsExport
+{
+    /** count / min / p50 / p90 / max / mean of Values. */
+    static TSharedRef<FJsonObject> MakeDistribution(const TArray<float>& Values)
+    {
+        TSharedRef<FJsonObject> Out = MakeShared<FJsonObject>();
+        Out->SetNumberField(TEXT("count"), Values.Num());
+        if (Values.Num() == 0)
+        {
+            return Out;
+        }
+
+        TArray<float> Sorted = Values;
+        Sorted.Sort();
+
+        auto Percentile = [&Sorted](double P)
+            {
+                const int32 Rank = FMath::Clamp(FMath::CeilToInt(P * Sorted.Num()) - 1, 0, Sorted.Num() - 1);
+                return Sorted[Rank];
+            };
+
+        double Sum = 0.0;
+        for (float Value : Sorted)
+        {
+            Sum += Value;
+        }
+
+        Out->SetNumberField(TEXT("min"), Sorted[0]);
+        Out->SetNumberField(TEXT("p50"), Percentile(0.5));
+        Out->SetNumberField(TEXT("p90"), Percentile(0.9));
+        Out->SetNumberField(TEXT("max"), Sorted.Last());
+        Out->SetNumberField(TEXT("mean"), Sum / Sorted.Num());
+        return Out;
+    }
+
+    static TSharedRef<FJsonObject> MakeTotals(const FSTStatTotals& Totals)
+    {
+        TSharedRef<FJsonObject> Out = MakeShared<FJsonObject>();
+        Out->SetNumberField(TEXT("shots"), Totals.Shots);
+        Out->SetNumberField(TEXT("hits"), Totals.Hits);
+        Out->SetNumberField(TEXT("shotsWasted"), FMath::Max(0, Totals.Shots - Totals.Hits));
+        Out->SetNumberField(TEXT("damage"), Totals.Damage);
+        Out->SetNumberField(TEXT("kills"), Totals.Kills);
+        Out->SetNumberField(TEXT("leaks"), Totals.Leaks);
+        Out->SetObjectField(TEXT("timeToKill"), MakeDistribution(Totals.TimeToKill));
+        Out->SetObjectField(TEXT("captureSeconds"), MakeDistribution(Totals.CaptureSeconds));
+        return Out;
+    }
+
+    static bool Write(const FSTMatchStatsAggregate& Aggregate, int32 ExportIndex, const FString& Path)
+    {
+        TSharedRef<FJsonObject> Root = MakeShared<FJsonObject>();
+        Root->SetNumberField(TEXT("export"), ExportIndex);
+        Root->SetNumberField(TEXT("records"), static_cast<double>(Aggregate.NumRecords));
+
+        TArray<int32> WaveKeys;
+        Aggregate.Waves.GetKeys(WaveKeys);
+        WaveKeys.Sort();
+
+        TArray<TSharedPtr<FJsonValue>> Waves;
+        for (int32 WaveIndex : WaveKeys)
+        {
+            TSharedRef<FJsonObject> Wave = MakeTotals(Aggregate.Waves[WaveIndex]);
+            Wave->SetNumberField(TEXT("wave"), WaveIndex);
+            Waves.Add(MakeShared<FJsonValueObject>(Wave));
+        }
+        Root->SetArrayField(TEXT("waves"), Waves);
+
+        TArray<int32> TowerKeys;
+        Aggregate.Towers.GetKeys(TowerKeys);
+        TowerKeys.Sort();
+
+        TArray<TSharedPtr<FJsonValue>> Towers;
+        for (int32 SimId : TowerKeys)
+        {
+            TSharedRef<FJsonObject> Tower = MakeTotals(Aggregate.Towers[SimId]);
+            Tower->SetNumberField(TEXT("simId"), SimId);
+            if (const FString* ClassName = Aggregate.TowerClasses.Find(SimId))
+            {
+                Tower->SetStringField(TEXT("class"), *ClassName);
+            }
+            Towers.Add(MakeShared<FJsonValueObject>(Tower));
+        }
+        Root->SetArrayField(TEXT("towers"), Towers);
+
+        FString Json;
+        const TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&Json);
+        if (!FJsonSerializer::Serialize(Root, Writer))
+        {
+            return false;
+        }
+
+        return FFileHelper::SaveStringToFile(Json, *Path);
+    }
+}
+
+// ========================================================
+// Overhead measurement
+// ========================================================
+
+#if !UE_BUILD_SHIPPING
+/** Adds the cycles spent in its scope to Counter. */
+struct FSTStatsCycleScope
+{
+    explicit FSTStatsCycleScope(uint64& InCounter)
+        : Counter(InCounter), StartCycles(FPlatformTime::Cycles64())
+    {
+    }
+
+    ~FSTStatsCycleScope()
+    {
+        Counter += FPlatformTime::Cycles64() - StartCycles;
+    }
+
+    uint64& Counter;
+    uint64 StartCycles;
+};
+#define ST_STATS_CYCLE_SCOPE() FSTStatsCycleScope CycleScope(RecordCycles)
+#else
+#define ST_STATS_CYCLE_SCOPE()
+#endif
+
+// ========================================================
+// Subsystem
+// ========================================================
+
+void USTMatchStats::Initialize(FSubsystemCollectionBase& Collection)
+{
+    ST_LLM_SCOPE(Stats);
+
+    Super::Initialize(Collection);
+
+    SimClock = Collection.InitializeDependency<USTSimulationClock>();
+    Registry = Collection.InitializeDependency<USTWorldRegistrySubsystem>();
+
+    Records.Reserve(RecordCapacity);
+    SpareRecords.Reserve(RecordCapacity);
+    Aggregate = MakeShared<FSTMatchStatsAggregate, ESPMode::ThreadSafe>();
+
+    const FString MapName = GetWorld() ? UWorld::RemovePIEPrefix(GetWorld()->GetMapName()) : TEXT("Match");
+    ExportPath = FPaths::ProjectSavedDir() / TEXT("ActionTD") / TEXT("Stats")
+        / FString::Printf(TEXT("%s_%s.json"), *MapName, *FDateTime::Now().ToString());
+
+    ResetOverhead();
+}
+
+void USTMatchStats::Deinitialize()
+{
+    // Whatever the last wave left behind
+    FlushToExport();
+    WaitForExports();
+
+    Records.Empty();
+    SpareRecords.Empty();
+    NewTowerClasses.Empty();
+    Aggregate.Reset();
+
+    Super::Deinitialize();
+}
+
+bool USTMatchStats::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+    return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+USTMatchStats* USTMatchStats::Get(const UObject* WorldContextObject)
+{
+    if (!WorldContextObject)
+    {
+        return nullptr;
+    }
+
+    UWorld* World = WorldContextObject->GetWorld();
+    if (!World)
+    {
+        return nullptr;
+    }
+
+    return World->GetSubsystem<USTMatchStats>();
+}
+
+// ========================================================
+// Recording
+// ========================================================
+
+int16 USTMatchStats::GetCurrentWave() const
+{
+    const ASTSpawner* Spawner = Registry ? Registry->GetPrimarySpawner() : nullptr;
+    return Spawner ? static_cast<int16>(Spawner->GetCurrentWaveIndex()) : INDEX_NONE;
+}
+
+void USTMatchStats::AddRecord(ESTStatEvent Type, int32 TowerSimId, float Value)
+{
+    ST_STATS_CYCLE_SCOPE();
+
+    const uint64 SimStep = SimClock ? SimClock->GetSimStepNumber() : 0;
+
+    // Already exported (replaying / re-playing steps before the last export)
+    if (SimStep < ExportedThroughStep)
+    {
+        return;
+    }
+
+    // Full: export now rather than grow
+    if (Records.Num() >= RecordCapacity)
+    {
+        FlushToExport();
+    }
+
+    FSTStatRecord& Record = Records.AddDefaulted_GetRef();
+    Record.SimStep = SimStep;
+    Record.Value = Value;
+    Record.TowerSimId = TowerSimId;
+    Record.WaveIndex = GetCurrentWave();
+    Record.Type = Type;
+}
+
+void USTMatchStats::RecordShot(const ATowerBase* Tower)
+{
+    AddRecord(ESTStatEvent::Shot, Tower ? Tower->GetSimId() : INDEX_NONE, 0.f);
+}
+
+void USTMatchStats::RecordHit(float DamageDealt)
+{
+    AddRecord(ESTStatEvent::Hit, DamageSourceSimId, DamageDealt);
+}
+
+void USTMatchStats::RecordKill(float SecondsAlive)
+{
+    AddRecord(ESTStatEvent::Kill, DamageSourceSimId, SecondsAlive);
+}
+
+void USTMatchStats::RecordLeak()
+{
+    AddRecord(ESTStatEvent::Leak, INDEX_NONE, 0.f);
+}
+
+void USTMatchStats::RecordCapture(const ATowerBase* Capturer, float CaptureSeconds)
+{
+    AddRecord(ESTStatEvent::Capture, Capturer ? Capturer->GetSimId() : INDEX_NONE, CaptureSeconds);
+}
+
+void USTMatchStats::RegisterTower(const ATowerBase* Tower)
+{
+    if (Tower && Tower->GetSimId() != INDEX_NONE)
+    {
+        NewTowerClasses.Emplace(Tower->GetSimId(), Tower->GetClass()->GetName());
+    }
+}
+
+USTMatchStats::FDamageSourceScope::FDamageSourceScope(USTMatchStats* InStats, const ATowerBase* Tower)
+    : Stats(InStats)
+{
+    if (Stats)
+    {
+        PrevSourceSimId = Stats->DamageSourceSimId;
+        Stats->DamageSourceSimId = Tower ? Tower->GetSimId() : INDEX_NONE;
+    }
+}
+
+USTMatchStats::FDamageSourceScope::~FDamageSourceScope()
+{
+    if (Stats)
+    {
+        Stats->DamageSourceSimId = PrevSourceSimId;
+    }
+}
+
+void USTMatchStats::DiscardAfterStep(uint64 SimStep)
+{
+    // Records are in step order
+    int32 NewNum = Records.Num();
+    while (NewNum > 0 && Records[NewNum - 1].SimStep > SimStep)
+    {
+        --NewNum;
+    }
+
+    Records.SetNum(NewNum, EAllowShrinking::No);
+}
+
+// ========================================================
+// Export
+// ========================================================
+
+void USTMatchStats::NotifyWaveEnded()
+{
+    FlushToExport();
+}
+
+void USTMatchStats::FlushToExport()
+{
+    ST_LLM_SCOPE(Stats);
+
+    if (Records.Num() == 0 || !Aggregate.IsValid())
+    {
+        return;
+    }
+
+    ExportedThroughStep = FMath::Max(ExportedThroughStep, Records.Last().SimStep);
+
+    // The spare buffer is still out with the previous export only when two flushes
+    // come within one export's run time; the aggregate is also one task at a time
+    WaitForExports();
+
+    // The full buffer goes to the task; recording continues into the emptied spare
+    Swap(Records, SpareRecords);
+    check(Records.Num() == 0);
+
+    const int32 ExportIndex = NumExportsStarted++;
+
+    // Usually empty: names only arrive when towers register
+    auto Export = [AggregateRef = Aggregate, Batch = &SpareRecords, TowerClasses = MoveTemp(NewTowerClasses),
+        ExportIndex, Path = ExportPath]()
+        {
+            ST_LLM_SCOPE(Stats); // task thread: the caller's scope does not carry over
+
+            AggregateRef->Add(*Batch);
+            for (const TPair<int32, FString>& TowerClass : TowerClasses)
+            {
+                AggregateRef->TowerClasses.Add(TowerClass.Key, TowerClass.Value);
+            }
+
+            // Hand the buffer back, allocation kept, for the next flush
+            Batch->Reset();
+
+            if (!STMatchStatsExport::Write(*AggregateRef, ExportIndex, Path))
+            {
+                UE_LOG(LogTemp, Warning, TEXT("MatchStats: could not write %s"), *Path);
+            }
+        };
+
+    // Deinitialize waits for the task, so SpareRecords outlives it
+    LastExportTask = UE::Tasks::Launch(UE_SOURCE_LOCATION, MoveTemp(Export));
+}
+
+void USTMatchStats::WaitForExports()
+{
+    if (LastExportTask.IsValid())
+    {
+        LastExportTask.Wait();
+    }
+}
+
+// ========================================================
+// Overhead
+// ========================================================
+
+double USTMatchStats::GetOverheadPercent() const
+{
+    const double WallSeconds = FPlatformTime::Seconds() - OverheadStartSeconds;
+    return WallSeconds > 0.0 ? 100.0 * FPlatformTime::ToSeconds64(RecordCycles) / WallSeconds : 0.0;
+}
+
+void USTMatchStats::ResetOverhead()
+{
+    RecordCycles = 0;
+    OverheadStartSeconds = FPlatformTime::Seconds();
+}
+
+// ========================================================
+// Console
+// ========================================================
+
+#if !UE_BUILD_SHIPPING
+
+static FAutoConsoleCommandWithWorld GSTStatsOverheadCommand(
+    TEXT("ActionTD.StatsOverhead"),
+    TEXT("Log the time spent recording match stats since the last call, as a percent of wall time (budget 1%), then reset."),
+    FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+        {
+            USTMatchStats* Stats = USTMatchStats::Get(World);
+            if (!Stats)
+            {
+                return;
+            }
+
+            const double Percent = Stats->GetOverheadPercent();
+            UE_LOG(LogTemp, Log, TEXT("MatchStats: recording overhead %.4f%% of frame time (budget %.1f%%) -> %s | %d records buffered, %d exports"),
+                Percent,
+                USTMatchStats::MaxOverheadPercent,
+                Percent <= USTMatchStats::MaxOverheadPercent ? TEXT("PASS") : TEXT("FAIL"),
+                Stats->GetNumBufferedRecords(),
+                Stats->GetNumExports());
+
+            Stats->ResetOverhead();
+        }));
+
+static FAutoConsoleCommandWithWorld GSTStatsExportCommand(
+    TEXT("ActionTD.StatsExport"),
+    TEXT("Export the match stats recorded so far now (normally done at wave end)."),
+    FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+        {
+            if (USTMatchStats* Stats = USTMatchStats::Get(World))
+            {
+                Stats->FlushToExport();
+                Stats->WaitForExports();
+                UE_LOG(LogTemp, Log, TEXT("MatchStats: exported to %s"), *Stats->GetExportPath());
+            }
+        }));
+
+#endif // !UE_BUILD_SHIPPING
@@ -0,0 +1,171 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Tasks/Task.h"
+#include "STMatchStats.generated.h"
+
+class ATowerBase;
+class USTSimulationClock;
+class USTWorldRegistrySubsystem;
+struct FSTMatchStatsAggregate;
+
+enum class ESTStatEvent : uint8
+{
+    Shot,       // a tower fired (projectile or scheduled impact)
+    Hit,        // Value = damage actually dealt (overkill excluded)
+    Kill,       // Value = game-seconds the enemy was alive
+    Leak,       // an enemy reached the goal
+    Capture,    // Value = game-seconds the capture took
+};
+
+/** One stat event. Plain data, fixed size: the hot path only copies one in. */
+struct FSTStatRecord
+{
+    /** Substep the event happened in (rewinds discard newer records). */
+    uint64 SimStep = 0;
+
+    float Value = 0.f;
+
+    /** Tower that caused it (shooter / killer / capturer), INDEX_NONE for leaks. */
+    int32 TowerSimId = INDEX_NONE;
+
+    int16 WaveIndex = INDEX_NONE;
+    ESTStatEvent Type = ESTStatEvent::Shot;
+};
+
+/**
+ * Match statistics for balancing: per-wave and per-tower shots, hits, damage,
+ * kills, leaks, time-to-kill and capture durations.
+ *
+ * The fire / damage / kill / capture paths call the Record* functions, which copy
+ * a FSTStatRecord into a buffer preallocated to RecordCapacity; no allocations, no
+ * UObjects, no logging. When a wave ends (the next one starts, or the game is over)
+ * or the buffer fills up, it is handed to a background task and recording swaps to
+ * a second buffer of the same capacity. The task folds the records into the match
+ * totals, rewrites Saved/ActionTD/Stats/<match>.json and hands the emptied buffer
+ * back for the next swap. Tower class names are captured when towers register.
+ *
+ * Shots wasted = shots - hits (a shot still in flight at export time counts as
+ * wasted until it lands).
+ *
+ * Rewinds and seeks discard buffered records newer than the restored step, and
+ * seek replays record again. Exported records are final: events re-simulated at
+ * steps before the last export are not recorded a second time.
+ *
+ * Time spent in Record* is measured in development builds (GetOverheadPercent,
+ * ActionTD.StatsOverhead); the budget is MaxOverheadPercent of frame time.
+ */
+UCLASS()
+class ACTIONTOWERDEFENSE_API USTMatchStats : public UWorldSubsystem
+{
+    GENERATED_BODY()
+
+public:
+    virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+    virtual void Deinitialize() override;
+
+    /** Convenience helper so other classes can find the collector. */
+    static USTMatchStats* Get(const UObject* WorldContextObject);
+
+    /** Records buffered before an export is forced. */
+    static constexpr int32 RecordCapacity = 16384;
+
+    /** Overhead budget, percent of game-thread time. */
+    static constexpr double MaxOverheadPercent = 1.0;
+
+    // --- Hot path ---
+
+    void RecordShot(const ATowerBase* Tower);
+    void RecordHit(float DamageDealt);
+    void RecordKill(float SecondsAlive);
+    void RecordLeak();
+    void RecordCapture(const ATowerBase* Capturer, float CaptureSeconds);
+
+    /** A tower entered the match: remember its class for the export. */
+    void RegisterTower(const ATowerBase* Tower);
+
+    /**
+     * Damage dealt and kills made while a scope is alive are credited to Tower
+     * (damage goes through IDamageableTarget, which does not carry a source).
+     */
+    struct FDamageSourceScope
+    {
+        FDamageSourceScope(USTMatchStats* InStats, const ATowerBase* Tower);
+        ~FDamageSourceScope();
+
+    private:
+        USTMatchStats* Stats = nullptr;
+        int32 PrevSourceSimId = INDEX_NONE;
+    };
+
+    // --- Export ---
+
+    /** A wave ended: export everything recorded so far. */
+    void NotifyWaveEnded();
+
+    /** Hand the buffered records to a background export. */
+    void FlushToExport();
+
+    /** Drop buffered records newer than SimStep (the simulation was restored to it). */
+    void DiscardAfterStep(uint64 SimStep);
+
+    /** Block until every export task has finished. */
+    void WaitForExports();
+
+    FORCEINLINE int32 GetNumBufferedRecords() const { return Records.Num(); }
+    FORCEINLINE int32 GetNumExports() const { return NumExportsStarted; }
+    FORCEINLINE const FString& GetExportPath() const { return ExportPath; }
+
+    // --- Overhead ---
+
+    /** Time spent recording, as a percent of wall time since the last reset (0 in shipping builds). */
+    double GetOverheadPercent() const;
+    void ResetOverhead();
+
+protected:
+    virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+    void AddRecord(ESTStatEvent Type, int32 TowerSimId, float Value);
+
+    /** Current wave of the level's main spawner. */
+    int16 GetCurrentWave() const;
+
+    UPROPERTY(Transient)
+    USTSimulationClock* SimClock = nullptr;
+
+    UPROPERTY(Transient)
+    USTWorldRegistrySubsystem* Registry = nullptr;
+
+    /** Buffered records, reserved to RecordCapacity. */
+    TArray<FSTStatRecord> Records;
+
+    /**
+     * Second buffer, reserved to RecordCapacity: owned by the running export task,
+     * which empties it when done, and swapped with Records on the next flush.
+     */
+    TArray<FSTStatRecord> SpareRecords;
+
+    /** Towers registered since the last flush (SimId, class name); moved to the next export. */
+    TArray<TPair<int32, FString>> NewTowerClasses;
+
+    /** Tower credited by the active FDamageSourceScope. */
+    int32 DamageSourceSimId = INDEX_NONE;
+
+    /** Match totals; only touched by export tasks (and after WaitForExports). */
+    TSharedPtr<FSTMatchStatsAggregate, ESPMode::ThreadSafe> Aggregate;
+
+    /** Latest export task; it holds SpareRecords until it completes. */
+    UE::Tasks::FTask LastExportTask;
+
+    /** SimStep of the newest exported record. */
+    uint64 ExportedThroughStep = 0;
+
+    FString ExportPath;
+    int32 NumExportsStarted = 0;
+
+    uint64 RecordCycles = 0;
+    double OverheadStartSeconds = 0.0;
+};
@@ -0,0 +1,14 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "STMemoryTags.h"
+
+// Unique names with '_' show as ActionTD/<Subsystem> under the ActionTD parent
+LLM_DEFINE_TAG(ActionTD);
+LLM_DEFINE_TAG(ActionTD_Enemies);
+LLM_DEFINE_TAG(ActionTD_Projectiles);
+LLM_DEFINE_TAG(ActionTD_Towers);
+LLM_DEFINE_TAG(ActionTD_PathVisuals);
+LLM_DEFINE_TAG(ActionTD_UI);
+LLM_DEFINE_TAG(ActionTD_Rewind);
+LLM_DEFINE_TAG(ActionTD_Stats);
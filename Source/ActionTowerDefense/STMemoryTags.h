@@ -0,0 +1,36 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/LowLevelMemTracker.h"
+
+// ========================================================
+// Low-Level Memory tracker tags
+// ========================================================
+//
+// Gameplay allocations are attributed to ActionTD/<Subsystem>, so an LLM capture
+// (-llm, "stat LLMFULL", -llmcsv) shows which subsystem grows as enemy counts
+// scale:
+//
+// - Enemies:      enemy actors and their components (spawner, rewind respawns)
+// - Projectiles:  the projectile pool and the shots towers fire
+// - Towers:       tower actors, their components and upgrades
+// - PathVisuals:  spline mesh components built along the paths
+// - UI:           HUD / panel / end-game widgets
+// - Rewind:       rewind ring buffer, scratch states, match keyframes
+// - Stats:        match stats buffers and exports, perf capture reports
+//
+// ST_LLM_SCOPE(Enemies) tags everything allocated in the enclosing scope.
+// Compiles out where LLM is disabled (Shipping by default).
+
+LLM_DECLARE_TAG_API(ActionTD, ACTIONTOWERDEFENSE_API);
+LLM_DECLARE_TAG_API(ActionTD_Enemies, ACTIONTOWERDEFENSE_API);
+LLM_DECLARE_TAG_API(ActionTD_Projectiles, ACTIONTOWERDEFENSE_API);
+LLM_DECLARE_TAG_API(ActionTD_Towers, ACTIONTOWERDEFENSE_API);
+LLM_DECLARE_TAG_API(ActionTD_PathVisuals, ACTIONTOWERDEFENSE_API);
+LLM_DECLARE_TAG_API(ActionTD_UI, ACTIONTOWERDEFENSE_API);
+LLM_DECLARE_TAG_API(ActionTD_Rewind, ACTIONTOWERDEFENSE_API);
+LLM_DECLARE_TAG_API(ActionTD_Stats, ACTIONTOWERDEFENSE_API);
+
+#define ST_LLM_SCOPE(Tag) LLM_SCOPE_BYTAG(ActionTD_##Tag)
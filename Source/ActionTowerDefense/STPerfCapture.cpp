@@ -0,0 +1,365 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "STPerfCapture.h"
+#include "Engine/World.h"
+#include "HAL/FileManager.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/CommandLine.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Parse.h"
+#include "Misc/Paths.h"
+#include "ProfilingDebugging/CsvProfiler.h"
+#include "STSimulationClock.h"
+#include "STWorldRegistry.h"
+#include "STSpawner.h"
+#include "STMemoryTags.h"
+
+static TAutoConsoleVariable<int32> CVarSTPerfCapture(
+    TEXT("ActionTD.PerfCapture"),
+    0,
+    TEXT("1: record one CSV profiler capture per wave to Saved/ActionTD/Csv/<map>_<time>/ (read when a wave starts)."));
+
+// ========================================================
+// Report
+// ========================================================
+
+namespace STPerfReport
+{
+    /** Per-frame milliseconds for one wave or one speed mode. */
+    struct FSamples
+    {
+        TArray<float> FrameMs;
+        TArray<float> SimMs;
+    };
+
+    static float Percentile(const TArray<float>& Sorted, double P)
+    {
+        if (Sorted.Num() == 0)
+        {
+            return 0.f;
+        }
+
+        const int32 Rank = FMath::Clamp(FMath::CeilToInt(P * Sorted.Num()) - 1, 0, Sorted.Num() - 1);
+        return Sorted[Rank];
+    }
+
+    /** Frames,FrameP50,FrameP90,FrameP95,FrameP99,FrameMax,SimP50,SimP95 */
+    static FString FormatRow(FSamples& Samples)
+    {
+        Samples.FrameMs.Sort();
+        Samples.SimMs.Sort();
+
+        return FString::Printf(TEXT("%d,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f"),
+            Samples.FrameMs.Num(),
+            Percentile(Samples.FrameMs, 0.50),
+            Percentile(Samples.FrameMs, 0.90),
+            Percentile(Samples.FrameMs, 0.95),
+            Percentile(Samples.FrameMs, 0.99),
+            Samples.FrameMs.Num() > 0 ? Samples.FrameMs.Last() : 0.f,
+            Percentile(Samples.SimMs, 0.50),
+            Percentile(Samples.SimMs, 0.95));
+    }
+
+    /** Add every frame of one capture. False if it has no FrameTime column. */
+    static bool ReadCapture(const FString& Path, TMap<int32, FSamples>& ByWave, TMap<float, FSamples>& BySpeed)
+    {
+        TArray<FString> Lines;
+        if (!FFileHelper::LoadFileToStringArray(Lines, *Path) || Lines.Num() < 2)
+        {
+            return false;
+        }
+
+        TArray<FString> Header;
+        Lines[0].ParseIntoArray(Header, TEXT(","), false);
+
+        const int32 FrameColumn = Header.IndexOfByKey(TEXT("FrameTime"));
+        const int32 SimColumn = Header.IndexOfByKey(TEXT("ActionTD/ClockFrame"));
+        const int32 WaveColumn = Header.IndexOfByKey(TEXT("ActionTD/WaveIndex"));
+        const int32 SpeedColumn = Header.IndexOfByKey(TEXT("ActionTD/GameSpeed"));
+
+        if (FrameColumn == INDEX_NONE)
+        {
+            return false;
+        }
+
+        auto ReadFloat = [](const TArray<FString>& Cells, int32 Column, float Default)
+            {
+                return Cells.IsValidIndex(Column) ? FCString::Atof(*Cells[Column]) : Default;
+            };
+
+        TArray<FString> Cells;
+        for (int32 LineIndex = 1; LineIndex < Lines.Num(); ++LineIndex)
+        {
+            const FString& Line = Lines[LineIndex];
+
+            // The header is repeated after the last frame, followed by the metadata row
+            if (Line.Equals(Lines[0]) || Line.StartsWith(TEXT("[")))
+            {
+                break;
+            }
+
+            Line.ParseIntoArray(Cells, TEXT(","), false);
+            if (!Cells.IsValidIndex(FrameColumn))
+            {
+                continue;
+            }
+
+            const float FrameMs = ReadFloat(Cells, FrameColumn, 0.f);
+            const float SimMs = ReadFloat(Cells, SimColumn, 0.f);
+            const int32 Wave = FMath::RoundToInt(ReadFloat(Cells, WaveColumn, INDEX_NONE));
+            const float Speed = ReadFloat(Cells, SpeedColumn, 1.f);
+
+            FSamples& WaveSamples = ByWave.FindOrAdd(Wave);
+            WaveSamples.FrameMs.Add(FrameMs);
+            WaveSamples.SimMs.Add(SimMs);
+
+            FSamples& SpeedSamples = BySpeed.FindOrAdd(Speed);
+            SpeedSamples.FrameMs.Add(FrameMs);
+            SpeedSamples.SimMs.Add(SimMs);
+        }
+
+        return true;
+    }
+}
+
+bool USTPerfCapture::WriteReport(const FString& InCaptureDir, FString* OutReportPath)
+{
+    ST_LLM_SCOPE(Stats);
+
+    TArray<FString> CaptureFiles;
+    IFileManager::Get().FindFilesRecursive(CaptureFiles, *InCaptureDir, TEXT("*.csv"), true, false);
+
+    const FString ReportPath = InCaptureDir / TEXT("PerfReport.csv");
+    CaptureFiles.RemoveAll([](const FString& File)
+        {
+            return FPaths::GetCleanFilename(File) == TEXT("PerfReport.csv");
+        });
+    CaptureFiles.Sort();
+
+    TMap<int32, STPerfReport::FSamples> ByWave;
+    TMap<float, STPerfReport::FSamples> BySpeed;
+
+    int32 NumRead = 0;
+    for (const FString& File : CaptureFiles)
+    {
+        NumRead += STPerfReport::ReadCapture(File, ByWave, BySpeed) ? 1 : 0;
+    }
+
+    if (NumRead == 0)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("PerfCapture: no CSV captures with FrameTime under %s"), *InCaptureDir);
+        return false;
+    }
+
+    ByWave.KeySort(TLess<int32>());
+    BySpeed.KeySort(TLess<float>());
+
+    // One flat table: diffs cleanly between builds and loads in any spreadsheet
+    TArray<FString> Rows;
+    Rows.Add(TEXT("Group,Key,Frames,FrameP50,FrameP90,FrameP95,FrameP99,FrameMax,SimP50,SimP95"));
+
+    for (TPair<int32, STPerfReport::FSamples>& Pair : ByWave)
+    {
+        Rows.Add(FString::Printf(TEXT("Wave,%d,%s"), Pair.Key, *STPerfReport::FormatRow(Pair.Value)));
+    }
+
+    for (TPair<float, STPerfReport::FSamples>& Pair : BySpeed)
+    {
+        Rows.Add(FString::Printf(TEXT("Speed,%gx,%s"), Pair.Key, *STPerfReport::FormatRow(Pair.Value)));
+    }
+
+    if (!FFileHelper::SaveStringArrayToFile(Rows, *ReportPath))
+    {
+        UE_LOG(LogTemp, Warning, TEXT("PerfCapture: could not write %s"), *ReportPath);
+        return false;
+    }
+
+    UE_LOG(LogTemp, Log, TEXT("PerfCapture: report for %d captures -> %s"), NumRead, *ReportPath);
+    for (const FString& Row : Rows)
+    {
+        UE_LOG(LogTemp, Log, TEXT("  %s"), *Row);
+    }
+
+    if (OutReportPath)
+    {
+        *OutReportPath = ReportPath;
+    }
+    return true;
+}
+
+// ========================================================
+// Subsystem
+// ========================================================
+
+void USTPerfCapture::Initialize(FSubsystemCollectionBase& Collection)
+{
+    Super::Initialize(Collection);
+
+    SimClock = Collection.InitializeDependency<USTSimulationClock>();
+    Registry = Collection.InitializeDependency<USTWorldRegistrySubsystem>();
+
+    if (FParse::Param(FCommandLine::Get(), TEXT("ActionTDPerfCapture")))
+    {
+        CVarSTPerfCapture->Set(1, ECVF_SetByCommandline);
+    }
+
+    const FString MapName = GetWorld() ? UWorld::RemovePIEPrefix(GetWorld()->GetMapName()) : TEXT("Match");
+    CaptureDir = FPaths::ProjectSavedDir() / TEXT("ActionTD") / TEXT("Csv")
+        / FString::Printf(TEXT("%s_%s"), *MapName, *FDateTime::Now().ToString());
+
+    // Spawners register in BeginPlay, after world subsystems exist
+    if (Registry)
+    {
+        SpawnerRegisteredHandle = Registry->OnSpawnerRegistered.AddUObject(
+            this, &USTPerfCapture::HandleSpawnerRegistered);
+    }
+}
+
+void USTPerfCapture::Deinitialize()
+{
+    EndCapture();
+
+    if (Registry)
+    {
+        Registry->OnSpawnerRegistered.Remove(SpawnerRegisteredHandle);
+    }
+    SpawnerRegisteredHandle.Reset();
+
+    if (BoundSpawner)
+    {
+        BoundSpawner->OnWaveStarted.RemoveDynamic(this, &USTPerfCapture::HandleWaveStarted);
+        BoundSpawner = nullptr;
+    }
+
+    Super::Deinitialize();
+}
+
+bool USTPerfCapture::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+    return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+USTPerfCapture* USTPerfCapture::Get(const UObject* WorldContextObject)
+{
+    if (!WorldContextObject)
+    {
+        return nullptr;
+    }
+
+    UWorld* World = WorldContextObject->GetWorld();
+    if (!World)
+    {
+        return nullptr;
+    }
+
+    return World->GetSubsystem<USTPerfCapture>();
+}
+
+void USTPerfCapture::HandleSpawnerRegistered(ASTSpawner* Spawner)
+{
+    // Follow the level's main spawner only, like the controller
+    if (!BoundSpawner && Spawner && Registry && Spawner == Registry->GetPrimarySpawner())
+    {
+        BindToSpawner(Spawner);
+    }
+}
+
+void USTPerfCapture::BindToSpawner(ASTSpawner* Spawner)
+{
+    BoundSpawner = Spawner;
+    BoundSpawner->OnWaveStarted.AddDynamic(this, &USTPerfCapture::HandleWaveStarted);
+}
+
+void USTPerfCapture::HandleWaveStarted(int32 WaveIndex, int32 TotalWaves)
+{
+    // Seek replays re-run old waves in one frame: nothing to measure
+    if (SimClock && SimClock->IsReplaying())
+    {
+        return;
+    }
+
+    if (CVarSTPerfCapture.GetValueOnGameThread() <= 0)
+    {
+        EndCapture();
+        return;
+    }
+
+    BeginWaveCapture(WaveIndex, TotalWaves);
+}
+
+void USTPerfCapture::NotifyMatchEnded()
+{
+    EndCapture();
+}
+
+void USTPerfCapture::BeginWaveCapture(int32 WaveIndex, int32 TotalWaves)
+{
+#if CSV_PROFILER
+    FCsvProfiler* Profiler = FCsvProfiler::Get();
+
+    // Someone else's capture: leave it running
+    if (!bOwnsCapture && Profiler->IsCapturing())
+    {
+        return;
+    }
+
+    // Queued: the profiler ends the previous file before starting this one
+    EndCapture();
+
+    const FString MapName = GetWorld() ? UWorld::RemovePIEPrefix(GetWorld()->GetMapName()) : FString();
+    CSV_METADATA(TEXT("ActionTD.Map"), *MapName);
+    CSV_METADATA(TEXT("ActionTD.Wave"), *FString::FromInt(WaveIndex));
+    CSV_METADATA(TEXT("ActionTD.TotalWaves"), *FString::FromInt(TotalWaves));
+
+    Profiler->BeginCapture(-1, CaptureDir, FString::Printf(TEXT("Wave_%02d.csv"), WaveIndex));
+    bOwnsCapture = true;
+
+    UE_LOG(LogTemp, Log, TEXT("PerfCapture: wave %d/%d -> %s"), WaveIndex + 1, TotalWaves, *CaptureDir);
+#endif
+}
+
+void USTPerfCapture::EndCapture()
+{
+#if CSV_PROFILER
+    if (bOwnsCapture)
+    {
+        FCsvProfiler::Get()->EndCapture();
+        bOwnsCapture = false;
+    }
+#endif
+}
+
+// ========================================================
+// Console
+// ========================================================
+
+#if !UE_BUILD_SHIPPING
+
+static FAutoConsoleCommandWithWorldAndArgs GSTPerfReportCommand(
+    TEXT("ActionTD.PerfReport"),
+    TEXT("Write PerfReport.csv (FrameTime percentiles per wave and per game speed) for this match's captures, or for the folder given."),
+    FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+        {
+            FString Dir;
+            if (Args.Num() > 0)
+            {
+                Dir = Args[0];
+            }
+            else if (const USTPerfCapture* Capture = USTPerfCapture::Get(World))
+            {
+                // The profiler writes a capture out a frame after it ends: a wave
+                // still being captured is not in the report yet
+                Dir = Capture->GetCaptureDir();
+            }
+
+            if (Dir.IsEmpty())
+            {
+                UE_LOG(LogTemp, Warning, TEXT("PerfCapture: usage ActionTD.PerfReport [CaptureDir]"));
+                return;
+            }
+
+            USTPerfCapture::WriteReport(Dir);
+        }));
+
+#endif // !UE_BUILD_SHIPPING
@@ -0,0 +1,88 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "STPerfCapture.generated.h"
+
+class ASTSpawner;
+class USTSimulationClock;
+class USTWorldRegistrySubsystem;
+
+/**
+ * Per-wave CSV profiler captures and the frame-time report built from them.
+ *
+ * With ActionTD.PerfCapture 1 (or -ActionTDPerfCapture on the command line),
+ * every OnWaveStarted of the level's main spawner ends the previous capture and
+ * starts a new one, so each wave lands in its own file:
+ *
+ *   Saved/ActionTD/Csv/<map>_<time>/Wave_<NN>.csv
+ *
+ * The match's last capture ends at victory / defeat (or when the world goes
+ * away). Besides the engine's own columns (FrameTime, GameThreadTime, ...) each
+ * frame carries the ActionTD/* columns: one timer per simulation phase and
+ * subsystem, entity counts, GameSpeed and WaveIndex (see STStatGroup.h).
+ *
+ * WriteReport reads every capture in a folder and writes PerfReport.csv next to
+ * them: FrameTime percentiles (and the simulation's own share) per wave and per
+ * game-speed mode. Two builds' reports for the same map diff line by line.
+ * Run it with ActionTD.PerfReport once a match is over.
+ *
+ * Captures started some other way (csvprofile start, -csvCaptureFrames) are
+ * left alone. Compiled out where the CSV profiler is (Shipping by default).
+ */
+UCLASS()
+class ACTIONTOWERDEFENSE_API USTPerfCapture : public UWorldSubsystem
+{
+    GENERATED_BODY()
+
+public:
+    virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+    virtual void Deinitialize() override;
+
+    /** Convenience helper so other classes can find the capture subsystem. */
+    static USTPerfCapture* Get(const UObject* WorldContextObject);
+
+    /** The match is over: end the last wave's capture. */
+    void NotifyMatchEnded();
+
+    /** Folder this match's captures go to. */
+    FORCEINLINE const FString& GetCaptureDir() const { return CaptureDir; }
+
+    FORCEINLINE bool IsCapturing() const { return bOwnsCapture; }
+
+    /**
+     * Build the percentile report for every .csv under CaptureDir and write it to
+     * CaptureDir/PerfReport.csv. Returns false if no capture had frame times.
+     */
+    static bool WriteReport(const FString& InCaptureDir, FString* OutReportPath = nullptr);
+
+protected:
+    virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+    void BindToSpawner(ASTSpawner* Spawner);
+    void HandleSpawnerRegistered(ASTSpawner* Spawner);
+
+    UFUNCTION()
+    void HandleWaveStarted(int32 WaveIndex, int32 TotalWaves);
+
+    void BeginWaveCapture(int32 WaveIndex, int32 TotalWaves);
+    void EndCapture();
+
+    UPROPERTY(Transient)
+    USTSimulationClock* SimClock = nullptr;
+
+    UPROPERTY(Transient)
+    USTWorldRegistrySubsystem* Registry = nullptr;
+
+    UPROPERTY(Transient)
+    ASTSpawner* BoundSpawner = nullptr;
+
+    FDelegateHandle SpawnerRegisteredHandle;
+
+    FString CaptureDir;
+
+    /** We started the capture in progress (and so may end it). */
+    bool bOwnsCapture = false;
+};
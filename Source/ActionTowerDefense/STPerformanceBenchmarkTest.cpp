@@ -0,0 +1,399 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+// Headless performance benchmark: ActionTD.Perf.Benchmark
+//
+// Builds its own benchmark level in a fresh game world (a long straight path, a
+// fixed grid of attack towers along it, one spawner) and drives a deterministic
+// wave set that brings the number of enemies alive up through 100, 1,000, 5,000
+// and 10,000. Enemies are made unkillable for the run so every tier holds its
+// count while the towers keep acquiring targets and firing.
+//
+// At each tier it measures a fixed number of fixed-delta frames and records
+// mean / p95 / p99 frame time, game-thread (world tick) time and memory, then
+// writes Saved/ActionTD/Benchmark/Benchmark_<time>.json.
+//
+// Runs without a GPU:
+//
+//   UnrealEditor-Cmd ActionTowerDefense.uproject -nullrhi -unattended -nosplash
+//       -ExecCmds="Automation RunTests ActionTD.Perf.Benchmark; Quit"
+
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "Components/SplineComponent.h"
+#include "Containers/Ticker.h"
+#include "Async/TaskGraphInterfaces.h"
+#include "HAL/PlatformMemory.h"
+#include "Misc/App.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Dom/JsonObject.h"
+#include "Serialization/JsonWriter.h"
+#include "Serialization/JsonSerializer.h"
+#include "STSimulationClock.h"
+#include "STSpawner.h"
+#include "STWaveSet.h"
+#include "EnemyBase.h"
+#include "AttackTowerBase.h"
+#include "Projectile.h"
+
+namespace STPerfBenchmark
+{
+    /** Enemies alive at each measured tier. */
+    static const int32 Tiers[] = { 100, 1000, 5000, 10000 };
+
+    constexpr float FrameSeconds = 1.f / 60.f;   // one default simulation substep per frame
+    constexpr int32 EnemiesPerLane = 100;         // each lane spawns one enemy per SpawnInterval
+    constexpr float SpawnInterval = 0.01f;
+    constexpr int32 MaxRampFrames = 1200;         // a tier that cannot fill up in 20 s fails
+    constexpr int32 WarmupFrames = 60;
+    constexpr int32 MeasureFrames = 300;
+
+    constexpr float PathLength = 200000.f;
+    constexpr int32 NumTowers = 16;
+    constexpr float TowerSpacing = 600.f;
+    constexpr float TowerOffset = 400.f;          // distance from the path, alternating sides
+
+    /** Write a UPROPERTY by name (benchmark setup touches protected config). */
+    template <typename T>
+    static bool SetProperty(UObject* Object, FName Name, const T& Value)
+    {
+        FProperty* Property = FindFProperty<FProperty>(Object->GetClass(), Name);
+        if (!Property || Property->GetElementSize() != sizeof(T))
+        {
+            return false;
+        }
+
+        *Property->ContainerPtrToValuePtr<T>(Object) = Value;
+        return true;
+    }
+
+    static bool SetBoolProperty(UObject* Object, FName Name, bool bValue)
+    {
+        FBoolProperty* Property = FindFProperty<FBoolProperty>(Object->GetClass(), Name);
+        if (!Property)
+        {
+            return false;
+        }
+
+        Property->SetPropertyValue_InContainer(Object, bValue);
+        return true;
+    }
+
+    /** Makes ASTEnemyBase unkillable for the run; restores the defaults after. */
+    struct FEnemyDefaultsScope
+    {
+        FEnemyDefaultsScope()
+        {
+            UObject* Defaults = ASTEnemyBase::StaticClass()->GetDefaultObject();
+            if (const FFloatProperty* Property = FindFProperty<FFloatProperty>(ASTEnemyBase::StaticClass(), TEXT("MaxHealth")))
+            {
+                SavedMaxHealth = Property->GetPropertyValue_InContainer(Defaults);
+            }
+            SetProperty(Defaults, TEXT("MaxHealth"), 1.0e9f);
+        }
+
+        ~FEnemyDefaultsScope()
+        {
+            SetProperty(ASTEnemyBase::StaticClass()->GetDefaultObject(), TEXT("MaxHealth"), SavedMaxHealth);
+        }
+
+        float SavedMaxHealth = 100.f;
+    };
+
+    struct FTierResult
+    {
+        int32 Enemies = 0;
+        int32 Frames = 0;
+        double FrameMeanMs = 0.0;
+        double FrameP95Ms = 0.0;
+        double FrameP99Ms = 0.0;
+        double GameThreadMeanMs = 0.0;
+        double GameThreadP95Ms = 0.0;
+        double UsedPhysicalMB = 0.0;
+        double PeakUsedPhysicalMB = 0.0;
+    };
+
+    static double Percentile(const TArray<double>& Sorted, double P)
+    {
+        if (Sorted.Num() == 0)
+        {
+            return 0.0;
+        }
+
+        const int32 Rank = FMath::Clamp(FMath::CeilToInt(P * Sorted.Num()) - 1, 0, Sorted.Num() - 1);
+        return Sorted[Rank];
+    }
+
+    static double Mean(const TArray<double>& Values)
+    {
+        double Sum = 0.0;
+        for (double Value : Values)
+        {
+            Sum += Value;
+        }
+        return Values.Num() > 0 ? Sum / Values.Num() : 0.0;
+    }
+
+    /** The benchmark wave set: wave N tops the enemies alive up to Tiers[N]. */
+    static USTWaveSet* MakeWaveSet()
+    {
+        USTWaveSet* WaveSet = NewObject<USTWaveSet>(GetTransientPackage());
+
+        int32 Alive = 0;
+        for (int32 Tier : Tiers)
+        {
+            FSTWave& Wave = WaveSet->Waves.AddDefaulted_GetRef();
+            Wave.WaveName = *FString::Printf(TEXT("Tier_%d"), Tier);
+            Wave.TimeBeforeWave = FrameSeconds; // a zero countdown never fires
+
+            const int32 NumToAdd = Tier - Alive;
+            const int32 NumLanes = FMath::DivideAndRoundUp(NumToAdd, EnemiesPerLane);
+            for (int32 LaneIndex = 0; LaneIndex < NumLanes; ++LaneIndex)
+            {
+                FSTSpawnLane& Lane = Wave.Lanes.AddDefaulted_GetRef();
+                Lane.EnemyClass = ASTEnemyBase::StaticClass();
+                Lane.NumToSpawn = FMath::Min(EnemiesPerLane, NumToAdd - LaneIndex * EnemiesPerLane);
+                Lane.Interval = SpawnInterval;
+                Lane.Jitter = 0.f; // deterministic
+            }
+
+            Alive = Tier;
+        }
+
+        return WaveSet;
+    }
+
+    /** Straight path, the spawner at its start, towers on both sides of its first stretch. */
+    static ASTSpawner* BuildLevel(UWorld* World, USTWaveSet* WaveSet)
+    {
+        FActorSpawnParameters Params;
+        Params.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+        AActor* Path = World->SpawnActor<AActor>(AActor::StaticClass(), FTransform::Identity, Params);
+        USplineComponent* Spline = NewObject<USplineComponent>(Path, TEXT("BenchPath"));
+        Path->SetRootComponent(Spline);
+        Spline->RegisterComponent();
+        Spline->ClearSplinePoints(false);
+        Spline->AddSplinePoint(FVector::ZeroVector, ESplineCoordinateSpace::World, false);
+        Spline->AddSplinePoint(FVector(PathLength, 0.f, 0.f), ESplineCoordinateSpace::World, true);
+
+        for (int32 Index = 0; Index < NumTowers; ++Index)
+        {
+            const float Side = (Index % 2 == 0) ? 1.f : -1.f;
+            const FTransform TowerTransform(FVector((Index / 2 + 1) * TowerSpacing, Side * TowerOffset, 0.f));
+
+            AAttackTowerBase* Tower = World->SpawnActorDeferred<AAttackTowerBase>(
+                AAttackTowerBase::StaticClass(), TowerTransform, nullptr, nullptr,
+                ESpawnActorCollisionHandlingMethod::AlwaysSpawn);
+            if (!Tower)
+            {
+                continue;
+            }
+
+            SetProperty(Tower, TEXT("ProjectileClass"), TSubclassOf<AProjectile>(AProjectile::StaticClass()));
+            Tower->SetTeam(ETowerTeam::Player);
+            Tower->FinishSpawning(TowerTransform);
+        }
+
+        ASTSpawner* Spawner = World->SpawnActorDeferred<ASTSpawner>(
+            ASTSpawner::StaticClass(), FTransform::Identity, nullptr, nullptr,
+            ESpawnActorCollisionHandlingMethod::AlwaysSpawn);
+        if (!Spawner)
+        {
+            return nullptr;
+        }
+
+        Spawner->Path = Path;
+        SetProperty(Spawner, TEXT("WaveSet"), WaveSet);
+        SetBoolProperty(Spawner, TEXT("bAutoStartNextWave"), false); // the benchmark starts each tier
+        SetBoolProperty(Spawner, TEXT("bStartOnBeginPlay"), true);
+        SetBoolProperty(Spawner, TEXT("bLogSpawns"), false);
+        Spawner->FinishSpawning(FTransform::Identity);
+
+        return Spawner;
+    }
+
+    static int32 CountAlive(const USTSimulationClock* Clock)
+    {
+        int32 Alive = 0;
+        for (const ASTEnemyBase* Enemy : Clock->GetEnemies())
+        {
+            Alive += Enemy ? 1 : 0;
+        }
+        return Alive;
+    }
+
+    /** One frame: the world tick (game thread) plus what the engine loop would pump around it. */
+    static double TickFrame(UWorld* World, double& OutGameThreadMs)
+    {
+        const uint64 FrameStart = FPlatformTime::Cycles64();
+
+        World->Tick(LEVELTICK_All, FrameSeconds);
+        const uint64 TickEnd = FPlatformTime::Cycles64();
+
+        FTSTicker::GetCoreTicker().Tick(FrameSeconds);
+        FTaskGraphInterface::Get().ProcessThreadUntilIdle(ENamedThreads::GameThread);
+
+        const uint64 FrameEnd = FPlatformTime::Cycles64();
+        OutGameThreadMs = FPlatformTime::ToMilliseconds64(TickEnd - FrameStart);
+        return FPlatformTime::ToMilliseconds64(FrameEnd - FrameStart);
+    }
+
+    static FTierResult MeasureTier(UWorld* World, int32 Tier)
+    {
+        TArray<double> FrameMs;
+        TArray<double> GameThreadMs;
+        FrameMs.Reserve(MeasureFrames);
+        GameThreadMs.Reserve(MeasureFrames);
+
+        double TickMs = 0.0;
+        for (int32 Frame = 0; Frame < WarmupFrames; ++Frame)
+        {
+            TickFrame(World, TickMs);
+        }
+
+        for (int32 Frame = 0; Frame < MeasureFrames; ++Frame)
+        {
+            FrameMs.Add(TickFrame(World, TickMs));
+            GameThreadMs.Add(TickMs);
+        }
+
+        const FPlatformMemoryStats Memory = FPlatformMemory::GetStats();
+
+        FTierResult Result;
+        Result.Enemies = Tier;
+        Result.Frames = FrameMs.Num();
+        Result.FrameMeanMs = Mean(FrameMs);
+        Result.GameThreadMeanMs = Mean(GameThreadMs);
+
+        FrameMs.Sort();
+        GameThreadMs.Sort();
+        Result.FrameP95Ms = Percentile(FrameMs, 0.95);
+        Result.FrameP99Ms = Percentile(FrameMs, 0.99);
+        Result.GameThreadP95Ms = Percentile(GameThreadMs, 0.95);
+        Result.UsedPhysicalMB = Memory.UsedPhysical / (1024.0 * 1024.0);
+        Result.PeakUsedPhysicalMB = Memory.PeakUsedPhysical / (1024.0 * 1024.0);
+        return Result;
+    }
+
+    static bool WriteResults(const TArray<FTierResult>& Results, FString& OutPath)
+    {
+        TSharedRef<FJsonObject> Root = MakeShared<FJsonObject>();
+        Root->SetStringField(TEXT("benchmark"), TEXT("ActionTD.Perf.Benchmark"));
+        Root->SetStringField(TEXT("build"), FApp::GetBuildVersion());
+        Root->SetStringField(TEXT("configuration"), LexToString(FApp::GetBuildConfiguration()));
+        Root->SetStringField(TEXT("platform"), FPlatformProperties::IniPlatformName());
+        Root->SetStringField(TEXT("time"), FDateTime::UtcNow().ToIso8601());
+        Root->SetNumberField(TEXT("frameSeconds"), FrameSeconds);
+        Root->SetNumberField(TEXT("towers"), NumTowers);
+
+        TArray<TSharedPtr<FJsonValue>> TierValues;
+        for (const FTierResult& Result : Results)
+        {
+            TSharedRef<FJsonObject> Tier = MakeShared<FJsonObject>();
+            Tier->SetNumberField(TEXT("enemies"), Result.Enemies);
+            Tier->SetNumberField(TEXT("frames"), Result.Frames);
+            Tier->SetNumberField(TEXT("frameMeanMs"), Result.FrameMeanMs);
+            Tier->SetNumberField(TEXT("frameP95Ms"), Result.FrameP95Ms);
+            Tier->SetNumberField(TEXT("frameP99Ms"), Result.FrameP99Ms);
+            Tier->SetNumberField(TEXT("gameThreadMeanMs"), Result.GameThreadMeanMs);
+            Tier->SetNumberField(TEXT("gameThreadP95Ms"), Result.GameThreadP95Ms);
+            Tier->SetNumberField(TEXT("usedPhysicalMB"), Result.UsedPhysicalMB);
+            Tier->SetNumberField(TEXT("peakUsedPhysicalMB"), Result.PeakUsedPhysicalMB);
+            TierValues.Add(MakeShared<FJsonValueObject>(Tier));
+        }
+        Root->SetArrayField(TEXT("tiers"), TierValues);
+
+        FString Json;
+        const TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&Json);
+        if (!FJsonSerializer::Serialize(Root, Writer))
+        {
+            return false;
+        }
+
+        OutPath = FPaths::ProjectSavedDir() / TEXT("ActionTD") / TEXT("Benchmark")
+            / FString::Printf(TEXT("Benchmark_%s.json"), *FDateTime::Now().ToString());
+        return FFileHelper::SaveStringToFile(Json, *OutPath);
+    }
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSTPerformanceBenchmarkTest, "ActionTD.Perf.Benchmark",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::PerfFilter)
+
+bool FSTPerformanceBenchmarkTest::RunTest(const FString& Parameters)
+{
+    using namespace STPerfBenchmark;
+
+    STPerfBenchmark::FEnemyDefaultsScope EnemyDefaults;
+
+    // Own game world, so the benchmark does not depend on (or disturb) a loaded map
+    UWorld* World = UWorld::CreateWorld(EWorldType::Game, false, TEXT("ActionTDBenchmark"));
+    FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+    WorldContext.SetCurrentWorld(World);
+
+    const FURL URL;
+    World->SetGameMode(URL);
+    World->InitializeActorsForPlay(URL);
+    World->BeginPlay();
+
+    USTSimulationClock* Clock = USTSimulationClock::Get(World);
+    ASTSpawner* Spawner = Clock ? BuildLevel(World, MakeWaveSet()) : nullptr;
+
+    TArray<FTierResult> Results;
+
+    if (TestNotNull(TEXT("Simulation clock"), Clock) && TestNotNull(TEXT("Benchmark spawner"), Spawner))
+    {
+        for (int32 TierIndex = 0; TierIndex < UE_ARRAY_COUNT(Tiers); ++TierIndex)
+        {
+            const int32 Tier = Tiers[TierIndex];
+
+            // Wave 0 starts on its own; later tiers once the previous one is measured
+            if (TierIndex > 0)
+            {
+                Spawner->RequestNextWaveNow();
+            }
+
+            double TickMs = 0.0;
+            int32 RampFrames = 0;
+            while (CountAlive(Clock) < Tier && RampFrames < MaxRampFrames)
+            {
+                TickFrame(World, TickMs);
+                ++RampFrames;
+            }
+
+            if (!TestTrue(FString::Printf(TEXT("%d enemies alive after %d frames"), Tier, RampFrames), CountAlive(Clock) >= Tier))
+            {
+                break;
+            }
+
+            const FTierResult& Result = Results.Add_GetRef(MeasureTier(World, Tier));
+
+            AddInfo(FString::Printf(
+                TEXT("%5d enemies | frame mean %.2f ms p95 %.2f ms p99 %.2f ms | game thread mean %.2f ms p95 %.2f ms | %.0f MB (peak %.0f MB)"),
+                Result.Enemies, Result.FrameMeanMs, Result.FrameP95Ms, Result.FrameP99Ms,
+                Result.GameThreadMeanMs, Result.GameThreadP95Ms,
+                Result.UsedPhysicalMB, Result.PeakUsedPhysicalMB));
+        }
+    }
+
+    GEngine->DestroyWorldContext(World);
+    World->DestroyWorld(false);
+
+    if (Results.Num() > 0)
+    {
+        FString ResultsPath;
+        if (TestTrue(TEXT("Write benchmark results"), WriteResults(Results, ResultsPath)))
+        {
+            AddInfo(FString::Printf(TEXT("Results: %s"), *ResultsPath));
+        }
+    }
+
+    return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -11,6 +11,8 @@
 #include "GameFramework/PlayerController.h"
 #include "STGameController.h"
 #include "USTTowerActionPanelWidget.h"
+#include "STMemoryTags.h"
+#include "STMatchRecorder.h"
 
 ASTPlayerController::ASTPlayerController()
 {
@@ -54,6 +56,8 @@ void ASTPlayerController::BeginPlay()
     InputMode.SetHideCursorDuringCapture(false);
     SetInputMode(InputMode);
 
+    ST_LLM_SCOPE(UI);
+
     if (HUDWidgetClass)
     {
         HUDWidget = CreateWidget<USTHUDWidget>(this, HUDWidgetClass);
@@ -175,6 +179,9 @@ void ASTPlayerController::SetSelectedTower(ATowerBase* NewTower)
     if (SelectedTower == NewTower)
         return;
 
+    if (!USTMatchRecorder::ShouldRunCommand(this, ESTPlayerCommand::SelectTower, NewTower))
+        return;
+
     // Turn off selection on previous tower
     if (SelectedTower)
     {
@@ -16,6 +16,9 @@ class ACTIONTOWERDEFENSE_API ASTPlayerController : public APlayerController
 {
     GENERATED_BODY()
 
+    // Replays select towers through SetSelectedTower like a click does
+    friend class USTMatchRecorder;
+
 public:
     ASTPlayerController();
 
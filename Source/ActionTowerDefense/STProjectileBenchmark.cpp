@@ -0,0 +1,114 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+// Dev-only console command comparing the per-projectile simulation step cost
+// of homing shots against straight lead shots:
+//
+//   ActionTD.BenchProjectileModes [NumProjectiles=500] [NumFrames=120]
+
+#include "CoreMinimal.h"
+#include "HAL/IConsoleManager.h"
+#include "Engine/World.h"
+#include "Components/SceneComponent.h"
+#include "Projectile.h"
+
+#if !UE_BUILD_SHIPPING
+
+namespace STProjectileBenchmark
+{
+    /** Average microseconds per projectile per simulation substep for one mode. */
+    static double RunMode(UWorld* World, AActor* Target, bool bHoming, int32 NumProjectiles, int32 NumFrames)
+    {
+        constexpr float Speed = 2000.f;
+        constexpr float HomingAcceleration = 8000.f;
+        constexpr float FrameDelta = 1.f / 60.f; // one default simulation substep
+
+        FActorSpawnParameters Params;
+        Params.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+        TArray<AProjectile*> Projectiles;
+        Projectiles.Reserve(NumProjectiles);
+
+        for (int32 Index = 0; Index < NumProjectiles; ++Index)
+        {
+            // Spread out on a line so nothing overlaps
+            const FVector SpawnLoc(0.f, Index * 200.f, 10000.f);
+
+            AProjectile* Projectile = World->SpawnActor<AProjectile>(
+                AProjectile::StaticClass(),
+                FTransform((Target->GetActorLocation() - SpawnLoc).Rotation(), SpawnLoc),
+                Params);
+
+            if (!Projectile)
+            {
+                continue;
+            }
+
+            // Target is far enough away that no shot reaches it: steering + movement
+            // + hit test only, no damage handling
+            Projectile->InitProjectile(Target, 0.f, Speed, bHoming, HomingAcceleration);
+
+            Projectiles.Add(Projectile);
+        }
+
+        const uint64 StartCycles = FPlatformTime::Cycles64();
+
+        for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+        {
+            for (AProjectile* Projectile : Projectiles)
+            {
+                Projectile->SimStep(FrameDelta);
+            }
+        }
+
+        const double TotalSeconds = FPlatformTime::ToSeconds64(FPlatformTime::Cycles64() - StartCycles);
+
+        for (AProjectile* Projectile : Projectiles)
+        {
+            Projectile->Destroy();
+        }
+
+        const int32 NumUpdates = FMath::Max(1, Projectiles.Num() * NumFrames);
+        return TotalSeconds * 1.0e6 / NumUpdates;
+    }
+
+    static void Run(const TArray<FString>& Args, UWorld* World)
+    {
+        if (!World)
+        {
+            return;
+        }
+
+        const int32 NumProjectiles = Args.Num() > 0 ? FMath::Max(1, FCString::Atoi(*Args[0])) : 500;
+        const int32 NumFrames = Args.Num() > 1 ? FMath::Max(1, FCString::Atoi(*Args[1])) : 120;
+
+        // Plain actor with a root component to home in on
+        AActor* Target = World->SpawnActor<AActor>(AActor::StaticClass(), FTransform(FVector(50000.f, 0.f, 10000.f)));
+        if (!Target)
+        {
+            return;
+        }
+
+        USceneComponent* TargetRoot = NewObject<USceneComponent>(Target, TEXT("BenchTargetRoot"));
+        Target->SetRootComponent(TargetRoot);
+        TargetRoot->RegisterComponent();
+        TargetRoot->SetWorldLocation(FVector(50000.f, 0.f, 10000.f));
+
+        const double StraightMicros = RunMode(World, Target, false, NumProjectiles, NumFrames);
+        const double HomingMicros = RunMode(World, Target, true, NumProjectiles, NumFrames);
+
+        Target->Destroy();
+
+        UE_LOG(LogTemp, Log,
+            TEXT("BenchProjectileModes: %d projectiles x %d steps | straight %.3f us/step | homing %.3f us/step | homing costs %.2fx"),
+            NumProjectiles, NumFrames,
+            StraightMicros, HomingMicros,
+            StraightMicros > 0.0 ? HomingMicros / StraightMicros : 0.0);
+    }
+}
+
+static FAutoConsoleCommandWithWorldAndArgs GSTBenchProjectileModesCommand(
+    TEXT("ActionTD.BenchProjectileModes"),
+    TEXT("Compare per-projectile simulation step cost of homing vs straight lead shots. Args: [NumProjectiles] [NumFrames]"),
+    FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&STProjectileBenchmark::Run));
+
+#endif // !UE_BUILD_SHIPPING
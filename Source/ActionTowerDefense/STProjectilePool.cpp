@@ -0,0 +1,281 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "STProjectilePool.h"
+#include "Projectile.h"
+#include "Engine/World.h"
+#include "Algo/StableSort.h"
+#include "STTrace.h"
+#include "STMemoryTags.h"
+#include "STFlightRecorder.h"
+
+void USTProjectilePoolSubsystem::Deinitialize()
+{
+    // Pooled actors belong to the level and are destroyed with it
+    Buckets.Reset();
+    ActiveProjectiles.Reset();
+
+    Super::Deinitialize();
+}
+
+void USTProjectilePoolSubsystem::SimStep(float StepSeconds)
+{
+    ST_TRACE_CPUSCOPE(ActionTD_ProjectilePool_SimStep);
+
+    // Backwards: a hit releases the projectile, which swaps the last entry
+    // (already stepped) into its slot
+    for (int32 Index = ActiveProjectiles.Num() - 1; Index >= 0; --Index)
+    {
+        if (!ActiveProjectiles.IsValidIndex(Index))
+        {
+            continue;
+        }
+
+        AProjectile* Projectile = ActiveProjectiles[Index];
+        if (IsValid(Projectile))
+        {
+            Projectile->SimStep(StepSeconds);
+        }
+    }
+}
+
+void USTProjectilePoolSubsystem::UpdatePresentation(float Alpha)
+{
+    for (AProjectile* Projectile : ActiveProjectiles)
+    {
+        if (IsValid(Projectile))
+        {
+            Projectile->UpdatePresentation(Alpha);
+        }
+    }
+}
+
+USTProjectilePoolSubsystem* USTProjectilePoolSubsystem::Get(const UObject* WorldContextObject)
+{
+    if (!WorldContextObject)
+    {
+        return nullptr;
+    }
+
+    UWorld* World = WorldContextObject->GetWorld();
+    if (!World)
+    {
+        return nullptr;
+    }
+
+    return World->GetSubsystem<USTProjectilePoolSubsystem>();
+}
+
+int32 USTProjectilePoolSubsystem::FindOrAddBucket(UClass* TowerClass, UClass* ProjectileClass)
+{
+    ST_LLM_SCOPE(Projectiles);
+
+    for (int32 Index = 0; Index < Buckets.Num(); ++Index)
+    {
+        const FSTProjectilePoolBucket& Bucket = Buckets[Index];
+        if (Bucket.TowerClass == TowerClass && Bucket.ProjectileClass == ProjectileClass)
+        {
+            return Index;
+        }
+    }
+
+    FSTProjectilePoolBucket& NewBucket = Buckets.AddDefaulted_GetRef();
+    NewBucket.TowerClass = TowerClass;
+    NewBucket.ProjectileClass = ProjectileClass;
+    return Buckets.Num() - 1;
+}
+
+AProjectile* USTProjectilePoolSubsystem::SpawnPooledProjectile(int32 BucketIndex)
+{
+    ST_LLM_SCOPE(Projectiles);
+
+    UWorld* World = GetWorld();
+    if (!World || !Buckets.IsValidIndex(BucketIndex))
+    {
+        return nullptr;
+    }
+
+    FActorSpawnParameters Params;
+    Params.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+    AProjectile* Projectile = World->SpawnActor<AProjectile>(
+        Buckets[BucketIndex].ProjectileClass,
+        FTransform::Identity,
+        Params
+    );
+
+    if (Projectile)
+    {
+        Projectile->PoolBucketIndex = BucketIndex;
+        Projectile->DeactivateToPool();
+        ST_FLIGHT_EVENT(PoolGrow, BucketIndex);
+    }
+
+    return Projectile;
+}
+
+void USTProjectilePoolSubsystem::ReservePool(UClass* TowerClass, TSubclassOf<AProjectile> ProjectileClass, int32 Count)
+{
+    if (!TowerClass || !ProjectileClass || Count <= 0)
+    {
+        return;
+    }
+
+    const int32 BucketIndex = FindOrAddBucket(TowerClass, ProjectileClass);
+    Buckets[BucketIndex].ReservedSize += Count;
+
+    // Top up the free list so the whole reservation exists before the first shot
+    while (Buckets[BucketIndex].FreeProjectiles.Num() + Buckets[BucketIndex].NumActive < Buckets[BucketIndex].ReservedSize)
+    {
+        AProjectile* Projectile = SpawnPooledProjectile(BucketIndex);
+        if (!Projectile)
+        {
+            break;
+        }
+
+        Buckets[BucketIndex].FreeProjectiles.Add(Projectile);
+    }
+}
+
+AProjectile* USTProjectilePoolSubsystem::AcquireProjectile(AActor* OwnerTower,
+    TSubclassOf<AProjectile> ProjectileClass,
+    const FTransform& SpawnTransform)
+{
+    if (!OwnerTower || !ProjectileClass)
+    {
+        return nullptr;
+    }
+
+    const int32 BucketIndex = FindOrAddBucket(OwnerTower->GetClass(), ProjectileClass);
+
+    AProjectile* Projectile = AcquireFromBucket(BucketIndex, OwnerTower, SpawnTransform);
+    if (Projectile)
+    {
+        Projectile->SimId = NextProjectileSimId++;
+    }
+
+    return Projectile;
+}
+
+AProjectile* USTProjectilePoolSubsystem::AcquireForRestore(int32 BucketIndex, int32 SimId, AActor* OwnerTower,
+    const FTransform& SpawnTransform)
+{
+    if (!Buckets.IsValidIndex(BucketIndex))
+    {
+        return nullptr;
+    }
+
+    AProjectile* Projectile = AcquireFromBucket(BucketIndex, OwnerTower, SpawnTransform);
+    if (Projectile)
+    {
+        Projectile->SimId = SimId;
+    }
+
+    return Projectile;
+}
+
+AProjectile* USTProjectilePoolSubsystem::AcquireFromBucket(int32 BucketIndex, AActor* OwnerTower,
+    const FTransform& SpawnTransform)
+{
+    AProjectile* Projectile = nullptr;
+
+    // Skip anything that was destroyed behind our back (level streaming etc.)
+    while (!Projectile && Buckets[BucketIndex].FreeProjectiles.Num() > 0)
+    {
+        AProjectile* Candidate = Buckets[BucketIndex].FreeProjectiles.Pop(EAllowShrinking::No);
+        if (IsValid(Candidate))
+        {
+            Projectile = Candidate;
+        }
+    }
+
+    // Pool exhausted: grow it rather than dropping the shot
+    if (!Projectile)
+    {
+        Projectile = SpawnPooledProjectile(BucketIndex);
+        if (!Projectile)
+        {
+            return nullptr;
+        }
+    }
+
+    Buckets[BucketIndex].NumActive++;
+
+    Projectile->ActiveIndex = ActiveProjectiles.Add(Projectile);
+    ST_FLIGHT_EVENT(ProjectileShot, BucketIndex, ActiveProjectiles.Num());
+
+    Projectile->ActivateFromPool(SpawnTransform, OwnerTower, OwnerTower ? OwnerTower->GetInstigator() : nullptr);
+    return Projectile;
+}
+
+void USTProjectilePoolSubsystem::ReleaseProjectile(AProjectile* Projectile)
+{
+    if (!Projectile || !Buckets.IsValidIndex(Projectile->PoolBucketIndex))
+    {
+        return;
+    }
+
+    Projectile->DeactivateToPool();
+
+    // Swap-remove from the in-flight list and patch the moved projectile's slot
+    const int32 Slot = Projectile->ActiveIndex;
+    if (ActiveProjectiles.IsValidIndex(Slot) && ActiveProjectiles[Slot] == Projectile)
+    {
+        ActiveProjectiles.RemoveAtSwap(Slot, EAllowShrinking::No);
+        if (ActiveProjectiles.IsValidIndex(Slot) && ActiveProjectiles[Slot])
+        {
+            ActiveProjectiles[Slot]->ActiveIndex = Slot;
+        }
+    }
+    Projectile->ActiveIndex = INDEX_NONE;
+
+    FSTProjectilePoolBucket& Bucket = Buckets[Projectile->PoolBucketIndex];
+    Bucket.NumActive = FMath::Max(0, Bucket.NumActive - 1);
+    Bucket.FreeProjectiles.Add(Projectile);
+}
+
+void USTProjectilePoolSubsystem::SetActiveOrder(TConstArrayView<int32> SimIds)
+{
+    TMap<int32, int32> Rank;
+    Rank.Reserve(SimIds.Num());
+    for (int32 Index = 0; Index < SimIds.Num(); ++Index)
+    {
+        Rank.Add(SimIds[Index], Index);
+    }
+
+    Algo::StableSortBy(ActiveProjectiles, [&Rank](const AProjectile* Projectile)
+        {
+            const int32* Found = Projectile ? Rank.Find(Projectile->SimId) : nullptr;
+            return Found ? *Found : MAX_int32;
+        });
+
+    for (int32 Index = 0; Index < ActiveProjectiles.Num(); ++Index)
+    {
+        if (ActiveProjectiles[Index])
+        {
+            ActiveProjectiles[Index]->ActiveIndex = Index;
+        }
+    }
+}
+
+void USTProjectilePoolSubsystem::ReleaseAllProjectiles()
+{
+    // Newest first: each release swap-removes the last slot
+    while (ActiveProjectiles.Num() > 0)
+    {
+        AProjectile* Projectile = ActiveProjectiles.Last();
+        if (!Projectile)
+        {
+            ActiveProjectiles.Pop(EAllowShrinking::No);
+            continue;
+        }
+
+        Projectile->ReturnToPool();
+
+        // Not pooled after all: make sure we still make progress
+        if (ActiveProjectiles.Num() > 0 && ActiveProjectiles.Last() == Projectile)
+        {
+            ActiveProjectiles.Pop(EAllowShrinking::No);
+        }
+    }
+}
@@ -0,0 +1,116 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "STProjectilePool.generated.h"
+
+class AProjectile;
+
+/**
+ * Free list of pooled projectiles for one tower class.
+ * Towers of the same class share a bucket, so the pool is sized per tower type.
+ */
+USTRUCT()
+struct FSTProjectilePoolBucket
+{
+    GENERATED_BODY()
+
+    /** Tower class this bucket serves. */
+    UPROPERTY()
+    UClass* TowerClass = nullptr;
+
+    /** Projectile class spawned into this bucket. */
+    UPROPERTY()
+    UClass* ProjectileClass = nullptr;
+
+    /** Inactive projectiles ready to be reused. */
+    UPROPERTY()
+    TArray<AProjectile*> FreeProjectiles;
+
+    /** Requested capacity (sum of all towers that reserved into this bucket). */
+    int32 ReservedSize = 0;
+
+    /** Projectiles currently in flight. */
+    int32 NumActive = 0;
+};
+
+/**
+ * Per-world projectile pool.
+ *  - Towers reserve capacity in BeginPlay (FireRate x expected flight time)
+ *  - FireProjectile acquires an instance instead of SpawnActor
+ *  - Projectiles hand themselves back on hit / expiry instead of Destroy()
+ */
+UCLASS()
+class ACTIONTOWERDEFENSE_API USTProjectilePoolSubsystem : public UWorldSubsystem
+{
+    GENERATED_BODY()
+
+public:
+    virtual void Deinitialize() override;
+
+    /** Convenience helper so towers / projectiles can find the pool. */
+    static USTProjectilePoolSubsystem* Get(const UObject* WorldContextObject);
+
+    /**
+     * Grow the bucket for TowerClass by Count projectiles and pre-spawn them,
+     * so the first volley does not pay for SpawnActor.
+     */
+    void ReservePool(UClass* TowerClass, TSubclassOf<AProjectile> ProjectileClass, int32 Count);
+
+    /** Take a projectile out of the pool (spawns a new one if the bucket is empty). */
+    AProjectile* AcquireProjectile(AActor* OwnerTower,
+        TSubclassOf<AProjectile> ProjectileClass,
+        const FTransform& SpawnTransform);
+
+    /**
+     * Re-acquire a projectile that a rewind brings back into flight, keeping its old id.
+     * The caller restores the flight state.
+     */
+    AProjectile* AcquireForRestore(int32 BucketIndex, int32 SimId, AActor* OwnerTower,
+        const FTransform& SpawnTransform);
+
+    /** Put a projectile back into its bucket. Called by the projectile itself. */
+    void ReleaseProjectile(AProjectile* Projectile);
+
+    /** Put every projectile in flight back into its bucket. */
+    void ReleaseAllProjectiles();
+
+    /**
+     * Reorder the projectiles in flight to follow SimIds (unlisted ones go last).
+     * Swap-removals leave the step order to history; seeks put the recorded one back.
+     */
+    void SetActiveOrder(TConstArrayView<int32> SimIds);
+
+    /** Flight id the next AcquireProjectile hands out (part of rewind snapshots). */
+    FORCEINLINE int32 GetNextProjectileSimId() const { return NextProjectileSimId; }
+    void SetNextProjectileSimId(int32 InNextSimId) { NextProjectileSimId = InNextSimId; }
+
+    /** Number of projectiles currently in flight across all buckets. */
+    FORCEINLINE int32 GetNumActiveProjectiles() const { return ActiveProjectiles.Num(); }
+
+    /** Projectiles currently in flight (order changes as shots are released). */
+    FORCEINLINE const TArray<AProjectile*>& GetActiveProjectiles() const { return ActiveProjectiles; }
+
+    /** Move every projectile in flight by one fixed substep. Called by USTSimulationClock. */
+    void SimStep(float StepSeconds);
+
+    /** Place projectiles in flight for rendering (Alpha from USTSimulationClock). */
+    void UpdatePresentation(float Alpha);
+
+protected:
+    UPROPERTY()
+    TArray<FSTProjectilePoolBucket> Buckets;
+
+    /** Projectiles currently in flight (each knows its own slot for O(1) removal). */
+    UPROPERTY()
+    TArray<AProjectile*> ActiveProjectiles;
+
+    /** Flight ids handed out by AcquireProjectile. */
+    int32 NextProjectileSimId = 0;
+
+    int32 FindOrAddBucket(UClass* TowerClass, UClass* ProjectileClass);
+    AProjectile* SpawnPooledProjectile(int32 BucketIndex);
+    AProjectile* AcquireFromBucket(int32 BucketIndex, AActor* OwnerTower, const FTransform& SpawnTransform);
+};
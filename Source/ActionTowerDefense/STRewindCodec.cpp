@@ -0,0 +1,1076 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "STRewindCodec.h"
+#include "Math/VectorRegister.h"
+
+void FSTRewindState::Reset()
+{
+    SimStepNumber = 0;
+    GameTime = 0.0;
+    GrossScore = 0.f;
+    Lives = 0;
+    NumEnemiesAlive = 0;
+    NextSimId = 0;
+    NextProjectileSimId = 0;
+
+    Spawners.Reset();
+    Lanes.Reset();
+    Enemies.Reset();
+    Towers.Reset();
+    Projectiles.Reset();
+    Impacts.Reset();
+}
+
+namespace STRewindCodec
+{
+    // ========================================================
+    // Quantization
+    // ========================================================
+
+    uint16 QuantizeUnit(float Value, float Max)
+    {
+        if (Max <= 0.f)
+        {
+            return 0;
+        }
+
+        return static_cast<uint16>(FMath::Clamp(Value / Max, 0.f, 1.f) * 65535.f + 0.5f);
+    }
+
+    float DequantizeUnit(uint16 Value, float Max)
+    {
+        return static_cast<float>(Value) * (1.f / 65535.f) * Max;
+    }
+
+    void QuantizeUnitBatch(const float* Values, const float* Max, uint16* Out, int32 Num)
+    {
+        const VectorRegister4Float Zero = VectorZeroFloat();
+        const VectorRegister4Float One = VectorOneFloat();
+        const VectorRegister4Float Range = VectorSetFloat1(65535.f);
+        const VectorRegister4Float Half = VectorSetFloat1(0.5f);
+
+        int32 Index = 0;
+        for (; Index + 4 <= Num; Index += 4)
+        {
+            const VectorRegister4Float Value = VectorLoad(Values + Index);
+            const VectorRegister4Float Limit = VectorLoad(Max + Index);
+
+            // Max <= 0 (no path / no health): divide by 1, then force to 0
+            const VectorRegister4Float Valid = VectorCompareGT(Limit, Zero);
+            const VectorRegister4Float SafeLimit = VectorSelect(Valid, Limit, One);
+
+            VectorRegister4Float Unit = VectorDivide(Value, SafeLimit);
+            Unit = VectorMin(VectorMax(Unit, Zero), One);
+
+            // +0.5 then truncate = round to nearest (all values are >= 0)
+            const VectorRegister4Float Scaled = VectorSelect(Valid, VectorMultiplyAdd(Unit, Range, Half), Zero);
+
+            int32 Quantized[4];
+            VectorIntStore(VectorFloatToInt(Scaled), Quantized);
+
+            Out[Index + 0] = static_cast<uint16>(Quantized[0]);
+            Out[Index + 1] = static_cast<uint16>(Quantized[1]);
+            Out[Index + 2] = static_cast<uint16>(Quantized[2]);
+            Out[Index + 3] = static_cast<uint16>(Quantized[3]);
+        }
+
+        for (; Index < Num; ++Index)
+        {
+            Out[Index] = QuantizeUnit(Values[Index], Max[Index]);
+        }
+    }
+
+    void DequantizeUnitBatch(const uint16* Values, const float* Max, float* Out, int32 Num)
+    {
+        const VectorRegister4Float InvRange = VectorSetFloat1(1.f / 65535.f);
+
+        int32 Index = 0;
+        for (; Index + 4 <= Num; Index += 4)
+        {
+            const int32 Widened[4] = { Values[Index], Values[Index + 1], Values[Index + 2], Values[Index + 3] };
+
+            const VectorRegister4Float Unit = VectorMultiply(VectorIntToFloat(VectorIntLoad(Widened)), InvRange);
+            VectorStore(VectorMultiply(Unit, VectorLoad(Max + Index)), Out + Index);
+        }
+
+        for (; Index < Num; ++Index)
+        {
+            Out[Index] = DequantizeUnit(Values[Index], Max[Index]);
+        }
+    }
+
+    FIntVector QuantizePosition(const FVector& Value)
+    {
+        return FIntVector(
+            FMath::RoundToInt32(Value.X * PositionScale),
+            FMath::RoundToInt32(Value.Y * PositionScale),
+            FMath::RoundToInt32(Value.Z * PositionScale));
+    }
+
+    FVector DequantizePosition(const FIntVector& Value)
+    {
+        return FVector(Value) * (1.0 / PositionScale);
+    }
+
+    // ========================================================
+    // Byte streams
+    // ========================================================
+
+    namespace
+    {
+        constexpr uint8 KeyframeFlag = 1 << 0;
+
+        /** Delta frame that also read the frame before its base (linear prediction). */
+        constexpr uint8 PredictFlag = 1 << 1;
+
+        /** Residual codes packed two bits per field into entity tags. */
+        constexpr int32 ResidualBits = 2;
+        constexpr uint64 ResidualExplicit = 3;
+
+        /** Spawners with more lanes than fit in the change mask are written in full. */
+        constexpr int32 MaxMaskedLanes = 24;
+
+        struct FWriter
+        {
+            TArray<uint8>& Out;
+
+            void VarUInt(uint64 Value)
+            {
+                while (Value >= 0x80)
+                {
+                    Out.Add(static_cast<uint8>(Value) | 0x80);
+                    Value >>= 7;
+                }
+                Out.Add(static_cast<uint8>(Value));
+            }
+
+            /** Zigzag so small negative deltas stay small. */
+            void VarInt(int64 Value)
+            {
+                VarUInt((static_cast<uint64>(Value) << 1) ^ static_cast<uint64>(Value >> 63));
+            }
+
+            template<typename T>
+            void Pod(const T& Value)
+            {
+                Out.Append(reinterpret_cast<const uint8*>(&Value), sizeof(T));
+            }
+
+            /** (SimId gap, per-field codes, matched-in-base flag) in one varint. */
+            void Tag(uint64 Gap, int32 ExtraBits, uint64 Extra, bool bMatched)
+            {
+                VarUInt((Gap << (ExtraBits + 1)) | (Extra << 1) | (bMatched ? 1 : 0));
+            }
+        };
+
+        struct FReader
+        {
+            const uint8* Data = nullptr;
+            int32 Size = 0;
+            int32 Pos = 0;
+            bool bError = false;
+
+            uint64 VarUInt()
+            {
+                uint64 Value = 0;
+                for (int32 Shift = 0; Shift < 64; Shift += 7)
+                {
+                    if (Pos >= Size)
+                    {
+                        bError = true;
+                        return 0;
+                    }
+
+                    const uint8 Byte = Data[Pos++];
+                    Value |= static_cast<uint64>(Byte & 0x7F) << Shift;
+                    if ((Byte & 0x80) == 0)
+                    {
+                        return Value;
+                    }
+                }
+
+                bError = true;
+                return 0;
+            }
+
+            int64 VarInt()
+            {
+                const uint64 Value = VarUInt();
+                return static_cast<int64>(Value >> 1) ^ -static_cast<int64>(Value & 1);
+            }
+
+            template<typename T>
+            T Pod()
+            {
+                T Value{};
+                if (Pos + static_cast<int32>(sizeof(T)) > Size)
+                {
+                    bError = true;
+                    return Value;
+                }
+
+                FMemory::Memcpy(&Value, Data + Pos, sizeof(T));
+                Pos += sizeof(T);
+                return Value;
+            }
+
+            /** Reject counts that could not possibly fit in the remaining bytes. */
+            int32 Count()
+            {
+                const uint64 Value = VarUInt();
+                if (Value > static_cast<uint64>(Size - Pos))
+                {
+                    bError = true;
+                    return 0;
+                }
+                return static_cast<int32>(Value);
+            }
+        };
+
+        /** Entity tag as read back: SimId gap, field codes, matched flag. */
+        struct FTag
+        {
+            int64 Gap = 0;
+            uint64 Extra = 0;
+            bool bMatched = false;
+
+            FTag(uint64 Raw, int32 ExtraBits)
+                : Gap(static_cast<int64>(Raw >> (ExtraBits + 1)))
+                , Extra((Raw >> 1) & ((uint64(1) << ExtraBits) - 1))
+                , bMatched((Raw & 1) != 0)
+            {
+            }
+        };
+
+        /** Merge-walk a SimId-sorted base list alongside a SimId-sorted frame. */
+        template<typename T>
+        const T* FindBaseEntry(const TArray<T>* BaseList, int32& Cursor, int32 SimId)
+        {
+            if (!BaseList)
+            {
+                return nullptr;
+            }
+
+            while (Cursor < BaseList->Num() && (*BaseList)[Cursor].SimId < SimId)
+            {
+                ++Cursor;
+            }
+
+            return (Cursor < BaseList->Num() && (*BaseList)[Cursor].SimId == SimId) ? &(*BaseList)[Cursor] : nullptr;
+        }
+
+        /** Wrapped difference of two compressed angles (shortest way round). */
+        int32 AngleDelta(uint16 Value, uint16 Base)
+        {
+            return static_cast<int16>(static_cast<uint16>(Value - Base));
+        }
+
+        /** Value extrapolated from the previous frame (and the one before it, if known). */
+        int64 Predict(int64 Prev, int64 PrevPrev, bool bHasPrevPrev)
+        {
+            return bHasPrevPrev ? 2 * Prev - PrevPrev : Prev;
+        }
+
+        uint16 PredictAngle(uint16 Prev, uint16 PrevPrev, bool bHasPrevPrev)
+        {
+            return bHasPrevPrev ? static_cast<uint16>(Prev + AngleDelta(Prev, PrevPrev)) : Prev;
+        }
+
+        /** 0 / +1 / -1 live in the tag; anything else is written after it. */
+        uint64 ResidualCode(int64 Residual)
+        {
+            return Residual == 0 ? 0 : Residual == 1 ? 1 : Residual == -1 ? 2 : ResidualExplicit;
+        }
+
+        template<int32 NumFields>
+        uint64 PackResidualCodes(const int64 (&Residuals)[NumFields])
+        {
+            uint64 Codes = 0;
+            for (int32 Field = 0; Field < NumFields; ++Field)
+            {
+                Codes |= ResidualCode(Residuals[Field]) << (Field * ResidualBits);
+            }
+            return Codes;
+        }
+
+        template<int32 NumFields>
+        void WriteExplicitResiduals(FWriter& Writer, const int64 (&Residuals)[NumFields])
+        {
+            for (int32 Field = 0; Field < NumFields; ++Field)
+            {
+                if (ResidualCode(Residuals[Field]) == ResidualExplicit)
+                {
+                    Writer.VarInt(Residuals[Field]);
+                }
+            }
+        }
+
+        template<int32 NumFields>
+        void ReadResiduals(FReader& Reader, uint64 Codes, int64 (&OutResiduals)[NumFields])
+        {
+            for (int32 Field = 0; Field < NumFields; ++Field)
+            {
+                const uint64 Code = (Codes >> (Field * ResidualBits)) & ResidualExplicit;
+                OutResiduals[Field] = Code == ResidualExplicit ? Reader.VarInt() : Code == 1 ? 1 : Code == 2 ? -1 : 0;
+            }
+        }
+
+        bool IsSameEnemy(const FSTRewindEnemyState& A, const FSTRewindEnemyState& B)
+        {
+            return A.ClassIndex == B.ClassIndex && A.PathIndex == B.PathIndex;
+        }
+
+        /** Projectiles only delta-encode against the same flight. */
+        bool IsSameFlight(const FSTRewindProjectileState& A, const FSTRewindProjectileState& B)
+        {
+            return A.OwnerSimId == B.OwnerSimId
+                && A.TargetSimId == B.TargetSimId
+                && A.BucketIndex == B.BucketIndex
+                && A.bHoming == B.bHoming
+                && A.Damage == B.Damage
+                && A.BaseSpeed == B.BaseSpeed
+                && A.HomingAcceleration == B.HomingAcceleration;
+        }
+
+        bool IsSameImpact(const FSTRewindImpactState& A, const FSTRewindImpactState& B)
+        {
+            return A.TargetSimId == B.TargetSimId
+                && A.SourceSimId == B.SourceSimId
+                && A.Damage == B.Damage
+                && A.Delay == B.Delay;
+        }
+
+        bool HasSameTowerMeta(const FSTRewindTowerState& A, const FSTRewindTowerState& B)
+        {
+            return A.Team == B.Team && A.OrderState == B.OrderState && A.CaptureTargetSimId == B.CaptureTargetSimId;
+        }
+
+        /** Same spawner in the same slot with a lane count the change mask can hold. */
+        const FSTRewindSpawnerState* FindBaseSpawner(const FSTRewindState* Base, int32 Index, const FSTRewindSpawnerState& Spawner)
+        {
+            if (!Base || !Base->Spawners.IsValidIndex(Index))
+            {
+                return nullptr;
+            }
+
+            const FSTRewindSpawnerState& Candidate = Base->Spawners[Index];
+            return Candidate.SimId == Spawner.SimId && Candidate.NumLanes == Spawner.NumLanes && Spawner.NumLanes <= MaxMaskedLanes
+                ? &Candidate : nullptr;
+        }
+
+        /** Wave clocks tick linearly while a wave runs. */
+        float PredictFloat(float Prev, const float* PrevPrev)
+        {
+            return PrevPrev ? Prev + (Prev - *PrevPrev) : Prev;
+        }
+
+        // Entity tag layouts (extra bits between the SimId gap and the matched flag)
+        enum EEnemyField { EnemyDistance, EnemyHealth, NumEnemyFields };
+        enum ETowerField { TowerPitch, TowerYaw, TowerRoll, TowerCooldown, TowerCaptureHP, NumTowerFields };
+        enum EProjectileField { ProjLocX, ProjLocY, ProjLocZ, ProjVelX, ProjVelY, ProjVelZ, ProjAge, NumProjectileFields };
+
+        constexpr int32 EnemyExtraBits = NumEnemyFields * ResidualBits;
+        constexpr int32 TowerExtraBits = NumTowerFields * ResidualBits + 1;   // + team / orders changed
+        constexpr int32 ProjectileExtraBits = NumProjectileFields * ResidualBits;
+        constexpr uint64 TowerMetaBit = uint64(1) << (NumTowerFields * ResidualBits);
+
+        // Delta frame header: one bit per field that differs from its prediction
+        enum EHeaderBit : uint8
+        {
+            HeaderStep = 1 << 0,
+            HeaderTime = 1 << 1,
+            HeaderScore = 1 << 2,
+            HeaderLives = 1 << 3,
+            HeaderAlive = 1 << 4,
+            HeaderNextSimId = 1 << 5,
+            HeaderNextProjectileSimId = 1 << 6,
+        };
+
+        // Delta spawner mask: bit 0 = matched, then fields, then two bits per lane
+        enum ESpawnerBit : uint64
+        {
+            SpawnerMatched = 1 << 0,
+            SpawnerWaveIndex = 1 << 1,
+            SpawnerWaveClock = 1 << 2,
+            SpawnerTimeUntilNextWave = 1 << 3,
+            SpawnerWaveRunning = 1 << 4,
+            SpawnerRandomSeed = 1 << 5,
+        };
+        constexpr int32 SpawnerFirstLaneBit = 6;
+
+        double PredictGameTime(const FSTRewindState& Prev, const FSTRewindState* PrevPrev)
+        {
+            return PrevPrev ? Prev.GameTime + (Prev.GameTime - PrevPrev->GameTime) : Prev.GameTime;
+        }
+
+        void WriteSpawnerFull(FWriter& Writer, const FSTRewindState& State, const FSTRewindSpawnerState& Spawner)
+        {
+            Writer.VarInt(Spawner.WaveIndex);
+            Writer.Pod(Spawner.WaveClock);
+            Writer.Pod(Spawner.TimeUntilNextWave);
+            Writer.Pod<uint8>(Spawner.bWaveRunning ? 1 : 0);
+            Writer.VarInt(Spawner.RandomSeed);
+            Writer.VarUInt(Spawner.NumLanes);
+
+            for (int32 Lane = 0; Lane < Spawner.NumLanes; ++Lane)
+            {
+                const FSTRewindLaneState& LaneState = State.Lanes[Spawner.FirstLane + Lane];
+                Writer.VarUInt(LaneState.SpawnsDone);
+                Writer.Pod(LaneState.NextSpawnTime);
+            }
+        }
+
+        void ReadSpawnerFull(FReader& Reader, FSTRewindState& Out, FSTRewindSpawnerState& Spawner)
+        {
+            Spawner.WaveIndex = static_cast<int32>(Reader.VarInt());
+            Spawner.WaveClock = Reader.Pod<float>();
+            Spawner.TimeUntilNextWave = Reader.Pod<float>();
+            Spawner.bWaveRunning = Reader.Pod<uint8>() != 0;
+            Spawner.RandomSeed = static_cast<int32>(Reader.VarInt());
+            Spawner.NumLanes = Reader.Count();
+            Spawner.FirstLane = Out.Lanes.Num();
+
+            for (int32 Lane = 0; Lane < Spawner.NumLanes; ++Lane)
+            {
+                FSTRewindLaneState& LaneState = Out.Lanes.AddDefaulted_GetRef();
+                LaneState.SpawnsDone = static_cast<int32>(Reader.VarUInt());
+                LaneState.NextSpawnTime = Reader.Pod<float>();
+            }
+        }
+
+        void WriteImpactFull(FWriter& Writer, const FSTRewindImpactState& Impact)
+        {
+            Writer.VarInt(Impact.TargetSimId);
+            Writer.VarInt(Impact.SourceSimId);
+            Writer.Pod(Impact.Damage);
+            Writer.Pod(Impact.Delay);
+            Writer.Pod(Impact.Elapsed);
+        }
+
+        void ReadImpactFull(FReader& Reader, FSTRewindImpactState& Impact)
+        {
+            Impact.TargetSimId = static_cast<int32>(Reader.VarInt());
+            Impact.SourceSimId = static_cast<int32>(Reader.VarInt());
+            Impact.Damage = Reader.Pod<float>();
+            Impact.Delay = Reader.Pod<float>();
+            Impact.Elapsed = Reader.Pod<float>();
+        }
+    }
+
+    // ========================================================
+    // Encode
+    // ========================================================
+
+    void Encode(const FSTRewindState& State, const FSTRewindState* Prev, const FSTRewindState* PrevPrev, TArray<uint8>& Out)
+    {
+        FWriter Writer{ Out };
+
+        if (!Prev)
+        {
+            PrevPrev = nullptr;
+        }
+
+        Writer.Pod<uint8>(!Prev ? KeyframeFlag : (PrevPrev ? PredictFlag : 0));
+
+        // --- Header ---
+        if (Prev)
+        {
+            const uint64 PredictedStep = Prev->SimStepNumber + 1;
+            const double PredictedTime = PredictGameTime(*Prev, PrevPrev);
+
+            uint8 Mask = 0;
+            Mask |= State.SimStepNumber != PredictedStep ? HeaderStep : 0;
+            Mask |= State.GameTime != PredictedTime ? HeaderTime : 0;
+            Mask |= State.GrossScore != Prev->GrossScore ? HeaderScore : 0;
+            Mask |= State.Lives != Prev->Lives ? HeaderLives : 0;
+            Mask |= State.NumEnemiesAlive != Prev->NumEnemiesAlive ? HeaderAlive : 0;
+            Mask |= State.NextSimId != Prev->NextSimId ? HeaderNextSimId : 0;
+            Mask |= State.NextProjectileSimId != Prev->NextProjectileSimId ? HeaderNextProjectileSimId : 0;
+            Writer.Pod(Mask);
+
+            if (Mask & HeaderStep)                { Writer.VarInt(static_cast<int64>(State.SimStepNumber - PredictedStep)); }
+            if (Mask & HeaderTime)                { Writer.Pod(State.GameTime); }
+            if (Mask & HeaderScore)               { Writer.Pod(State.GrossScore); }
+            if (Mask & HeaderLives)               { Writer.VarInt(State.Lives - Prev->Lives); }
+            if (Mask & HeaderAlive)               { Writer.VarInt(State.NumEnemiesAlive - Prev->NumEnemiesAlive); }
+            if (Mask & HeaderNextSimId)           { Writer.VarInt(State.NextSimId - Prev->NextSimId); }
+            if (Mask & HeaderNextProjectileSimId) { Writer.VarInt(State.NextProjectileSimId - Prev->NextProjectileSimId); }
+        }
+        else
+        {
+            Writer.VarUInt(State.SimStepNumber);
+            Writer.Pod(State.GameTime);
+            Writer.Pod(State.GrossScore);
+            Writer.VarInt(State.Lives);
+            Writer.VarInt(State.NumEnemiesAlive);
+            Writer.VarInt(State.NextSimId);
+            Writer.VarInt(State.NextProjectileSimId);
+        }
+
+        // --- Spawners: a handful; deltas flag which fields changed ---
+        Writer.VarUInt(State.Spawners.Num());
+        for (int32 Index = 0; Index < State.Spawners.Num(); ++Index)
+        {
+            const FSTRewindSpawnerState& Spawner = State.Spawners[Index];
+            Writer.VarInt(Spawner.SimId);
+
+            if (!Prev)
+            {
+                WriteSpawnerFull(Writer, State, Spawner);
+                continue;
+            }
+
+            const FSTRewindSpawnerState* Base = FindBaseSpawner(Prev, Index, Spawner);
+            if (!Base)
+            {
+                Writer.VarUInt(0);
+                WriteSpawnerFull(Writer, State, Spawner);
+                continue;
+            }
+
+            const FSTRewindSpawnerState* Base2 = FindBaseSpawner(PrevPrev, Index, Spawner);
+            const float PredictedClock = PredictFloat(Base->WaveClock, Base2 ? &Base2->WaveClock : nullptr);
+
+            uint64 Mask = SpawnerMatched;
+            Mask |= Spawner.WaveIndex != Base->WaveIndex ? SpawnerWaveIndex : 0;
+            Mask |= Spawner.WaveClock != PredictedClock ? SpawnerWaveClock : 0;
+            Mask |= Spawner.TimeUntilNextWave != Base->TimeUntilNextWave ? SpawnerTimeUntilNextWave : 0;
+            Mask |= Spawner.bWaveRunning != Base->bWaveRunning ? SpawnerWaveRunning : 0;
+            Mask |= Spawner.RandomSeed != Base->RandomSeed ? SpawnerRandomSeed : 0;
+
+            for (int32 Lane = 0; Lane < Spawner.NumLanes; ++Lane)
+            {
+                const FSTRewindLaneState& LaneState = State.Lanes[Spawner.FirstLane + Lane];
+                const FSTRewindLaneState& BaseLane = Prev->Lanes[Base->FirstLane + Lane];
+                const int32 Bit = SpawnerFirstLaneBit + Lane * 2;
+                Mask |= LaneState.SpawnsDone != BaseLane.SpawnsDone ? uint64(1) << Bit : 0;
+                Mask |= LaneState.NextSpawnTime != BaseLane.NextSpawnTime ? uint64(1) << (Bit + 1) : 0;
+            }
+
+            Writer.VarUInt(Mask);
+
+            if (Mask & SpawnerWaveIndex)         { Writer.VarInt(Spawner.WaveIndex - Base->WaveIndex); }
+            if (Mask & SpawnerWaveClock)         { Writer.Pod(Spawner.WaveClock); }
+            if (Mask & SpawnerTimeUntilNextWave) { Writer.Pod(Spawner.TimeUntilNextWave); }
+            if (Mask & SpawnerRandomSeed)        { Writer.VarInt(Spawner.RandomSeed); }
+
+            for (int32 Lane = 0; Lane < Spawner.NumLanes; ++Lane)
+            {
+                const FSTRewindLaneState& LaneState = State.Lanes[Spawner.FirstLane + Lane];
+                const FSTRewindLaneState& BaseLane = Prev->Lanes[Base->FirstLane + Lane];
+                const int32 Bit = SpawnerFirstLaneBit + Lane * 2;
+
+                if (Mask & (uint64(1) << Bit))       { Writer.VarInt(LaneState.SpawnsDone - BaseLane.SpawnsDone); }
+                if (Mask & (uint64(1) << (Bit + 1))) { Writer.Pod(LaneState.NextSpawnTime); }
+            }
+        }
+
+        // --- Enemies: distance extrapolated from the last two frames, health held ---
+        {
+            Writer.VarUInt(State.Enemies.Num());
+
+            int32 Cursor = 0;
+            int32 Cursor2 = 0;
+            int64 PrevId = INDEX_NONE;
+            for (const FSTRewindEnemyState& Enemy : State.Enemies)
+            {
+                const uint64 Gap = static_cast<uint64>(Enemy.SimId - PrevId);
+                PrevId = Enemy.SimId;
+
+                const FSTRewindEnemyState* Base = FindBaseEntry(Prev ? &Prev->Enemies : nullptr, Cursor, Enemy.SimId);
+                if (!Base || !IsSameEnemy(*Base, Enemy))
+                {
+                    Writer.Tag(Gap, EnemyExtraBits, 0, false);
+                    Writer.VarUInt(Enemy.ClassIndex);
+                    Writer.VarUInt(Enemy.PathIndex);
+                    Writer.VarUInt(Enemy.Distance);
+                    Writer.VarUInt(Enemy.Health);
+                    continue;
+                }
+
+                const FSTRewindEnemyState* Base2 = FindBaseEntry(PrevPrev ? &PrevPrev->Enemies : nullptr, Cursor2, Enemy.SimId);
+                const bool bLinear = Base2 && IsSameEnemy(*Base2, *Base);
+
+                int64 Residuals[NumEnemyFields];
+                Residuals[EnemyDistance] = Enemy.Distance - Predict(Base->Distance, bLinear ? Base2->Distance : 0, bLinear);
+                Residuals[EnemyHealth] = static_cast<int64>(Enemy.Health) - Base->Health;
+
+                Writer.Tag(Gap, EnemyExtraBits, PackResidualCodes(Residuals), true);
+                WriteExplicitResiduals(Writer, Residuals);
+            }
+        }
+
+        // --- Towers: angles / cooldown / capture extrapolated; team and orders only on change ---
+        {
+            Writer.VarUInt(State.Towers.Num());
+
+            int32 Cursor = 0;
+            int32 Cursor2 = 0;
+            int64 PrevId = INDEX_NONE;
+            for (const FSTRewindTowerState& Tower : State.Towers)
+            {
+                const uint64 Gap = static_cast<uint64>(Tower.SimId - PrevId);
+                PrevId = Tower.SimId;
+
+                const FSTRewindTowerState* Base = FindBaseEntry(Prev ? &Prev->Towers : nullptr, Cursor, Tower.SimId);
+                if (!Base)
+                {
+                    Writer.Tag(Gap, TowerExtraBits, 0, false);
+                    Writer.VarUInt(Tower.Pitch);
+                    Writer.VarUInt(Tower.Yaw);
+                    Writer.VarUInt(Tower.Roll);
+                    Writer.VarUInt(Tower.FireCooldown);
+                    Writer.VarUInt(Tower.CaptureHP);
+                    Writer.Pod<uint8>(Tower.Team);
+                    Writer.Pod<uint8>(Tower.OrderState);
+                    Writer.VarInt(Tower.CaptureTargetSimId);
+                    continue;
+                }
+
+                const FSTRewindTowerState* Base2 = FindBaseEntry(PrevPrev ? &PrevPrev->Towers : nullptr, Cursor2, Tower.SimId);
+                const bool bLinear = Base2 != nullptr;
+
+                int64 Residuals[NumTowerFields];
+                Residuals[TowerPitch] = AngleDelta(Tower.Pitch, PredictAngle(Base->Pitch, bLinear ? Base2->Pitch : 0, bLinear));
+                Residuals[TowerYaw] = AngleDelta(Tower.Yaw, PredictAngle(Base->Yaw, bLinear ? Base2->Yaw : 0, bLinear));
+                Residuals[TowerRoll] = AngleDelta(Tower.Roll, PredictAngle(Base->Roll, bLinear ? Base2->Roll : 0, bLinear));
+                Residuals[TowerCooldown] = Tower.FireCooldown - Predict(Base->FireCooldown, bLinear ? Base2->FireCooldown : 0, bLinear);
+                Residuals[TowerCaptureHP] = Tower.CaptureHP - Predict(Base->CaptureHP, bLinear ? Base2->CaptureHP : 0, bLinear);
+
+                const bool bMetaChanged = !HasSameTowerMeta(Tower, *Base);
+
+                Writer.Tag(Gap, TowerExtraBits, PackResidualCodes(Residuals) | (bMetaChanged ? TowerMetaBit : 0), true);
+                WriteExplicitResiduals(Writer, Residuals);
+
+                if (bMetaChanged)
+                {
+                    Writer.Pod<uint8>(Tower.Team);
+                    Writer.Pod<uint8>(Tower.OrderState);
+                    Writer.VarInt(Tower.CaptureTargetSimId);
+                }
+            }
+        }
+
+        // --- Projectiles: straight flights extrapolate exactly up to rounding ---
+        {
+            Writer.VarUInt(State.Projectiles.Num());
+
+            int32 Cursor = 0;
+            int32 Cursor2 = 0;
+            int64 PrevId = INDEX_NONE;
+            for (const FSTRewindProjectileState& Projectile : State.Projectiles)
+            {
+                const uint64 Gap = static_cast<uint64>(Projectile.SimId - PrevId);
+                PrevId = Projectile.SimId;
+
+                const FSTRewindProjectileState* Base = FindBaseEntry(Prev ? &Prev->Projectiles : nullptr, Cursor, Projectile.SimId);
+                if (!Base || !IsSameFlight(*Base, Projectile))
+                {
+                    Writer.Tag(Gap, ProjectileExtraBits, 0, false);
+                    Writer.VarInt(Projectile.OwnerSimId);
+                    Writer.VarInt(Projectile.TargetSimId);
+                    Writer.VarInt(Projectile.BucketIndex);
+                    Writer.Pod<uint8>(Projectile.bHoming ? 1 : 0);
+                    Writer.VarInt(Projectile.Location.X);
+                    Writer.VarInt(Projectile.Location.Y);
+                    Writer.VarInt(Projectile.Location.Z);
+                    Writer.VarInt(Projectile.Velocity.X);
+                    Writer.VarInt(Projectile.Velocity.Y);
+                    Writer.VarInt(Projectile.Velocity.Z);
+                    Writer.VarUInt(Projectile.AgeMs);
+                    Writer.Pod(Projectile.Damage);
+                    Writer.Pod(Projectile.BaseSpeed);
+                    Writer.Pod(Projectile.HomingAcceleration);
+                    continue;
+                }
+
+                const FSTRewindProjectileState* Base2 = FindBaseEntry(PrevPrev ? &PrevPrev->Projectiles : nullptr, Cursor2, Projectile.SimId);
+                const bool bLinear = Base2 && IsSameFlight(*Base2, *Base);
+
+                int64 Residuals[NumProjectileFields];
+                Residuals[ProjLocX] = Projectile.Location.X - Predict(Base->Location.X, bLinear ? Base2->Location.X : 0, bLinear);
+                Residuals[ProjLocY] = Projectile.Location.Y - Predict(Base->Location.Y, bLinear ? Base2->Location.Y : 0, bLinear);
+                Residuals[ProjLocZ] = Projectile.Location.Z - Predict(Base->Location.Z, bLinear ? Base2->Location.Z : 0, bLinear);
+                Residuals[ProjVelX] = Projectile.Velocity.X - Predict(Base->Velocity.X, bLinear ? Base2->Velocity.X : 0, bLinear);
+                Residuals[ProjVelY] = Projectile.Velocity.Y - Predict(Base->Velocity.Y, bLinear ? Base2->Velocity.Y : 0, bLinear);
+                Residuals[ProjVelZ] = Projectile.Velocity.Z - Predict(Base->Velocity.Z, bLinear ? Base2->Velocity.Z : 0, bLinear);
+                Residuals[ProjAge] = static_cast<int64>(Projectile.AgeMs) - Predict(Base->AgeMs, bLinear ? Base2->AgeMs : 0, bLinear);
+
+                Writer.Tag(Gap, ProjectileExtraBits, PackResidualCodes(Residuals), true);
+                WriteExplicitResiduals(Writer, Residuals);
+            }
+        }
+
+        // --- Impacts: scheduling order; survivors only advance their elapsed time ---
+        Writer.VarUInt(State.Impacts.Num());
+        if (!Prev)
+        {
+            for (const FSTRewindImpactState& Impact : State.Impacts)
+            {
+                WriteImpactFull(Writer, Impact);
+            }
+        }
+        else
+        {
+            const float StepSeconds = static_cast<float>(State.GameTime - Prev->GameTime);
+
+            // Fired impacts leave gaps; new ones are appended: skip forward through the base
+            int32 Cursor = 0;
+            for (const FSTRewindImpactState& Impact : State.Impacts)
+            {
+                int32 Match = Cursor;
+                while (Match < Prev->Impacts.Num() && !IsSameImpact(Prev->Impacts[Match], Impact))
+                {
+                    ++Match;
+                }
+
+                if (Match >= Prev->Impacts.Num())
+                {
+                    Writer.VarUInt(0);
+                    WriteImpactFull(Writer, Impact);
+                    continue;
+                }
+
+                const bool bElapsedExplicit = Impact.Elapsed != Prev->Impacts[Match].Elapsed + StepSeconds;
+                Writer.VarUInt((static_cast<uint64>(Match - Cursor) << 2) | (bElapsedExplicit ? 2 : 0) | 1);
+                if (bElapsedExplicit)
+                {
+                    Writer.Pod(Impact.Elapsed);
+                }
+
+                Cursor = Match + 1;
+            }
+        }
+    }
+
+    // ========================================================
+    // Decode
+    // ========================================================
+
+    bool IsKeyframe(const uint8* Data, int32 Size)
+    {
+        return Size > 0 && (Data[0] & KeyframeFlag) != 0;
+    }
+
+    bool Decode(const uint8* Data, int32 Size, const FSTRewindState* Prev, const FSTRewindState* PrevPrev, FSTRewindState& Out)
+    {
+        Out.Reset();
+
+        FReader Reader{ Data, Size };
+
+        const uint8 Flags = Reader.Pod<uint8>();
+        const bool bKeyframe = (Flags & KeyframeFlag) != 0;
+        const bool bPredicted = (Flags & PredictFlag) != 0;
+        if (Reader.bError || (!bKeyframe && !Prev) || (bPredicted && !PrevPrev))
+        {
+            return false;
+        }
+
+        // Keyframes never reference another frame
+        if (bKeyframe)
+        {
+            Prev = nullptr;
+        }
+        if (!bPredicted)
+        {
+            PrevPrev = nullptr;
+        }
+
+        // --- Header ---
+        if (Prev)
+        {
+            const uint64 PredictedStep = Prev->SimStepNumber + 1;
+            const uint8 Mask = Reader.Pod<uint8>();
+
+            Out.SimStepNumber = (Mask & HeaderStep) ? PredictedStep + Reader.VarInt() : PredictedStep;
+            Out.GameTime = (Mask & HeaderTime) ? Reader.Pod<double>() : PredictGameTime(*Prev, PrevPrev);
+            Out.GrossScore = (Mask & HeaderScore) ? Reader.Pod<float>() : Prev->GrossScore;
+            Out.Lives = Prev->Lives + ((Mask & HeaderLives) ? static_cast<int32>(Reader.VarInt()) : 0);
+            Out.NumEnemiesAlive = Prev->NumEnemiesAlive + ((Mask & HeaderAlive) ? static_cast<int32>(Reader.VarInt()) : 0);
+            Out.NextSimId = Prev->NextSimId + ((Mask & HeaderNextSimId) ? static_cast<int32>(Reader.VarInt()) : 0);
+            Out.NextProjectileSimId = Prev->NextProjectileSimId
+                + ((Mask & HeaderNextProjectileSimId) ? static_cast<int32>(Reader.VarInt()) : 0);
+        }
+        else
+        {
+            Out.SimStepNumber = Reader.VarUInt();
+            Out.GameTime = Reader.Pod<double>();
+            Out.GrossScore = Reader.Pod<float>();
+            Out.Lives = static_cast<int32>(Reader.VarInt());
+            Out.NumEnemiesAlive = static_cast<int32>(Reader.VarInt());
+            Out.NextSimId = static_cast<int32>(Reader.VarInt());
+            Out.NextProjectileSimId = static_cast<int32>(Reader.VarInt());
+        }
+
+        // --- Spawners ---
+        const int32 NumSpawners = Reader.Count();
+        Out.Spawners.SetNum(NumSpawners);
+        for (int32 Index = 0; Index < NumSpawners; ++Index)
+        {
+            FSTRewindSpawnerState& Spawner = Out.Spawners[Index];
+            Spawner.SimId = static_cast<int32>(Reader.VarInt());
+
+            const uint64 Mask = Prev ? Reader.VarUInt() : 0;
+            if (!(Mask & SpawnerMatched))
+            {
+                ReadSpawnerFull(Reader, Out, Spawner);
+                if (Reader.bError)
+                {
+                    return false;
+                }
+                continue;
+            }
+
+            // Lane count comes from the base; the lookup needs it on the spawner first
+            if (!Prev->Spawners.IsValidIndex(Index))
+            {
+                return false;
+            }
+            Spawner.NumLanes = Prev->Spawners[Index].NumLanes;
+
+            const FSTRewindSpawnerState* Base = FindBaseSpawner(Prev, Index, Spawner);
+            if (!Base)
+            {
+                return false;
+            }
+
+            const FSTRewindSpawnerState* Base2 = FindBaseSpawner(PrevPrev, Index, Spawner);
+
+            Spawner.WaveIndex = Base->WaveIndex + ((Mask & SpawnerWaveIndex) ? static_cast<int32>(Reader.VarInt()) : 0);
+            Spawner.WaveClock = (Mask & SpawnerWaveClock) ? Reader.Pod<float>()
+                : PredictFloat(Base->WaveClock, Base2 ? &Base2->WaveClock : nullptr);
+            Spawner.TimeUntilNextWave = (Mask & SpawnerTimeUntilNextWave) ? Reader.Pod<float>() : Base->TimeUntilNextWave;
+            Spawner.bWaveRunning = (Mask & SpawnerWaveRunning) ? !Base->bWaveRunning : Base->bWaveRunning;
+            Spawner.RandomSeed = (Mask & SpawnerRandomSeed) ? static_cast<int32>(Reader.VarInt()) : Base->RandomSeed;
+            Spawner.FirstLane = Out.Lanes.Num();
+
+            for (int32 Lane = 0; Lane < Spawner.NumLanes; ++Lane)
+            {
+                const FSTRewindLaneState& BaseLane = Prev->Lanes[Base->FirstLane + Lane];
+                const int32 Bit = SpawnerFirstLaneBit + Lane * 2;
+
+                FSTRewindLaneState& LaneState = Out.Lanes.AddDefaulted_GetRef();
+                LaneState.SpawnsDone = BaseLane.SpawnsDone
+                    + ((Mask & (uint64(1) << Bit)) ? static_cast<int32>(Reader.VarInt()) : 0);
+                LaneState.NextSpawnTime = (Mask & (uint64(1) << (Bit + 1))) ? Reader.Pod<float>() : BaseLane.NextSpawnTime;
+            }
+
+            if (Reader.bError)
+            {
+                return false;
+            }
+        }
+
+        // --- Enemies ---
+        {
+            const int32 Num = Reader.Count();
+            Out.Enemies.SetNum(Num);
+
+            int32 Cursor = 0;
+            int32 Cursor2 = 0;
+            int64 PrevId = INDEX_NONE;
+            for (FSTRewindEnemyState& Enemy : Out.Enemies)
+            {
+                const FTag Tag(Reader.VarUInt(), EnemyExtraBits);
+                Enemy.SimId = static_cast<int32>(PrevId + Tag.Gap);
+                PrevId = Enemy.SimId;
+
+                if (!Tag.bMatched)
+                {
+                    Enemy.ClassIndex = static_cast<uint16>(Reader.VarUInt());
+                    Enemy.PathIndex = static_cast<uint16>(Reader.VarUInt());
+                    Enemy.Distance = static_cast<uint16>(Reader.VarUInt());
+                    Enemy.Health = static_cast<uint16>(Reader.VarUInt());
+                    continue;
+                }
+
+                const FSTRewindEnemyState* Base = FindBaseEntry(Prev ? &Prev->Enemies : nullptr, Cursor, Enemy.SimId);
+                if (!Base)
+                {
+                    return false;
+                }
+
+                const FSTRewindEnemyState* Base2 = FindBaseEntry(PrevPrev ? &PrevPrev->Enemies : nullptr, Cursor2, Enemy.SimId);
+                const bool bLinear = Base2 && IsSameEnemy(*Base2, *Base);
+
+                int64 Residuals[NumEnemyFields];
+                ReadResiduals(Reader, Tag.Extra, Residuals);
+
+                Enemy.ClassIndex = Base->ClassIndex;
+                Enemy.PathIndex = Base->PathIndex;
+                Enemy.Distance = static_cast<uint16>(Predict(Base->Distance, bLinear ? Base2->Distance : 0, bLinear) + Residuals[EnemyDistance]);
+                Enemy.Health = static_cast<uint16>(Base->Health + Residuals[EnemyHealth]);
+            }
+        }
+
+        // --- Towers ---
+        {
+            const int32 Num = Reader.Count();
+            Out.Towers.SetNum(Num);
+
+            int32 Cursor = 0;
+            int32 Cursor2 = 0;
+            int64 PrevId = INDEX_NONE;
+            for (FSTRewindTowerState& Tower : Out.Towers)
+            {
+                const FTag Tag(Reader.VarUInt(), TowerExtraBits);
+                Tower.SimId = static_cast<int32>(PrevId + Tag.Gap);
+                PrevId = Tower.SimId;
+
+                if (!Tag.bMatched)
+                {
+                    Tower.Pitch = static_cast<uint16>(Reader.VarUInt());
+                    Tower.Yaw = static_cast<uint16>(Reader.VarUInt());
+                    Tower.Roll = static_cast<uint16>(Reader.VarUInt());
+                    Tower.FireCooldown = static_cast<uint16>(Reader.VarUInt());
+                    Tower.CaptureHP = static_cast<uint16>(Reader.VarUInt());
+                    Tower.Team = Reader.Pod<uint8>();
+                    Tower.OrderState = Reader.Pod<uint8>();
+                    Tower.CaptureTargetSimId = static_cast<int32>(Reader.VarInt());
+                    continue;
+                }
+
+                const FSTRewindTowerState* Base = FindBaseEntry(Prev ? &Prev->Towers : nullptr, Cursor, Tower.SimId);
+                if (!Base)
+                {
+                    return false;
+                }
+
+                const FSTRewindTowerState* Base2 = FindBaseEntry(PrevPrev ? &PrevPrev->Towers : nullptr, Cursor2, Tower.SimId);
+                const bool bLinear = Base2 != nullptr;
+
+                int64 Residuals[NumTowerFields];
+                ReadResiduals(Reader, Tag.Extra, Residuals);
+
+                Tower.Pitch = static_cast<uint16>(PredictAngle(Base->Pitch, bLinear ? Base2->Pitch : 0, bLinear) + Residuals[TowerPitch]);
+                Tower.Yaw = static_cast<uint16>(PredictAngle(Base->Yaw, bLinear ? Base2->Yaw : 0, bLinear) + Residuals[TowerYaw]);
+                Tower.Roll = static_cast<uint16>(PredictAngle(Base->Roll, bLinear ? Base2->Roll : 0, bLinear) + Residuals[TowerRoll]);
+                Tower.FireCooldown = static_cast<uint16>(Predict(Base->FireCooldown, bLinear ? Base2->FireCooldown : 0, bLinear) + Residuals[TowerCooldown]);
+                Tower.CaptureHP = static_cast<uint16>(Predict(Base->CaptureHP, bLinear ? Base2->CaptureHP : 0, bLinear) + Residuals[TowerCaptureHP]);
+
+                if (Tag.Extra & TowerMetaBit)
+                {
+                    Tower.Team = Reader.Pod<uint8>();
+                    Tower.OrderState = Reader.Pod<uint8>();
+                    Tower.CaptureTargetSimId = static_cast<int32>(Reader.VarInt());
+                }
+                else
+                {
+                    Tower.Team = Base->Team;
+                    Tower.OrderState = Base->OrderState;
+                    Tower.CaptureTargetSimId = Base->CaptureTargetSimId;
+                }
+            }
+        }
+
+        // --- Projectiles ---
+        {
+            const int32 Num = Reader.Count();
+            Out.Projectiles.SetNum(Num);
+
+            int32 Cursor = 0;
+            int32 Cursor2 = 0;
+            int64 PrevId = INDEX_NONE;
+            for (FSTRewindProjectileState& Projectile : Out.Projectiles)
+            {
+                const FTag Tag(Reader.VarUInt(), ProjectileExtraBits);
+                Projectile.SimId = static_cast<int32>(PrevId + Tag.Gap);
+                PrevId = Projectile.SimId;
+
+                if (!Tag.bMatched)
+                {
+                    Projectile.OwnerSimId = static_cast<int32>(Reader.VarInt());
+                    Projectile.TargetSimId = static_cast<int32>(Reader.VarInt());
+                    Projectile.BucketIndex = static_cast<int32>(Reader.VarInt());
+                    Projectile.bHoming = Reader.Pod<uint8>() != 0;
+                    Projectile.Location.X = static_cast<int32>(Reader.VarInt());
+                    Projectile.Location.Y = static_cast<int32>(Reader.VarInt());
+                    Projectile.Location.Z = static_cast<int32>(Reader.VarInt());
+                    Projectile.Velocity.X = static_cast<int32>(Reader.VarInt());
+                    Projectile.Velocity.Y = static_cast<int32>(Reader.VarInt());
+                    Projectile.Velocity.Z = static_cast<int32>(Reader.VarInt());
+                    Projectile.AgeMs = static_cast<uint32>(Reader.VarUInt());
+                    Projectile.Damage = Reader.Pod<float>();
+                    Projectile.BaseSpeed = Reader.Pod<float>();
+                    Projectile.HomingAcceleration = Reader.Pod<float>();
+                    continue;
+                }
+
+                const FSTRewindProjectileState* Base = FindBaseEntry(Prev ? &Prev->Projectiles : nullptr, Cursor, Projectile.SimId);
+                if (!Base)
+                {
+                    return false;
+                }
+
+                const FSTRewindProjectileState* Base2 = FindBaseEntry(PrevPrev ? &PrevPrev->Projectiles : nullptr, Cursor2, Projectile.SimId);
+                const bool bLinear = Base2 && IsSameFlight(*Base2, *Base);
+
+                int64 Residuals[NumProjectileFields];
+                ReadResiduals(Reader, Tag.Extra, Residuals);
+
+                Projectile.OwnerSimId = Base->OwnerSimId;
+                Projectile.TargetSimId = Base->TargetSimId;
+                Projectile.BucketIndex = Base->BucketIndex;
+                Projectile.bHoming = Base->bHoming;
+                Projectile.Damage = Base->Damage;
+                Projectile.BaseSpeed = Base->BaseSpeed;
+                Projectile.HomingAcceleration = Base->HomingAcceleration;
+
+                Projectile.Location.X = static_cast<int32>(Predict(Base->Location.X, bLinear ? Base2->Location.X : 0, bLinear) + Residuals[ProjLocX]);
+                Projectile.Location.Y = static_cast<int32>(Predict(Base->Location.Y, bLinear ? Base2->Location.Y : 0, bLinear) + Residuals[ProjLocY]);
+                Projectile.Location.Z = static_cast<int32>(Predict(Base->Location.Z, bLinear ? Base2->Location.Z : 0, bLinear) + Residuals[ProjLocZ]);
+                Projectile.Velocity.X = static_cast<int32>(Predict(Base->Velocity.X, bLinear ? Base2->Velocity.X : 0, bLinear) + Residuals[ProjVelX]);
+                Projectile.Velocity.Y = static_cast<int32>(Predict(Base->Velocity.Y, bLinear ? Base2->Velocity.Y : 0, bLinear) + Residuals[ProjVelY]);
+                Projectile.Velocity.Z = static_cast<int32>(Predict(Base->Velocity.Z, bLinear ? Base2->Velocity.Z : 0, bLinear) + Residuals[ProjVelZ]);
+                Projectile.AgeMs = static_cast<uint32>(Predict(Base->AgeMs, bLinear ? Base2->AgeMs : 0, bLinear) + Residuals[ProjAge]);
+            }
+        }
+
+        // --- Impacts ---
+        {
+            const int32 Num = Reader.Count();
+            Out.Impacts.SetNum(Num);
+
+            const float StepSeconds = Prev ? static_cast<float>(Out.GameTime - Prev->GameTime) : 0.f;
+
+            int32 Cursor = 0;
+            for (FSTRewindImpactState& Impact : Out.Impacts)
+            {
+                const uint64 Tag = Prev ? Reader.VarUInt() : 0;
+                if (!(Tag & 1))
+                {
+                    ReadImpactFull(Reader, Impact);
+                    continue;
+                }
+
+                const int64 Match = Cursor + static_cast<int64>(Tag >> 2);
+                if (Match >= Prev->Impacts.Num())
+                {
+                    return false;
+                }
+
+                const FSTRewindImpactState& Base = Prev->Impacts[Match];
+                Impact = Base;
+                Impact.Elapsed = (Tag & 2) ? Reader.Pod<float>() : Base.Elapsed + StepSeconds;
+
+                Cursor = static_cast<int32>(Match) + 1;
+            }
+        }
+
+        return !Reader.bError;
+    }
+
+    int32 GetUncompressedSize(const FSTRewindState& State)
+    {
+        // Plain struct layout the history used before compression:
+        // header 48, spawner 24 (+8 per lane), enemy 16, tower 24, projectile 56, impact 20
+        return 48
+            + State.Spawners.Num() * 24
+            + State.Lanes.Num() * 8
+            + State.Enemies.Num() * 16
+            + State.Towers.Num() * 24
+            + State.Projectiles.Num() * 56
+            + State.Impacts.Num() * 20;
+    }
+}
@@ -0,0 +1,187 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+// ========================================================
+// Quantized simulation state
+// ========================================================
+//
+// What one rewind frame decodes to. USTRewindHistory fills it from the world
+// (quantizing) and applies it back (dequantizing); STRewindCodec packs it.
+// Enemy, tower and projectile lists are sorted by SimId (deltas merge-walk them).
+
+struct FSTRewindSpawnerState
+{
+    int32 SimId = INDEX_NONE;
+    int32 WaveIndex = INDEX_NONE;
+    float WaveClock = 0.f;
+    float TimeUntilNextWave = 0.f;
+    bool bWaveRunning = false;
+
+    /** FRandomStream::GetCurrentSeed() of the spawn jitter stream. */
+    int32 RandomSeed = 0;
+
+    /** This spawner's lanes in FSTRewindState::Lanes. */
+    int32 FirstLane = 0;
+    int32 NumLanes = 0;
+};
+
+struct FSTRewindLaneState
+{
+    int32 SpawnsDone = 0;
+    float NextSpawnTime = 0.f;
+};
+
+struct FSTRewindEnemyState
+{
+    int32 SimId = INDEX_NONE;
+    uint16 ClassIndex = 0;
+    uint16 PathIndex = 0;
+
+    /** Fraction of the path length, 0..65535. */
+    uint16 Distance = 0;
+
+    /** Fraction of MaxHealth, 0..65535. */
+    uint16 Health = 0;
+};
+
+struct FSTRewindTowerState
+{
+    int32 SimId = INDEX_NONE;
+
+    /** FRotator::CompressAxisToShort. */
+    uint16 Pitch = 0;
+    uint16 Yaw = 0;
+    uint16 Roll = 0;
+
+    /** Seconds in 1/CooldownScale steps. */
+    uint16 FireCooldown = 0;
+
+    /** Fraction of CaptureHPMax, 0..65535. */
+    uint16 CaptureHP = 0;
+
+    /** ETowerTeam / ETowerOrderState (captures are not rewound; these tell a restore which towers changed hands). */
+    uint8 Team = 0;
+    uint8 OrderState = 0;
+
+    /** Tower being captured by this one. */
+    int32 CaptureTargetSimId = INDEX_NONE;
+};
+
+struct FSTRewindProjectileState
+{
+    int32 SimId = INDEX_NONE;
+    int32 OwnerSimId = INDEX_NONE;
+    int32 TargetSimId = INDEX_NONE;
+    int32 BucketIndex = INDEX_NONE;
+    bool bHoming = false;
+
+    /** World units in 1/PositionScale steps. */
+    FIntVector Location = FIntVector::ZeroValue;
+    FIntVector Velocity = FIntVector::ZeroValue;
+
+    /** Game-milliseconds since launch. */
+    uint32 AgeMs = 0;
+
+    float Damage = 0.f;
+    float BaseSpeed = 0.f;
+    float HomingAcceleration = 0.f;
+};
+
+/** Scheduled-impact damage still on its way (USTGameEventScheduler::ScheduleImpact). */
+struct FSTRewindImpactState
+{
+    int32 TargetSimId = INDEX_NONE;
+    int32 SourceSimId = INDEX_NONE;
+    float Damage = 0.f;
+
+    /** Game-seconds from firing to impact, and how many of them have passed. */
+    float Delay = 0.f;
+    float Elapsed = 0.f;
+};
+
+struct FSTRewindState
+{
+    uint64 SimStepNumber = 0;
+    double GameTime = 0.0;
+    float GrossScore = 0.f;
+    int32 Lives = 0;
+    int32 NumEnemiesAlive = 0;
+
+    /** Id counters, so a replay from this state hands out the same ids again. */
+    int32 NextSimId = 0;
+    int32 NextProjectileSimId = 0;
+
+    TArray<FSTRewindSpawnerState> Spawners;
+    TArray<FSTRewindLaneState> Lanes;
+    TArray<FSTRewindEnemyState> Enemies;
+    TArray<FSTRewindTowerState> Towers;
+    TArray<FSTRewindProjectileState> Projectiles;
+
+    /** Pending impacts in scheduling order (not SimId-sorted). */
+    TArray<FSTRewindImpactState> Impacts;
+
+    /** Empty the lists but keep their allocations. */
+    void Reset();
+};
+
+/**
+ * Compact encoding of rewind frames.
+ *
+ *  - Keyframes store every entity; delta frames store each entity against the
+ *    same SimId in the previous frame (new entities in full)
+ *  - with the frame before that as well, values are extrapolated linearly and only
+ *    the residual is kept: enemies walking, projectiles flying straight, cooldowns
+ *    counting down and turrets turning at a steady rate all predict to within +-1
+ *  - each entity's tag packs its SimId gap and a 2-bit code per field (unchanged,
+ *    +1, -1, or "varint follows"), so a steadily moving enemy costs one byte
+ *  - header, spawner and tower team / order fields are only written when changed
+ *  - quantization happens before encoding; encode / decode themselves are lossless
+ */
+namespace STRewindCodec
+{
+    /** Projectile positions / velocities: 1/16 world unit. */
+    constexpr float PositionScale = 16.f;
+
+    /** Fire cooldown: 1/4096 s (max ~16 s). */
+    constexpr float CooldownScale = 4096.f;
+
+    /**
+     * Quantize Values[i] / Max[i] (clamped to 0..1) to 16 bits, four at a time.
+     * Max[i] <= 0 quantizes to 0.
+     */
+    ACTIONTOWERDEFENSE_API void QuantizeUnitBatch(const float* Values, const float* Max, uint16* Out, int32 Num);
+
+    /** Inverse of QuantizeUnitBatch: Out[i] = Values[i] / 65535 * Max[i], four at a time. */
+    ACTIONTOWERDEFENSE_API void DequantizeUnitBatch(const uint16* Values, const float* Max, float* Out, int32 Num);
+
+    ACTIONTOWERDEFENSE_API uint16 QuantizeUnit(float Value, float Max);
+    ACTIONTOWERDEFENSE_API float DequantizeUnit(uint16 Value, float Max);
+
+    ACTIONTOWERDEFENSE_API FIntVector QuantizePosition(const FVector& Value);
+    ACTIONTOWERDEFENSE_API FVector DequantizePosition(const FIntVector& Value);
+
+    /**
+     * Append State to Out. Without Prev a self-contained keyframe is written; with it,
+     * a delta against Prev (the frame recorded just before State). PrevPrev, the frame
+     * before Prev, is optional and enables linear prediction.
+     */
+    ACTIONTOWERDEFENSE_API void Encode(const FSTRewindState& State, const FSTRewindState* Prev, const FSTRewindState* PrevPrev,
+        TArray<uint8>& Out);
+
+    /**
+     * Decode a frame written by Encode. Delta frames need the same Prev (and PrevPrev,
+     * if one was used) they were encoded against. Returns false on malformed data or
+     * a missing base.
+     */
+    ACTIONTOWERDEFENSE_API bool Decode(const uint8* Data, int32 Size, const FSTRewindState* Prev, const FSTRewindState* PrevPrev,
+        FSTRewindState& Out);
+
+    /** True if the encoded frame at Data is a keyframe. */
+    ACTIONTOWERDEFENSE_API bool IsKeyframe(const uint8* Data, int32 Size);
+
+    /** Bytes the same frame takes as full-precision structs (for compression stats). */
+    ACTIONTOWERDEFENSE_API int32 GetUncompressedSize(const FSTRewindState& State);
+}
@@ -0,0 +1,295 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+// Rewind codec test: ActionTD.Rewind.Codec
+//
+// Runs STRewindCodec on synthetic FSTRewindStates, recorded the way
+// USTRewindHistory records them (a keyframe every KeyframeInterval frames, deltas
+// against the two frames before in between): enemies walking their paths and
+// occasionally taking damage, turrets turning and firing, straight projectiles
+// and scheduled impacts coming and going. Checks that every frame decodes back
+// bit-exact and that the whole recording reaches the 10x compression target.
+//
+//   UnrealEditor-Cmd ActionTowerDefense.uproject -nullrhi -unattended -nosplash
+//       -ExecCmds="Automation RunTests ActionTD.Rewind.Codec; Quit"
+
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Math/RandomStream.h"
+#include "STRewindCodec.h"
+
+namespace STRewindCodecTest
+{
+    constexpr int32 NumFrames = 600;
+    constexpr int32 KeyframeInterval = 30;
+    constexpr float StepSeconds = 1.f / 60.f;
+    constexpr double TargetRatio = 10.0;
+
+    constexpr int32 NumEnemies = 400;
+    constexpr int32 NumTowers = 24;
+    constexpr int32 NumProjectiles = 40;
+    constexpr int32 NumImpacts = 30;
+
+    constexpr float PathLength = 20000.f;
+    constexpr float ProjectileSpeed = 2000.f;
+
+    /** Full-precision world the states are quantized from. */
+    struct FWorld
+    {
+        struct FEnemy { int32 SimId; float Distance; float Speed; float Health; };
+        struct FTower { int32 SimId; float Yaw; float TurnRate; float Cooldown; };
+        struct FProjectile { int32 SimId; int32 Owner; FVector Location; FVector Velocity; float Age; };
+        struct FImpact { int32 Target; int32 Source; float Delay; float Elapsed; };
+
+        FRandomStream Random{ 1234 };
+        uint64 Step = 0;
+        double GameTime = 0.0;
+        int32 NextSimId = 0;
+        int32 NextProjectileSimId = 0;
+        float Score = 0.f;
+
+        TArray<FEnemy> Enemies;
+        TArray<FTower> Towers;
+        TArray<FProjectile> Projectiles;
+        TArray<FImpact> Impacts;
+
+        FWorld()
+        {
+            for (int32 Index = 0; Index < NumTowers; ++Index)
+            {
+                Towers.Add({ NextSimId++, Random.FRandRange(-180.f, 180.f), Random.FRandRange(-90.f, 90.f), 0.f });
+            }
+            for (int32 Index = 0; Index < NumEnemies; ++Index)
+            {
+                AddEnemy();
+            }
+            for (int32 Index = 0; Index < NumProjectiles; ++Index)
+            {
+                AddProjectile();
+            }
+            for (int32 Index = 0; Index < NumImpacts; ++Index)
+            {
+                AddImpact();
+            }
+        }
+
+        void AddEnemy()
+        {
+            Enemies.Add({ NextSimId++, Random.FRandRange(0.f, PathLength * 0.5f), Random.FRandRange(150.f, 450.f), 100.f });
+        }
+
+        void AddProjectile()
+        {
+            const FVector Direction = Random.GetUnitVector();
+            Projectiles.Add({ NextProjectileSimId++, Towers[Random.RandHelper(NumTowers)].SimId,
+                Random.GetUnitVector() * 1000.f, Direction * ProjectileSpeed, 0.f });
+        }
+
+        void AddImpact()
+        {
+            Impacts.Add({ Enemies[Random.RandHelper(Enemies.Num())].SimId, Towers[Random.RandHelper(NumTowers)].SimId,
+                Random.FRandRange(0.05f, 0.5f), 0.f });
+        }
+
+        void Advance()
+        {
+            ++Step;
+            GameTime += StepSeconds;
+
+            for (FEnemy& Enemy : Enemies)
+            {
+                Enemy.Distance += Enemy.Speed * StepSeconds;
+                if (Random.FRand() < 0.01f)
+                {
+                    Enemy.Health -= 10.f;
+                }
+            }
+
+            // Leaked or killed: replaced by a fresh spawn (ids stay sorted)
+            const int32 NumBefore = Enemies.Num();
+            Enemies.RemoveAll([](const FEnemy& Enemy) { return Enemy.Distance >= PathLength || Enemy.Health <= 0.f; });
+            for (int32 Index = Enemies.Num(); Index < NumBefore; ++Index)
+            {
+                AddEnemy();
+                Score += 10.f;
+            }
+
+            for (FTower& Tower : Towers)
+            {
+                Tower.Yaw = FRotator::NormalizeAxis(Tower.Yaw + Tower.TurnRate * StepSeconds);
+                Tower.Cooldown -= StepSeconds;
+                if (Tower.Cooldown <= 0.f)
+                {
+                    Tower.Cooldown += 1.f;
+                }
+                if (Random.FRand() < 0.005f)
+                {
+                    Tower.TurnRate = Random.FRandRange(-90.f, 90.f);
+                }
+            }
+
+            for (FProjectile& Projectile : Projectiles)
+            {
+                Projectile.Location += Projectile.Velocity * StepSeconds;
+                Projectile.Age += StepSeconds;
+            }
+            const int32 NumProjectilesBefore = Projectiles.Num();
+            Projectiles.RemoveAll([](const FProjectile& Projectile) { return Projectile.Age > 1.f; });
+            for (int32 Index = Projectiles.Num(); Index < NumProjectilesBefore; ++Index)
+            {
+                AddProjectile();
+            }
+
+            for (FImpact& Impact : Impacts)
+            {
+                Impact.Elapsed += StepSeconds;
+            }
+            const int32 NumImpactsBefore = Impacts.Num();
+            Impacts.RemoveAll([](const FImpact& Impact) { return Impact.Elapsed >= Impact.Delay; });
+            for (int32 Index = Impacts.Num(); Index < NumImpactsBefore; ++Index)
+            {
+                AddImpact();
+            }
+        }
+
+        void Capture(FSTRewindState& Out) const
+        {
+            Out.Reset();
+            Out.SimStepNumber = Step;
+            Out.GameTime = GameTime;
+            Out.GrossScore = Score;
+            Out.Lives = 20;
+            Out.NumEnemiesAlive = Enemies.Num();
+            Out.NextSimId = NextSimId;
+            Out.NextProjectileSimId = NextProjectileSimId;
+
+            FSTRewindSpawnerState& Spawner = Out.Spawners.AddDefaulted_GetRef();
+            Spawner.SimId = NumTowers + NumEnemies * 1000;
+            Spawner.WaveIndex = 0;
+            Spawner.WaveClock = static_cast<float>(GameTime);
+            Spawner.bWaveRunning = true;
+            Spawner.RandomSeed = Random.GetCurrentSeed();
+            Spawner.NumLanes = 1;
+            Out.Lanes.Add({ NextSimId, static_cast<float>(GameTime) + 0.5f });
+
+            for (const FEnemy& Enemy : Enemies)
+            {
+                FSTRewindEnemyState& State = Out.Enemies.AddDefaulted_GetRef();
+                State.SimId = Enemy.SimId;
+                State.Distance = STRewindCodec::QuantizeUnit(Enemy.Distance, PathLength);
+                State.Health = STRewindCodec::QuantizeUnit(Enemy.Health, 100.f);
+            }
+
+            for (const FTower& Tower : Towers)
+            {
+                FSTRewindTowerState& State = Out.Towers.AddDefaulted_GetRef();
+                State.SimId = Tower.SimId;
+                State.Yaw = FRotator::CompressAxisToShort(Tower.Yaw);
+                State.FireCooldown = static_cast<uint16>(FMath::RoundToInt32(Tower.Cooldown * STRewindCodec::CooldownScale));
+                State.CaptureHP = MAX_uint16;
+                State.Team = 1;
+            }
+
+            for (const FProjectile& Projectile : Projectiles)
+            {
+                FSTRewindProjectileState& State = Out.Projectiles.AddDefaulted_GetRef();
+                State.SimId = Projectile.SimId;
+                State.OwnerSimId = Projectile.Owner;
+                State.BucketIndex = 0;
+                State.Location = STRewindCodec::QuantizePosition(Projectile.Location);
+                State.Velocity = STRewindCodec::QuantizePosition(Projectile.Velocity);
+                State.AgeMs = static_cast<uint32>(FMath::RoundToInt32(Projectile.Age * 1000.f));
+                State.Damage = 20.f;
+                State.BaseSpeed = ProjectileSpeed;
+            }
+
+            for (const FImpact& Impact : Impacts)
+            {
+                Out.Impacts.Add({ Impact.Target, Impact.Source, 20.f, Impact.Delay, Impact.Elapsed });
+            }
+        }
+    };
+
+    /** Keyframe encodings carry every field in full: equal bytes means equal states. */
+    static bool StatesEqual(const FSTRewindState& A, const FSTRewindState& B)
+    {
+        TArray<uint8> BytesA;
+        TArray<uint8> BytesB;
+        STRewindCodec::Encode(A, nullptr, nullptr, BytesA);
+        STRewindCodec::Encode(B, nullptr, nullptr, BytesB);
+        return BytesA == BytesB;
+    }
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSTRewindCodecTest, "ActionTD.Rewind.Codec",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::ProductFilter)
+
+bool FSTRewindCodecTest::RunTest(const FString& Parameters)
+{
+    using namespace STRewindCodecTest;
+
+    FWorld World;
+
+    // Encoder side and decoder side each keep their own last two frames
+    FSTRewindState Captured;
+    FSTRewindState EncodePrev, EncodePrevPrev;
+    FSTRewindState DecodePrev, DecodePrevPrev;
+    FSTRewindState Decoded;
+
+    TArray<uint8> Frame;
+    int64 UncompressedBytes = 0;
+    int64 EncodedBytes = 0;
+    int32 FramesInGroup = 0;
+
+    for (int32 FrameIndex = 0; FrameIndex < NumFrames; ++FrameIndex)
+    {
+        World.Advance();
+        World.Capture(Captured);
+
+        const bool bKeyframe = FramesInGroup == 0;
+        const FSTRewindState* Prev = bKeyframe ? nullptr : &EncodePrev;
+        const FSTRewindState* PrevPrev = FramesInGroup >= 2 ? &EncodePrevPrev : nullptr;
+
+        Frame.Reset();
+        STRewindCodec::Encode(Captured, Prev, PrevPrev, Frame);
+
+        UncompressedBytes += STRewindCodec::GetUncompressedSize(Captured);
+        EncodedBytes += Frame.Num();
+
+        if (!TestEqual(FString::Printf(TEXT("Frame %d keyframe flag"), FrameIndex), STRewindCodec::IsKeyframe(Frame.GetData(), Frame.Num()), bKeyframe))
+        {
+            return false;
+        }
+
+        const bool bDecoded = STRewindCodec::Decode(Frame.GetData(), Frame.Num(),
+            bKeyframe ? nullptr : &DecodePrev, FramesInGroup >= 2 ? &DecodePrevPrev : nullptr, Decoded);
+
+        if (!TestTrue(FString::Printf(TEXT("Frame %d decodes"), FrameIndex), bDecoded)
+            || !TestTrue(FString::Printf(TEXT("Frame %d round trips exactly"), FrameIndex), StatesEqual(Captured, Decoded)))
+        {
+            return false;
+        }
+
+        Swap(EncodePrevPrev, EncodePrev);
+        EncodePrev = Captured;
+        Swap(DecodePrevPrev, DecodePrev);
+        Swap(DecodePrev, Decoded);
+
+        FramesInGroup = (FramesInGroup + 1) % KeyframeInterval;
+    }
+
+    // Delta frames need a base
+    TestFalse(TEXT("Delta without a base is rejected"), STRewindCodec::Decode(Frame.GetData(), Frame.Num(), nullptr, nullptr, Decoded));
+
+    const double Ratio = EncodedBytes > 0 ? static_cast<double>(UncompressedBytes) / EncodedBytes : 0.0;
+    AddInfo(FString::Printf(TEXT("%d frames | %lld B raw, %lld B encoded | %.1fx (target >= %.0fx)"),
+        NumFrames, UncompressedBytes, EncodedBytes, Ratio, TargetRatio));
+
+    TestTrue(FString::Printf(TEXT("Compression ratio %.1fx reaches %.0fx"), Ratio, TargetRatio), Ratio >= TargetRatio);
+
+    return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,2003 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "STRewindHistory.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "Algo/Sort.h"
+#include "Algo/BinarySearch.h"
+#include "STSimulationClock.h"
+#include "STProjectilePool.h"
+#include "STGameEventScheduler.h"
+#include "STGameController.h"
+#include "STGameState.h"
+#include "STSpawner.h"
+#include "STWorldRegistry.h"
+#include "STMatchStats.h"
+#include "STMatchRecorder.h"
+#include "EnemyBase.h"
+#include "TowerBase.h"
+#include "AttackTowerBase.h"
+#include "AMinigunTower.h"
+#include "TowerAttackComponent.h"
+#include "Projectile.h"
+#include "STMemoryTags.h"
+
+namespace STRewind
+{
+    static constexpr uint16 NoIndex = MAX_uint16;
+
+    /** Uncompressed / stored size the history has to reach (RunFidelityCheck). */
+    static constexpr double TargetCompressionRatio = 10.0;
+
+    /** First allocation of the ring; it doubles from there while under the budget. */
+    static constexpr int64 InitialRingBytes = 256 * 1024;
+
+    static int32 GetSimIdOf(const AActor* Actor)
+    {
+        if (const ASTEnemyBase* Enemy = Cast<ASTEnemyBase>(Actor))
+        {
+            return Enemy->GetSimId();
+        }
+        return INDEX_NONE;
+    }
+
+    static uint16 QuantizeCooldown(float Seconds)
+    {
+        return static_cast<uint16>(FMath::Clamp(FMath::RoundToInt32(Seconds * STRewindCodec::CooldownScale), 0, MAX_uint16));
+    }
+
+    static float DequantizeCooldown(uint16 Value)
+    {
+        return Value / STRewindCodec::CooldownScale;
+    }
+
+    /** Append a scalar's raw bytes to a checksum buffer. */
+    template <typename T>
+    static void AppendRaw(TArray<uint8>& Bytes, const T& Value)
+    {
+        Bytes.Append(reinterpret_cast<const uint8*>(&Value), sizeof(T));
+    }
+}
+
+// ========================================================
+// Subsystem
+// ========================================================
+
+void USTRewindHistory::Initialize(FSubsystemCollectionBase& Collection)
+{
+    Super::Initialize(Collection);
+
+    SimClock = Collection.InitializeDependency<USTSimulationClock>();
+    ProjectilePool = Collection.InitializeDependency<USTProjectilePoolSubsystem>();
+}
+
+void USTRewindHistory::Deinitialize()
+{
+    ClearHistory();
+    Ring.Empty();
+    MatchKeyframes.Empty();
+    WaveMarkers.Empty();
+    MatchKeyframeBytes = 0;
+    EnemyClasses.Reset();
+    PathActors.Reset();
+    PathLengths.Reset();
+    ClassNameChecksums.Reset();
+    ChecksumScratch.Empty();
+
+    Super::Deinitialize();
+}
+
+bool USTRewindHistory::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+    return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+USTRewindHistory* USTRewindHistory::Get(const UObject* WorldContextObject)
+{
+    if (!WorldContextObject)
+    {
+        return nullptr;
+    }
+
+    UWorld* World = WorldContextObject->GetWorld();
+    if (!World)
+    {
+        return nullptr;
+    }
+
+    return World->GetSubsystem<USTRewindHistory>();
+}
+
+void USTRewindHistory::SetBudget(float InHistorySeconds, int64 InMemoryBudgetBytes)
+{
+    HistorySeconds = FMath::Max(InHistorySeconds, 0.f);
+    MemoryBudgetBytes = FMath::Max<int64>(InMemoryBudgetBytes, 1024);
+
+    // Ring grows again from empty on the next record
+    ClearHistory();
+    Ring.Empty();
+}
+
+void USTRewindHistory::ClearHistory()
+{
+    Frames.Empty();
+    WriteHead = 0;
+    UsedBytes = 0;
+    UncompressedBytes = 0;
+    NumGroupStates = 0;
+}
+
+double USTRewindHistory::GetSecondsAvailable() const
+{
+    return Frames.Num() >= 2 ? Frames.Last().GameTime - Frames.First().GameTime : 0.0;
+}
+
+// ========================================================
+// Ring buffer
+// ========================================================
+
+void USTRewindHistory::PopOldestFrame()
+{
+    // Delta frames are useless without their keyframe: drop them together
+    do
+    {
+        UsedBytes -= Frames.First().Size;
+        UncompressedBytes -= Frames.First().UncompressedSize;
+        Frames.PopFront();
+    }
+    while (!Frames.IsEmpty() && !Frames.First().bKeyframe);
+
+    if (Frames.IsEmpty())
+    {
+        WriteHead = 0;
+        NumGroupStates = 0;
+    }
+}
+
+bool USTRewindHistory::GrowRing(int32 Size)
+{
+    const int64 MaxCapacity = FMath::Min<int64>(MemoryBudgetBytes, MAX_int32);
+    const int64 OldCapacity = Ring.Num();
+    const int64 Tail = Frames.IsEmpty() ? 0 : Frames.First().Offset;
+    const bool bWrapped = !Frames.IsEmpty() && WriteHead <= Tail;
+
+    // A wrapped ring moves its front part behind the old end, so the live bytes run up to OldCapacity + WriteHead
+    const int64 LiveEnd = Frames.IsEmpty() ? 0 : (bWrapped ? OldCapacity + WriteHead : WriteHead);
+    const int64 Needed = LiveEnd + Size;
+    const int64 NewCapacity = FMath::Min(MaxCapacity, FMath::Max3(Needed, OldCapacity * 2, STRewind::InitialRingBytes));
+    if (NewCapacity <= OldCapacity || NewCapacity < Needed)
+    {
+        return false;
+    }
+
+    Ring.SetNumUninitialized(static_cast<int32>(NewCapacity));
+
+    if (bWrapped)
+    {
+        FMemory::Memcpy(Ring.GetData() + OldCapacity, Ring.GetData(), WriteHead);
+        for (int32 Index = 0; Index < Frames.Num(); ++Index)
+        {
+            if (Frames[Index].Offset < Tail)
+            {
+                Frames[Index].Offset += OldCapacity;
+            }
+        }
+        WriteHead += OldCapacity;
+    }
+
+    return true;
+}
+
+bool USTRewindHistory::AllocateInRing(int32 Size, int64& OutOffset)
+{
+    if (Size > FMath::Min<int64>(MemoryBudgetBytes, MAX_int32))
+    {
+        return false;
+    }
+
+    for (;;)
+    {
+        const int64 Capacity = Ring.Num();
+
+        if (Frames.IsEmpty())
+        {
+            if (Capacity < Size && !GrowRing(Size))
+            {
+                return false;
+            }
+
+            OutOffset = 0;
+            return true;
+        }
+
+        // Live bytes run from the oldest frame up to the write head, possibly wrapping
+        const int64 Tail = Frames.First().Offset;
+
+        if (WriteHead > Tail)
+        {
+            // [Tail, WriteHead) live: room at the end, or at the start before Tail
+            if (Capacity - WriteHead >= Size)
+            {
+                OutOffset = WriteHead;
+                return true;
+            }
+            if (Tail >= Size)
+            {
+                OutOffset = 0;
+                return true;
+            }
+        }
+        else if (Tail - WriteHead >= Size)
+        {
+            // Wrapped: only the gap between head and tail is free
+            OutOffset = WriteHead;
+            return true;
+        }
+
+        // Full: grow while under the budget, drop the oldest frames once at it
+        if (!GrowRing(Size))
+        {
+            PopOldestFrame();
+        }
+    }
+}
+
+void USTRewindHistory::RecordFrame(uint64 SimStepNumber, double GameTime)
+{
+    ST_LLM_SCOPE(Rewind);
+
+    const bool bCaptured = RecordMatchTimeline(SimStepNumber, GameTime);
+
+    // Rewind off: only match keyframe steps pay for a capture
+    if (MemoryBudgetBytes <= 0 || HistorySeconds <= 0.f)
+    {
+        return;
+    }
+
+    if (!bCaptured)
+    {
+        CaptureState(SimStepNumber, GameTime, CaptureScratch);
+    }
+
+    bool bKeyframe = Frames.IsEmpty() || NumGroupStates == 0 || NumGroupStates >= KeyframeInterval;
+
+    FrameScratch.Reset();
+    if (bKeyframe)
+    {
+        STRewindCodec::Encode(CaptureScratch, nullptr, nullptr, FrameScratch);
+    }
+    else
+    {
+        const FSTRewindState* PrevPrev = NumGroupStates >= 2 ? &GroupStates[NumGroupStates - 2] : nullptr;
+        STRewindCodec::Encode(CaptureScratch, &GroupStates[NumGroupStates - 1], PrevPrev, FrameScratch);
+    }
+
+    int64 Offset = 0;
+    bool bAllocated = AllocateInRing(FrameScratch.Num(), Offset);
+
+    // Making room evicted the frames this delta was written against
+    if (bAllocated && !bKeyframe && Frames.IsEmpty())
+    {
+        bKeyframe = true;
+        FrameScratch.Reset();
+        STRewindCodec::Encode(CaptureScratch, nullptr, nullptr, FrameScratch);
+        bAllocated = AllocateInRing(FrameScratch.Num(), Offset);
+    }
+
+    if (!bAllocated)
+    {
+        // A single frame bigger than the whole budget: history is useless
+        UE_LOG(LogTemp, Warning,
+            TEXT("RewindHistory: frame of %d bytes exceeds the %lld byte budget; history disabled until it shrinks"),
+            FrameScratch.Num(), MemoryBudgetBytes);
+        ClearHistory();
+        return;
+    }
+
+    FMemory::Memcpy(Ring.GetData() + Offset, FrameScratch.GetData(), FrameScratch.Num());
+
+    FSTRewindFrameRef Ref;
+    Ref.Offset = Offset;
+    Ref.Size = FrameScratch.Num();
+    Ref.SimStepNumber = SimStepNumber;
+    Ref.GameTime = GameTime;
+    Ref.bKeyframe = bKeyframe;
+    Ref.UncompressedSize = STRewindCodec::GetUncompressedSize(CaptureScratch);
+    Frames.Add(Ref);
+
+    WriteHead = Offset + Ref.Size;
+    UsedBytes += Ref.Size;
+    UncompressedBytes += Ref.UncompressedSize;
+
+    // The captured state becomes the next frame's base; the recycled slot is the next capture buffer
+    if (bKeyframe)
+    {
+        NumGroupStates = 0;
+    }
+    if (NumGroupStates == GroupStates.Num())
+    {
+        GroupStates.AddDefaulted();
+    }
+    Swap(GroupStates[NumGroupStates++], CaptureScratch);
+
+    // Seconds budget: drop whole keyframe groups, never the one the newest frame needs
+    while (Frames.Num() > 2 && GameTime - Frames.First().GameTime > HistorySeconds)
+    {
+        int32 NextKeyframe = 1;
+        while (NextKeyframe < Frames.Num() && !Frames[NextKeyframe].bKeyframe)
+        {
+            ++NextKeyframe;
+        }
+
+        if (NextKeyframe >= Frames.Num())
+        {
+            break;
+        }
+
+        PopOldestFrame();
+    }
+}
+
+bool USTRewindHistory::DecodeGroupEndingAt(int32 Index)
+{
+    ST_LLM_SCOPE(Rewind);
+
+    NumGroupStates = 0;
+
+    int32 KeyIndex = Index;
+    while (KeyIndex > 0 && !Frames[KeyIndex].bKeyframe)
+    {
+        --KeyIndex;
+    }
+
+    if (!Frames[KeyIndex].bKeyframe)
+    {
+        return false;
+    }
+
+    // Every delta needs the two frames before it decoded: front to back
+    for (int32 FrameIndex = KeyIndex; FrameIndex <= Index; ++FrameIndex)
+    {
+        if (NumGroupStates == GroupStates.Num())
+        {
+            GroupStates.AddDefaulted();
+        }
+
+        const FSTRewindState* Prev = NumGroupStates >= 1 ? &GroupStates[NumGroupStates - 1] : nullptr;
+        const FSTRewindState* PrevPrev = NumGroupStates >= 2 ? &GroupStates[NumGroupStates - 2] : nullptr;
+
+        const FSTRewindFrameRef& Ref = Frames[FrameIndex];
+        if (!STRewindCodec::Decode(Ring.GetData() + Ref.Offset, Ref.Size, Prev, PrevPrev, GroupStates[NumGroupStates]))
+        {
+            NumGroupStates = 0;
+            return false;
+        }
+
+        ++NumGroupStates;
+    }
+
+    return true;
+}
+
+bool USTRewindHistory::RewindOneFrame(uint64& OutSimStepNumber, double& OutGameTime)
+{
+    if (!CanRewind())
+    {
+        return false;
+    }
+
+    // Newest frame is the current state; step back to the one before it
+    UsedBytes -= Frames.Last().Size;
+    UncompressedBytes -= Frames.Last().UncompressedSize;
+    Frames.Pop();
+
+    const FSTRewindFrameRef& Ref = Frames.Last();
+    WriteHead = Ref.Offset + Ref.Size;
+
+    // Still decoded while inside the newest group; stepping past its keyframe decodes the group before
+    NumGroupStates = FMath::Max(NumGroupStates - 1, 0);
+    if (NumGroupStates == 0 && !DecodeGroupEndingAt(Frames.Num() - 1))
+    {
+        UE_LOG(LogTemp, Warning, TEXT("RewindHistory: failed to decode frame %llu; history cleared"), Ref.SimStepNumber);
+        ClearHistory();
+        return false;
+    }
+
+    const FSTRewindState& State = GroupStates[NumGroupStates - 1];
+    ApplyState(State);
+
+    OutSimStepNumber = State.SimStepNumber;
+    OutGameTime = State.GameTime;
+    return true;
+}
+
+// ========================================================
+// Match timeline
+// ========================================================
+
+void USTRewindHistory::MarkWaveStart(int32 WaveIndex)
+{
+    // Replays re-run wave starts that are already marked
+    if (SimClock && SimClock->IsReplaying())
+    {
+        return;
+    }
+
+    PendingWaveIndex = WaveIndex;
+}
+
+void USTRewindHistory::DropMatchTimelineFrom(uint64 FirstDroppedStep)
+{
+    while (MatchKeyframes.Num() > 0 && MatchKeyframes.Last().SimStepNumber >= FirstDroppedStep)
+    {
+        MatchKeyframeBytes -= MatchKeyframes.Last().GetAllocatedSize();
+        MatchKeyframes.Pop();
+    }
+
+    while (WaveMarkers.Num() > 0 && WaveMarkers.Last().SimStepNumber >= FirstDroppedStep)
+    {
+        WaveMarkers.Pop();
+    }
+}
+
+bool USTRewindHistory::RecordMatchTimeline(uint64 SimStepNumber, double GameTime)
+{
+    // A seek replaying up to its target: those keyframes are already there, and
+    // the step has to come out the way it did the first time
+    if (SimClock && SimClock->IsReplaying())
+    {
+        VerifySeekStep(SimStepNumber);
+        return false;
+    }
+
+    // Recording over a step again means we rewound: that future is gone
+    DropMatchTimelineFrom(SimStepNumber);
+
+    // Only a match recording / playback pays for the per-step checksum
+    if (MatchRecorder && MatchRecorder->WantsStepChecksums())
+    {
+        MatchRecorder->RecordStepChecksum(SimStepNumber, ComputeStateChecksum());
+    }
+
+    const bool bWaveStart = PendingWaveIndex != INDEX_NONE;
+    if (bWaveStart)
+    {
+        FSTWaveMarker& Marker = WaveMarkers.AddDefaulted_GetRef();
+        Marker.WaveIndex = PendingWaveIndex;
+        Marker.SimStepNumber = SimStepNumber;
+        Marker.GameTime = GameTime;
+        PendingWaveIndex = INDEX_NONE;
+    }
+
+    // Wave starts always get a keyframe so seeking to them needs no replay; commands
+    // get one so no replay has to know about them
+    if (!bWaveStart && !bMatchKeyframeRequested && MatchKeyframes.Num() > 0
+        && GameTime - MatchKeyframes.Last().GameTime < MatchKeyframeSeconds - UE_KINDA_SMALL_NUMBER)
+    {
+        return false;
+    }
+
+    bMatchKeyframeRequested = false;
+
+    CaptureState(SimStepNumber, GameTime, CaptureScratch);
+
+    FSTMatchKeyframe& Keyframe = MatchKeyframes.AddDefaulted_GetRef();
+    Keyframe.SimStepNumber = SimStepNumber;
+    Keyframe.GameTime = GameTime;
+    STRewindCodec::Encode(CaptureScratch, nullptr, nullptr, Keyframe.Data);
+    Keyframe.Data.Shrink();
+    CaptureExact(CaptureScratch, Keyframe.Exact);
+
+    MatchKeyframeBytes += Keyframe.GetAllocatedSize();
+    return true;
+}
+
+bool USTRewindHistory::FindWaveStartStep(int32 WaveIndex, uint64& OutSimStepNumber) const
+{
+    // Newest first: looping wave sets start the same index more than once
+    for (int32 Index = WaveMarkers.Num() - 1; Index >= 0; --Index)
+    {
+        if (WaveMarkers[Index].WaveIndex == WaveIndex)
+        {
+            OutSimStepNumber = WaveMarkers[Index].SimStepNumber;
+            return true;
+        }
+    }
+    return false;
+}
+
+uint64 USTRewindHistory::GetStepForGameTime(double TargetGameTime) const
+{
+    if (MatchKeyframes.Num() == 0)
+    {
+        return 0;
+    }
+
+    // Steps after a keyframe are FixedStepSeconds apart
+    const int32 Index = FMath::Max(0,
+        Algo::UpperBoundBy(MatchKeyframes, TargetGameTime, &FSTMatchKeyframe::GameTime) - 1);
+    const FSTMatchKeyframe& Keyframe = MatchKeyframes[Index];
+
+    const double StepSeconds = SimClock ? SimClock->GetFixedStepSeconds() : 1.0 / 60.0;
+    const int64 StepsAfter = FMath::Max<int64>(0, FMath::RoundToInt64((TargetGameTime - Keyframe.GameTime) / StepSeconds));
+
+    return Keyframe.SimStepNumber + StepsAfter;
+}
+
+bool USTRewindHistory::RestoreMatchKeyframe(uint64 TargetStep, uint64& OutSimStepNumber, double& OutGameTime)
+{
+    ST_LLM_SCOPE(Rewind);
+
+    if (!SimClock)
+    {
+        return false;
+    }
+
+    const int32 Index = Algo::UpperBoundBy(MatchKeyframes, TargetStep, &FSTMatchKeyframe::SimStepNumber) - 1;
+    if (!MatchKeyframes.IsValidIndex(Index))
+    {
+        return false;
+    }
+
+    const FSTMatchKeyframe& Keyframe = MatchKeyframes[Index];
+    if (!STRewindCodec::Decode(Keyframe.Data.GetData(), Keyframe.Data.Num(), nullptr, nullptr, DecodeScratch))
+    {
+        UE_LOG(LogTemp, Warning, TEXT("RewindHistory: failed to decode match keyframe %llu"), Keyframe.SimStepNumber);
+        return false;
+    }
+
+    // Nothing in flight in the current timeline may leak into the replay
+    if (ProjectilePool)
+    {
+        ProjectilePool->ReleaseAllProjectiles();
+    }
+
+    if (USTGameEventScheduler* Scheduler = USTGameEventScheduler::Get(this))
+    {
+        Scheduler->CancelAllEvents();
+    }
+
+    SeekDivergedStep = INDEX_NONE;
+
+    ApplyState(DecodeScratch);
+
+    // Towers the keyframe does not know (upgraded in since) start without targets
+    int32 NextSimId = DecodeScratch.NextSimId;
+    for (ATowerBase* Tower : SimClock->GetTowers())
+    {
+        if (!Tower)
+        {
+            continue;
+        }
+
+        // Towers are not rewound: never hand a live tower's id out twice
+        NextSimId = FMath::Max(NextSimId, Tower->SimId + 1);
+
+        if (AAttackTowerBase* AttackTower = Cast<AAttackTowerBase>(Tower))
+        {
+            if (AttackTower->AttackComponent)
+            {
+                AttackTower->AttackComponent->ClearTargets();
+            }
+        }
+    }
+
+    ApplyExact(DecodeScratch, Keyframe.Exact);
+
+    SimClock->SetNextSimId(NextSimId);
+    if (ProjectilePool)
+    {
+        ProjectilePool->SetNextProjectileSimId(DecodeScratch.NextProjectileSimId);
+    }
+
+    // The replay re-records the ring; the timeline past the target is abandoned
+    DropMatchTimelineFrom(TargetStep + 1);
+    ClearHistory();
+    PendingWaveIndex = INDEX_NONE;
+
+    OutSimStepNumber = DecodeScratch.SimStepNumber;
+    OutGameTime = DecodeScratch.GameTime;
+    return true;
+}
+
+void USTRewindHistory::VerifySeekStep(uint64 SimStepNumber)
+{
+    // One report per seek; without a recording there is nothing to check against
+    uint32 RecordedChecksum = 0;
+    if (SeekDivergedStep != INDEX_NONE || !MatchRecorder || !MatchRecorder->FindStepChecksum(SimStepNumber, RecordedChecksum))
+    {
+        return;
+    }
+
+    if (ComputeStateChecksum() != RecordedChecksum)
+    {
+        SeekDivergedStep = static_cast<int64>(SimStepNumber);
+        UE_LOG(LogTemp, Warning, TEXT("RewindHistory: seek replay diverged from the recorded timeline at step %llu"), SimStepNumber);
+    }
+}
+
+uint16 USTRewindHistory::GetEnemyClassIndex(UClass* EnemyClass)
+{
+    int32 Index = EnemyClasses.Find(EnemyClass);
+    if (Index == INDEX_NONE)
+    {
+        Index = EnemyClasses.Add(EnemyClass);
+    }
+    return static_cast<uint16>(Index);
+}
+
+uint16 USTRewindHistory::GetPathIndex(AActor* PathActor)
+{
+    if (!PathActor)
+    {
+        return STRewind::NoIndex;
+    }
+
+    int32 Index = PathActors.Find(PathActor);
+    if (Index == INDEX_NONE)
+    {
+        Index = PathActors.Add(PathActor);
+
+        USTWorldRegistrySubsystem* Registry = USTWorldRegistrySubsystem::Get(this);
+        const FSTPathInfo* Info = Registry ? Registry->RegisterPath(PathActor) : nullptr;
+        PathLengths.Add(Info ? Info->Length : 0.f);
+    }
+    return static_cast<uint16>(Index);
+}
+
+float USTRewindHistory::GetPathLength(uint16 PathIndex) const
+{
+    return PathLengths.IsValidIndex(PathIndex) ? PathLengths[PathIndex] : 0.f;
+}
+
+// ========================================================
+// Capture (world -> quantized state)
+// ========================================================
+
+void USTRewindHistory::CaptureState(uint64 SimStepNumber, double GameTime, FSTRewindState& Out)
+{
+    Out.Reset();
+    Out.SimStepNumber = SimStepNumber;
+    Out.GameTime = GameTime;
+
+    if (!SimClock)
+    {
+        return;
+    }
+
+    // Includes removals the controller has queued but not processed yet
+    if (const ASTGameController* GC = ASTGameController::Get(this))
+    {
+        GC->GetSimCounters(Out.GrossScore, Out.Lives, Out.NumEnemiesAlive);
+    }
+    else if (const ASTGameState* GS = ASTGameState::Get(this))
+    {
+        Out.Lives = GS->Lives;
+    }
+
+    Out.NextSimId = SimClock->GetNextSimId();
+    if (ProjectilePool)
+    {
+        Out.NextProjectileSimId = ProjectilePool->GetNextProjectileSimId();
+    }
+
+    // --- Spawners ---
+    for (const ASTSpawner* Spawner : SimClock->GetSpawners())
+    {
+        if (!Spawner)
+        {
+            continue;
+        }
+
+        FSTRewindSpawnerState& State = Out.Spawners.AddDefaulted_GetRef();
+        State.SimId = Spawner->SimId;
+        State.WaveIndex = Spawner->CurrentWaveIndex;
+        State.WaveClock = Spawner->WaveClock;
+        State.TimeUntilNextWave = Spawner->TimeUntilNextWave;
+        State.bWaveRunning = Spawner->bWaveRunning;
+        State.RandomSeed = Spawner->RandomStream.GetCurrentSeed();
+        State.FirstLane = Out.Lanes.Num();
+        State.NumLanes = Spawner->LaneStates.Num();
+
+        for (const FSTLaneRuntimeState& Lane : Spawner->LaneStates)
+        {
+            FSTRewindLaneState& LaneState = Out.Lanes.AddDefaulted_GetRef();
+            LaneState.SpawnsDone = Lane.SpawnsDone;
+            LaneState.NextSpawnTime = Lane.NextSpawnTime;
+        }
+    }
+
+    // --- Enemies: gather, then quantize distance / health four at a time ---
+    EnemyScratch.Reset();
+    for (ASTEnemyBase* Enemy : SimClock->GetEnemies())
+    {
+        if (Enemy)
+        {
+            EnemyScratch.Add(Enemy);
+        }
+    }
+    Algo::SortBy(EnemyScratch, [](const ASTEnemyBase* Enemy) { return Enemy->SimId; });
+
+    const int32 NumEnemies = EnemyScratch.Num();
+    Out.Enemies.SetNum(NumEnemies);
+    QuantValues.SetNumUninitialized(NumEnemies);
+    QuantMax.SetNumUninitialized(NumEnemies);
+    QuantPacked.SetNumUninitialized(NumEnemies);
+
+    for (int32 Index = 0; Index < NumEnemies; ++Index)
+    {
+        const ASTEnemyBase* Enemy = EnemyScratch[Index];
+        FSTRewindEnemyState& State = Out.Enemies[Index];
+
+        State.SimId = Enemy->SimId;
+        State.ClassIndex = GetEnemyClassIndex(Enemy->GetClass());
+        State.PathIndex = GetPathIndex(Enemy->SplineActor);
+
+        QuantValues[Index] = Enemy->DistanceAlongSpline;
+        QuantMax[Index] = GetPathLength(State.PathIndex);
+    }
+
+    STRewindCodec::QuantizeUnitBatch(QuantValues.GetData(), QuantMax.GetData(), QuantPacked.GetData(), NumEnemies);
+    for (int32 Index = 0; Index < NumEnemies; ++Index)
+    {
+        Out.Enemies[Index].Distance = QuantPacked[Index];
+
+        QuantValues[Index] = EnemyScratch[Index]->CurrentHealth;
+        QuantMax[Index] = EnemyScratch[Index]->MaxHealth;
+    }
+
+    STRewindCodec::QuantizeUnitBatch(QuantValues.GetData(), QuantMax.GetData(), QuantPacked.GetData(), NumEnemies);
+    for (int32 Index = 0; Index < NumEnemies; ++Index)
+    {
+        Out.Enemies[Index].Health = QuantPacked[Index];
+    }
+
+    EnemyScratch.Reset();
+
+    // --- Towers ---
+    for (const ATowerBase* Tower : SimClock->GetTowers())
+    {
+        if (!Tower)
+        {
+            continue;
+        }
+
+        FSTRewindTowerState& State = Out.Towers.AddDefaulted_GetRef();
+        State.SimId = Tower->SimId;
+        State.CaptureHP = STRewindCodec::QuantizeUnit(Tower->CaptureHP, Tower->CaptureHPMax);
+        State.Team = static_cast<uint8>(Tower->Team);
+        State.CaptureTargetSimId = Tower->AssignedCaptureTarget ? Tower->AssignedCaptureTarget->SimId : INDEX_NONE;
+
+        if (const AAttackTowerBase* AttackTower = Cast<AAttackTowerBase>(Tower))
+        {
+            State.OrderState = static_cast<uint8>(AttackTower->CurrentOrderState);
+
+            State.Pitch = FRotator::CompressAxisToShort(AttackTower->SimRotation.Pitch);
+            State.Yaw = FRotator::CompressAxisToShort(AttackTower->SimRotation.Yaw);
+            State.Roll = FRotator::CompressAxisToShort(AttackTower->SimRotation.Roll);
+
+            if (AttackTower->AttackComponent)
+            {
+                State.FireCooldown = STRewind::QuantizeCooldown(AttackTower->AttackComponent->FireCooldown);
+            }
+        }
+    }
+    Algo::SortBy(Out.Towers, &FSTRewindTowerState::SimId);
+
+    // --- Projectiles ---
+    if (ProjectilePool)
+    {
+        for (const AProjectile* Projectile : ProjectilePool->GetActiveProjectiles())
+        {
+            if (!Projectile || !Projectile->IsActiveInPool())
+            {
+                continue;
+            }
+
+            FSTRewindProjectileState& State = Out.Projectiles.AddDefaulted_GetRef();
+            State.SimId = Projectile->SimId;
+            State.BucketIndex = Projectile->PoolBucketIndex;
+            State.bHoming = Projectile->bWasHomingProjectile;
+            State.Location = STRewindCodec::QuantizePosition(Projectile->SimLocation);
+            State.Velocity = STRewindCodec::QuantizePosition(Projectile->SimVelocity);
+            State.AgeMs = static_cast<uint32>(FMath::Max(0, FMath::RoundToInt32(Projectile->Age * 1000.f)));
+            State.Damage = Projectile->Damage;
+            State.BaseSpeed = Projectile->BaseSpeed;
+            State.HomingAcceleration = Projectile->HomingAcceleration;
+            State.TargetSimId = STRewind::GetSimIdOf(Projectile->TargetActor.Get());
+
+            if (const ATowerBase* OwnerTower = Cast<ATowerBase>(Projectile->GetOwner()))
+            {
+                State.OwnerSimId = OwnerTower->SimId;
+            }
+        }
+
+        // Pool order changes with every release; the codec wants id order
+        Algo::SortBy(Out.Projectiles, &FSTRewindProjectileState::SimId);
+    }
+
+    // --- Scheduled impacts ---
+    if (const USTGameEventScheduler* Scheduler = USTGameEventScheduler::Get(this))
+    {
+        Scheduler->GetPendingImpacts(EventScratch);
+        for (const FSTScheduledGameEvent* Event : EventScratch)
+        {
+            FSTRewindImpactState& State = Out.Impacts.AddDefaulted_GetRef();
+            State.TargetSimId = STRewind::GetSimIdOf(Cast<AActor>(Event->BoundObject.Get()));
+            State.SourceSimId = Event->ImpactSource.IsValid() ? Event->ImpactSource->SimId : INDEX_NONE;
+            State.Damage = Event->ImpactDamage;
+            State.Delay = Event->Delay;
+            State.Elapsed = Event->Elapsed;
+        }
+        EventScratch.Reset();
+    }
+}
+
+void USTRewindHistory::CaptureExact(const FSTRewindState& State, FSTMatchKeyframeExact& Out)
+{
+    if (!SimClock)
+    {
+        return;
+    }
+
+    // --- Enemies (id order, like CaptureState) ---
+    EnemyScratch.Reset();
+    for (ASTEnemyBase* Enemy : SimClock->GetEnemies())
+    {
+        if (Enemy)
+        {
+            EnemyScratch.Add(Enemy);
+        }
+    }
+    Algo::SortBy(EnemyScratch, [](const ASTEnemyBase* Enemy) { return Enemy->SimId; });
+
+    Out.Enemies.Reset(EnemyScratch.Num());
+    for (const ASTEnemyBase* Enemy : EnemyScratch)
+    {
+        FSTMatchKeyframeExact::FEnemy& Exact = Out.Enemies.AddDefaulted_GetRef();
+        Exact.Distance = Enemy->DistanceAlongSpline;
+        Exact.Health = Enemy->CurrentHealth;
+    }
+    EnemyScratch.Reset();
+
+    // --- Towers: values, then each one's target queue ---
+    TMap<int32, const ATowerBase*> TowersById;
+    for (const ATowerBase* Tower : SimClock->GetTowers())
+    {
+        if (Tower)
+        {
+            TowersById.Add(Tower->SimId, Tower);
+        }
+    }
+
+    Out.Towers.Reset(State.Towers.Num());
+    Out.TargetQueues.Reset();
+    for (const FSTRewindTowerState& Record : State.Towers)
+    {
+        FSTMatchKeyframeExact::FTower& Exact = Out.Towers.AddDefaulted_GetRef();
+        const int32 QueueHeader = Out.TargetQueues.Num();
+        Out.TargetQueues.Add(INDEX_NONE);
+        Out.TargetQueues.Add(0);
+
+        const ATowerBase* Tower = TowersById.FindRef(Record.SimId);
+        if (!Tower)
+        {
+            continue;
+        }
+
+        Exact.CaptureHP = Tower->CaptureHP;
+        Exact.CaptureStartGameTime = Tower->CaptureStartGameTime;
+
+        if (const AMinigunTower* Minigun = Cast<AMinigunTower>(Tower))
+        {
+            Exact.MuzzleIndex = Minigun->CurrentMuzzleIndex;
+        }
+
+        const AAttackTowerBase* AttackTower = Cast<AAttackTowerBase>(Tower);
+        if (!AttackTower)
+        {
+            continue;
+        }
+
+        Exact.Rotation = AttackTower->SimRotation;
+
+        if (const UTowerAttackComponent* Attack = AttackTower->AttackComponent)
+        {
+            Exact.FireCooldown = Attack->FireCooldown;
+            Out.TargetQueues[QueueHeader] = STRewind::GetSimIdOf(Attack->CurrentTarget.Get());
+
+            for (const TWeakObjectPtr<AActor>& Queued : Attack->EnemyQueue)
+            {
+                const int32 QueuedId = STRewind::GetSimIdOf(Queued.Get());
+                if (QueuedId != INDEX_NONE)
+                {
+                    Out.TargetQueues.Add(QueuedId);
+                    ++Out.TargetQueues[QueueHeader + 1];
+                }
+            }
+        }
+    }
+
+    // --- Projectiles: values in state order, plus the pool's step order ---
+    Out.Projectiles.Reset(State.Projectiles.Num());
+    Out.ProjectileOrder.Reset();
+    if (ProjectilePool)
+    {
+        TMap<int32, const AProjectile*> ProjectilesById;
+        for (const AProjectile* Projectile : ProjectilePool->GetActiveProjectiles())
+        {
+            if (Projectile && Projectile->IsActiveInPool())
+            {
+                ProjectilesById.Add(Projectile->SimId, Projectile);
+                Out.ProjectileOrder.Add(Projectile->SimId);
+            }
+        }
+
+        for (const FSTRewindProjectileState& Record : State.Projectiles)
+        {
+            FSTMatchKeyframeExact::FProjectile& Exact = Out.Projectiles.AddDefaulted_GetRef();
+            if (const AProjectile* Projectile = ProjectilesById.FindRef(Record.SimId))
+            {
+                Exact.Location = Projectile->SimLocation;
+                Exact.Velocity = Projectile->SimVelocity;
+                Exact.Age = Projectile->Age;
+            }
+        }
+    }
+
+    // --- Scheduler: impacts and projectile lifetimes, in firing order ---
+    Out.EventOrder.Reset();
+    Out.LifetimeElapsed.Reset();
+    if (const USTGameEventScheduler* Scheduler = USTGameEventScheduler::Get(this))
+    {
+        Scheduler->GetPendingEvents(EventScratch);
+        for (const FSTScheduledGameEvent* Event : EventScratch)
+        {
+            if (Event->bImpact)
+            {
+                Out.EventOrder.Add(INDEX_NONE);
+            }
+            else if (const AProjectile* Projectile = Cast<AProjectile>(Event->BoundObject.Get()))
+            {
+                if (Projectile->LifetimeEventId == Event->Id)
+                {
+                    Out.EventOrder.Add(Projectile->SimId);
+                    Out.LifetimeElapsed.Add(Event->Elapsed);
+                }
+            }
+        }
+        EventScratch.Reset();
+    }
+
+    Out.TargetQueues.Shrink();
+    Out.ProjectileOrder.Shrink();
+    Out.EventOrder.Shrink();
+    Out.LifetimeElapsed.Shrink();
+}
+
+// ========================================================
+// Restore (decoded state -> world)
+// ========================================================
+
+ASTEnemyBase* USTRewindHistory::RespawnEnemy(int32 SimId, uint16 ClassIndex, uint16 PathIndex)
+{
+    ST_LLM_SCOPE(Enemies);
+
+    UWorld* World = GetWorld();
+    if (!World || !EnemyClasses.IsValidIndex(ClassIndex) || !EnemyClasses[ClassIndex])
+    {
+        return nullptr;
+    }
+
+    ASTEnemyBase* Enemy = World->SpawnActorDeferred<ASTEnemyBase>(
+        EnemyClasses[ClassIndex],
+        FTransform::Identity,
+        nullptr,
+        nullptr,
+        ESpawnActorCollisionHandlingMethod::AlwaysSpawn);
+
+    if (!Enemy)
+    {
+        return nullptr;
+    }
+
+    // Set before BeginPlay so the clock keeps the old id instead of allocating one
+    Enemy->SimId = SimId;
+    Enemy->FinishSpawning(FTransform::Identity);
+
+    if (PathActors.IsValidIndex(PathIndex) && PathActors[PathIndex])
+    {
+        Enemy->SetSplineActor(PathActors[PathIndex]);
+    }
+
+    // Already counted in the snapshot's NumEnemiesAlive; its life component reports the removal
+
+    return Enemy;
+}
+
+void USTRewindHistory::ApplyState(const FSTRewindState& State)
+{
+    if (!SimClock)
+    {
+        return;
+    }
+
+    // Stat events after this step did not happen (seek replays record them again)
+    if (USTMatchStats* Stats = USTMatchStats::Get(this))
+    {
+        Stats->DiscardAfterStep(State.SimStepNumber);
+    }
+
+    // --- Spawners ---
+    {
+        TMap<int32, ASTSpawner*> LiveSpawners;
+        for (ASTSpawner* Spawner : SimClock->GetSpawners())
+        {
+            if (Spawner)
+            {
+                LiveSpawners.Add(Spawner->SimId, Spawner);
+            }
+        }
+
+        for (const FSTRewindSpawnerState& Record : State.Spawners)
+        {
+            ASTSpawner* Spawner = LiveSpawners.FindRef(Record.SimId);
+            if (!Spawner)
+            {
+                continue;
+            }
+
+            Spawner->CurrentWaveIndex = Record.WaveIndex;
+            Spawner->WaveClock = Record.WaveClock;
+            Spawner->TimeUntilNextWave = Record.TimeUntilNextWave;
+            Spawner->bWaveRunning = Record.bWaveRunning;
+            Spawner->RandomStream.Initialize(Record.RandomSeed);
+            Spawner->LaneStates.SetNum(Record.NumLanes);
+
+            for (int32 Lane = 0; Lane < Record.NumLanes; ++Lane)
+            {
+                const FSTRewindLaneState& LaneState = State.Lanes[Record.FirstLane + Lane];
+                Spawner->LaneStates[Lane].SpawnsDone = LaneState.SpawnsDone;
+                Spawner->LaneStates[Lane].NextSpawnTime = LaneState.NextSpawnTime;
+            }
+        }
+    }
+
+    // --- Enemies ---
+    TMap<int32, ASTEnemyBase*> EnemiesById;
+    {
+        EnemiesById.Reserve(State.Enemies.Num());
+        for (const FSTRewindEnemyState& Record : State.Enemies)
+        {
+            EnemiesById.Add(Record.SimId, nullptr);
+        }
+
+        // Spawned after this frame: remove quietly (no kill / leak notification)
+        TArray<ASTEnemyBase*, TInlineAllocator<32>> ToRemove;
+        for (ASTEnemyBase* Enemy : SimClock->GetEnemies())
+        {
+            if (!Enemy)
+            {
+                continue;
+            }
+
+            if (ASTEnemyBase** Slot = EnemiesById.Find(Enemy->SimId))
+            {
+                *Slot = Enemy;
+            }
+            else
+            {
+                ToRemove.Add(Enemy);
+            }
+        }
+
+        for (ASTEnemyBase* Enemy : ToRemove)
+        {
+            Enemy->Destroy();
+        }
+
+        // Resolve (or resurrect) every recorded enemy, then dequantize in batches
+        const int32 NumEnemies = State.Enemies.Num();
+        EnemyScratch.SetNumUninitialized(NumEnemies);
+        QuantPacked.SetNumUninitialized(NumEnemies);
+        QuantMax.SetNumUninitialized(NumEnemies);
+        QuantValues.SetNumUninitialized(NumEnemies);
+
+        for (int32 Index = 0; Index < NumEnemies; ++Index)
+        {
+            const FSTRewindEnemyState& Record = State.Enemies[Index];
+
+            // Killed or leaked after this frame: bring it back
+            ASTEnemyBase*& Enemy = EnemiesById.FindChecked(Record.SimId);
+            if (!Enemy)
+            {
+                Enemy = RespawnEnemy(Record.SimId, Record.ClassIndex, Record.PathIndex);
+            }
+
+            EnemyScratch[Index] = Enemy;
+            QuantPacked[Index] = Record.Distance;
+            QuantMax[Index] = GetPathLength(Record.PathIndex);
+        }
+
+        STRewindCodec::DequantizeUnitBatch(QuantPacked.GetData(), QuantMax.GetData(), QuantValues.GetData(), NumEnemies);
+        for (int32 Index = 0; Index < NumEnemies; ++Index)
+        {
+            if (ASTEnemyBase* Enemy = EnemyScratch[Index])
+            {
+                Enemy->DistanceAlongSpline = QuantValues[Index];
+                Enemy->PrevDistanceAlongSpline = QuantValues[Index];
+                QuantMax[Index] = Enemy->MaxHealth;
+            }
+            else
+            {
+                QuantMax[Index] = 0.f;
+            }
+            QuantPacked[Index] = State.Enemies[Index].Health;
+        }
+
+        STRewindCodec::DequantizeUnitBatch(QuantPacked.GetData(), QuantMax.GetData(), QuantValues.GetData(), NumEnemies);
+        for (int32 Index = 0; Index < NumEnemies; ++Index)
+        {
+            if (ASTEnemyBase* Enemy = EnemyScratch[Index])
+            {
+                Enemy->CurrentHealth = QuantValues[Index];
+                Enemy->RefreshSimLocation();
+                Enemy->SetActorLocation(Enemy->SimLocation);
+            }
+        }
+
+        EnemyScratch.Reset();
+    }
+
+    // --- Towers ---
+    TMap<int32, ATowerBase*> TowersById;
+    for (ATowerBase* Tower : SimClock->GetTowers())
+    {
+        if (Tower)
+        {
+            TowersById.Add(Tower->SimId, Tower);
+        }
+    }
+
+    for (const FSTRewindTowerState& Record : State.Towers)
+    {
+        // Upgraded away since (upgrades are not rewound)
+        ATowerBase* Tower = TowersById.FindRef(Record.SimId);
+        if (!Tower)
+        {
+            continue;
+        }
+
+        // Captures are not rewound: a tower that changed hands since keeps its
+        // current capture HP and orders instead of the ones recorded for its old team
+        const bool bSameTeam = static_cast<uint8>(Tower->Team) == Record.Team;
+        if (bSameTeam)
+        {
+            Tower->CaptureHP = STRewindCodec::DequantizeUnit(Record.CaptureHP, Tower->CaptureHPMax);
+        }
+
+        if (AAttackTowerBase* AttackTower = Cast<AAttackTowerBase>(Tower))
+        {
+            AttackTower->SimRotation = FRotator(
+                FRotator::DecompressAxisFromShort(Record.Pitch),
+                FRotator::DecompressAxisFromShort(Record.Yaw),
+                FRotator::DecompressAxisFromShort(Record.Roll));
+            AttackTower->PrevSimRotation = AttackTower->SimRotation;
+            AttackTower->SetActorRotation(AttackTower->SimRotation);
+
+            if (AttackTower->AttackComponent)
+            {
+                AttackTower->AttackComponent->FireCooldown = STRewind::DequantizeCooldown(Record.FireCooldown);
+            }
+
+            // Bonus actors have no SimId: a bonus order is left as it is
+            const ETowerOrderState RecordedOrder = static_cast<ETowerOrderState>(Record.OrderState);
+            ATowerBase* CaptureTarget = TowersById.FindRef(Record.CaptureTargetSimId);
+            if (bSameTeam && RecordedOrder != ETowerOrderState::AttackBonus
+                && (AttackTower->CurrentOrderState != RecordedOrder || AttackTower->AssignedCaptureTarget != CaptureTarget))
+            {
+                AttackTower->SetOrderState(RecordedOrder, CaptureTarget);
+            }
+        }
+    }
+
+    // --- Projectiles ---
+    if (ProjectilePool)
+    {
+        TMap<int32, AProjectile*> ProjectilesById;
+        ProjectilesById.Reserve(State.Projectiles.Num());
+        for (const FSTRewindProjectileState& Record : State.Projectiles)
+        {
+            ProjectilesById.Add(Record.SimId, nullptr);
+        }
+
+        // Fired after this frame: back into the pool
+        TArray<AProjectile*, TInlineAllocator<64>> ToRelease;
+        for (AProjectile* Projectile : ProjectilePool->GetActiveProjectiles())
+        {
+            if (!Projectile)
+            {
+                continue;
+            }
+
+            if (AProjectile** Slot = ProjectilesById.Find(Projectile->SimId))
+            {
+                *Slot = Projectile;
+            }
+            else
+            {
+                ToRelease.Add(Projectile);
+            }
+        }
+
+        for (AProjectile* Projectile : ToRelease)
+        {
+            Projectile->ReturnToPool();
+        }
+
+        for (const FSTRewindProjectileState& Record : State.Projectiles)
+        {
+            const FVector Location = STRewindCodec::DequantizePosition(Record.Location);
+            const FVector Velocity = STRewindCodec::DequantizePosition(Record.Velocity);
+            const float Age = Record.AgeMs / 1000.f;
+
+            AProjectile*& Projectile = ProjectilesById.FindChecked(Record.SimId);
+            bool bReacquired = false;
+
+            // Hit or expired after this frame: take it back out of the pool
+            if (!Projectile)
+            {
+                Projectile = ProjectilePool->AcquireForRestore(
+                    Record.BucketIndex,
+                    Record.SimId,
+                    TowersById.FindRef(Record.OwnerSimId),
+                    FTransform(Velocity.Rotation(), Location));
+
+                if (!Projectile)
+                {
+                    continue;
+                }
+                bReacquired = true;
+            }
+
+            ASTEnemyBase* Target = EnemiesById.FindRef(Record.TargetSimId);
+
+            Projectile->TargetActor = Target;
+            Projectile->Damage = Record.Damage;
+            Projectile->BaseSpeed = Record.BaseSpeed;
+            Projectile->bWasHomingProjectile = Record.bHoming && Target;
+            Projectile->HomingAcceleration = Record.HomingAcceleration;
+            Projectile->SimLocation = Location;
+            Projectile->PrevSimLocation = Location;
+            Projectile->SimVelocity = Velocity;
+            Projectile->Age = Age;
+
+            // Surviving projectiles already had their lifetime rewound by the scheduler
+            if (bReacquired)
+            {
+                Projectile->ScheduleLifetime(Age);
+            }
+
+            Projectile->UpdatePresentation(1.f);
+        }
+    }
+
+    // --- Scheduled impacts: whatever was in flight at this frame lands again ---
+    if (USTGameEventScheduler* Scheduler = USTGameEventScheduler::Get(this))
+    {
+        Scheduler->CancelAllImpacts();
+
+        for (const FSTRewindImpactState& Record : State.Impacts)
+        {
+            if (ASTEnemyBase* Target = EnemiesById.FindRef(Record.TargetSimId))
+            {
+                Scheduler->ScheduleImpact(Record.Delay, Target, TowersById.FindRef(Record.SourceSimId),
+                    Record.Damage, Record.Elapsed);
+            }
+        }
+    }
+
+    // --- Score / lives ---
+    if (ASTGameController* GC = ASTGameController::Get(this))
+    {
+        GC->RestoreRewoundState(State.GrossScore, State.Lives, State.NumEnemiesAlive);
+    }
+}
+
+void USTRewindHistory::ApplyExact(const FSTRewindState& State, const FSTMatchKeyframeExact& Exact)
+{
+    if (!SimClock)
+    {
+        return;
+    }
+
+    // Written by CaptureExact for this very state, or not at all
+    if (Exact.Enemies.Num() != State.Enemies.Num() || Exact.Towers.Num() != State.Towers.Num()
+        || Exact.Projectiles.Num() != State.Projectiles.Num())
+    {
+        return;
+    }
+
+    // --- Enemies ---
+    TMap<int32, ASTEnemyBase*> EnemiesById;
+    EnemiesById.Reserve(State.Enemies.Num());
+    for (ASTEnemyBase* Enemy : SimClock->GetEnemies())
+    {
+        if (Enemy)
+        {
+            EnemiesById.Add(Enemy->SimId, Enemy);
+        }
+    }
+
+    for (int32 Index = 0; Index < State.Enemies.Num(); ++Index)
+    {
+        ASTEnemyBase* Enemy = EnemiesById.FindRef(State.Enemies[Index].SimId);
+        if (!Enemy)
+        {
+            continue;
+        }
+
+        Enemy->DistanceAlongSpline = Exact.Enemies[Index].Distance;
+        Enemy->PrevDistanceAlongSpline = Exact.Enemies[Index].Distance;
+        Enemy->CurrentHealth = Exact.Enemies[Index].Health;
+        Enemy->RefreshSimLocation();
+        Enemy->SetActorLocation(Enemy->SimLocation);
+    }
+
+    // --- Towers (same team rule as ApplyState) ---
+    TMap<int32, ATowerBase*> TowersById;
+    for (ATowerBase* Tower : SimClock->GetTowers())
+    {
+        if (Tower)
+        {
+            TowersById.Add(Tower->SimId, Tower);
+        }
+    }
+
+    int32 QueueIndex = 0;
+    for (int32 Index = 0; Index < State.Towers.Num() && Exact.TargetQueues.IsValidIndex(QueueIndex + 1); ++Index)
+    {
+        const FSTMatchKeyframeExact::FTower& Record = Exact.Towers[Index];
+        const int32 CurrentTargetId = Exact.TargetQueues[QueueIndex];
+        const int32 FirstQueued = QueueIndex + 2;
+        QueueIndex = FirstQueued + Exact.TargetQueues[QueueIndex + 1];
+
+        ATowerBase* Tower = TowersById.FindRef(State.Towers[Index].SimId);
+        if (!Tower)
+        {
+            continue;
+        }
+
+        if (static_cast<uint8>(Tower->Team) == State.Towers[Index].Team)
+        {
+            Tower->CaptureHP = Record.CaptureHP;
+            Tower->CaptureStartGameTime = Record.CaptureStartGameTime;
+        }
+
+        if (AMinigunTower* Minigun = Cast<AMinigunTower>(Tower))
+        {
+            Minigun->CurrentMuzzleIndex = Record.MuzzleIndex;
+        }
+
+        AAttackTowerBase* AttackTower = Cast<AAttackTowerBase>(Tower);
+        if (!AttackTower)
+        {
+            continue;
+        }
+
+        AttackTower->SimRotation = Record.Rotation;
+        AttackTower->PrevSimRotation = Record.Rotation;
+        AttackTower->SetActorRotation(Record.Rotation);
+
+        if (UTowerAttackComponent* Attack = AttackTower->AttackComponent)
+        {
+            Attack->FireCooldown = Record.FireCooldown;
+
+            // Targets in the order they came into range, not the order a fresh query returns
+            Attack->EnemyQueue.Reset();
+            for (int32 Queued = FirstQueued; Queued < QueueIndex && Exact.TargetQueues.IsValidIndex(Queued); ++Queued)
+            {
+                if (ASTEnemyBase* Enemy = EnemiesById.FindRef(Exact.TargetQueues[Queued]))
+                {
+                    Attack->EnemyQueue.Add(Enemy);
+                }
+            }
+            Attack->CurrentTarget = EnemiesById.FindRef(CurrentTargetId);
+        }
+    }
+
+    // --- Projectiles ---
+    TMap<int32, AProjectile*> ProjectilesById;
+    if (ProjectilePool)
+    {
+        ProjectilesById.Reserve(State.Projectiles.Num());
+        for (AProjectile* Projectile : ProjectilePool->GetActiveProjectiles())
+        {
+            if (Projectile)
+            {
+                ProjectilesById.Add(Projectile->SimId, Projectile);
+            }
+        }
+
+        for (int32 Index = 0; Index < State.Projectiles.Num(); ++Index)
+        {
+            AProjectile* Projectile = ProjectilesById.FindRef(State.Projectiles[Index].SimId);
+            if (!Projectile)
+            {
+                continue;
+            }
+
+            const FSTMatchKeyframeExact::FProjectile& Record = Exact.Projectiles[Index];
+            Projectile->SimLocation = Record.Location;
+            Projectile->PrevSimLocation = Record.Location;
+            Projectile->SimVelocity = Record.Velocity;
+            Projectile->Age = Record.Age;
+            Projectile->UpdatePresentation(1.f);
+        }
+
+        ProjectilePool->SetActiveOrder(Exact.ProjectileOrder);
+    }
+
+    // --- Scheduler: every pending event again, in the recorded firing order ---
+    if (USTGameEventScheduler* Scheduler = USTGameEventScheduler::Get(this))
+    {
+        Scheduler->CancelAllEvents();
+
+        int32 NextImpact = 0;
+        int32 NextLifetime = 0;
+        for (const int32 ProjectileId : Exact.EventOrder)
+        {
+            if (ProjectileId == INDEX_NONE)
+            {
+                if (!State.Impacts.IsValidIndex(NextImpact))
+                {
+                    continue;
+                }
+
+                const FSTRewindImpactState& Record = State.Impacts[NextImpact++];
+                if (ASTEnemyBase* Target = EnemiesById.FindRef(Record.TargetSimId))
+                {
+                    Scheduler->ScheduleImpact(Record.Delay, Target, TowersById.FindRef(Record.SourceSimId),
+                        Record.Damage, Record.Elapsed);
+                }
+            }
+            else
+            {
+                const float Elapsed = Exact.LifetimeElapsed.IsValidIndex(NextLifetime) ? Exact.LifetimeElapsed[NextLifetime] : 0.f;
+                ++NextLifetime;
+
+                if (AProjectile* Projectile = ProjectilesById.FindRef(ProjectileId))
+                {
+                    Projectile->ScheduleLifetime(Elapsed);
+                }
+            }
+        }
+    }
+}
+
+// ========================================================
+// Fidelity check
+// ========================================================
+
+namespace STRewind
+{
+    /** Exact comparison of two quantized states (the codec must be lossless). */
+    static bool StatesMatch(const FSTRewindState& A, const FSTRewindState& B)
+    {
+        if (A.SimStepNumber != B.SimStepNumber || A.GameTime != B.GameTime || A.GrossScore != B.GrossScore
+            || A.Lives != B.Lives || A.NumEnemiesAlive != B.NumEnemiesAlive
+            || A.NextSimId != B.NextSimId || A.NextProjectileSimId != B.NextProjectileSimId
+            || A.Spawners.Num() != B.Spawners.Num() || A.Lanes.Num() != B.Lanes.Num()
+            || A.Enemies.Num() != B.Enemies.Num() || A.Towers.Num() != B.Towers.Num()
+            || A.Projectiles.Num() != B.Projectiles.Num() || A.Impacts.Num() != B.Impacts.Num())
+        {
+            return false;
+        }
+
+        for (int32 Index = 0; Index < A.Spawners.Num(); ++Index)
+        {
+            const FSTRewindSpawnerState& SA = A.Spawners[Index];
+            const FSTRewindSpawnerState& SB = B.Spawners[Index];
+            if (SA.SimId != SB.SimId || SA.WaveIndex != SB.WaveIndex || SA.WaveClock != SB.WaveClock
+                || SA.TimeUntilNextWave != SB.TimeUntilNextWave || SA.bWaveRunning != SB.bWaveRunning
+                || SA.RandomSeed != SB.RandomSeed || SA.NumLanes != SB.NumLanes)
+            {
+                return false;
+            }
+        }
+
+        for (int32 Index = 0; Index < A.Lanes.Num(); ++Index)
+        {
+            if (A.Lanes[Index].SpawnsDone != B.Lanes[Index].SpawnsDone
+                || A.Lanes[Index].NextSpawnTime != B.Lanes[Index].NextSpawnTime)
+            {
+                return false;
+            }
+        }
+
+        for (int32 Index = 0; Index < A.Enemies.Num(); ++Index)
+        {
+            const FSTRewindEnemyState& EA = A.Enemies[Index];
+            const FSTRewindEnemyState& EB = B.Enemies[Index];
+            if (EA.SimId != EB.SimId || EA.ClassIndex != EB.ClassIndex || EA.PathIndex != EB.PathIndex
+                || EA.Distance != EB.Distance || EA.Health != EB.Health)
+            {
+                return false;
+            }
+        }
+
+        for (int32 Index = 0; Index < A.Towers.Num(); ++Index)
+        {
+            const FSTRewindTowerState& TA = A.Towers[Index];
+            const FSTRewindTowerState& TB = B.Towers[Index];
+            if (TA.SimId != TB.SimId || TA.Pitch != TB.Pitch || TA.Yaw != TB.Yaw || TA.Roll != TB.Roll
+                || TA.FireCooldown != TB.FireCooldown || TA.CaptureHP != TB.CaptureHP
+                || TA.Team != TB.Team || TA.OrderState != TB.OrderState
+                || TA.CaptureTargetSimId != TB.CaptureTargetSimId)
+            {
+                return false;
+            }
+        }
+
+        for (int32 Index = 0; Index < A.Projectiles.Num(); ++Index)
+        {
+            const FSTRewindProjectileState& PA = A.Projectiles[Index];
+            const FSTRewindProjectileState& PB = B.Projectiles[Index];
+            if (PA.SimId != PB.SimId || PA.OwnerSimId != PB.OwnerSimId || PA.TargetSimId != PB.TargetSimId
+                || PA.BucketIndex != PB.BucketIndex || PA.bHoming != PB.bHoming
+                || PA.Location != PB.Location || PA.Velocity != PB.Velocity || PA.AgeMs != PB.AgeMs
+                || PA.Damage != PB.Damage || PA.BaseSpeed != PB.BaseSpeed
+                || PA.HomingAcceleration != PB.HomingAcceleration)
+            {
+                return false;
+            }
+        }
+
+        for (int32 Index = 0; Index < A.Impacts.Num(); ++Index)
+        {
+            const FSTRewindImpactState& IA = A.Impacts[Index];
+            const FSTRewindImpactState& IB = B.Impacts[Index];
+            if (IA.TargetSimId != IB.TargetSimId || IA.SourceSimId != IB.SourceSimId || IA.Damage != IB.Damage
+                || IA.Delay != IB.Delay || IA.Elapsed != IB.Elapsed)
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+}
+
+bool USTRewindHistory::RunFidelityCheck(FString& OutReport)
+{
+    if (!SimClock)
+    {
+        OutReport = TEXT("no simulation clock");
+        return false;
+    }
+
+    FSTRewindState Captured;
+    CaptureState(SimClock->GetSimStepNumber(), SimClock->GetGameTime(), Captured);
+
+    // 1) Codec round trips must be bit-exact
+    TArray<uint8> Encoded;
+    STRewindCodec::Encode(Captured, nullptr, nullptr, Encoded);
+    const int32 KeyframeBytes = Encoded.Num();
+
+    FSTRewindState Decoded;
+    const bool bKeyframeExact = STRewindCodec::Decode(Encoded.GetData(), Encoded.Num(), nullptr, nullptr, Decoded)
+        && STRewind::StatesMatch(Captured, Decoded);
+
+    int32 DeltaBytes = 0;
+    bool bDeltaExact = true;
+    const bool bHasDeltaBase = NumGroupStates > 0;
+    if (bHasDeltaBase)
+    {
+        const FSTRewindState* Prev = &GroupStates[NumGroupStates - 1];
+        const FSTRewindState* PrevPrev = NumGroupStates >= 2 ? &GroupStates[NumGroupStates - 2] : nullptr;
+
+        Encoded.Reset();
+        STRewindCodec::Encode(Captured, Prev, PrevPrev, Encoded);
+        DeltaBytes = Encoded.Num();
+
+        bDeltaExact = STRewindCodec::Decode(Encoded.GetData(), Encoded.Num(), Prev, PrevPrev, Decoded)
+            && STRewind::StatesMatch(Captured, Decoded);
+    }
+
+    // 2) Quantization error against the live (full precision) actors
+    double MaxDistanceError = 0.0, MaxDistanceTolerance = 0.0;
+    double MaxHealthError = 0.0, MaxHealthTolerance = 0.0;
+    for (const FSTRewindEnemyState& Record : Captured.Enemies)
+    {
+        for (const ASTEnemyBase* Enemy : SimClock->GetEnemies())
+        {
+            if (!Enemy || Enemy->SimId != Record.SimId)
+            {
+                continue;
+            }
+
+            const float PathLength = GetPathLength(Record.PathIndex);
+            MaxDistanceError = FMath::Max(MaxDistanceError,
+                FMath::Abs(STRewindCodec::DequantizeUnit(Record.Distance, PathLength) - Enemy->DistanceAlongSpline));
+            MaxDistanceTolerance = FMath::Max(MaxDistanceTolerance, PathLength / 65535.0);
+
+            MaxHealthError = FMath::Max(MaxHealthError,
+                FMath::Abs(STRewindCodec::DequantizeUnit(Record.Health, Enemy->MaxHealth) - Enemy->CurrentHealth));
+            MaxHealthTolerance = FMath::Max(MaxHealthTolerance, Enemy->MaxHealth / 65535.0);
+            break;
+        }
+    }
+
+    double MaxAngleError = 0.0;
+    for (const FSTRewindTowerState& Record : Captured.Towers)
+    {
+        for (const ATowerBase* Tower : SimClock->GetTowers())
+        {
+            const AAttackTowerBase* AttackTower = Cast<AAttackTowerBase>(Tower);
+            if (!AttackTower || AttackTower->SimId != Record.SimId)
+            {
+                continue;
+            }
+
+            const FRotator Restored(
+                FRotator::DecompressAxisFromShort(Record.Pitch),
+                FRotator::DecompressAxisFromShort(Record.Yaw),
+                FRotator::DecompressAxisFromShort(Record.Roll));
+            const FRotator Diff = (Restored - AttackTower->SimRotation).GetNormalized();
+
+            MaxAngleError = FMath::Max(MaxAngleError,
+                FMath::Max3(FMath::Abs(Diff.Pitch), FMath::Abs(Diff.Yaw), FMath::Abs(Diff.Roll)));
+            break;
+        }
+    }
+
+    double MaxPositionError = 0.0;
+    if (ProjectilePool)
+    {
+        for (const FSTRewindProjectileState& Record : Captured.Projectiles)
+        {
+            for (const AProjectile* Projectile : ProjectilePool->GetActiveProjectiles())
+            {
+                if (Projectile && Projectile->SimId == Record.SimId)
+                {
+                    const FVector Error = STRewindCodec::DequantizePosition(Record.Location) - Projectile->SimLocation;
+                    MaxPositionError = FMath::Max(MaxPositionError, Error.GetAbsMax());
+                    break;
+                }
+            }
+        }
+    }
+
+    // Rounding to nearest: half a step, plus float slack
+    const bool bDistanceOk = MaxDistanceError <= MaxDistanceTolerance * 0.5 + 0.01;
+    const bool bHealthOk = MaxHealthError <= MaxHealthTolerance * 0.5 + 0.001;
+    const bool bAngleOk = MaxAngleError <= 360.0 / 65536.0 + 0.001;
+    const bool bPositionOk = MaxPositionError <= 0.5 / STRewindCodec::PositionScale + 0.001;
+
+    // The ratio only means something once a couple of keyframe groups are recorded
+    const bool bRatioMeasured = Frames.Num() >= KeyframeInterval * 2;
+    const bool bRatioOk = bRatioMeasured && GetCompressionRatio() >= STRewind::TargetCompressionRatio;
+
+    const int32 UncompressedSize = STRewindCodec::GetUncompressedSize(Captured);
+
+    OutReport = FString::Printf(
+        TEXT("%d enemies / %d towers / %d projectiles | keyframe round trip %s, delta round trip %s | ")
+        TEXT("max error: distance %.3f, health %.4f, angle %.4f deg, projectile %.4f | ")
+        TEXT("frame %d B raw, %d B keyframe, %d B delta | history %.1fx (%lld / %lld B, target >= %.0fx)%s"),
+        Captured.Enemies.Num(), Captured.Towers.Num(), Captured.Projectiles.Num(),
+        bKeyframeExact ? TEXT("exact") : TEXT("MISMATCH"),
+        bHasDeltaBase ? (bDeltaExact ? TEXT("exact") : TEXT("MISMATCH")) : TEXT("skipped (nothing recorded)"),
+        MaxDistanceError, MaxHealthError, MaxAngleError, MaxPositionError,
+        UncompressedSize, KeyframeBytes, DeltaBytes,
+        GetCompressionRatio(), UncompressedBytes, UsedBytes, STRewind::TargetCompressionRatio,
+        bRatioMeasured ? TEXT("") : *FString::Printf(TEXT(" | ratio not measured yet (%d / %d frames)"), Frames.Num(), KeyframeInterval * 2));
+
+    return bKeyframeExact && bDeltaExact && bDistanceOk && bHealthOk && bAngleOk && bPositionOk && bRatioOk;
+}
+
+// ========================================================
+// Seek benchmark
+// ========================================================
+
+bool USTRewindHistory::RunSeekBenchmark(int32 Runs, double TargetMs, FString& OutReport)
+{
+    if (!SimClock || MatchKeyframes.Num() == 0)
+    {
+        OutReport = TEXT("nothing recorded yet");
+        return false;
+    }
+
+    // The first run is the reference the others must reproduce
+    Runs = FMath::Max(Runs, 2);
+
+    const uint64 TargetStep = SimClock->GetSimStepNumber();
+    const int32 KeyIndex = Algo::UpperBoundBy(MatchKeyframes, TargetStep, &FSTMatchKeyframe::SimStepNumber) - 1;
+    const uint64 ReplaySteps = MatchKeyframes.IsValidIndex(KeyIndex) ? TargetStep - MatchKeyframes[KeyIndex].SimStepNumber : 0;
+
+    FSTRewindState Reference;
+    uint32 ReferenceChecksum = 0;
+    bool bRunsAgree = true;
+    double MinMs = TNumericLimits<double>::Max();
+    double MaxMs = 0.0;
+    double TotalMs = 0.0;
+    int64 DivergedStep = INDEX_NONE;
+
+    for (int32 Run = 0; Run < Runs; ++Run)
+    {
+        const uint64 StartCycles = FPlatformTime::Cycles64();
+        if (!SimClock->SeekToStep(TargetStep))
+        {
+            OutReport = FString::Printf(TEXT("seek to step %llu failed"), TargetStep);
+            return false;
+        }
+        const double Ms = FPlatformTime::ToMilliseconds64(FPlatformTime::Cycles64() - StartCycles);
+
+        MinMs = FMath::Min(MinMs, Ms);
+        MaxMs = FMath::Max(MaxMs, Ms);
+        TotalMs += Ms;
+
+        // Replayed steps were checked against the match recording, if one runs
+        if (DivergedStep == INDEX_NONE)
+        {
+            DivergedStep = SeekDivergedStep;
+        }
+
+        const uint32 Checksum = ComputeStateChecksum();
+        if (Run == 0)
+        {
+            CaptureState(SimClock->GetSimStepNumber(), SimClock->GetGameTime(), Reference);
+            ReferenceChecksum = Checksum;
+        }
+        else
+        {
+            bRunsAgree &= Checksum == ReferenceChecksum;
+        }
+    }
+
+    const bool bRecorded = MatchRecorder && MatchRecorder->WantsStepChecksums();
+    const bool bMatched = DivergedStep == INDEX_NONE && bRunsAgree;
+
+    FString Verdict;
+    if (DivergedStep != INDEX_NONE)
+    {
+        Verdict = FString::Printf(TEXT("DIVERGED from the recording at step %lld"), DivergedStep);
+    }
+    else if (!bRunsAgree)
+    {
+        Verdict = TEXT("DIVERGED from the first run");
+    }
+    else
+    {
+        Verdict = bRecorded ? TEXT("match the recording") : TEXT("agree (no match recording: steps not checked)");
+    }
+
+    OutReport = FString::Printf(
+        TEXT("%.1f min match, %d keyframes (%.1f KB) | replay %llu steps (%.2f s) | ")
+        TEXT("%d enemies / %d projectiles | seek min %.2f / avg %.2f / max %.2f ms (target %.1f ms) | replays %s"),
+        SimClock->GetGameTime() / 60.0,
+        MatchKeyframes.Num(), MatchKeyframeBytes / 1024.0,
+        ReplaySteps, ReplaySteps * SimClock->GetFixedStepSeconds(),
+        Reference.Enemies.Num(), Reference.Projectiles.Num(),
+        MinMs, TotalMs / Runs, MaxMs, TargetMs, *Verdict);
+
+    return bMatched && MaxMs <= TargetMs;
+}
+
+uint32 USTRewindHistory::ComputeStateChecksum()
+{
+    if (!SimClock)
+    {
+        return 0;
+    }
+
+    ST_LLM_SCOPE(Rewind);
+
+    // Raw values in step order, not the quantized snapshot: a replay has to match
+    // bit for bit. The buffer is reused, so this allocates nothing once it has grown.
+    using STRewind::AppendRaw;
+    TArray<uint8>& Bytes = ChecksumScratch;
+    Bytes.Reset();
+
+    AppendRaw(Bytes, SimClock->GetSimStepNumber());
+    AppendRaw(Bytes, SimClock->GetGameTime());
+    AppendRaw(Bytes, SimClock->GetNextSimId());
+    if (ProjectilePool)
+    {
+        AppendRaw(Bytes, ProjectilePool->GetNextProjectileSimId());
+    }
+
+    if (const ASTGameController* GC = ASTGameController::Get(this))
+    {
+        float GrossScore = 0.f;
+        int32 Lives = 0;
+        int32 NumEnemiesAlive = 0;
+        GC->GetSimCounters(GrossScore, Lives, NumEnemiesAlive);
+
+        AppendRaw(Bytes, GrossScore);
+        AppendRaw(Bytes, Lives);
+        AppendRaw(Bytes, NumEnemiesAlive);
+    }
+
+    // --- Spawners ---
+    for (const ASTSpawner* Spawner : SimClock->GetSpawners())
+    {
+        if (!Spawner)
+        {
+            continue;
+        }
+
+        AppendRaw(Bytes, Spawner->SimId);
+        AppendRaw(Bytes, Spawner->CurrentWaveIndex);
+        AppendRaw(Bytes, Spawner->WaveClock);
+        AppendRaw(Bytes, Spawner->TimeUntilNextWave);
+        AppendRaw(Bytes, static_cast<uint8>(Spawner->bWaveRunning));
+        AppendRaw(Bytes, Spawner->RandomStream.GetCurrentSeed());
+
+        for (const FSTLaneRuntimeState& Lane : Spawner->LaneStates)
+        {
+            AppendRaw(Bytes, Lane.SpawnsDone);
+            AppendRaw(Bytes, Lane.NextSpawnTime);
+        }
+    }
+
+    // --- Enemies ---
+    for (const ASTEnemyBase* Enemy : SimClock->GetEnemies())
+    {
+        if (!Enemy)
+        {
+            continue;
+        }
+
+        AppendRaw(Bytes, Enemy->SimId);
+        AppendRaw(Bytes, Enemy->DistanceAlongSpline);
+        AppendRaw(Bytes, Enemy->CurrentHealth);
+    }
+
+    // --- Towers: the class stands for the upgrade ---
+    for (const ATowerBase* Tower : SimClock->GetTowers())
+    {
+        if (!Tower)
+        {
+            continue;
+        }
+
+        const UClass* TowerClass = Tower->GetClass();
+        const uint32* ClassChecksum = ClassNameChecksums.Find(TowerClass);
+        if (!ClassChecksum)
+        {
+            ClassChecksum = &ClassNameChecksums.Add(TowerClass, FCrc::StrCrc32(*TowerClass->GetName()));
+        }
+
+        AppendRaw(Bytes, Tower->SimId);
+        AppendRaw(Bytes, *ClassChecksum);
+        AppendRaw(Bytes, static_cast<uint8>(Tower->Team));
+        AppendRaw(Bytes, Tower->CaptureHP);
+        AppendRaw(Bytes, Tower->AssignedCaptureTarget ? Tower->AssignedCaptureTarget->SimId : INDEX_NONE);
+
+        if (const AAttackTowerBase* AttackTower = Cast<AAttackTowerBase>(Tower))
+        {
+            AppendRaw(Bytes, static_cast<uint8>(AttackTower->CurrentOrderState));
+            AppendRaw(Bytes, AttackTower->SimRotation.Pitch);
+            AppendRaw(Bytes, AttackTower->SimRotation.Yaw);
+            AppendRaw(Bytes, AttackTower->SimRotation.Roll);
+
+            if (AttackTower->AttackComponent)
+            {
+                AppendRaw(Bytes, AttackTower->AttackComponent->FireCooldown);
+                AppendRaw(Bytes, STRewind::GetSimIdOf(AttackTower->AttackComponent->GetCurrentTarget()));
+            }
+        }
+    }
+
+    // --- Projectiles ---
+    if (ProjectilePool)
+    {
+        for (const AProjectile* Projectile : ProjectilePool->GetActiveProjectiles())
+        {
+            if (!Projectile)
+            {
+                continue;
+            }
+
+            AppendRaw(Bytes, Projectile->SimId);
+            AppendRaw(Bytes, Projectile->SimLocation.X);
+            AppendRaw(Bytes, Projectile->SimLocation.Y);
+            AppendRaw(Bytes, Projectile->SimLocation.Z);
+            AppendRaw(Bytes, Projectile->SimVelocity.X);
+            AppendRaw(Bytes, Projectile->SimVelocity.Y);
+            AppendRaw(Bytes, Projectile->SimVelocity.Z);
+            AppendRaw(Bytes, Projectile->Age);
+            AppendRaw(Bytes, Projectile->Damage);
+            AppendRaw(Bytes, STRewind::GetSimIdOf(Projectile->TargetActor.Get()));
+        }
+    }
+
+    // --- Scheduler queue, in firing order (ids themselves are not part of the state) ---
+    if (const USTGameEventScheduler* Scheduler = USTGameEventScheduler::Get(this))
+    {
+        Scheduler->GetPendingEvents(EventScratch);
+        for (const FSTScheduledGameEvent* Event : EventScratch)
+        {
+            const UObject* Bound = Event->BoundObject.Get();
+            const AProjectile* BoundProjectile = Cast<AProjectile>(Bound);
+
+            AppendRaw(Bytes, static_cast<uint8>(Event->bImpact));
+            AppendRaw(Bytes, BoundProjectile ? BoundProjectile->SimId : STRewind::GetSimIdOf(Cast<AActor>(Bound)));
+            AppendRaw(Bytes, Event->Delay);
+            AppendRaw(Bytes, Event->Elapsed);
+            AppendRaw(Bytes, Event->ImpactDamage);
+        }
+        EventScratch.Reset();
+    }
+
+    return FCrc::MemCrc32(Bytes.GetData(), Bytes.Num());
+}
+
+// ========================================================
+// Console
+// ========================================================
+
+#if !UE_BUILD_SHIPPING
+
+static FAutoConsoleCommandWithWorld GSTRewindStatsCommand(
+    TEXT("ActionTD.RewindStats"),
+    TEXT("Log rewind history size, memory use, compression and seconds available."),
+    FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+        {
+            const USTRewindHistory* History = USTRewindHistory::Get(World);
+            if (!History)
+            {
+                return;
+            }
+
+            UE_LOG(LogTemp, Log,
+                TEXT("RewindStats: %d frames | %.2f s available | %.2f MB used / %.2f MB allocated / %.2f MB budget | %lld bytes/frame | %.1fx compression"),
+                History->GetNumFrames(),
+                History->GetSecondsAvailable(),
+                History->GetMemoryUsedBytes() / (1024.0 * 1024.0),
+                History->GetMemoryAllocatedBytes() / (1024.0 * 1024.0),
+                History->GetMemoryBudgetBytes() / (1024.0 * 1024.0),
+                History->GetAverageFrameBytes(),
+                History->GetCompressionRatio());
+        }));
+
+static FAutoConsoleCommandWithWorld GSTRewindFidelityCommand(
+    TEXT("ActionTD.RewindFidelity"),
+    TEXT("Round-trip the current state through the rewind codec and report quantization error and compression."),
+    FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+        {
+            USTRewindHistory* History = USTRewindHistory::Get(World);
+            if (!History)
+            {
+                return;
+            }
+
+            FString Report;
+            const bool bPassed = History->RunFidelityCheck(Report);
+
+            UE_LOG(LogTemp, Log, TEXT("RewindFidelity %s: %s"), bPassed ? TEXT("PASSED") : TEXT("FAILED"), *Report);
+        }));
+
+static FAutoConsoleCommandWithWorldAndArgs GSTSeekLatencyCommand(
+    TEXT("ActionTD.SeekLatency"),
+    TEXT("Seek to the current step repeatedly; report seek latency and whether every replayed step matched the recording. ")
+    TEXT("Clears the rewind history. Args: [Runs=5] [TargetMs=100]"),
+    FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+        {
+            USTRewindHistory* History = USTRewindHistory::Get(World);
+            if (!History)
+            {
+                return;
+            }
+
+            const int32 Runs = Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 5;
+            const double TargetMs = Args.Num() > 1 ? FCString::Atod(*Args[1]) : 100.0;
+
+            FString Report;
+            const bool bPassed = History->RunSeekBenchmark(Runs, TargetMs, Report);
+
+            UE_LOG(LogTemp, Log, TEXT("SeekLatency %s: %s"), bPassed ? TEXT("PASSED") : TEXT("FAILED"), *Report);
+        }));
+
+#endif // !UE_BUILD_SHIPPING
@@ -0,0 +1,348 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/RingBuffer.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "STRewindCodec.h"
+#include "STRewindHistory.generated.h"
+
+class USTSimulationClock;
+class USTProjectilePoolSubsystem;
+class USTMatchRecorder;
+class ASTEnemyBase;
+struct FSTScheduledGameEvent;
+
+/** Where one recorded substep lives in the byte ring. */
+struct FSTRewindFrameRef
+{
+    int64 Offset = 0;
+    int32 Size = 0;
+    uint64 SimStepNumber = 0;
+    double GameTime = 0.0;
+
+    /** Keyframes decode on their own; delta frames need the keyframe before them. */
+    bool bKeyframe = false;
+
+    /** Size of this frame as full-precision structs (compression stats). */
+    int32 UncompressedSize = 0;
+};
+
+/**
+ * What a match keyframe's quantized state rounds off or leaves out: full-precision
+ * values (in the state's SimId order), tower target queues, the projectiles' step
+ * order and the scheduler's firing order. With it a seek retraces the recorded
+ * timeline bit for bit.
+ */
+struct FSTMatchKeyframeExact
+{
+    struct FEnemy
+    {
+        float Distance = 0.f;
+        float Health = 0.f;
+    };
+
+    struct FTower
+    {
+        FRotator Rotation = FRotator::ZeroRotator;
+        float FireCooldown = 0.f;
+        float CaptureHP = 0.f;
+        double CaptureStartGameTime = 0.0;
+        int32 MuzzleIndex = 0;
+    };
+
+    struct FProjectile
+    {
+        FVector Location = FVector::ZeroVector;
+        FVector Velocity = FVector::ZeroVector;
+        float Age = 0.f;
+    };
+
+    TArray<FEnemy> Enemies;
+    TArray<FTower> Towers;
+    TArray<FProjectile> Projectiles;
+
+    /** Per tower, in state order: current target id, queue length, queued enemy ids (FIFO). */
+    TArray<int32> TargetQueues;
+
+    /** Projectile ids in the pool's step order. */
+    TArray<int32> ProjectileOrder;
+
+    /** Pending events in firing order: a projectile id (its lifetime) or INDEX_NONE (the state's next impact). */
+    TArray<int32> EventOrder;
+
+    /** Game-seconds elapsed of each lifetime in EventOrder. */
+    TArray<float> LifetimeElapsed;
+
+    int64 GetAllocatedSize() const
+    {
+        return Enemies.GetAllocatedSize() + Towers.GetAllocatedSize() + Projectiles.GetAllocatedSize()
+            + TargetQueues.GetAllocatedSize() + ProjectileOrder.GetAllocatedSize()
+            + EventOrder.GetAllocatedSize() + LifetimeElapsed.GetAllocatedSize();
+    }
+};
+
+/** Self-contained keyframe kept for the whole match (timeline seeking). */
+struct FSTMatchKeyframe
+{
+    uint64 SimStepNumber = 0;
+    double GameTime = 0.0;
+    TArray<uint8> Data;
+    FSTMatchKeyframeExact Exact;
+
+    int64 GetAllocatedSize() const { return Data.GetAllocatedSize() + Exact.GetAllocatedSize(); }
+};
+
+/** First recorded step of a wave. */
+struct FSTWaveMarker
+{
+    int32 WaveIndex = INDEX_NONE;
+    uint64 SimStepNumber = 0;
+    double GameTime = 0.0;
+};
+
+/**
+ * Rewind history: a compressed snapshot after every forward substep in a byte ring
+ * bounded by seconds and bytes, plus sparse whole-match keyframes for seeking.
+ */
+UCLASS()
+class ACTIONTOWERDEFENSE_API USTRewindHistory : public UWorldSubsystem
+{
+    GENERATED_BODY()
+
+public:
+    virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+    virtual void Deinitialize() override;
+
+    /** Convenience helper so other classes can find the history. */
+    static USTRewindHistory* Get(const UObject* WorldContextObject);
+
+    /** Seconds of game time to keep, and the byte cap for the ring. Clears the history. */
+    void SetBudget(float InHistorySeconds, int64 InMemoryBudgetBytes);
+
+    /** Frames per keyframe (1 = keyframes only). Takes effect at the next keyframe. */
+    void SetKeyframeInterval(int32 InKeyframeInterval) { KeyframeInterval = FMath::Max(1, InKeyframeInterval); }
+
+    /** Snapshot the current simulation state (called by USTSimulationClock after each forward substep). */
+    void RecordFrame(uint64 SimStepNumber, double GameTime);
+
+    /** True while there is an older frame to step back into. */
+    FORCEINLINE bool CanRewind() const { return Frames.Num() >= 2; }
+
+    /**
+     * Drop the newest frame and restore the simulation to the one before it.
+     * Writes that frame's step number and game time back to the caller.
+     */
+    bool RewindOneFrame(uint64& OutSimStepNumber, double& OutGameTime);
+
+    /** Forget everything recorded so far. */
+    void ClearHistory();
+
+    // --- Match timeline (seeking) ---
+
+    /** Game-seconds between match keyframes (bounds the replay a seek needs). */
+    void SetMatchKeyframeSeconds(float InSeconds) { MatchKeyframeSeconds = FMath::Max(InSeconds, 0.1f); }
+
+    /** A wave started during the current substep; the frame recorded for it becomes its marker. */
+    void MarkWaveStart(int32 WaveIndex);
+
+    /** A player command ran: the next recorded step gets a match keyframe, so no seek replays across it. */
+    void RequestMatchKeyframe() { bMatchKeyframeRequested = true; }
+
+    /** Step of the most recent start of WaveIndex. */
+    bool FindWaveStartStep(int32 WaveIndex, uint64& OutSimStepNumber) const;
+
+    /** Nearest step to TargetGameTime (clamped to the recorded range). */
+    uint64 GetStepForGameTime(double TargetGameTime) const;
+
+    /** Game time of the earliest match keyframe (start of the seekable range). */
+    double GetTimelineStartTime() const { return MatchKeyframes.Num() > 0 ? MatchKeyframes[0].GameTime : 0.0; }
+
+    FORCEINLINE const TArray<FSTWaveMarker>& GetWaveMarkers() const { return WaveMarkers; }
+    FORCEINLINE int32 GetNumMatchKeyframes() const { return MatchKeyframes.Num(); }
+    FORCEINLINE int64 GetMatchKeyframeBytes() const { return MatchKeyframeBytes; }
+
+    /** The world's match recorder keeps the per-step checksums while it records or plays back. */
+    void SetMatchRecorder(USTMatchRecorder* InRecorder) { MatchRecorder = InRecorder; }
+
+    /**
+     * Start of a seek (called by USTSimulationClock::SeekToStep): restore the latest
+     * match keyframe at or before TargetStep onto a clean slate (projectiles, scheduled
+     * events and tower target queues all come from the keyframe, none from the current
+     * timeline) and drop the timeline past TargetStep. Writes the keyframe's step /
+     * time back to the caller.
+     */
+    bool RestoreMatchKeyframe(uint64 TargetStep, uint64& OutSimStepNumber, double& OutGameTime);
+
+    /**
+     * Compare the current state against the match recording's checksum for
+     * SimStepNumber, if it has one (seeks call this for the restored keyframe and
+     * every replayed step). The first mismatch of a seek is logged and kept in
+     * GetSeekDivergedStep.
+     */
+    void VerifySeekStep(uint64 SimStepNumber);
+
+    /** First step of the last seek that did not match the recorded timeline (INDEX_NONE: it matched). */
+    FORCEINLINE int64 GetSeekDivergedStep() const { return SeekDivergedStep; }
+
+    // --- Stats ---
+
+    FORCEINLINE int32 GetNumFrames() const { return Frames.Num(); }
+
+    /** Bytes held by live frames. */
+    FORCEINLINE int64 GetMemoryUsedBytes() const { return UsedBytes; }
+
+    /** Bytes allocated for the ring (grows on demand up to the budget). */
+    FORCEINLINE int64 GetMemoryAllocatedBytes() const { return Ring.GetAllocatedSize(); }
+
+    /** Byte cap for the ring. */
+    FORCEINLINE int64 GetMemoryBudgetBytes() const { return MemoryBudgetBytes; }
+
+    /** Game-seconds between the oldest and newest frame. */
+    double GetSecondsAvailable() const;
+
+    /** Average bytes per frame over the live frames. */
+    int64 GetAverageFrameBytes() const { return Frames.Num() > 0 ? UsedBytes / Frames.Num() : 0; }
+
+    /** What the live frames would take as full-precision structs. */
+    FORCEINLINE int64 GetUncompressedBytes() const { return UncompressedBytes; }
+
+    /** Uncompressed / stored size of the live frames. */
+    double GetCompressionRatio() const { return UsedBytes > 0 ? static_cast<double>(UncompressedBytes) / UsedBytes : 0.0; }
+
+    /**
+     * Round-trip the current world state through the codec (as a keyframe and as a
+     * delta against the newest recorded frames) and measure quantization error against
+     * the live actors. Returns true if every check passed, including a history
+     * compression ratio of at least 10x; details go to OutReport.
+     */
+    bool RunFidelityCheck(FString& OutReport);
+
+    /**
+     * Seek to the current step Runs times, timing each seek. Replayed steps are
+     * checked against the match recording while one runs; every run must also end
+     * in the state the first one did. Passes if the slowest seek took at most
+     * TargetMs and no replay diverged. Clears the rewind ring (seeks always do).
+     */
+    bool RunSeekBenchmark(int32 Runs, double TargetMs, FString& OutReport);
+
+    /**
+     * CRC of the current simulation state at full precision: score / lives, spawners,
+     * enemies, towers (class, team, orders, targets), projectiles and the scheduler
+     * queue. Match replays and seeks compare these per step.
+     */
+    uint32 ComputeStateChecksum();
+
+protected:
+    virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+    /** Quantize the current simulation state (lists sorted by SimId). */
+    void CaptureState(uint64 SimStepNumber, double GameTime, FSTRewindState& Out);
+
+    /** Push a decoded state back into the world. */
+    void ApplyState(const FSTRewindState& State);
+
+    /**
+     * Add a match keyframe / wave marker for the step just simulated, if one is due.
+     * Returns true if it captured the step into CaptureScratch (keyframe steps only).
+     */
+    bool RecordMatchTimeline(uint64 SimStepNumber, double GameTime);
+
+    /** Forget match keyframes and wave markers from FirstDroppedStep on. */
+    void DropMatchTimelineFrom(uint64 FirstDroppedStep);
+
+    /** Full-precision leftovers of State, captured from the world it was just captured from. */
+    void CaptureExact(const FSTRewindState& State, FSTMatchKeyframeExact& Out);
+
+    /** Overwrite what ApplyState(State) restored with Exact's values, target queues and orders. */
+    void ApplyExact(const FSTRewindState& State, const FSTMatchKeyframeExact& Exact);
+
+    /** Decode the keyframe group that Frames[Index] belongs to, up to Index, into GroupStates. */
+    bool DecodeGroupEndingAt(int32 Index);
+
+    /** Find room for Size bytes at the write head, growing the ring or evicting the oldest frames as needed. */
+    bool AllocateInRing(int32 Size, int64& OutOffset);
+
+    /** Grow the ring (up to the budget) so Size more bytes fit after the live ones. */
+    bool GrowRing(int32 Size);
+
+    void PopOldestFrame();
+
+    /** Index into EnemyClasses / PathActors, adding on first use. */
+    uint16 GetEnemyClassIndex(UClass* EnemyClass);
+    uint16 GetPathIndex(AActor* PathActor);
+
+    /** Spline length of a PathActors entry (0 if unknown). */
+    float GetPathLength(uint16 PathIndex) const;
+
+    ASTEnemyBase* RespawnEnemy(int32 SimId, uint16 ClassIndex, uint16 PathIndex);
+
+    UPROPERTY(Transient)
+    USTSimulationClock* SimClock = nullptr;
+
+    UPROPERTY(Transient)
+    USTProjectilePoolSubsystem* ProjectilePool = nullptr;
+
+    UPROPERTY(Transient)
+    USTMatchRecorder* MatchRecorder = nullptr;
+
+    /** Enemy classes / paths referenced by recorded frames (frames store indices). */
+    UPROPERTY(Transient)
+    TArray<UClass*> EnemyClasses;
+
+    UPROPERTY(Transient)
+    TArray<AActor*> PathActors;
+
+    /** Spline length per PathActors entry (enemy distances are stored as fractions of it). */
+    TArray<float> PathLengths;
+
+    float HistorySeconds = 30.f;
+    int64 MemoryBudgetBytes = 32 * 1024 * 1024;
+
+    /** Byte ring (grown on demand up to MemoryBudgetBytes) and the frames in it, oldest first. */
+    TArray<uint8> Ring;
+    TRingBuffer<FSTRewindFrameRef> Frames;
+
+    /** Next write position in Ring. */
+    int64 WriteHead = 0;
+    int64 UsedBytes = 0;
+    int64 UncompressedBytes = 0;
+
+    int32 KeyframeInterval = 30;
+
+    /** Whole-match keyframes and wave starts, oldest first. */
+    TArray<FSTMatchKeyframe> MatchKeyframes;
+    TArray<FSTWaveMarker> WaveMarkers;
+    int64 MatchKeyframeBytes = 0;
+    float MatchKeyframeSeconds = 5.f;
+
+    /** Wave started in the substep being recorded (INDEX_NONE if none). */
+    int32 PendingWaveIndex = INDEX_NONE;
+
+    /** A player command ran since the last recorded step. */
+    bool bMatchKeyframeRequested = false;
+
+    int64 SeekDivergedStep = INDEX_NONE;
+
+    /**
+     * States of the newest keyframe group's frames, oldest first (the keyframe at 0).
+     * The next delta is encoded against the last two. Slots are recycled, not freed.
+     */
+    TArray<FSTRewindState> GroupStates;
+    int32 NumGroupStates = 0;
+
+    /** Reused buffers (capture / decode / encode / quantization batches). */
+    FSTRewindState CaptureScratch;
+    FSTRewindState DecodeScratch;
+    TArray<uint8> FrameScratch;
+    TArray<ASTEnemyBase*> EnemyScratch;
+    TArray<const FSTScheduledGameEvent*> EventScratch;
+    TArray<uint8> ChecksumScratch;
+
+    /** Class name CRC per tower class (checksums must agree across processes, FName indices do not). */
+    TMap<const UClass*, uint32> ClassNameChecksums;
+    TArray<float> QuantValues;
+    TArray<float> QuantMax;
+    TArray<uint16> QuantPacked;
+};
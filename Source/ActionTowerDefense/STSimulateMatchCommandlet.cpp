@@ -0,0 +1,667 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "STSimulateMatchCommandlet.h"
+#include "Engine/Engine.h"
+#include "Engine/GameInstance.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "Containers/Ticker.h"
+#include "Async/TaskGraphInterfaces.h"
+#include "Algo/StableSort.h"
+#include "Misc/App.h"
+#include "Misc/DateTime.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Parse.h"
+#include "Misc/Paths.h"
+#include "Templates/TypeHash.h"
+#include "Dom/JsonObject.h"
+#include "Serialization/JsonWriter.h"
+#include "Serialization/JsonSerializer.h"
+#include "STSimulationClock.h"
+#include "STGameController.h"
+#include "STSpawner.h"
+#include "STMatchRecorder.h"
+#include "STMatchStats.h"
+#include "STWaveSet.h"
+#include "TowerBase.h"
+#include "AttackTowerBase.h"
+
+namespace STSimulateMatch
+{
+    /** Engine frame delta when not replaying (the clock turns it into substeps). */
+    constexpr float FrameSeconds = 1.f / 60.f;
+
+    constexpr double DefaultMaxGameSeconds = 7200.0;
+
+    /** "TestLevel" -> "/Game/TestLevel"; package paths pass through. */
+    static FString ToMapPackage(const FString& MapName)
+    {
+        return MapName.StartsWith(TEXT("/")) ? MapName : FString(TEXT("/Game/")) / MapName;
+    }
+
+    static bool ParseSpeedMode(const FString& Name, EGameSpeedMode& OutMode)
+    {
+        const int64 Value = StaticEnum<EGameSpeedMode>()->GetValueByNameString(Name);
+        if (Value == INDEX_NONE)
+        {
+            return false;
+        }
+
+        OutMode = static_cast<EGameSpeedMode>(Value);
+        return true;
+    }
+}
+
+USTSimulateMatchCommandlet::USTSimulateMatchCommandlet()
+{
+    IsClient = false;
+    IsServer = false;
+    LogToConsole = true;
+}
+
+// ========================================================
+// Main
+// ========================================================
+
+int32 USTSimulateMatchCommandlet::Main(const FString& Params)
+{
+    // Batch mode: one process start for many matches
+    FString JobsPath;
+    if (!FParse::Value(*Params, TEXT("Jobs="), JobsPath))
+    {
+        return RunMatch(Params);
+    }
+
+    TArray<FString> Jobs;
+    if (!FFileHelper::LoadFileToStringArray(Jobs, *JobsPath))
+    {
+        UE_LOG(LogTemp, Error, TEXT("SimulateMatch: could not read jobs %s"), *JobsPath);
+        return 1;
+    }
+
+    int32 ExitCode = 0;
+    int32 NumRun = 0;
+    for (const FString& Job : Jobs)
+    {
+        if (Job.TrimStartAndEnd().IsEmpty())
+        {
+            continue;
+        }
+
+        ExitCode = FMath::Max(ExitCode, RunMatch(Job));
+        ++NumRun;
+
+        // The next match loads its map afresh
+        CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+    }
+
+    UE_LOG(LogTemp, Display, TEXT("SimulateMatch: ran %d matches from %s"), NumRun, *JobsPath);
+    return ExitCode;
+}
+
+int32 USTSimulateMatchCommandlet::RunMatch(const FString& Params)
+{
+    using namespace STSimulateMatch;
+
+    const TCHAR* CmdLine = *Params;
+
+    Script.Reset();
+    NextScriptCommand = 0;
+    Waves.Reset();
+    Overrides = FSTSimMatchOverrides();
+    OverrideWaveSet = nullptr;
+
+    FString MapName = TEXT("TestLevel");
+    FString ScriptPath;
+    FString ReplayPath;
+    FString SpeedName = TEXT("Unlimited");
+    FString JsonPath;
+    double MaxGameSeconds = DefaultMaxGameSeconds;
+
+    FParse::Value(CmdLine, TEXT("Map="), MapName);
+    FParse::Value(CmdLine, TEXT("Script="), ScriptPath);
+    FParse::Value(CmdLine, TEXT("Replay="), ReplayPath);
+    FParse::Value(CmdLine, TEXT("Speed="), SpeedName);
+    FParse::Value(CmdLine, TEXT("Json="), JsonPath);
+    FParse::Value(CmdLine, TEXT("MaxGameSeconds="), MaxGameSeconds);
+
+    EGameSpeedMode SpeedMode = EGameSpeedMode::Unlimited;
+    if (!ParseSpeedMode(SpeedName, SpeedMode))
+    {
+        UE_LOG(LogTemp, Error, TEXT("SimulateMatch: unknown speed mode %s"), *SpeedName);
+        return 1;
+    }
+
+    const bool bReplay = !ReplayPath.IsEmpty();
+    if (bReplay)
+    {
+        // The recording decides the map, the seeds and every command
+        FSTMatchRecording Header;
+        if (!Header.LoadFromFile(ReplayPath))
+        {
+            UE_LOG(LogTemp, Error, TEXT("SimulateMatch: could not read replay %s"), *ReplayPath);
+            return 1;
+        }
+
+        MapName = Header.MapName;
+        USTMatchRecorder::QueueReplay(ReplayPath);
+    }
+    else
+    {
+        if (!ScriptPath.IsEmpty() && !LoadScript(ScriptPath))
+        {
+            return 1;
+        }
+
+        int32 Seed = 0;
+        if (FParse::Value(CmdLine, TEXT("Seed="), Seed))
+        {
+            Overrides.Seed = Seed;
+        }
+
+        float Value = 0.f;
+        if (FParse::Value(CmdLine, TEXT("FireRate="), Value))
+        {
+            Overrides.FireRate = Value;
+        }
+        if (FParse::Value(CmdLine, TEXT("ProjectileDamage="), Value))
+        {
+            Overrides.ProjectileDamage = Value;
+        }
+        if (FParse::Value(CmdLine, TEXT("RotationSpeedDegPerSec="), Value))
+        {
+            Overrides.RotationSpeedDegPerSec = Value;
+        }
+
+        if (FParse::Value(CmdLine, TEXT("WaveSet="), Overrides.WaveSetPath))
+        {
+            OverrideWaveSet = LoadObject<USTWaveSet>(nullptr, *Overrides.WaveSetPath);
+            if (!OverrideWaveSet)
+            {
+                UE_LOG(LogTemp, Error, TEXT("SimulateMatch: could not load wave set %s"), *Overrides.WaveSetPath);
+                return 1;
+            }
+        }
+    }
+
+    const FString MapPackage = ToMapPackage(MapName);
+
+    UWorld* World = LoadMatchWorld(MapPackage);
+    if (!World)
+    {
+        return 1;
+    }
+
+    SimClock = USTSimulationClock::Get(World);
+    Controller = ASTGameController::Get(World);
+    USTMatchRecorder* Recorder = USTMatchRecorder::Get(World);
+
+    if (!SimClock || !Controller)
+    {
+        UE_LOG(LogTemp, Error, TEXT("SimulateMatch: %s has no %s"), *MapPackage,
+            SimClock ? TEXT("STGameController") : TEXT("simulation clock"));
+        DestroyMatchWorld(World);
+        return 1;
+    }
+
+    Controller->OnEnemyRemovalsProcessed.AddDynamic(this, &USTSimulateMatchCommandlet::HandleEnemyRemovalsProcessed);
+
+    for (ASTSpawner* Spawner : SimClock->GetSpawners())
+    {
+        if (!Spawner)
+        {
+            continue;
+        }
+
+        Spawner->OnWaveStarted.AddDynamic(this, &USTSimulateMatchCommandlet::HandleWaveStarted);
+
+        // Waves that start in BeginPlay are already running
+        if (Spawner->IsWaveRunning())
+        {
+            HandleWaveStarted(Spawner->GetCurrentWaveIndex(), Spawner->GetNumWaves());
+        }
+    }
+
+    if (!bReplay)
+    {
+        Controller->SetSpeedMode(SpeedMode);
+    }
+
+    UE_LOG(LogTemp, Display, TEXT("SimulateMatch: %s | %s"), *MapPackage,
+        bReplay ? *FString::Printf(TEXT("replay %s"), *ReplayPath)
+                : *FString::Printf(TEXT("speed %s, %d scripted commands"), *SpeedName, Script.Num()));
+
+    const uint64 StartStep = SimClock->GetSimStepNumber();
+    const double StartSeconds = FPlatformTime::Seconds();
+    uint64 NumFrames = 0;
+    bool bTimedOut = false;
+
+    while (!Controller->bIsGameOver && !IsEngineExitRequested())
+    {
+        // A recording of an unfinished match ends where it was saved
+        if (bReplay && NumFrames > 0 && !(Recorder && Recorder->IsPlayingBack()))
+        {
+            break;
+        }
+
+        if (SimClock->GetGameTime() >= MaxGameSeconds)
+        {
+            bTimedOut = true;
+            break;
+        }
+
+        RunScriptUpTo(SimClock->GetGameTime());
+
+        // Playback feeds the recorded deltas through the fixed time step
+        const float DeltaSeconds = FApp::UseFixedTimeStep() ? static_cast<float>(FApp::GetFixedDeltaTime()) : FrameSeconds;
+
+        World->Tick(LEVELTICK_All, DeltaSeconds);
+        FTSTicker::GetCoreTicker().Tick(DeltaSeconds);
+        FTaskGraphInterface::Get().ProcessThreadUntilIdle(ENamedThreads::GameThread);
+
+        ++NumFrames;
+    }
+
+    const double WallSeconds = FMath::Max(FPlatformTime::Seconds() - StartSeconds, UE_DOUBLE_SMALL_NUMBER);
+    const uint64 NumSubsteps = SimClock->GetSimStepNumber() - StartStep;
+
+    CloseCurrentWave();
+
+    float GrossScore = 0.f;
+    int32 Lives = 0;
+    int32 NumEnemiesAlive = 0;
+    Controller->GetSimCounters(GrossScore, Lives, NumEnemiesAlive);
+
+    const TCHAR* Result = bTimedOut ? TEXT("timeout")
+        : !Controller->bIsGameOver ? TEXT("unfinished")
+        : Controller->bPlayerWon ? TEXT("victory") : TEXT("defeat");
+
+    UE_LOG(LogTemp, Display,
+        TEXT("SimulateMatch: %s | score %.0f, %d leaks (%d lives left) | %.0f game s in %.2f s wall | %llu substeps = %.0f substeps/s, %llu frames = %.0f frames/s"),
+        Result, Controller->ScoreInternal, FMath::Max(Controller->StartLives - Lives, 0), Lives,
+        SimClock->GetGameTime(), WallSeconds,
+        NumSubsteps, NumSubsteps / WallSeconds, NumFrames, NumFrames / WallSeconds);
+
+    for (const FSTSimWaveResult& Wave : Waves)
+    {
+        UE_LOG(LogTemp, Display,
+            TEXT("SimulateMatch:   wave %2d | starts %7.1f s | %7.1f game s in %7.3f s wall (%llu substeps) | %d kills, %d leaks"),
+            Wave.WaveIndex + 1, Wave.StartGameSeconds, Wave.GameSeconds, Wave.WallSeconds, Wave.Substeps, Wave.Kills, Wave.Leaks);
+    }
+
+    // Let the balance stats finish so the JSON can point at them
+    if (USTMatchStats* Stats = USTMatchStats::Get(World))
+    {
+        Stats->NotifyWaveEnded();
+        Stats->WaitForExports();
+    }
+
+    if (JsonPath.IsEmpty())
+    {
+        JsonPath = FPaths::ProjectSavedDir() / TEXT("ActionTD") / TEXT("Simulations")
+            / FString::Printf(TEXT("%s_%s.json"), *FPaths::GetBaseFilename(MapPackage), *FDateTime::Now().ToString());
+    }
+
+    if (WriteResults(JsonPath, MapPackage, bReplay ? ReplayPath : ScriptPath, WallSeconds, NumFrames, NumSubsteps))
+    {
+        UE_LOG(LogTemp, Display, TEXT("SimulateMatch: results -> %s"), *JsonPath);
+    }
+    else
+    {
+        UE_LOG(LogTemp, Warning, TEXT("SimulateMatch: could not write %s"), *JsonPath);
+    }
+
+    DestroyMatchWorld(World);
+
+    return bTimedOut ? 1 : 0;
+}
+
+// ========================================================
+// World
+// ========================================================
+
+UWorld* USTSimulateMatchCommandlet::LoadMatchWorld(const FString& MapName)
+{
+    // A standalone game instance owns the world context LoadMap fills in
+    GameInstance = NewObject<UGameInstance>(GEngine);
+    GameInstance->InitializeStandalone();
+
+    FWorldContext* Context = GameInstance->GetWorldContext();
+
+    const FDelegateHandle InitializedActorsHandle = FWorldDelegates::OnWorldInitializedActors.AddUObject(
+        this, &USTSimulateMatchCommandlet::HandleWorldInitializedActors);
+
+    FString Error;
+    const bool bLoaded = Context && GEngine->LoadMap(*Context, FURL(*MapName), nullptr, Error);
+
+    FWorldDelegates::OnWorldInitializedActors.Remove(InitializedActorsHandle);
+
+    if (!bLoaded)
+    {
+        UE_LOG(LogTemp, Error, TEXT("SimulateMatch: could not load %s: %s"), *MapName, *Error);
+        GameInstance->Shutdown();
+        GameInstance = nullptr;
+        return nullptr;
+    }
+
+    return Context->World();
+}
+
+void USTSimulateMatchCommandlet::DestroyMatchWorld(UWorld* World)
+{
+    // Ends play (the recorder writes a recording in progress)
+    GEngine->DestroyWorldContext(World);
+    World->DestroyWorld(false);
+
+    if (GameInstance)
+    {
+        GameInstance->Shutdown();
+        GameInstance = nullptr;
+    }
+
+    SimClock = nullptr;
+    Controller = nullptr;
+}
+
+void USTSimulateMatchCommandlet::HandleWorldInitializedActors(const FActorsInitializedParams& InitParams)
+{
+    UWorld* World = InitParams.World;
+    if (!World || World->WorldType != EWorldType::Game)
+    {
+        return;
+    }
+
+    // Spawners seed their streams and schedule wave 0 in BeginPlay, towers push FireRate there
+    int32 SpawnerIndex = 0;
+    for (TActorIterator<ASTSpawner> It(World); It; ++It)
+    {
+        if (Overrides.Seed.IsSet())
+        {
+            // Hashed, not Seed + N: a sweep runs consecutive seeds, so spawner 1 of
+            // seed S would otherwise replay spawner 0 of seed S + 1
+            It->RandomSeed = static_cast<int32>(HashCombine(GetTypeHash(Overrides.Seed.GetValue()), GetTypeHash(SpawnerIndex)));
+        }
+        if (OverrideWaveSet)
+        {
+            It->WaveSet = OverrideWaveSet;
+        }
+        ++SpawnerIndex;
+    }
+
+    for (TActorIterator<AAttackTowerBase> It(World); It; ++It)
+    {
+        if (Overrides.FireRate.IsSet())
+        {
+            It->FireRate = Overrides.FireRate.GetValue();
+        }
+        if (Overrides.ProjectileDamage.IsSet())
+        {
+            It->ProjectileDamage = Overrides.ProjectileDamage.GetValue();
+        }
+        if (Overrides.RotationSpeedDegPerSec.IsSet())
+        {
+            It->RotationSpeedDegPerSec = Overrides.RotationSpeedDegPerSec.GetValue();
+        }
+    }
+}
+
+// ========================================================
+// Script
+// ========================================================
+
+bool USTSimulateMatchCommandlet::LoadScript(const FString& Path)
+{
+    TArray<FString> Lines;
+    if (!FFileHelper::LoadFileToStringArray(Lines, *Path))
+    {
+        UE_LOG(LogTemp, Error, TEXT("SimulateMatch: could not read script %s"), *Path);
+        return false;
+    }
+
+    for (int32 Index = 0; Index < Lines.Num(); ++Index)
+    {
+        FString Line = Lines[Index];
+
+        int32 CommentStart = INDEX_NONE;
+        if (Line.FindChar(TEXT('#'), CommentStart))
+        {
+            Line.LeftInline(CommentStart);
+        }
+
+        TArray<FString> Tokens;
+        Line.ParseIntoArrayWS(Tokens);
+        if (Tokens.Num() == 0)
+        {
+            continue;
+        }
+
+        if (Tokens.Num() < 2 || !Tokens[0].IsNumeric())
+        {
+            UE_LOG(LogTemp, Error, TEXT("SimulateMatch: %s:%d: expected \"<game seconds> <command> [args]\""), *Path, Index + 1);
+            return false;
+        }
+
+        FSTSimScriptCommand& Command = Script.AddDefaulted_GetRef();
+        Command.GameSeconds = FCString::Atof(*Tokens[0]);
+        Command.Verb = Tokens[1].ToLower();
+        Command.Args.Append(Tokens.GetData() + 2, Tokens.Num() - 2);
+        Command.Line = Index + 1;
+    }
+
+    // Same-time commands keep their file order
+    Algo::StableSortBy(Script, &FSTSimScriptCommand::GameSeconds);
+    return true;
+}
+
+void USTSimulateMatchCommandlet::RunScriptUpTo(double GameSeconds)
+{
+    while (Script.IsValidIndex(NextScriptCommand) && Script[NextScriptCommand].GameSeconds <= GameSeconds)
+    {
+        RunScriptCommand(Script[NextScriptCommand++]);
+    }
+}
+
+void USTSimulateMatchCommandlet::RunScriptCommand(const FSTSimScriptCommand& Command)
+{
+    auto TowerArg = [this, &Command](int32 ArgIndex) -> ATowerBase*
+    {
+        return Command.Args.IsValidIndex(ArgIndex) ? FindTower(FCString::Atoi(*Command.Args[ArgIndex])) : nullptr;
+    };
+
+    bool bRan = false;
+
+    if (Command.Verb == TEXT("capture"))
+    {
+        AAttackTowerBase* Tower = Cast<AAttackTowerBase>(TowerArg(0));
+        ATowerBase* Neutral = TowerArg(1);
+        if (Tower && Neutral)
+        {
+            Tower->OrderCaptureTower(Neutral);
+            bRan = true;
+        }
+    }
+    else if (Command.Verb == TEXT("stop"))
+    {
+        if (AAttackTowerBase* Tower = Cast<AAttackTowerBase>(TowerArg(0)))
+        {
+            Tower->OrderStopCurrentAction();
+            bRan = true;
+        }
+    }
+    else if (Command.Verb == TEXT("upgrade"))
+    {
+        if (ATowerBase* Tower = TowerArg(0))
+        {
+            Tower->UpgradeTower();
+            bRan = true;
+        }
+    }
+    else if (Command.Verb == TEXT("wave"))
+    {
+        Controller->Command_RequestNextWave();
+        bRan = true;
+    }
+    else if (Command.Verb == TEXT("speed"))
+    {
+        EGameSpeedMode Mode;
+        if (Command.Args.Num() > 0 && STSimulateMatch::ParseSpeedMode(Command.Args[0], Mode))
+        {
+            Controller->SetSpeedMode(Mode);
+            bRan = true;
+        }
+    }
+
+    if (!bRan)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("SimulateMatch: script line %d (%s %s) did not run"),
+            Command.Line, *Command.Verb, *FString::Join(Command.Args, TEXT(" ")));
+    }
+}
+
+ATowerBase* USTSimulateMatchCommandlet::FindTower(int32 SimId) const
+{
+    if (!SimClock || SimId == INDEX_NONE)
+    {
+        return nullptr;
+    }
+
+    for (ATowerBase* Tower : SimClock->GetTowers())
+    {
+        if (Tower && Tower->GetSimId() == SimId)
+        {
+            return Tower;
+        }
+    }
+
+    return nullptr;
+}
+
+// ========================================================
+// Waves
+// ========================================================
+
+void USTSimulateMatchCommandlet::HandleWaveStarted(int32 WaveIndex, int32 TotalWaves)
+{
+    // Several spawners start the same wave; seeks replay ones already seen
+    if (!SimClock || (Waves.Num() > 0 && WaveIndex <= Waves.Last().WaveIndex))
+    {
+        return;
+    }
+
+    CloseCurrentWave();
+
+    FSTSimWaveResult& Wave = Waves.AddDefaulted_GetRef();
+    Wave.WaveIndex = WaveIndex;
+    Wave.StartGameSeconds = SimClock->GetGameTime();
+    Wave.StartStep = SimClock->GetSimStepNumber();
+    Wave.StartWallSeconds = FPlatformTime::Seconds();
+}
+
+void USTSimulateMatchCommandlet::HandleEnemyRemovalsProcessed(int32 NumKilled, int32 NumLeaked, float ScoreAwarded)
+{
+    if (Waves.Num() > 0)
+    {
+        Waves.Last().Kills += NumKilled;
+        Waves.Last().Leaks += NumLeaked;
+    }
+}
+
+void USTSimulateMatchCommandlet::CloseCurrentWave()
+{
+    if (Waves.Num() == 0 || !SimClock)
+    {
+        return;
+    }
+
+    // A wave lasts until the next one starts (or the match ends)
+    FSTSimWaveResult& Wave = Waves.Last();
+    Wave.GameSeconds = SimClock->GetGameTime() - Wave.StartGameSeconds;
+    Wave.Substeps = SimClock->GetSimStepNumber() - Wave.StartStep;
+    Wave.WallSeconds = FPlatformTime::Seconds() - Wave.StartWallSeconds;
+}
+
+// ========================================================
+// Results
+// ========================================================
+
+bool USTSimulateMatchCommandlet::WriteResults(const FString& Path, const FString& MapName, const FString& ScriptPath,
+    double WallSeconds, uint64 NumFrames, uint64 NumSubsteps) const
+{
+    float GrossScore = 0.f;
+    int32 Lives = 0;
+    int32 NumEnemiesAlive = 0;
+    Controller->GetSimCounters(GrossScore, Lives, NumEnemiesAlive);
+
+    TSharedRef<FJsonObject> Root = MakeShared<FJsonObject>();
+    Root->SetStringField(TEXT("map"), MapName);
+    Root->SetStringField(TEXT("script"), ScriptPath);
+    Root->SetStringField(TEXT("build"), FApp::GetBuildVersion());
+    Root->SetStringField(TEXT("configuration"), LexToString(FApp::GetBuildConfiguration()));
+    Root->SetStringField(TEXT("time"), FDateTime::UtcNow().ToIso8601());
+    Root->SetBoolField(TEXT("finished"), Controller->bIsGameOver);
+    Root->SetBoolField(TEXT("victory"), Controller->bIsGameOver && Controller->bPlayerWon);
+    Root->SetNumberField(TEXT("score"), Controller->ScoreInternal);
+    Root->SetNumberField(TEXT("grossScore"), GrossScore);
+    Root->SetNumberField(TEXT("leaks"), FMath::Max(Controller->StartLives - Lives, 0));
+    Root->SetNumberField(TEXT("livesLeft"), Lives);
+    Root->SetNumberField(TEXT("gameSeconds"), SimClock->GetGameTime());
+    Root->SetNumberField(TEXT("wallSeconds"), WallSeconds);
+    Root->SetNumberField(TEXT("frames"), static_cast<double>(NumFrames));
+    Root->SetNumberField(TEXT("substeps"), static_cast<double>(NumSubsteps));
+    Root->SetNumberField(TEXT("framesPerSecond"), NumFrames / WallSeconds);
+    Root->SetNumberField(TEXT("substepsPerSecond"), NumSubsteps / WallSeconds);
+
+    // Only what was overridden; everything else is as placed in the level
+    TSharedRef<FJsonObject> OverridesObject = MakeShared<FJsonObject>();
+    if (Overrides.Seed.IsSet())
+    {
+        OverridesObject->SetNumberField(TEXT("seed"), Overrides.Seed.GetValue());
+    }
+    if (!Overrides.WaveSetPath.IsEmpty())
+    {
+        OverridesObject->SetStringField(TEXT("waveSet"), Overrides.WaveSetPath);
+    }
+    if (Overrides.FireRate.IsSet())
+    {
+        OverridesObject->SetNumberField(TEXT("fireRate"), Overrides.FireRate.GetValue());
+    }
+    if (Overrides.ProjectileDamage.IsSet())
+    {
+        OverridesObject->SetNumberField(TEXT("projectileDamage"), Overrides.ProjectileDamage.GetValue());
+    }
+    if (Overrides.RotationSpeedDegPerSec.IsSet())
+    {
+        OverridesObject->SetNumberField(TEXT("rotationSpeedDegPerSec"), Overrides.RotationSpeedDegPerSec.GetValue());
+    }
+    Root->SetObjectField(TEXT("overrides"), OverridesObject);
+
+    if (const USTMatchStats* Stats = USTMatchStats::Get(SimClock))
+    {
+        Root->SetStringField(TEXT("stats"), Stats->GetExportPath());
+    }
+
+    TArray<TSharedPtr<FJsonValue>> WaveValues;
+    for (const FSTSimWaveResult& Wave : Waves)
+    {
+        TSharedRef<FJsonObject> WaveObject = MakeShared<FJsonObject>();
+        WaveObject->SetNumberField(TEXT("wave"), Wave.WaveIndex + 1);
+        WaveObject->SetNumberField(TEXT("startGameSeconds"), Wave.StartGameSeconds);
+        WaveObject->SetNumberField(TEXT("gameSeconds"), Wave.GameSeconds);
+        WaveObject->SetNumberField(TEXT("wallSeconds"), Wave.WallSeconds);
+        WaveObject->SetNumberField(TEXT("substeps"), static_cast<double>(Wave.Substeps));
+        WaveObject->SetNumberField(TEXT("kills"), Wave.Kills);
+        WaveObject->SetNumberField(TEXT("leaks"), Wave.Leaks);
+        WaveValues.Add(MakeShared<FJsonValueObject>(WaveObject));
+    }
+    Root->SetArrayField(TEXT("waves"), WaveValues);
+
+    FString Json;
+    const TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&Json);
+    if (!FJsonSerializer::Serialize(Root, Writer))
+    {
+        return false;
+    }
+
+    return FFileHelper::SaveStringToFile(Json, *Path);
+}
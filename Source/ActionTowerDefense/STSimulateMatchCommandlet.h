@@ -0,0 +1,147 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "STSimulateMatchCommandlet.generated.h"
+
+class UWorld;
+class UGameInstance;
+class USTSimulationClock;
+class ASTGameController;
+class ATowerBase;
+class USTWaveSet;
+struct FActorsInitializedParams;
+
+/** One scripted command: what to do once game time reaches GameSeconds. */
+struct FSTSimScriptCommand
+{
+    float GameSeconds = 0.f;
+    FString Verb;
+    TArray<FString> Args;
+    int32 Line = 0;
+};
+
+/** Level changes a match runs with, applied before BeginPlay (unset: as placed). */
+struct FSTSimMatchOverrides
+{
+    /** Spawner N of the level gets a seed hashed from (Seed, N). */
+    TOptional<int32> Seed;
+
+    FString WaveSetPath;
+
+    /** Attack towers placed in the level (not towers spawned later by upgrades). */
+    TOptional<float> FireRate;
+    TOptional<float> ProjectileDamage;
+    TOptional<float> RotationSpeedDegPerSec;
+};
+
+/** Timings and removals of one wave of a simulated match. */
+struct FSTSimWaveResult
+{
+    int32 WaveIndex = INDEX_NONE;
+    double StartGameSeconds = 0.0;
+    double GameSeconds = 0.0;
+    double WallSeconds = 0.0;
+    uint64 Substeps = 0;
+    int32 Kills = 0;
+    int32 Leaks = 0;
+
+    /** Clock / wall time when the wave started (for closing it). */
+    uint64 StartStep = 0;
+    double StartWallSeconds = 0.0;
+};
+
+/**
+ * Plays a whole match headless at unlimited speed and reports how it went.
+ *
+ *   UnrealEditor-Cmd ActionTowerDefense.uproject -run=STSimulateMatch -Map=TestLevel2
+ *       [-Script=<file>] [-Replay=<file.atdreplay>] [-Speed=Unlimited] [-MaxGameSeconds=7200]
+ *       [-Seed=N] [-WaveSet=<asset path>] [-FireRate=X] [-ProjectileDamage=X] [-RotationSpeedDegPerSec=X]
+ *       [-Json=<file>] -nullrhi -unattended
+ *
+ * The level loads as a game world and ticks back to back without rendering or
+ * waiting, at -Speed (an EGameSpeedMode name, Unlimited by default: as many
+ * substeps per frame as the clock's fast-forward budget allows).
+ *
+ * Tower setup:
+ *  - the level as placed, by default
+ *  - -Script: a text file of "<game seconds> <command> [args]" lines ('#' comments),
+ *    run when game time reaches them. Towers are named by sim id:
+ *      capture <TowerId> <NeutralTowerId>   stop <TowerId>   upgrade <TowerId>
+ *      wave                                  speed <EGameSpeedMode>
+ *  - -Replay: a match recording (USTMatchRecorder); its map, seeds, frame timings
+ *    and commands are played back instead (speed, script and overrides do not apply)
+ *
+ * -Seed, -WaveSet and the tower parameters override the level (FSTSimMatchOverrides).
+ *
+ * -Jobs=<file> runs one match per line of the file, each line holding the options
+ * above, in one process (USTBalanceSweepCommandlet's workers use this).
+ *
+ * Reports victory / defeat, final score, leaks, per-wave game and wall time, and
+ * simulated substeps and frames per second; logs them and writes them to -Json
+ * (default Saved/ActionTD/Simulations/<map>_<time>.json).
+ *
+ * Returns 1 when the match could not run or hit MaxGameSeconds, 0 otherwise
+ * (victory, defeat, or the end of a recording of an unfinished match).
+ */
+UCLASS()
+class ACTIONTOWERDEFENSE_API USTSimulateMatchCommandlet : public UCommandlet
+{
+    GENERATED_BODY()
+
+public:
+    USTSimulateMatchCommandlet();
+
+    virtual int32 Main(const FString& Params) override;
+
+protected:
+    /** One match with the options in Params; returns its exit code. */
+    int32 RunMatch(const FString& Params);
+
+    /** Load MapName into a fresh game world (nullptr on failure). */
+    UWorld* LoadMatchWorld(const FString& MapName);
+    void DestroyMatchWorld(UWorld* World);
+
+    /** Apply Overrides to the level's actors (before they begin play). */
+    void HandleWorldInitializedActors(const FActorsInitializedParams& InitParams);
+
+    bool LoadScript(const FString& Path);
+
+    /** Run every scripted command due by GameSeconds. */
+    void RunScriptUpTo(double GameSeconds);
+    void RunScriptCommand(const FSTSimScriptCommand& Command);
+
+    ATowerBase* FindTower(int32 SimId) const;
+
+    void CloseCurrentWave();
+
+    bool WriteResults(const FString& Path, const FString& MapName, const FString& ScriptPath,
+        double WallSeconds, uint64 NumFrames, uint64 NumSubsteps) const;
+
+    UFUNCTION()
+    void HandleWaveStarted(int32 WaveIndex, int32 TotalWaves);
+
+    UFUNCTION()
+    void HandleEnemyRemovalsProcessed(int32 NumKilled, int32 NumLeaked, float ScoreAwarded);
+
+    UPROPERTY(Transient)
+    USTSimulationClock* SimClock = nullptr;
+
+    UPROPERTY(Transient)
+    ASTGameController* Controller = nullptr;
+
+    UPROPERTY(Transient)
+    UGameInstance* GameInstance = nullptr;
+
+    UPROPERTY(Transient)
+    USTWaveSet* OverrideWaveSet = nullptr;
+
+    FSTSimMatchOverrides Overrides;
+
+    TArray<FSTSimScriptCommand> Script;
+    int32 NextScriptCommand = 0;
+
+    TArray<FSTSimWaveResult> Waves;
+};
@@ -0,0 +1,889 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "STSimulationClock.h"
+#include "Engine/World.h"
+#include "Engine/GameViewportClient.h"
+#include "STSpawner.h"
+#include "EnemyBase.h"
+#include "TowerBase.h"
+#include "STProjectilePool.h"
+#include "STGameEventScheduler.h"
+#include "STRewindHistory.h"
+#include "Algo/StableSort.h"
+#include "Algo/BinarySearch.h"
+#include "Projectile.h"
+#include "HAL/IConsoleManager.h"
+#include "STTrace.h"
+#include "STStatGroup.h"
+
+void USTSimulationClock::Initialize(FSubsystemCollectionBase& Collection)
+{
+    Super::Initialize(Collection);
+
+    ProjectilePool = Collection.InitializeDependency<USTProjectilePoolSubsystem>();
+    EventScheduler = Collection.InitializeDependency<USTGameEventScheduler>();
+
+    TickStartHandle = FWorldDelegates::OnWorldTickStart.AddUObject(
+        this, &USTSimulationClock::HandleWorldTickStart);
+}
+
+void USTSimulationClock::Deinitialize()
+{
+    FWorldDelegates::OnWorldTickStart.Remove(TickStartHandle);
+    TickStartHandle.Reset();
+
+    Spawners.Reset();
+    Enemies.Reset();
+    Towers.Reset();
+    SuspendedActors.Reset();
+    SuspendedComponents.Reset();
+
+    // The viewport outlives the world: never leave it blank
+    if (bWorldRenderingSkipped)
+    {
+        if (UWorld* World = GetWorld())
+        {
+            if (UGameViewportClient* Viewport = World->GetGameViewport())
+            {
+                Viewport->bDisableWorldRendering = false;
+            }
+        }
+        bWorldRenderingSkipped = false;
+    }
+
+    Super::Deinitialize();
+}
+
+bool USTSimulationClock::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+    return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void USTSimulationClock::OnWorldBeginPlay(UWorld& InWorld)
+{
+    Super::OnWorldBeginPlay(InWorld);
+
+    // Not an initialization dependency: the history reads our participant lists
+    RewindHistory = InWorld.GetSubsystem<USTRewindHistory>();
+
+    SimRateStartWallSeconds = FPlatformTime::Seconds();
+}
+
+USTSimulationClock* USTSimulationClock::Get(const UObject* WorldContextObject)
+{
+    if (!WorldContextObject)
+    {
+        return nullptr;
+    }
+
+    UWorld* World = WorldContextObject->GetWorld();
+    if (!World)
+    {
+        return nullptr;
+    }
+
+    return World->GetSubsystem<USTSimulationClock>();
+}
+
+void USTSimulationClock::SetFixedStepSeconds(float InStepSeconds)
+{
+    FixedStepSeconds = FMath::Max(InStepSeconds, 0.001f);
+    Accumulator = 0.f;
+}
+
+// ========================================================
+// Frame start: latch speed, run substeps
+// ========================================================
+
+void USTSimulationClock::HandleWorldTickStart(UWorld* InWorld, ELevelTick TickType, float DeltaSeconds)
+{
+    // The delegate is global: only advance for our own world
+    if (InWorld != GetWorld())
+    {
+        return;
+    }
+
+    ST_SCOPE_TIMER(ClockFrame);
+
+    ++FrameNumber;
+    UpdateFrameStats();
+
+    // Replayed commands land here, before the speed they may change is latched
+    OnFrameStart.Broadcast(FrameNumber);
+
+    const int32 ForcedSteps = ForcedSubsteps;
+    ForcedSubsteps = INDEX_NONE;
+
+    GameSpeed = PendingGameSpeed;
+    RealDeltaSeconds = DeltaSeconds;
+
+    // A hard engine pause (SetGamePaused) freezes the simulation too
+    const bool bWorldPaused = InWorld->IsPaused();
+
+    bIsPaused = bWorldPaused || FMath::IsNearlyZero(GameSpeed);
+    bIsReversing = !bIsPaused && GameSpeed < 0.f;
+
+    if (!bIsPaused && !bIsReversing)
+    {
+        LogGameSpeed();
+    }
+
+    // Pausing stops simulation actors from ticking at all, instead of early-outs in Tick
+    if (bIsPaused != bTicksSuspended)
+    {
+        if (bIsPaused)
+        {
+            SuspendParticipantTicks();
+        }
+        else
+        {
+            ResumeParticipantTicks();
+        }
+    }
+
+    if (GameSpeed != SimRateSpeed)
+    {
+        RestartSimRateMeasurement();
+    }
+
+    // Fast-forward: draw one frame in FastForwardRenderInterval, simulate in the others
+    bIsFastForward = !bIsPaused && GameSpeed > FastForwardSpeed;
+    bPresentThisFrame = !bIsFastForward || (FrameNumber % FastForwardRenderInterval) == 0;
+    UpdateRenderDecimation(InWorld);
+
+    ScaledDeltaSeconds = bIsPaused ? 0.f : DeltaSeconds * GameSpeed;
+
+    NumSubstepsThisFrame = 0;
+
+    // Paused: keep the accumulator and interpolation alpha as they are
+    if (bIsPaused)
+    {
+        return;
+    }
+
+    // Direction change: leftover time from the other direction is meaningless
+    const float StepSign = bIsReversing ? -1.f : 1.f;
+    if (StepSign != AccumulatorSign)
+    {
+        Accumulator = 0.f;
+        AccumulatorSign = StepSign;
+    }
+
+    const bool bUnlimited = GameSpeed >= UnlimitedSpeed;
+
+    int32 NumSteps = MAX_int32;
+    if (bUnlimited)
+    {
+        // No target rate: the frame budget alone decides
+        Accumulator = 0.f;
+    }
+    else
+    {
+        Accumulator += FMath::Abs(ScaledDeltaSeconds);
+
+        NumSteps = FMath::FloorToInt(Accumulator / FixedStepSeconds);
+        Accumulator -= NumSteps * FixedStepSeconds;
+    }
+
+    // Too much to catch up on: run what we can afford, drop the rest
+    // (fast-forward is bounded by wall-clock time below instead)
+    if (!bIsFastForward && NumSteps > MaxSubstepsPerFrame)
+    {
+        DroppedGameSeconds += (NumSteps - MaxSubstepsPerFrame) * FixedStepSeconds;
+        NumSteps = MaxSubstepsPerFrame;
+    }
+
+    // A replayed frame runs what the recorded one ran, whatever the budget says now
+    if (ForcedSteps != INDEX_NONE)
+    {
+        NumSteps = ForcedSteps;
+    }
+
+    const float StepSeconds = FixedStepSeconds * StepSign;
+    const double BudgetEndSeconds = FPlatformTime::Seconds() + FastForwardBudgetSeconds;
+
+    int32 NumRun = 0;
+    while (NumRun < NumSteps)
+    {
+        RunSubstep(StepSeconds);
+        ++NumRun;
+
+        if (bIsFastForward && ForcedSteps == INDEX_NONE && FPlatformTime::Seconds() >= BudgetEndSeconds)
+        {
+            break;
+        }
+    }
+
+    if (!bUnlimited && NumRun < NumSteps)
+    {
+        DroppedGameSeconds += (NumSteps - NumRun) * FixedStepSeconds;
+    }
+
+    NumSubstepsThisFrame = NumRun;
+    SimRateGameSeconds += NumRun * FixedStepSeconds;
+    SimRateSubsteps += NumRun;
+    ++SimRateFrames;
+
+    InterpAlpha = bUnlimited ? 1.f : FMath::Clamp(Accumulator / FixedStepSeconds, 0.f, 1.f);
+
+    // Projectiles have no actor tick; place them for rendering here
+    if (ProjectilePool && bPresentThisFrame)
+    {
+        ST_SCOPE_TIMER(ProjectilePresentation);
+        ProjectilePool->UpdatePresentation(InterpAlpha);
+    }
+}
+
+void USTSimulationClock::UpdateFrameStats() const
+{
+#if STATS || CSV_PROFILER
+    const int32 NumEnemies = NumEnemiesRegistered;
+    const int32 NumAwake = NumTowersAwake;
+    const int32 NumProjectiles = ProjectilePool ? ProjectilePool->GetNumActiveProjectiles() : 0;
+
+    SET_DWORD_STAT(STAT_ActionTD_EnemiesAlive, NumEnemies);
+    SET_DWORD_STAT(STAT_ActionTD_ProjectilesAlive, NumProjectiles);
+    SET_DWORD_STAT(STAT_ActionTD_TowersAwake, NumAwake);
+
+    // Wave and speed columns let the per-wave report bucket frames by speed mode
+    const ASTSpawner* Spawner = Spawners.Num() > 0 ? Spawners[0] : nullptr;
+    CSV_CUSTOM_STAT(ActionTD, EnemiesAlive, NumEnemies, ECsvCustomStatOp::Set);
+    CSV_CUSTOM_STAT(ActionTD, ProjectilesAlive, NumProjectiles, ECsvCustomStatOp::Set);
+    CSV_CUSTOM_STAT(ActionTD, TowersAwake, NumAwake, ECsvCustomStatOp::Set);
+    CSV_CUSTOM_STAT(ActionTD, GameSpeed, GameSpeed, ECsvCustomStatOp::Set);
+    CSV_CUSTOM_STAT(ActionTD, WaveIndex, Spawner ? Spawner->GetCurrentWaveIndex() : INDEX_NONE, ECsvCustomStatOp::Set);
+
+#if STATS
+    STStats::UpdateRates();
+#endif
+#endif
+}
+
+void USTSimulationClock::UpdateRenderDecimation(UWorld* InWorld)
+{
+    const bool bSkipRender = !bPresentThisFrame;
+    if (bSkipRender == bWorldRenderingSkipped)
+    {
+        return;
+    }
+
+    if (UGameViewportClient* Viewport = InWorld->GetGameViewport())
+    {
+        Viewport->bDisableWorldRendering = bSkipRender;
+        bWorldRenderingSkipped = bSkipRender;
+    }
+}
+
+// ========================================================
+// Sim-rate measurement
+// ========================================================
+
+double USTSimulationClock::GetSimRate() const
+{
+    const double WallSeconds = FPlatformTime::Seconds() - SimRateStartWallSeconds;
+    return WallSeconds > 0.0 ? SimRateGameSeconds / WallSeconds : 0.0;
+}
+
+void USTSimulationClock::RestartSimRateMeasurement()
+{
+    const double NowSeconds = FPlatformTime::Seconds();
+
+#if !UE_BUILD_SHIPPING
+    // One line per speed setting that ran long enough to mean something
+    const double WallSeconds = NowSeconds - SimRateStartWallSeconds;
+    if (SimRateSpeed > 0.f && SimRateFrames > 0 && WallSeconds >= 1.0)
+    {
+        UE_LOG(LogTemp, Log,
+            TEXT("SimRate: %s ran at %.1f game-s per real-s over %.1f s (%.1f substeps/frame, %.0f fps)"),
+            SimRateSpeed >= UnlimitedSpeed ? TEXT("max") : *FString::Printf(TEXT("%gx"), SimRateSpeed),
+            SimRateGameSeconds / WallSeconds,
+            WallSeconds,
+            static_cast<double>(SimRateSubsteps) / SimRateFrames,
+            SimRateFrames / WallSeconds);
+    }
+#endif
+
+    SimRateSpeed = GameSpeed;
+    SimRateStartWallSeconds = NowSeconds;
+    SimRateGameSeconds = 0.0;
+    SimRateFrames = 0;
+    SimRateSubsteps = 0;
+}
+
+void USTSimulationClock::RunSubstep(float StepSeconds)
+{
+    ST_TRACE_CPUSCOPE(ActionTD_Clock_RunSubstep);
+
+    if (StepSeconds < 0.f)
+    {
+        RunReverseSubstep(StepSeconds);
+        return;
+    }
+
+    ++SimStepNumber;
+    GameTime += StepSeconds;
+    INC_DWORD_STAT(STAT_ActionTD_Substeps);
+
+    // Enemies move below; the first tower query rebuilds the grid
+    bEnemyGridValid = false;
+
+    // Index loops: participants may register (spawns, upgrades) or unregister
+    // (kills, leaks) mid-step. New entries step right away, removed ones are nulled.
+    {
+        ST_SCOPE_TIMER(StepSpawners);
+        for (int32 Index = 0; Index < Spawners.Num(); ++Index)
+        {
+            if (ASTSpawner* Spawner = Spawners[Index])
+            {
+                Spawner->SimStep(StepSeconds);
+            }
+        }
+    }
+
+    {
+        ST_SCOPE_TIMER(StepEnemies);
+        for (int32 Index = 0; Index < Enemies.Num(); ++Index)
+        {
+            if (ASTEnemyBase* Enemy = Enemies[Index])
+            {
+                Enemy->SimStep(StepSeconds);
+            }
+        }
+    }
+
+    {
+        ST_SCOPE_TIMER(StepTowers);
+        for (int32 Index = 0; Index < Towers.Num(); ++Index)
+        {
+            if (ATowerBase* Tower = Towers[Index])
+            {
+                Tower->SimStep(StepSeconds);
+            }
+        }
+    }
+
+    if (ProjectilePool)
+    {
+        ST_SCOPE_TIMER(StepProjectiles);
+        ProjectilePool->SimStep(StepSeconds);
+    }
+
+    if (EventScheduler)
+    {
+        ST_SCOPE_TIMER(ScheduledEvents);
+        EventScheduler->AdvanceEvents(StepSeconds);
+    }
+
+    if (bNeedsCompaction)
+    {
+        CompactParticipants();
+    }
+
+    if (RewindHistory)
+    {
+        ST_SCOPE_TIMER(RewindRecord);
+        RewindHistory->RecordFrame(SimStepNumber, GameTime);
+    }
+}
+
+int32 USTSimulationClock::QueryEnemiesInReach(const FVector& Center, float Range, TArray<AActor*>& OutEnemies)
+{
+    if (!bEnemyGridValid)
+    {
+        EnemyGrid.Build(Enemies);
+        bEnemyGridValid = true;
+    }
+
+    EnemyQueryScratch.Reset();
+    const int32 NumTested = EnemyGrid.Query(Center, Range, EnemyQueryScratch);
+
+    // Slots of enemies killed since the build are null now
+    for (const int32 Index : EnemyQueryScratch)
+    {
+        if (ASTEnemyBase* Enemy = Enemies[Index])
+        {
+            OutEnemies.Add(Enemy);
+        }
+    }
+
+    return NumTested;
+}
+
+ASTEnemyBase* USTSimulationClock::FindFirstEnemyAlongSegment(const FVector& Start, const FVector& End, float Radius)
+{
+    if (!bEnemyGridValid)
+    {
+        EnemyGrid.Build(Enemies);
+        bEnemyGridValid = true;
+    }
+
+    // Bounding sphere of the swept segment
+    EnemyQueryScratch.Reset();
+    EnemyGrid.Query((Start + End) * 0.5f, FVector::Dist(Start, End) * 0.5f + Radius, EnemyQueryScratch);
+
+    ASTEnemyBase* FirstHit = nullptr;
+    float FirstHitDistSq = TNumericLimits<float>::Max();
+
+    for (const int32 Index : EnemyQueryScratch)
+    {
+        ASTEnemyBase* Enemy = Enemies[Index];
+        if (!Enemy)
+        {
+            continue;
+        }
+
+        const FVector EnemyLoc = Enemy->GetSimLocation();
+        const FVector Closest = FMath::ClosestPointOnSegment(EnemyLoc, Start, End);
+        const float HitRadius = Radius + Enemy->GetSimCollisionRadius();
+        if (FVector::DistSquared(Closest, EnemyLoc) > HitRadius * HitRadius)
+        {
+            continue;
+        }
+
+        // Slots come back ascending, so equal distances keep step order
+        const float DistSq = FVector::DistSquared(Start, Closest);
+        if (DistSq < FirstHitDistSq)
+        {
+            FirstHit = Enemy;
+            FirstHitDistSq = DistSq;
+        }
+    }
+
+    return FirstHit;
+}
+
+void USTSimulationClock::RunReverseSubstep(float StepSeconds)
+{
+    // Nothing recorded that far back: time simply stops
+    if (!RewindHistory || !RewindHistory->CanRewind())
+    {
+        return;
+    }
+
+    INC_DWORD_STAT(STAT_ActionTD_Substeps);
+
+    // Pending damage / lifetimes run backwards first; the snapshot is authoritative after
+    if (EventScheduler)
+    {
+        ST_SCOPE_TIMER(ScheduledEvents);
+        EventScheduler->AdvanceEvents(StepSeconds);
+    }
+
+    {
+        ST_SCOPE_TIMER(RewindRestore);
+        RewindHistory->RewindOneFrame(SimStepNumber, GameTime);
+    }
+
+    // Resurrected enemies registered at the back: restore id (= spawn) order
+    CompactParticipants(true);
+    RecountAwakeTowers();
+}
+
+// ========================================================
+// Timeline seeking
+// ========================================================
+
+void USTSimulationClock::LogGameSpeed()
+{
+    // Entries past the current step belong to a future that was rewound away
+    while (SpeedLog.Num() > 0 && SpeedLog.Last().FromStep > SimStepNumber)
+    {
+        SpeedLog.Pop(EAllowShrinking::No);
+    }
+
+    if (SpeedLog.Num() > 0 && SpeedLog.Last().Speed == GameSpeed)
+    {
+        return;
+    }
+
+    // Changed again before any step ran at the previous value
+    if (SpeedLog.Num() > 0 && SpeedLog.Last().FromStep == SimStepNumber)
+    {
+        SpeedLog.Last().Speed = GameSpeed;
+        return;
+    }
+
+    FSTSpeedLogEntry& Entry = SpeedLog.AddDefaulted_GetRef();
+    Entry.FromStep = SimStepNumber;
+    Entry.Speed = GameSpeed;
+}
+
+float USTSimulationClock::GetSpeedForStep(uint64 Step) const
+{
+    // Last entry logged before the step ran
+    const int32 Index = Algo::LowerBoundBy(SpeedLog, Step, &FSTSpeedLogEntry::FromStep) - 1;
+    return SpeedLog.IsValidIndex(Index) ? SpeedLog[Index].Speed : 1.f;
+}
+
+bool USTSimulationClock::SeekToStep(uint64 TargetStep)
+{
+    if (!RewindHistory || bIsReplaying || TargetStep > SimStepNumber)
+    {
+        return false;
+    }
+
+    ST_SCOPE_TIMER(Seek);
+
+    uint64 KeyStep = 0;
+    double KeyGameTime = 0.0;
+    if (!RewindHistory->RestoreMatchKeyframe(TargetStep, KeyStep, KeyGameTime))
+    {
+        return false;
+    }
+
+    SimStepNumber = KeyStep;
+    GameTime = KeyGameTime;
+    Accumulator = 0.f;
+
+    // Resurrected participants registered at the back: restore id (= spawn) order
+    CompactParticipants(true);
+    RecountAwakeTowers();
+
+    // The restored keyframe, then every replayed step (RecordFrame), must match the recording
+    RewindHistory->VerifySeekStep(KeyStep);
+
+    // Replay each step at the speed it originally ran at; this frame's speed comes back after
+    const float LatchedSpeed = GameSpeed;
+    bIsReplaying = true;
+
+    while (SimStepNumber < TargetStep)
+    {
+        GameSpeed = GetSpeedForStep(SimStepNumber + 1);
+        RunSubstep(FixedStepSeconds);
+    }
+
+    bIsReplaying = false;
+    GameSpeed = LatchedSpeed;
+
+    // Seeking while paused: projectiles put back in flight must not tick either
+    if (bTicksSuspended)
+    {
+        SuspendParticipantTicks();
+    }
+
+    // Show the target state itself, not a blend from the step before
+    InterpAlpha = 1.f;
+    if (ProjectilePool)
+    {
+        ProjectilePool->UpdatePresentation(InterpAlpha);
+    }
+
+    return true;
+}
+
+// ========================================================
+// Pause: participant ticks
+// ========================================================
+
+void USTSimulationClock::SuspendActorTicks(AActor* Actor)
+{
+    if (!Actor)
+    {
+        return;
+    }
+
+    if (Actor->IsActorTickEnabled())
+    {
+        Actor->SetActorTickEnabled(false);
+        SuspendedActors.Add(Actor);
+    }
+
+    for (UActorComponent* Component : Actor->GetComponents())
+    {
+        if (Component && Component->IsComponentTickEnabled())
+        {
+            Component->SetComponentTickEnabled(false);
+            SuspendedComponents.Add(Component);
+        }
+    }
+}
+
+void USTSimulationClock::SuspendParticipantTicks()
+{
+    bTicksSuspended = true;
+
+    for (ASTSpawner* Spawner : Spawners)
+    {
+        SuspendActorTicks(Spawner);
+    }
+
+    for (ASTEnemyBase* Enemy : Enemies)
+    {
+        SuspendActorTicks(Enemy);
+    }
+
+    for (ATowerBase* Tower : Towers)
+    {
+        if (Tower)
+        {
+            // Tower ticks used to switch the beam off on paused frames; do it once here
+            Tower->StopCaptureBeam();
+            SuspendActorTicks(Tower);
+        }
+    }
+
+    if (ProjectilePool)
+    {
+        for (AProjectile* Projectile : ProjectilePool->GetActiveProjectiles())
+        {
+            SuspendActorTicks(Projectile);
+        }
+    }
+}
+
+void USTSimulationClock::ResumeParticipantTicks()
+{
+    bTicksSuspended = false;
+
+    for (const TWeakObjectPtr<AActor>& Actor : SuspendedActors)
+    {
+        if (AActor* Resumed = Actor.Get())
+        {
+            Resumed->SetActorTickEnabled(true);
+        }
+    }
+
+    for (const TWeakObjectPtr<UActorComponent>& Component : SuspendedComponents)
+    {
+        if (UActorComponent* Resumed = Component.Get())
+        {
+            Resumed->SetComponentTickEnabled(true);
+        }
+    }
+
+    SuspendedActors.Reset();
+    SuspendedComponents.Reset();
+}
+
+// ========================================================
+// Participants
+// ========================================================
+
+template<typename T>
+bool USTSimulationClock::AddParticipant(TArray<T*>& List, T* Item)
+{
+    if (!Item || Item->SimIndex != INDEX_NONE)
+    {
+        return false;
+    }
+
+    // Rewind restores set the id before BeginPlay; keep it
+    if (Item->SimId == INDEX_NONE)
+    {
+        Item->SimId = AllocateSimId();
+    }
+
+    Item->SimIndex = List.Add(Item);
+
+    // Spawned / restored while paused: join the pause
+    if (bTicksSuspended)
+    {
+        SuspendActorTicks(Item);
+    }
+
+    return true;
+}
+
+template<typename T>
+bool USTSimulationClock::RemoveParticipant(TArray<T*>& List, T* Item)
+{
+    if (!Item || !List.IsValidIndex(Item->SimIndex) || List[Item->SimIndex] != Item)
+    {
+        return false;
+    }
+
+    // Null the slot instead of shifting: a step may be iterating this list
+    List[Item->SimIndex] = nullptr;
+    Item->SimIndex = INDEX_NONE;
+    bNeedsCompaction = true;
+
+    return true;
+}
+
+void USTSimulationClock::CompactParticipants(bool bSortBySimId)
+{
+    // Order-preserving so the step order stays deterministic
+    auto CompactList = [bSortBySimId](auto& List)
+        {
+            int32 WriteIndex = 0;
+            for (int32 ReadIndex = 0; ReadIndex < List.Num(); ++ReadIndex)
+            {
+                if (auto* Item = List[ReadIndex])
+                {
+                    List[WriteIndex++] = Item;
+                }
+            }
+            List.SetNum(WriteIndex, EAllowShrinking::No);
+
+            if (bSortBySimId)
+            {
+                Algo::StableSortBy(List, [](const auto* Item) { return Item->SimId; });
+            }
+
+            for (int32 Index = 0; Index < List.Num(); ++Index)
+            {
+                List[Index]->SimIndex = Index;
+            }
+        };
+
+    CompactList(Spawners);
+    CompactList(Enemies);
+    CompactList(Towers);
+
+    bNeedsCompaction = false;
+}
+
+void USTSimulationClock::RegisterSpawner(ASTSpawner* Spawner)
+{
+    AddParticipant(Spawners, Spawner);
+}
+
+void USTSimulationClock::UnregisterSpawner(ASTSpawner* Spawner)
+{
+    RemoveParticipant(Spawners, Spawner);
+}
+
+void USTSimulationClock::RegisterEnemy(ASTEnemyBase* Enemy)
+{
+    if (AddParticipant(Enemies, Enemy))
+    {
+        ++NumEnemiesRegistered;
+    }
+}
+
+void USTSimulationClock::UnregisterEnemy(ASTEnemyBase* Enemy)
+{
+    if (RemoveParticipant(Enemies, Enemy))
+    {
+        --NumEnemiesRegistered;
+    }
+}
+
+void USTSimulationClock::RegisterTower(ATowerBase* Tower)
+{
+    if (AddParticipant(Towers, Tower))
+    {
+        UpdateTowerAwake(Tower);
+    }
+}
+
+void USTSimulationClock::UnregisterTower(ATowerBase* Tower)
+{
+    if (RemoveParticipant(Towers, Tower) && Tower->bCountedAwake)
+    {
+        Tower->bCountedAwake = false;
+        --NumTowersAwake;
+    }
+}
+
+void USTSimulationClock::UpdateTowerAwake(ATowerBase* Tower)
+{
+    // Unregistered towers are not counted
+    if (!Tower || Tower->SimIndex == INDEX_NONE)
+    {
+        return;
+    }
+
+    const bool bAwake = Tower->IsAwake();
+    if (bAwake != Tower->bCountedAwake)
+    {
+        Tower->bCountedAwake = bAwake;
+        NumTowersAwake += bAwake ? 1 : -1;
+    }
+}
+
+void USTSimulationClock::RecountAwakeTowers()
+{
+    NumTowersAwake = 0;
+    for (ATowerBase* Tower : Towers)
+    {
+        if (Tower)
+        {
+            Tower->bCountedAwake = Tower->IsAwake();
+            NumTowersAwake += Tower->bCountedAwake ? 1 : 0;
+        }
+    }
+}
+
+// ========================================================
+// Console
+// ========================================================
+
+#if !UE_BUILD_SHIPPING
+
+static FAutoConsoleCommandWithWorld GSTSimRateCommand(
+    TEXT("ActionTD.SimRate"),
+    TEXT("Log game-seconds simulated per wall-clock second at the current speed (a line is also logged on every speed change)."),
+    FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+        {
+            const USTSimulationClock* Clock = USTSimulationClock::Get(World);
+            if (!Clock)
+            {
+                return;
+            }
+
+            UE_LOG(LogTemp, Log,
+                TEXT("SimRate: speed %g | %.1f game-s per real-s | %d substeps this frame | fast-forward %s | %.2f game-s dropped so far"),
+                Clock->GetGameSpeed(),
+                Clock->GetSimRate(),
+                Clock->GetNumSubstepsThisFrame(),
+                Clock->IsFastForwarding() ? TEXT("on") : TEXT("off"),
+                Clock->GetDroppedGameSeconds());
+        }));
+
+static FAutoConsoleCommandWithWorld GSTPauseTicksCommand(
+    TEXT("ActionTD.PauseTicks"),
+    TEXT("Count simulation actors / components that still tick. While paused this should be 0."),
+    FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+        {
+            const USTSimulationClock* Clock = USTSimulationClock::Get(World);
+            if (!Clock)
+            {
+                return;
+            }
+
+            int32 NumActors = 0;
+            int32 NumTicking = 0;
+            auto CountTicking = [&NumActors, &NumTicking](const AActor* Actor)
+                {
+                    if (!Actor)
+                    {
+                        return;
+                    }
+
+                    ++NumActors;
+                    NumTicking += Actor->IsActorTickEnabled() ? 1 : 0;
+                    for (const UActorComponent* Component : Actor->GetComponents())
+                    {
+                        NumTicking += (Component && Component->IsComponentTickEnabled()) ? 1 : 0;
+                    }
+                };
+
+            for (const ASTSpawner* Spawner : Clock->GetSpawners())
+            {
+                CountTicking(Spawner);
+            }
+            for (const ASTEnemyBase* Enemy : Clock->GetEnemies())
+            {
+                CountTicking(Enemy);
+            }
+            for (const ATowerBase* Tower : Clock->GetTowers())
+            {
+                CountTicking(Tower);
+            }
+            if (const USTProjectilePoolSubsystem* Pool = World->GetSubsystem<USTProjectilePoolSubsystem>())
+            {
+                for (const AProjectile* Projectile : Pool->GetActiveProjectiles())
+                {
+                    CountTicking(Projectile);
+                }
+            }
+
+            UE_LOG(LogTemp, Log,
+                TEXT("PauseTicks: %s | %d simulation actors | %d tick functions enabled | %d suspended by the pause"),
+                Clock->IsPaused() ? TEXT("paused") : TEXT("running"),
+                NumActors, NumTicking, Clock->GetNumSuspendedTicks());
+        }));
+
+#endif // !UE_BUILD_SHIPPING
@@ -0,0 +1,339 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "STEnemyGrid.h"
+#include "STSimulationClock.generated.h"
+
+class ASTSpawner;
+class ASTEnemyBase;
+class ATowerBase;
+class USTProjectilePoolSubsystem;
+class USTGameEventScheduler;
+class USTRewindHistory;
+
+/** From step FromStep + 1 on, the simulation ran at Speed (seek replays read this). */
+struct FSTSpeedLogEntry
+{
+    uint64 FromStep = 0;
+    float Speed = 1.f;
+};
+
+/** Start of a clock frame, before the game speed is latched (FrameNumber already advanced). */
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnSimFrameStart, uint64 /*FrameNumber*/);
+
+/**
+ * Authoritative simulation time for one world: latches game speed once per frame
+ * and steps every participant in fixed substeps of FixedStepSeconds.
+ */
+UCLASS()
+class ACTIONTOWERDEFENSE_API USTSimulationClock : public UWorldSubsystem
+{
+    GENERATED_BODY()
+
+public:
+    virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+    virtual void Deinitialize() override;
+
+    /** Convenience helper so other classes can find the clock. */
+    static USTSimulationClock* Get(const UObject* WorldContextObject);
+
+    /** Speeds above this run in fast-forward (budgeted substeps, decimated rendering). */
+    static constexpr float FastForwardSpeed = 5.f;
+
+    /** Game speed meaning "as many substeps as the frame budget allows". */
+    static constexpr float UnlimitedSpeed = 1000.f;
+
+    /** Called by ASTGameController whenever CurrentSpeed changes; takes effect next frame. */
+    void SetGameSpeed(float NewSpeed) { PendingGameSpeed = NewSpeed; }
+
+    /** Speed most recently pushed by the controller (what the next frame will latch). */
+    FORCEINLINE float GetPendingGameSpeed() const { return PendingGameSpeed; }
+
+    // --- Per-frame values (latched at frame start) ---
+
+    /** Game speed for this frame (-3, 0, 1, 3, 5, ...). */
+    FORCEINLINE float GetGameSpeed() const { return GameSpeed; }
+
+    /** Game speed clamped to be non-negative. */
+    FORCEINLINE float GetPositiveSpeed() const { return GameSpeed > 0.f ? GameSpeed : 0.f; }
+
+    /** Unscaled frame delta. */
+    FORCEINLINE float GetRealDeltaSeconds() const { return RealDeltaSeconds; }
+
+    /** Frame delta scaled by game speed (negative while rewinding, 0 while paused). */
+    FORCEINLINE float GetScaledDeltaSeconds() const { return ScaledDeltaSeconds; }
+
+    /** Accumulated game time since the world started (advanced in whole substeps). */
+    FORCEINLINE double GetGameTime() const { return GameTime; }
+
+    FORCEINLINE bool IsPaused() const { return bIsPaused; }
+    FORCEINLINE bool IsReversing() const { return bIsReversing; }
+
+    /** Above FastForwardSpeed this frame. */
+    FORCEINLINE bool IsFastForwarding() const { return bIsFastForward; }
+
+    /** False on fast-forward frames that are not drawn: skip presentation work. */
+    FORCEINLINE bool IsPresentationFrame() const { return bPresentThisFrame; }
+
+    /** Cosmetic-only work (Blueprint FX events) is skipped in fast-forward and seek replays. */
+    FORCEINLINE bool ShouldRunCosmetics() const { return !bIsFastForward && !bIsReplaying; }
+
+    /** Game-seconds simulated per wall-clock second since the speed last changed. */
+    double GetSimRate() const;
+
+    /** True while participant ticks are switched off for a pause. */
+    FORCEINLINE bool AreParticipantTicksSuspended() const { return bTicksSuspended; }
+
+    /** Actor / component ticks currently switched off by the pause. */
+    FORCEINLINE int32 GetNumSuspendedTicks() const { return SuspendedActors.Num() + SuspendedComponents.Num(); }
+
+    /** Number of frames the clock has advanced. */
+    FORCEINLINE uint64 GetFrameNumber() const { return FrameNumber; }
+
+    // --- Fixed-step simulation ---
+
+    /** Game-seconds per substep. */
+    FORCEINLINE float GetFixedStepSeconds() const { return FixedStepSeconds; }
+
+    /** Substeps run this frame. */
+    FORCEINLINE int32 GetNumSubstepsThisFrame() const { return NumSubstepsThisFrame; }
+
+    /** Substep index of the current simulation state (goes back down while rewinding). */
+    FORCEINLINE uint64 GetSimStepNumber() const { return SimStepNumber; }
+
+    /** 0..1 blend from the previous substep state to the current one, for rendering. */
+    FORCEINLINE float GetInterpAlpha() const { return InterpAlpha; }
+
+    /** Game-seconds dropped so far because the per-frame substep cap was hit. */
+    FORCEINLINE double GetDroppedGameSeconds() const { return DroppedGameSeconds; }
+
+    /**
+     * Run exactly NumSubsteps this frame (no cap, no fast-forward budget). Match
+     * replays call it from OnFrameStart with the count the recorded frame ran.
+     */
+    void ForceSubstepsThisFrame(int32 NumSubsteps) { ForcedSubsteps = FMath::Max(0, NumSubsteps); }
+
+    /** Fired at the start of every frame, before the speed is latched and any substep runs. */
+    FOnSimFrameStart OnFrameStart;
+
+    /** Change the substep size (game-seconds). Clears the accumulator. */
+    void SetFixedStepSeconds(float InStepSeconds);
+
+    /** Upper bound on substeps per frame before the simulation starts falling behind. */
+    void SetMaxSubstepsPerFrame(int32 InMaxSubsteps) { MaxSubstepsPerFrame = FMath::Max(1, InMaxSubsteps); }
+
+    /** Fast-forward: wall-clock seconds per frame the substeps may take. */
+    void SetFastForwardBudgetSeconds(float InSeconds) { FastForwardBudgetSeconds = FMath::Max(InSeconds, 0.001f); }
+
+    /** Fast-forward: draw one frame in this many. */
+    void SetFastForwardRenderInterval(int32 InInterval) { FastForwardRenderInterval = FMath::Max(1, InInterval); }
+
+    // --- Timeline seeking ---
+
+    /**
+     * Jump to an already simulated step (<= the current one): restore the nearest
+     * earlier match keyframe and re-simulate forward to TargetStep as fast as
+     * possible. Nothing is presented until the target is reached. Every replayed
+     * step is checked against the match recording's checksum for it, if one runs
+     * (USTRewindHistory::GetSeekDivergedStep).
+     * Returns false if no keyframe covers TargetStep.
+     */
+    bool SeekToStep(uint64 TargetStep);
+
+    /** True while SeekToStep is re-simulating (gameplay should skip player-facing side effects). */
+    FORCEINLINE bool IsReplaying() const { return bIsReplaying; }
+
+    /** Speed the given step ran at (1 if it was never simulated). */
+    float GetSpeedForStep(uint64 Step) const;
+
+    // --- Participants (register in BeginPlay, unregister in EndPlay) ---
+
+    void RegisterSpawner(ASTSpawner* Spawner);
+    void UnregisterSpawner(ASTSpawner* Spawner);
+
+    void RegisterEnemy(ASTEnemyBase* Enemy);
+    void UnregisterEnemy(ASTEnemyBase* Enemy);
+
+    void RegisterTower(ATowerBase* Tower);
+    void UnregisterTower(ATowerBase* Tower);
+
+    /** Something IsAwake reads changed on Tower: keep the awake-tower count in step. */
+    void UpdateTowerAwake(ATowerBase* Tower);
+
+    /** Live participants in simulation order (may contain nulls mid-step). */
+    FORCEINLINE const TArray<ASTSpawner*>& GetSpawners() const { return Spawners; }
+    FORCEINLINE const TArray<ASTEnemyBase*>& GetEnemies() const { return Enemies; }
+    FORCEINLINE const TArray<ATowerBase*>& GetTowers() const { return Towers; }
+
+    /**
+     * Append the enemies whose bounds the sphere (Center, Range) touches, in step
+     * order. The grid behind it is built on the first query of each substep.
+     * Returns the number of enemies tested.
+     */
+    int32 QueryEnemiesInReach(const FVector& Center, float Range, TArray<AActor*>& OutEnemies);
+
+    /**
+     * First enemy a sphere of Radius swept from Start to End touches (closest to
+     * Start; ties go to step order), or null. Uses the same grid.
+     */
+    ASTEnemyBase* FindFirstEnemyAlongSegment(const FVector& Start, const FVector& End, float Radius);
+
+    /** Next stable simulation id (participants get one on first registration). */
+    FORCEINLINE int32 AllocateSimId() { return NextSimId++; }
+
+    /** Id counter, saved and restored with snapshots so replays allocate the same ids. */
+    FORCEINLINE int32 GetNextSimId() const { return NextSimId; }
+    void SetNextSimId(int32 InNextSimId) { NextSimId = InNextSimId; }
+
+protected:
+    virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+    virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+
+    void HandleWorldTickStart(UWorld* InWorld, ELevelTick TickType, float DeltaSeconds);
+
+    /** Advance every participant by one substep (StepSeconds is negative while rewinding). */
+    void RunSubstep(float StepSeconds);
+
+    /** Step back to the previous recorded snapshot. */
+    void RunReverseSubstep(float StepSeconds);
+
+    /** Skip or restore world rendering for this frame (fast-forward decimation). */
+    void UpdateRenderDecimation(UWorld* InWorld);
+
+    /** Publish the live counts to "stat ActionTD" and the CSV profiler (no-op without either). */
+    void UpdateFrameStats() const;
+
+    /** Close the sim-rate measurement for the previous speed and start a new one. */
+    void RestartSimRateMeasurement();
+
+    /** Remember the speed latched this frame (drops entries of an abandoned future). */
+    void LogGameSpeed();
+
+    /**
+     * Switch off the actor and component ticks of every participant and projectile in
+     * flight, remembering which were on. Safe to call again to catch late arrivals.
+     */
+    void SuspendParticipantTicks();
+    void SuspendActorTicks(AActor* Actor);
+
+    /** Switch back on exactly what SuspendParticipantTicks switched off. */
+    void ResumeParticipantTicks();
+
+    /**
+     * Drop slots nulled by Unregister* during a step and re-index the survivors.
+     * bSortBySimId also puts participants re-registered by a rewind back in spawn order.
+     */
+    void CompactParticipants(bool bSortBySimId = false);
+
+    /** False if Item was already registered (or null). */
+    template<typename T>
+    bool AddParticipant(TArray<T*>& List, T* Item);
+
+    /** False if Item was not registered. */
+    template<typename T>
+    bool RemoveParticipant(TArray<T*>& List, T* Item);
+
+    /** Restores set tower state directly: count the awake towers again. */
+    void RecountAwakeTowers();
+
+    FDelegateHandle TickStartHandle;
+
+    /** Last speed pushed by the game controller. Defaults to 1 (menus / no controller). */
+    float PendingGameSpeed = 1.f;
+
+    float GameSpeed = 1.f;
+    float RealDeltaSeconds = 0.f;
+    float ScaledDeltaSeconds = 0.f;
+    double GameTime = 0.0;
+    bool bIsPaused = false;
+    bool bIsReversing = false;
+    uint64 FrameNumber = 0;
+
+    /** 60 Hz in game time: 1x runs ~1 substep per frame, 5x ~5. */
+    float FixedStepSeconds = 1.f / 60.f;
+
+    /** 5x at 20 fps needs 15; beyond this we degrade instead of stalling the frame. */
+    int32 MaxSubstepsPerFrame = 16;
+
+    bool bIsFastForward = false;
+    bool bPresentThisFrame = true;
+
+    /** Fast-forward substeps stop once this much wall-clock time was spent in a frame. */
+    float FastForwardBudgetSeconds = 0.012f;
+
+    /** Fast-forward draws every Nth frame; the rest of the frame time goes into substeps. */
+    int32 FastForwardRenderInterval = 4;
+
+    /** Set while we are the ones disabling world rendering on the game viewport. */
+    bool bWorldRenderingSkipped = false;
+
+    /** Sim-rate measurement for the current speed. */
+    float SimRateSpeed = 1.f;
+    double SimRateStartWallSeconds = 0.0;
+    double SimRateGameSeconds = 0.0;
+    uint64 SimRateFrames = 0;
+    uint64 SimRateSubsteps = 0;
+
+    /** Unsimulated game time carried into the next frame (always >= 0). */
+    float Accumulator = 0.f;
+
+    /** Direction of the accumulated time (+1 forward, -1 rewinding). */
+    float AccumulatorSign = 1.f;
+
+    int32 NumSubstepsThisFrame = 0;
+
+    /** Substeps this frame must run (ForceSubstepsThisFrame), or INDEX_NONE. */
+    int32 ForcedSubsteps = INDEX_NONE;
+
+    uint64 SimStepNumber = 0;
+    float InterpAlpha = 1.f;
+    double DroppedGameSeconds = 0.0;
+
+    UPROPERTY(Transient)
+    USTProjectilePoolSubsystem* ProjectilePool = nullptr;
+
+    UPROPERTY(Transient)
+    USTGameEventScheduler* EventScheduler = nullptr;
+
+    /** Records every forward substep and plays it back while rewinding. */
+    UPROPERTY(Transient)
+    USTRewindHistory* RewindHistory = nullptr;
+
+    int32 NextSimId = 0;
+
+    UPROPERTY(Transient)
+    TArray<ASTSpawner*> Spawners;
+
+    UPROPERTY(Transient)
+    TArray<ASTEnemyBase*> Enemies;
+
+    UPROPERTY(Transient)
+    TArray<ATowerBase*> Towers;
+
+    /** Enemy locations bucketed for range queries; stale once the next substep starts. */
+    FSTEnemyGrid EnemyGrid;
+    bool bEnemyGridValid = false;
+    TArray<int32> EnemyQueryScratch;
+
+    /** Set when a participant unregistered and left a null slot behind. */
+    bool bNeedsCompaction = false;
+
+    /** Live counts for UpdateFrameStats, kept by (un)registration and tower wake/sleep. */
+    int32 NumEnemiesRegistered = 0;
+    int32 NumTowersAwake = 0;
+
+    /** Set from the first paused frame until play resumes. */
+    bool bTicksSuspended = false;
+
+    /** Ticks we switched off (weak: actors may die or return to a pool while paused). */
+    TArray<TWeakObjectPtr<AActor>> SuspendedActors;
+    TArray<TWeakObjectPtr<UActorComponent>> SuspendedComponents;
+
+    /** Forward speed changes by step, oldest first. */
+    TArray<FSTSpeedLogEntry> SpeedLog;
+
+    bool bIsReplaying = false;
+};
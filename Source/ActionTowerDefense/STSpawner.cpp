@@ -4,19 +4,39 @@
 #include "STSpawner.h"
 #include "Engine/World.h"
 #include "Kismet/KismetMathLibrary.h"
-#include "STGameSpeedHelpers.h"
+#include "STSimulationClock.h"
+#include "STWorldRegistry.h"
 #include "EnemyBase.h"
+#include "STTrace.h"
+#include "STStatGroup.h"
+#include "STMemoryTags.h"
 
 
 ASTSpawner::ASTSpawner()
 {
-    PrimaryActorTick.bCanEverTick = true;
+    // Driven by USTSimulationClock substeps, not by actor tick
+    PrimaryActorTick.bCanEverTick = false;
 }
 
 void ASTSpawner::BeginPlay()
 {
     Super::BeginPlay();
 
+    // Before scheduling the first wave, so a controller that is waiting for us
+    // binds in time for OnNextWaveScheduled
+    if (USTWorldRegistrySubsystem* Registry = USTWorldRegistrySubsystem::Get(this))
+    {
+        Registry->RegisterSpawner(this); // also registers Path
+    }
+
+    SimClock = USTSimulationClock::Get(this);
+    if (SimClock)
+    {
+        SimClock->RegisterSpawner(this);
+    }
+
+    RandomStream.Initialize(RandomSeed);
+
     if (bStartOnBeginPlay && WaveSet && WaveSet->Waves.Num() > 0)
     {
         const float FirstDelay = WaveSet->Waves[0].TimeBeforeWave;
@@ -24,26 +44,37 @@ void ASTSpawner::BeginPlay()
     }
 }
 
-void ASTSpawner::Tick(float DeltaTime)
+void ASTSpawner::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+    if (SimClock)
+    {
+        SimClock->UnregisterSpawner(this);
+    }
+
+    if (USTWorldRegistrySubsystem* Registry = USTWorldRegistrySubsystem::Get(this))
+    {
+        Registry->UnregisterSpawner(this);
+    }
+
+    Super::EndPlay(EndPlayReason);
+}
+
+void ASTSpawner::SimStep(float StepSeconds)
 {
-    Super::Tick(DeltaTime);
+    ST_TRACE_CPUSCOPE(ActionTD_Spawner_SimStep);
 
     if (!WaveSet)
     {
         return;
     }
 
-    // Read global speed from GameController
-    // Read global speed from GameState
-    const float Speed = FSTGameSpeedHelpers::GetGameSpeed(this);
-    const float PositiveSpeed = FSTGameSpeedHelpers::GetPositiveSpeed(this);
-
     // --- PHASE 1: waiting for next wave to start ---
     if (!bWaveRunning)
     {
-        if (TimeUntilNextWave > 0.f && PositiveSpeed > 0.f)
+        // Countdown only runs forward
+        if (TimeUntilNextWave > 0.f && StepSeconds > 0.f)
         {
-            TimeUntilNextWave = FMath::Max(0.f, TimeUntilNextWave - DeltaTime * PositiveSpeed);
+            TimeUntilNextWave = FMath::Max(0.f, TimeUntilNextWave - StepSeconds);
 
             if (TimeUntilNextWave <= 0.f)
             {
@@ -63,46 +94,40 @@ void ASTSpawner::Tick(float DeltaTime)
         return;
     }
 
-    // No new spawns while rewinding or paused
-    if (Speed <= 0.f)
+    // No new spawns while rewinding
+    if (StepSeconds <= 0.f)
     {
         return;
     }
 
-    const float EffectiveDelta = DeltaTime * Speed;
-
     const FSTWave& Wave = WaveSet->Waves[CurrentWaveIndex];
 
-    WaveClock += EffectiveDelta;
+    WaveClock += StepSeconds;
+
+    int32 NumSpawnedThisStep = 0;
 
     // For each lane, check whether we should spawn more enemies
     for (int32 LaneIndex = 0; LaneIndex < Wave.Lanes.Num(); ++LaneIndex)
     {
         const FSTSpawnLane& Lane = Wave.Lanes[LaneIndex];
+        const STCore::FLaneSpec LaneSpec = Lane.ToCore();
         FSTLaneRuntimeState& State = LaneStates[LaneIndex];
 
-        if (State.SpawnsDone >= Lane.NumToSpawn)
-        {
-            continue;
-        }
-
-        while (State.SpawnsDone < Lane.NumToSpawn &&
-            WaveClock >= State.NextSpawnTime)
+        // Each due spawn also draws the jitter for the one after it
+        while (STCore::ConsumeLaneSpawn(LaneSpec, State, WaveClock, RandomStream))
         {
             SpawnEnemy(Lane, LaneIndex);
-            State.SpawnsDone++;
-
-            const float RandomJitter =
-                (Lane.Jitter != 0.0f)
-                ? FMath::FRandRange(-Lane.Jitter, Lane.Jitter)
-                : 0.0f;
-
-            const float Step = FMath::Max(Lane.Interval + RandomJitter, 0.01f);
-            const float Base = FMath::Max(WaveClock, State.NextSpawnTime);
-            State.NextSpawnTime = Base + Step;
+            ST_STAT_SPAWN();
+            ST_FLIGHT_EVENT(Spawn, CurrentWaveIndex, LaneIndex);
+            ++NumSpawnedThisStep;
         }
     }
 
+    if (NumSpawnedThisStep > 0)
+    {
+        ST_TRACE_SPAWN_BURST(CurrentWaveIndex, NumSpawnedThisStep);
+    }
+
     if (IsCurrentWaveFinished())
     {
         bWaveRunning = false;
@@ -145,11 +170,7 @@ void ASTSpawner::StartWave(int32 WaveIndex)
     // Initialize lane runtime state
     for (int32 LaneIndex = 0; LaneIndex < Wave.Lanes.Num(); ++LaneIndex)
     {
-        const FSTSpawnLane& Lane = Wave.Lanes[LaneIndex];
-        FSTLaneRuntimeState& State = LaneStates[LaneIndex];
-
-        State.SpawnsDone = 0;
-        State.NextSpawnTime = Lane.FirstSpawnDelay;
+        STCore::StartLane(Wave.Lanes[LaneIndex].ToCore(), LaneStates[LaneIndex]);
     }
 
     if (bLogSpawns)
@@ -159,6 +180,9 @@ void ASTSpawner::StartWave(int32 WaveIndex)
             *Wave.WaveName.ToString());
     }
 
+    ST_TRACE_WAVE_START(CurrentWaveIndex, WaveSet->Waves.Num());
+    ST_FLIGHT_EVENT(WaveStart, CurrentWaveIndex, WaveSet->Waves.Num());
+
     // Tell the outside world a new wave started
     OnWaveStarted.Broadcast(CurrentWaveIndex, WaveSet->Waves.Num());
 }
@@ -189,10 +213,7 @@ bool ASTSpawner::IsCurrentWaveFinished() const
 
     for (int32 LaneIndex = 0; LaneIndex < Wave.Lanes.Num(); ++LaneIndex)
     {
-        const FSTSpawnLane& Lane = Wave.Lanes[LaneIndex];
-        const FSTLaneRuntimeState& State = LaneStates[LaneIndex];
-
-        if (State.SpawnsDone < Lane.NumToSpawn)
+        if (!STCore::IsLaneFinished(Wave.Lanes[LaneIndex].ToCore(), LaneStates[LaneIndex]))
         {
             return false;
         }
@@ -203,6 +224,8 @@ bool ASTSpawner::IsCurrentWaveFinished() const
 
 AActor* ASTSpawner::SpawnEnemy_Implementation(const FSTSpawnLane& Lane, int32 LaneIndex)
 {
+    ST_LLM_SCOPE(Enemies);
+
     if (!GetWorld())
     {
         return nullptr;
@@ -233,9 +256,6 @@ AActor* ASTSpawner::SpawnEnemy_Implementation(const FSTSpawnLane& Lane, int32 La
     {
         if (ASTEnemyBase* Enemy = Cast<ASTEnemyBase>(Spawned))
         {
-            UE_LOG(LogTemp, Warning, TEXT("Spawner: Spawned %s as ASTEnemyBase"),
-                *Enemy->GetName());
-
             if (Path)
             {
                 Enemy->SetSplineActor(Path);
@@ -245,7 +265,7 @@ AActor* ASTSpawner::SpawnEnemy_Implementation(const FSTSpawnLane& Lane, int32 La
                 UE_LOG(LogTemp, Warning, TEXT("Spawner: Path is NULL!"));
             }
         }
-        else
+        else if (bLogSpawns)
         {
             UE_LOG(LogTemp, Warning, TEXT("Spawner: Spawned %s is NOT ASTEnemyBase"),
                 *Spawned->GetName());
@@ -288,7 +308,7 @@ void ASTSpawner::ScheduleNextWave(float DelaySeconds)
         return;
     }
 
-    // Store delay – Tick will count this down with game speed
+    // Store delay - SimStep counts this down in game time
     TimeUntilNextWave = DelaySeconds;
 
     if (bLogSpawns)
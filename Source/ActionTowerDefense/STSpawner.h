@@ -11,18 +11,13 @@
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnWaveStarted, int32, WaveIndex, int32, TotalWaves);
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnNextWaveScheduled, float, TimeUntilNextWave);
 
+class USTSimulationClock;
+
 // NEW: fired whenever an enemy is spawned
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnEnemySpawned, AActor*, EnemyActor);
 
 // Internal runtime state per lane (not exposed to Blueprint)
-USTRUCT()
-struct FSTLaneRuntimeState
-{
-    GENERATED_BODY()
-
-    int32 SpawnsDone = 0;
-    float NextSpawnTime = 0.0f;
-};
+using FSTLaneRuntimeState = STCore::FLaneState;
 
 UCLASS()
 class ACTIONTOWERDEFENSE_API ASTSpawner : public AActor
@@ -63,8 +58,12 @@ public:
 
     UFUNCTION(BlueprintCallable, Category = "Spawner|State")
     bool HasMoreWaves() const;
+
+    UFUNCTION(BlueprintCallable, Category = "Spawner|State")
+    int32 GetCurrentWaveIndex() const { return CurrentWaveIndex; }
     
-    virtual void Tick(float DeltaTime) override;
+    /** Advance wave countdown / spawn timing by one fixed simulation substep. */
+    void SimStep(float StepSeconds);
 
     /** Path actor (e.g. BP_Path) that owns a spline used by enemies. */
     UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Spawner|Config")
@@ -72,6 +71,7 @@ public:
 
 protected:
     virtual void BeginPlay() override;
+    virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
     
     // Timer used to delay the start of the next wave
     FTimerHandle NextWaveTimerHandle;
@@ -100,6 +100,13 @@ protected:
     UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Spawner|Debug")
     bool bLogSpawns = true;
 
+    /** Seed for spawn jitter. Same seed + same inputs = same match (seeking re-simulates). */
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Spawner|Config")
+    int32 RandomSeed = 1337;
+
+    /** Spawn jitter stream (its current seed is part of every rewind snapshot). */
+    FRandomStream RandomStream;
+
     /** Current wave index (0-based) */
     UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Spawner|State")
     int32 CurrentWaveIndex = INDEX_NONE;
@@ -112,14 +119,28 @@ protected:
     UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Spawner|State")
     bool bWaveRunning = false;
 
-    /** Runtime state per lane */
-    UPROPERTY()
+    /** Runtime state per lane (plain data: saved by the rewind history, not reflected) */
     TArray<FSTLaneRuntimeState> LaneStates;
 
     /** How long until the next wave starts (if scheduled). */
     UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Spawner|State")
     float TimeUntilNextWave = 0.0f;
 
+    /** Cached simulation clock (steps us in fixed substeps). */
+    UPROPERTY(Transient)
+    USTSimulationClock* SimClock = nullptr;
+
+    /** Slot in USTSimulationClock's spawner list. */
+    int32 SimIndex = INDEX_NONE;
+
+    /** Stable id for rewind snapshots. */
+    int32 SimId = INDEX_NONE;
+
+    friend class USTSimulationClock;
+    friend class USTRewindHistory;
+    friend class USTMatchRecorder;
+    friend class USTSimulateMatchCommandlet;
+
 protected:
     bool GetNextWaveIndex(int32& OutNextWaveIndex) const;
     
@@ -0,0 +1,78 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "STStatGroup.h"
+
+DEFINE_STAT(STAT_ActionTD_EnemiesAlive);
+DEFINE_STAT(STAT_ActionTD_ProjectilesAlive);
+DEFINE_STAT(STAT_ActionTD_TowersAwake);
+DEFINE_STAT(STAT_ActionTD_SpawnsPerSecond);
+DEFINE_STAT(STAT_ActionTD_KillsPerSecond);
+DEFINE_STAT(STAT_ActionTD_CosmeticLevel);
+DEFINE_STAT(STAT_ActionTD_SmoothedFrameMs);
+
+DEFINE_STAT(STAT_ActionTD_Substeps);
+DEFINE_STAT(STAT_ActionTD_Spawns);
+DEFINE_STAT(STAT_ActionTD_Kills);
+DEFINE_STAT(STAT_ActionTD_TargetAcquisitions);
+DEFINE_STAT(STAT_ActionTD_RangeChecks);
+
+DEFINE_STAT(STAT_ActionTD_ClockFrame);
+DEFINE_STAT(STAT_ActionTD_StepSpawners);
+DEFINE_STAT(STAT_ActionTD_StepEnemies);
+DEFINE_STAT(STAT_ActionTD_StepTowers);
+DEFINE_STAT(STAT_ActionTD_StepProjectiles);
+DEFINE_STAT(STAT_ActionTD_ScheduledEvents);
+DEFINE_STAT(STAT_ActionTD_RewindRecord);
+DEFINE_STAT(STAT_ActionTD_RewindRestore);
+DEFINE_STAT(STAT_ActionTD_Seek);
+DEFINE_STAT(STAT_ActionTD_ProjectilePresentation);
+DEFINE_STAT(STAT_ActionTD_RemovalBatch);
+DEFINE_STAT(STAT_ActionTD_HUDTick);
+
+CSV_DEFINE_CATEGORY_MODULE(ACTIONTOWERDEFENSE_API, ActionTD, true);
+
+#if STATS
+
+namespace STStats
+{
+    // Game thread only
+    static int32 SpawnsInWindow = 0;
+    static int32 KillsInWindow = 0;
+    static double WindowStartSeconds = 0.0;
+
+    void NoteSpawn()
+    {
+        INC_DWORD_STAT(STAT_ActionTD_Spawns);
+        ++SpawnsInWindow;
+    }
+
+    void NoteKill()
+    {
+        INC_DWORD_STAT(STAT_ActionTD_Kills);
+        ++KillsInWindow;
+    }
+
+    void UpdateRates()
+    {
+        const double Now = FPlatformTime::Seconds();
+        const double Elapsed = Now - WindowStartSeconds;
+        if (Elapsed < 1.0)
+        {
+            return;
+        }
+
+        // First call (or a long hitch): start a fresh window
+        if (WindowStartSeconds > 0.0 && Elapsed < 5.0)
+        {
+            SET_FLOAT_STAT(STAT_ActionTD_SpawnsPerSecond, SpawnsInWindow / Elapsed);
+            SET_FLOAT_STAT(STAT_ActionTD_KillsPerSecond, KillsInWindow / Elapsed);
+        }
+
+        SpawnsInWindow = 0;
+        KillsInWindow = 0;
+        WindowStartSeconds = Now;
+    }
+}
+
+#endif // STATS
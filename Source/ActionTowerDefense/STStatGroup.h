@@ -0,0 +1,91 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Stats/Stats.h"
+#include "ProfilingDebugging/CsvProfiler.h"
+#include "STFlightRecorder.h"
+
+// ========================================================
+// "stat ActionTD"
+// ========================================================
+//
+// Live counters and cycle timers for the gameplay simulation. View in game with
+// "stat ActionTD"; "stat startfile" / "stat stopfile" record them with the
+// rest of the stats. Compiled out where STATS is 0 (Shipping).
+//
+// - counts (enemies / projectiles alive, towers awake): set once per frame by USTSimulationClock
+// - per-frame counters (spawns, kills, target acquisitions, range checks, substeps)
+// - spawns / kills per second: wall-clock rates over the last second
+// - cosmetic level and the frame time it follows (USTCosmeticGovernor)
+// - one cycle counter per simulation phase and per gameplay subsystem
+//
+// The same timers and counts go to the CSV profiler under the ActionTD category
+// (see USTPerfCapture for the per-wave captures and the percentile report).
+
+DECLARE_STATS_GROUP(TEXT("ActionTD"), STATGROUP_ActionTD, STATCAT_Advanced);
+
+// --- Counts ---
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Enemies alive"), STAT_ActionTD_EnemiesAlive, STATGROUP_ActionTD, ACTIONTOWERDEFENSE_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Projectiles alive"), STAT_ActionTD_ProjectilesAlive, STATGROUP_ActionTD, ACTIONTOWERDEFENSE_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Towers awake"), STAT_ActionTD_TowersAwake, STATGROUP_ActionTD, ACTIONTOWERDEFENSE_API);
+DECLARE_FLOAT_ACCUMULATOR_STAT_EXTERN(TEXT("Spawns per second"), STAT_ActionTD_SpawnsPerSecond, STATGROUP_ActionTD, ACTIONTOWERDEFENSE_API);
+DECLARE_FLOAT_ACCUMULATOR_STAT_EXTERN(TEXT("Kills per second"), STAT_ActionTD_KillsPerSecond, STATGROUP_ActionTD, ACTIONTOWERDEFENSE_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Cosmetic level"), STAT_ActionTD_CosmeticLevel, STATGROUP_ActionTD, ACTIONTOWERDEFENSE_API);
+DECLARE_FLOAT_ACCUMULATOR_STAT_EXTERN(TEXT("Smoothed frame ms"), STAT_ActionTD_SmoothedFrameMs, STATGROUP_ActionTD, ACTIONTOWERDEFENSE_API);
+
+// --- Per frame ---
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Substeps"), STAT_ActionTD_Substeps, STATGROUP_ActionTD, ACTIONTOWERDEFENSE_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Spawns"), STAT_ActionTD_Spawns, STATGROUP_ActionTD, ACTIONTOWERDEFENSE_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Kills"), STAT_ActionTD_Kills, STATGROUP_ActionTD, ACTIONTOWERDEFENSE_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Target acquisitions"), STAT_ActionTD_TargetAcquisitions, STATGROUP_ActionTD, ACTIONTOWERDEFENSE_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Range checks"), STAT_ActionTD_RangeChecks, STATGROUP_ActionTD, ACTIONTOWERDEFENSE_API);
+
+// --- Cycles ---
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Clock frame"), STAT_ActionTD_ClockFrame, STATGROUP_ActionTD, ACTIONTOWERDEFENSE_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Step spawners"), STAT_ActionTD_StepSpawners, STATGROUP_ActionTD, ACTIONTOWERDEFENSE_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Step enemies"), STAT_ActionTD_StepEnemies, STATGROUP_ActionTD, ACTIONTOWERDEFENSE_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Step towers"), STAT_ActionTD_StepTowers, STATGROUP_ActionTD, ACTIONTOWERDEFENSE_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Step projectiles"), STAT_ActionTD_StepProjectiles, STATGROUP_ActionTD, ACTIONTOWERDEFENSE_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Scheduled events"), STAT_ActionTD_ScheduledEvents, STATGROUP_ActionTD, ACTIONTOWERDEFENSE_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Rewind record"), STAT_ActionTD_RewindRecord, STATGROUP_ActionTD, ACTIONTOWERDEFENSE_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Rewind restore"), STAT_ActionTD_RewindRestore, STATGROUP_ActionTD, ACTIONTOWERDEFENSE_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Seek"), STAT_ActionTD_Seek, STATGROUP_ActionTD, ACTIONTOWERDEFENSE_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Projectile presentation"), STAT_ActionTD_ProjectilePresentation, STATGROUP_ActionTD, ACTIONTOWERDEFENSE_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Removal batch"), STAT_ActionTD_RemovalBatch, STATGROUP_ActionTD, ACTIONTOWERDEFENSE_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("HUD tick"), STAT_ActionTD_HUDTick, STATGROUP_ActionTD, ACTIONTOWERDEFENSE_API);
+
+// --- CSV profiler ---
+CSV_DECLARE_CATEGORY_MODULE_EXTERN(ACTIONTOWERDEFENSE_API, ActionTD);
+
+/**
+ * Time the enclosing scope as STAT_ActionTD_<Name>, as the ActionTD/<Name> CSV column
+ * and as the flight recorder's per-frame ESTFlightPhase::Name total.
+ */
+#define ST_SCOPE_TIMER(Name) \
+    SCOPE_CYCLE_COUNTER(STAT_ActionTD_##Name); \
+    CSV_SCOPED_TIMING_STAT(ActionTD, Name); \
+    ST_FLIGHT_PHASE(Name)
+
+#if STATS
+
+namespace STStats
+{
+    /** Count a spawn / kill for this frame and for the per-second rates. */
+    ACTIONTOWERDEFENSE_API void NoteSpawn();
+    ACTIONTOWERDEFENSE_API void NoteKill();
+
+    /** Publish the per-second rates once a second has passed (called every frame). */
+    ACTIONTOWERDEFENSE_API void UpdateRates();
+}
+
+#define ST_STAT_SPAWN() STStats::NoteSpawn()
+#define ST_STAT_KILL() STStats::NoteKill()
+
+#else
+
+#define ST_STAT_SPAWN()
+#define ST_STAT_KILL()
+
+#endif // STATS
@@ -0,0 +1,79 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "STTargetPrediction.h"
+#include "EnemyBase.h"
+
+namespace
+{
+    // Fixed-point refinement converges in a few steps when the shot is much
+    // faster than the target; more steps only matter for slow projectiles.
+    constexpr int32 InterceptIterations = 4;
+}
+
+FVector FSTTargetPrediction::GetTargetSimLocation(const AActor* Target)
+{
+    if (!Target)
+    {
+        return FVector::ZeroVector;
+    }
+
+    if (const ASTEnemyBase* Enemy = Cast<ASTEnemyBase>(Target))
+    {
+        return Enemy->GetSimLocation();
+    }
+
+    return Target->GetActorLocation();
+}
+
+FVector FSTTargetPrediction::PredictTargetLocation(const AActor* Target, float GameSeconds)
+{
+    if (!Target)
+    {
+        return FVector::ZeroVector;
+    }
+
+    if (const ASTEnemyBase* Enemy = Cast<ASTEnemyBase>(Target))
+    {
+        return Enemy->PredictLocationAfter(GameSeconds);
+    }
+
+    return Target->GetActorLocation();
+}
+
+float FSTTargetPrediction::GetTargetPathSpeed(const AActor* Target)
+{
+    if (const ASTEnemyBase* Enemy = Cast<ASTEnemyBase>(Target))
+    {
+        return Enemy->GetMoveSpeed();
+    }
+
+    return 0.f;
+}
+
+bool FSTTargetPrediction::SolveIntercept(const FVector& Origin,
+    const AActor* Target,
+    float ProjectileSpeed,
+    FVector& OutAimPoint,
+    float& OutTimeToImpact)
+{
+    if (!Target || ProjectileSpeed <= 0.f)
+    {
+        return false;
+    }
+
+    // Start from the current position, then re-aim at where the target
+    // will be when a shot fired at the previous guess would arrive.
+    FVector AimPoint = GetTargetSimLocation(Target);
+    float TimeToImpact = FVector::Dist(Origin, AimPoint) / ProjectileSpeed;
+
+    for (int32 Iteration = 0; Iteration < InterceptIterations; ++Iteration)
+    {
+        AimPoint = PredictTargetLocation(Target, TimeToImpact);
+        TimeToImpact = FVector::Dist(Origin, AimPoint) / ProjectileSpeed;
+    }
+
+    OutAimPoint = AimPoint;
+    OutTimeToImpact = TimeToImpact;
+    return true;
+}
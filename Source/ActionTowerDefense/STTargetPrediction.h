@@ -0,0 +1,34 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class AActor;
+
+/**
+ * Small helper struct for predicting where a target will be.
+ * Enemies follow a known spline at a known speed, so their future position
+ * comes straight from path progress instead of extrapolating velocity.
+ */
+struct FSTTargetPrediction
+{
+    /** Target location as of the latest simulation substep (actor location for non-path actors). */
+    static FVector GetTargetSimLocation(const AActor* Target);
+
+    /** Where Target will be after GameSeconds (current location for non-path actors). */
+    static FVector PredictTargetLocation(const AActor* Target, float GameSeconds);
+
+    /** Target's speed along its path in units per game-second (0 for non-path actors). */
+    static float GetTargetPathSpeed(const AActor* Target);
+
+    /**
+     * Solve for the point where a straight shot from Origin at ProjectileSpeed meets Target.
+     * Returns false if the target cannot be reached (no target / zero speed).
+     */
+    static bool SolveIntercept(const FVector& Origin,
+        const AActor* Target,
+        float ProjectileSpeed,
+        FVector& OutAimPoint,
+        float& OutTimeToImpact);
+};
@@ -0,0 +1,69 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "STTrace.h"
+
+#if ST_TRACE_ENABLED
+
+#include "ProfilingDebugging/MiscTrace.h"
+
+UE_TRACE_CHANNEL_DEFINE(ActionTDChannel)
+
+UE_TRACE_EVENT_BEGIN(ActionTD, WaveStart)
+    UE_TRACE_EVENT_FIELD(uint64, Cycle)
+    UE_TRACE_EVENT_FIELD(int32, WaveIndex)
+    UE_TRACE_EVENT_FIELD(int32, TotalWaves)
+UE_TRACE_EVENT_END()
+
+UE_TRACE_EVENT_BEGIN(ActionTD, SpawnBurst)
+    UE_TRACE_EVENT_FIELD(uint64, Cycle)
+    UE_TRACE_EVENT_FIELD(int32, WaveIndex)
+    UE_TRACE_EVENT_FIELD(int32, NumSpawned)
+UE_TRACE_EVENT_END()
+
+UE_TRACE_EVENT_BEGIN(ActionTD, SpeedChange)
+    UE_TRACE_EVENT_FIELD(uint64, Cycle)
+    UE_TRACE_EVENT_FIELD(float, OldSpeed)
+    UE_TRACE_EVENT_FIELD(float, NewSpeed)
+UE_TRACE_EVENT_END()
+
+void STTrace::WaveStart(int32 WaveIndex, int32 TotalWaves)
+{
+    UE_TRACE_LOG(ActionTD, WaveStart, ActionTDChannel)
+        << WaveStart.Cycle(FPlatformTime::Cycles64())
+        << WaveStart.WaveIndex(WaveIndex)
+        << WaveStart.TotalWaves(TotalWaves);
+
+    if (UE_TRACE_CHANNELEXPR_IS_ENABLED(ActionTDChannel))
+    {
+        TRACE_BOOKMARK(TEXT("ActionTD: wave %d / %d"), WaveIndex + 1, TotalWaves);
+    }
+}
+
+void STTrace::SpawnBurst(int32 WaveIndex, int32 NumSpawned)
+{
+    UE_TRACE_LOG(ActionTD, SpawnBurst, ActionTDChannel)
+        << SpawnBurst.Cycle(FPlatformTime::Cycles64())
+        << SpawnBurst.WaveIndex(WaveIndex)
+        << SpawnBurst.NumSpawned(NumSpawned);
+
+    if (UE_TRACE_CHANNELEXPR_IS_ENABLED(ActionTDChannel))
+    {
+        TRACE_BOOKMARK(TEXT("ActionTD: spawned %d (wave %d)"), NumSpawned, WaveIndex + 1);
+    }
+}
+
+void STTrace::SpeedChange(float OldSpeed, float NewSpeed)
+{
+    UE_TRACE_LOG(ActionTD, SpeedChange, ActionTDChannel)
+        << SpeedChange.Cycle(FPlatformTime::Cycles64())
+        << SpeedChange.OldSpeed(OldSpeed)
+        << SpeedChange.NewSpeed(NewSpeed);
+
+    if (UE_TRACE_CHANNELEXPR_IS_ENABLED(ActionTDChannel))
+    {
+        TRACE_BOOKMARK(TEXT("ActionTD: speed %gx -> %gx"), OldSpeed, NewSpeed);
+    }
+}
+
+#endif // ST_TRACE_ENABLED
@@ -0,0 +1,46 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Trace/Trace.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+
+// ========================================================
+// Unreal Insights instrumentation
+// ========================================================
+//
+// - ActionTD trace channel: capture with -trace=default,ActionTD
+//   (or "Trace.Enable ActionTD" at runtime)
+// - ST_TRACE_CPUSCOPE(Name): named CPU scope on that channel, for the gameplay hot paths
+// - ST_TRACE_WAVE_START / ST_TRACE_SPAWN_BURST / ST_TRACE_SPEED_CHANGE: ActionTD.* trace
+//   events, each also dropped as a bookmark so it shows in the timing view
+//
+// Everything compiles out in Shipping builds (and when trace is disabled).
+
+#define ST_TRACE_ENABLED (UE_TRACE_ENABLED && !UE_BUILD_SHIPPING)
+
+#if ST_TRACE_ENABLED
+
+UE_TRACE_CHANNEL_EXTERN(ActionTDChannel, ACTIONTOWERDEFENSE_API)
+
+namespace STTrace
+{
+    ACTIONTOWERDEFENSE_API void WaveStart(int32 WaveIndex, int32 TotalWaves);
+    ACTIONTOWERDEFENSE_API void SpawnBurst(int32 WaveIndex, int32 NumSpawned);
+    ACTIONTOWERDEFENSE_API void SpeedChange(float OldSpeed, float NewSpeed);
+}
+
+#define ST_TRACE_CPUSCOPE(Name) TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL(Name, ActionTDChannel)
+#define ST_TRACE_WAVE_START(WaveIndex, TotalWaves) STTrace::WaveStart(WaveIndex, TotalWaves)
+#define ST_TRACE_SPAWN_BURST(WaveIndex, NumSpawned) STTrace::SpawnBurst(WaveIndex, NumSpawned)
+#define ST_TRACE_SPEED_CHANGE(OldSpeed, NewSpeed) STTrace::SpeedChange(OldSpeed, NewSpeed)
+
+#else
+
+#define ST_TRACE_CPUSCOPE(Name)
+#define ST_TRACE_WAVE_START(WaveIndex, TotalWaves)
+#define ST_TRACE_SPAWN_BURST(WaveIndex, NumSpawned)
+#define ST_TRACE_SPEED_CHANGE(OldSpeed, NewSpeed)
+
+#endif // ST_TRACE_ENABLED
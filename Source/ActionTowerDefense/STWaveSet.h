@@ -5,6 +5,7 @@
 #include "CoreMinimal.h"
 #include "Engine/DataAsset.h"
 #include "GameFramework/Actor.h"          // Needed for AActor
+#include "STCoreRules.h"
 #include "STWaveSet.generated.h"
 
 /**
@@ -34,6 +35,12 @@ struct FSTSpawnLane
     // Random +/- jitter applied to each interval
     UPROPERTY(EditAnywhere, BlueprintReadWrite)
     float Jitter = 0.0f;
+
+    /** Timing for the core wave timeline. */
+    STCore::FLaneSpec ToCore() const
+    {
+        return STCore::FLaneSpec{ NumToSpawn, FirstSpawnDelay, Interval, Jitter };
+    }
 };
 
 /**
@@ -0,0 +1,169 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "STWorldRegistry.h"
+#include "Engine/World.h"
+#include "Components/SplineComponent.h"
+#include "STGameController.h"
+#include "STGameState.h"
+#include "STSpawner.h"
+#include "TowerBase.h"
+
+void USTWorldRegistrySubsystem::Deinitialize()
+{
+    GameController = nullptr;
+    GameState = nullptr;
+    Spawners.Reset();
+    Towers.Reset();
+    Paths.Reset();
+    OnSpawnerRegistered.Clear();
+
+    Super::Deinitialize();
+}
+
+bool USTWorldRegistrySubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+    return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+USTWorldRegistrySubsystem* USTWorldRegistrySubsystem::Get(const UObject* WorldContextObject)
+{
+    if (!WorldContextObject)
+    {
+        return nullptr;
+    }
+
+    UWorld* World = WorldContextObject->GetWorld();
+    if (!World)
+    {
+        return nullptr;
+    }
+
+    return World->GetSubsystem<USTWorldRegistrySubsystem>();
+}
+
+// ========================================================
+// Game controller / game state
+// ========================================================
+
+void USTWorldRegistrySubsystem::RegisterGameController(ASTGameController* InController)
+{
+    if (GameController && GameController != InController)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("Registry: second game controller %s ignored (using %s)"),
+            *GetNameSafe(InController), *GameController->GetName());
+        return;
+    }
+
+    GameController = InController;
+}
+
+void USTWorldRegistrySubsystem::UnregisterGameController(ASTGameController* InController)
+{
+    if (GameController == InController)
+    {
+        GameController = nullptr;
+    }
+}
+
+void USTWorldRegistrySubsystem::RegisterGameState(ASTGameState* InGameState)
+{
+    GameState = InGameState;
+}
+
+void USTWorldRegistrySubsystem::UnregisterGameState(ASTGameState* InGameState)
+{
+    if (GameState == InGameState)
+    {
+        GameState = nullptr;
+    }
+}
+
+// ========================================================
+// Spawners
+// ========================================================
+
+void USTWorldRegistrySubsystem::RegisterSpawner(ASTSpawner* Spawner)
+{
+    if (!Spawner || Spawners.Contains(Spawner))
+    {
+        return;
+    }
+
+    Spawners.Add(Spawner);
+    RegisterPath(Spawner->Path);
+
+    OnSpawnerRegistered.Broadcast(Spawner);
+}
+
+void USTWorldRegistrySubsystem::UnregisterSpawner(ASTSpawner* Spawner)
+{
+    // Keep registration order (GetPrimarySpawner)
+    Spawners.Remove(Spawner);
+}
+
+// ========================================================
+// Paths
+// ========================================================
+
+const FSTPathInfo* USTWorldRegistrySubsystem::RegisterPath(AActor* PathActor)
+{
+    if (!PathActor)
+    {
+        return nullptr;
+    }
+
+    if (const FSTPathInfo* Existing = Paths.Find(PathActor))
+    {
+        return Existing;
+    }
+
+    USplineComponent* Spline = PathActor->FindComponentByClass<USplineComponent>();
+    if (!Spline)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("Registry: path %s has no USplineComponent"), *PathActor->GetName());
+        return nullptr;
+    }
+
+    FSTPathInfo& Info = Paths.Add(PathActor);
+    Info.Spline = Spline;
+    Info.Length = Spline->GetSplineLength();
+
+    PathActor->OnEndPlay.AddUniqueDynamic(this, &USTWorldRegistrySubsystem::HandlePathEndPlay);
+    return &Info;
+}
+
+void USTWorldRegistrySubsystem::UnregisterPath(AActor* PathActor)
+{
+    if (PathActor && Paths.Remove(PathActor) > 0)
+    {
+        PathActor->OnEndPlay.RemoveDynamic(this, &USTWorldRegistrySubsystem::HandlePathEndPlay);
+    }
+}
+
+const FSTPathInfo* USTWorldRegistrySubsystem::FindPath(const AActor* PathActor) const
+{
+    return PathActor ? Paths.Find(PathActor) : nullptr;
+}
+
+void USTWorldRegistrySubsystem::HandlePathEndPlay(AActor* Actor, EEndPlayReason::Type EndPlayReason)
+{
+    UnregisterPath(Actor);
+}
+
+// ========================================================
+// Towers
+// ========================================================
+
+void USTWorldRegistrySubsystem::RegisterTower(ATowerBase* Tower)
+{
+    if (Tower)
+    {
+        Towers.AddUnique(Tower);
+    }
+}
+
+void USTWorldRegistrySubsystem::UnregisterTower(ATowerBase* Tower)
+{
+    Towers.RemoveSingleSwap(Tower);
+}
@@ -0,0 +1,106 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/ObjectKey.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "STWorldRegistry.generated.h"
+
+class ASTGameController;
+class ASTGameState;
+class ASTSpawner;
+class ATowerBase;
+class USplineComponent;
+
+/** A registered enemy path: its spline, resolved once. */
+struct FSTPathInfo
+{
+    TWeakObjectPtr<USplineComponent> Spline;
+    float Length = 0.f;
+};
+
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnSTSpawnerRegistered, ASTSpawner*);
+
+/**
+ * O(1) lookups for the long-lived actors gameplay code needs to find.
+ *
+ * The game controller, game state, spawners, paths and towers register here in
+ * BeginPlay and leave in EndPlay, so nothing walks the world's actor list
+ * (TActorIterator / GetAllActorsOfClass) while the game runs.
+ *
+ * BeginPlay order between actors is not guaranteed: code that needs a spawner and
+ * finds none yet listens to OnSpawnerRegistered. Paths have no C++ base class, so
+ * whoever first references one (the spawner, an enemy) registers it; it unregisters
+ * itself when the path actor ends play.
+ */
+UCLASS()
+class ACTIONTOWERDEFENSE_API USTWorldRegistrySubsystem : public UWorldSubsystem
+{
+    GENERATED_BODY()
+
+public:
+    virtual void Deinitialize() override;
+
+    /** Convenience helper so other classes can find the registry. */
+    static USTWorldRegistrySubsystem* Get(const UObject* WorldContextObject);
+
+    // --- Game controller / game state ---
+
+    void RegisterGameController(ASTGameController* InController);
+    void UnregisterGameController(ASTGameController* InController);
+    FORCEINLINE ASTGameController* GetGameController() const { return GameController; }
+
+    void RegisterGameState(ASTGameState* InGameState);
+    void UnregisterGameState(ASTGameState* InGameState);
+    FORCEINLINE ASTGameState* GetGameState() const { return GameState; }
+
+    // --- Spawners ---
+
+    void RegisterSpawner(ASTSpawner* Spawner);
+    void UnregisterSpawner(ASTSpawner* Spawner);
+    FORCEINLINE const TArray<ASTSpawner*>& GetSpawners() const { return Spawners; }
+
+    /** The first spawner still registered (the level's main one). */
+    FORCEINLINE ASTSpawner* GetPrimarySpawner() const { return Spawners.Num() > 0 ? Spawners[0] : nullptr; }
+
+    /** Broadcast after a spawner registers (for code that began play before it). */
+    FOnSTSpawnerRegistered OnSpawnerRegistered;
+
+    // --- Paths ---
+
+    /**
+     * Register a path actor (no-op if already registered) and return its cached
+     * spline info. Null if PathActor is null or has no USplineComponent.
+     */
+    const FSTPathInfo* RegisterPath(AActor* PathActor);
+    void UnregisterPath(AActor* PathActor);
+    const FSTPathInfo* FindPath(const AActor* PathActor) const;
+
+    // --- Towers ---
+
+    void RegisterTower(ATowerBase* Tower);
+    void UnregisterTower(ATowerBase* Tower);
+    FORCEINLINE const TArray<ATowerBase*>& GetTowers() const { return Towers; }
+
+protected:
+    virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+    UFUNCTION()
+    void HandlePathEndPlay(AActor* Actor, EEndPlayReason::Type EndPlayReason);
+
+    UPROPERTY(Transient)
+    ASTGameController* GameController = nullptr;
+
+    UPROPERTY(Transient)
+    ASTGameState* GameState = nullptr;
+
+    /** In registration order. */
+    UPROPERTY(Transient)
+    TArray<ASTSpawner*> Spawners;
+
+    UPROPERTY(Transient)
+    TArray<ATowerBase*> Towers;
+
+    TMap<TObjectKey<AActor>, FSTPathInfo> Paths;
+};
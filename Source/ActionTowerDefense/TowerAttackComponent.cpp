@@ -3,6 +3,9 @@
 
 #include "TowerAttackComponent.h"
 #include "GameFramework/Actor.h"
+#include "STTrace.h"
+#include "STStatGroup.h"
+#include "STCoreRules.h"
 
 UTowerAttackComponent::UTowerAttackComponent()
 {
@@ -60,6 +63,54 @@ void UTowerAttackComponent::ClearTargets()
     CurrentTarget = nullptr;
 }
 
+void UTowerAttackComponent::SyncTargetsInRange(TConstArrayView<AActor*> InRange)
+{
+    // Hashed lookups both ways: queue and range can each hold hundreds at high counts
+    SyncScratch.Reset();
+    for (const AActor* Actor : InRange)
+    {
+        SyncScratch.Add(Actor);
+    }
+
+    // Drop whatever left range (or died) since the last query
+    EnemyQueue.RemoveAll(
+        [this](const TWeakObjectPtr<AActor>& Item)
+        {
+            AActor* Actor = Item.Get();
+            return !IsValid(Actor) || !SyncScratch.Contains(Actor);
+        });
+
+    if (CurrentTarget.IsValid() && !SyncScratch.Contains(CurrentTarget.Get()))
+    {
+        CurrentTarget = nullptr;
+    }
+
+    // Newcomers join the back of the FIFO queue
+    SyncScratch.Reset();
+    for (const TWeakObjectPtr<AActor>& Item : EnemyQueue)
+    {
+        SyncScratch.Add(Item.Get());
+    }
+    SyncScratch.Add(CurrentTarget.Get());
+
+    for (AActor* Actor : InRange)
+    {
+        if (!IsValid(Actor) || SyncScratch.Contains(Actor))
+        {
+            continue;
+        }
+
+        EnemyQueue.Add(Actor);
+        SyncScratch.Add(Actor);
+
+        // If we had no target, lock onto this one immediately
+        if (!CurrentTarget.IsValid())
+        {
+            CurrentTarget = Actor;
+        }
+    }
+}
+
 AActor* UTowerAttackComponent::GetCurrentTarget() const
 {
     return CurrentTarget.Get();
@@ -67,6 +118,8 @@ AActor* UTowerAttackComponent::GetCurrentTarget() const
 
 void UTowerAttackComponent::TickAttack(float DeltaSeconds, bool bCanFireNow)
 {
+    ST_TRACE_CPUSCOPE(ActionTD_AttackComponent_TickAttack);
+
     // Clean invalid current target
     if (CurrentTarget.IsValid() && !IsValid(CurrentTarget.Get()))
     {
@@ -85,6 +138,7 @@ void UTowerAttackComponent::TickAttack(float DeltaSeconds, bool bCanFireNow)
     {
         CurrentTarget = EnemyQueue[0];
         EnemyQueue.RemoveAt(0);
+        INC_DWORD_STAT(STAT_ActionTD_TargetAcquisitions);
     }
 
     if (!bCanFireNow)
@@ -97,14 +151,11 @@ void UTowerAttackComponent::TickAttack(float DeltaSeconds, bool bCanFireNow)
         return;
     }
 
-    FireCooldown -= DeltaSeconds;
-    if (FireCooldown > 0.f)
+    if (!STCore::TickCooldown(FireCooldown, FireRate, DeltaSeconds))
     {
         return;
     }
 
     // Tell the tower to actually shoot
     OnTowerReadyToFire.Broadcast();
-
-    FireCooldown = (FireRate > 0.f) ? (1.f / FireRate) : 0.f;
 }
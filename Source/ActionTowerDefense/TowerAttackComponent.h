@@ -45,6 +45,12 @@ public:
     /** Clear all targets (e.g. tower disabled). */
     void ClearTargets();
 
+    /**
+     * Replace the in-range set from a simulation range query.
+     * Targets that left range are dropped; newcomers are queued in the given order.
+     */
+    void SyncTargetsInRange(TConstArrayView<AActor*> InRange);
+
     /** Current target (may be nullptr). */
     AActor* GetCurrentTarget() const;
 
@@ -66,4 +72,9 @@ protected:
 
     /** Internal cooldown timer. */
     float FireCooldown = 0.f;
+
+    /** Reused lookup for SyncTargetsInRange (in-range set, then already-queued set). */
+    TSet<const AActor*> SyncScratch;
+
+    friend class USTRewindHistory;
 };
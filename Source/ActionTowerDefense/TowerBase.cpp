@@ -6,10 +6,19 @@
 #include "Kismet/KismetMathLibrary.h"
 #include "Engine/Engine.h"
 #include "STGameState.h"
-#include "STGameSpeedHelpers.h"
+#include "STSimulationClock.h"
+#include "STWorldRegistry.h"
+#include "STMatchStats.h"
+#include "STTrace.h"
+#include "STMemoryTags.h"
+#include "STFlightRecorder.h"
+#include "STCoreRules.h"
+#include "STMatchRecorder.h"
 
 ATowerBase::ATowerBase()
 {
+    ST_LLM_SCOPE(Towers);
+
     PrimaryActorTick.bCanEverTick = true;
 
     MeshComp = CreateDefaultSubobject<UStaticMeshComponent>(TEXT("MeshComp"));
@@ -50,31 +59,76 @@ void ATowerBase::BeginPlay()
     // Ensure capture HP starts at max
     CaptureHP = CaptureHPMax;
 
+    SimClock = USTSimulationClock::Get(this);
+    if (SimClock)
+    {
+        SimClock->RegisterTower(this);
+    }
+
+    if (USTWorldRegistrySubsystem* Registry = USTWorldRegistrySubsystem::Get(this))
+    {
+        Registry->RegisterTower(this);
+    }
+
+    // After the clock handed out the SimId
+    if (USTMatchStats* Stats = USTMatchStats::Get(this))
+    {
+        Stats->RegisterTower(this);
+    }
+
     UpdateSelectionVisuals(); // ensure visuals match team + selection
 }
 
+void ATowerBase::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+    if (SimClock)
+    {
+        SimClock->UnregisterTower(this);
+    }
+
+    if (USTWorldRegistrySubsystem* Registry = USTWorldRegistrySubsystem::Get(this))
+    {
+        Registry->UnregisterTower(this);
+    }
+
+    Super::EndPlay(EndPlayReason);
+}
+
 void ATowerBase::Tick(float DeltaSeconds)
 {
     Super::Tick(DeltaSeconds);
 
-    // Apply global game speed to capture logic
-    const float Speed = FSTGameSpeedHelpers::GetGameSpeed(this);
-
-    // Rule: no capture progress while rewinding or paused
-    if (Speed <= 0.f)
+    // No clock (should not happen in game worlds): step once per frame
+    if (!SimClock)
     {
-        StopCaptureBeam();   // make sure beam visuals are off
+        SimStep(DeltaSeconds);
         return;
     }
 
-    const float EffectiveDelta = DeltaSeconds * Speed; // 1x / 3x / 5x
+    // Paused frames run no substeps: make sure beam visuals are off
+    if (SimClock->GetScaledDeltaSeconds() <= 0.f)
+    {
+        StopCaptureBeam();
+    }
+}
 
-    TickCapture(EffectiveDelta);
+void ATowerBase::SimStep(float StepSeconds)
+{
+    // Rule: no capture progress while rewinding
+    if (StepSeconds <= 0.f)
+    {
+        StopCaptureBeam();
+        return;
+    }
+
+    TickCapture(StepSeconds);
 }
 
 // Capture neutral tower function
 void ATowerBase::TickCapture(float DeltaSeconds)
 {
+    ST_TRACE_CPUSCOPE(ActionTD_Tower_TickCapture);
+
     if (Team != ETowerTeam::Player)
     {
         StopCaptureBeam();
@@ -91,6 +145,7 @@ void ATowerBase::TickCapture(float DeltaSeconds)
     {
         StopCaptureBeam();
         AssignedCaptureTarget = nullptr;
+        NotifyAwakeChanged();
         return;
     }
 
@@ -123,13 +178,8 @@ bool ATowerBase::IsValidCaptureTarget(ATowerBase* Target) const
 void ATowerBase::SetCaptureTarget(ATowerBase* NewTarget)
 {
     // Optional: only allow targets that are not this tower
-    if (NewTarget == this)
-    {
-        AssignedCaptureTarget = nullptr;
-        return;
-    }
-
-    AssignedCaptureTarget = NewTarget;
+    AssignedCaptureTarget = NewTarget != this ? NewTarget : nullptr;
+    NotifyAwakeChanged();
 }
 
 void ATowerBase::ApplyCaptureDamage(float Amount, ATowerBase* SourceTower)
@@ -145,13 +195,18 @@ void ATowerBase::ApplyCaptureDamage(float Amount, ATowerBase* SourceTower)
         return;
     }
 
-    // Decrease capture HP
-    CaptureHP = FMath::Clamp(CaptureHP - Amount, 0.f, CaptureHPMax);
+    const STCore::FCaptureResult Result = STCore::ApplyCaptureDamage(CaptureHP, CaptureHPMax, Amount);
+
+    // First damage of a capture: start timing it
+    if (Result.bStarted)
+    {
+        CaptureStartGameTime = SimClock ? SimClock->GetGameTime() : 0.0;
+    }
 
     // Notify Blueprint about progress (for UI, etc.)
     BP_OnCaptureProgressChanged(CaptureHP, CaptureHPMax);
 
-    if (CaptureHP <= 0.f)
+    if (Result.bCaptured)
     {
         OnCapturedBy(SourceTower);
     }
@@ -159,11 +214,22 @@ void ATowerBase::ApplyCaptureDamage(float Amount, ATowerBase* SourceTower)
 
 void ATowerBase::OnCapturedBy(ATowerBase* SourceTower)
 {
+    ST_LLM_SCOPE(Towers);
+
     if (!SourceTower)
     {
         return;
     }
 
+    const double Now = SimClock ? SimClock->GetGameTime() : 0.0;
+    const float CaptureSeconds = static_cast<float>(Now - CaptureStartGameTime);
+    ST_FLIGHT_EVENT(Capture, SourceTower->GetSimId(), CaptureSeconds);
+
+    if (USTMatchStats* Stats = USTMatchStats::Get(this))
+    {
+        Stats->RecordCapture(SourceTower, CaptureSeconds);
+    }
+
     const ETowerTeam NewTeam = SourceTower->Team;
 
     Team = NewTeam;
@@ -174,6 +240,7 @@ void ATowerBase::OnCapturedBy(ATowerBase* SourceTower)
     // Stop any capture beam this tower might have been doing
     StopCaptureBeam();
     AssignedCaptureTarget = nullptr;
+    NotifyAwakeChanged();
 
     // If we *don’t* upgrade into a new tower instance,
     // we still want the selection visuals to reflect the new team.
@@ -311,6 +378,13 @@ void ATowerBase::LevelUp()
 
 void ATowerBase::UpgradeTower()
 {
+    ST_LLM_SCOPE(Towers);
+
+    if (!USTMatchRecorder::ShouldRunCommand(this, ESTPlayerCommand::UpgradeTower, this))
+    {
+        return;
+    }
+
     // Only allow upgrading for player-owned towers (generic rule).
     if (Team != ETowerTeam::Player)
     {
@@ -366,11 +440,25 @@ void ATowerBase::SetTeam(ETowerTeam NewTeam)
     }
 
     Team = NewTeam;
+    NotifyAwakeChanged();
 
     // Make sure visuals (selection ring material etc.) stay in sync with team.
     UpdateSelectionVisuals();
 }
 
+bool ATowerBase::IsAwake() const
+{
+    return Team == ETowerTeam::Player && AssignedCaptureTarget != nullptr;
+}
+
+void ATowerBase::NotifyAwakeChanged()
+{
+    if (SimClock)
+    {
+        SimClock->UpdateTowerAwake(this);
+    }
+}
+
 float ATowerBase::GetCaptureProgress01() const
 {
     if (CaptureHPMax <= 0.f)
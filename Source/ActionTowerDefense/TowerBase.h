@@ -8,6 +8,7 @@
 
 class UStaticMeshComponent;
 class UMaterialInterface;
+class USTSimulationClock;
 
 // ------------------ Team enum ------------------
 
@@ -29,8 +30,12 @@ class ACTIONTOWERDEFENSE_API ATowerBase : public AActor
 public:
     ATowerBase();
 
+    /** Presentation only (beam visuals); gameplay runs in SimStep. */
     virtual void Tick(float DeltaSeconds) override;
 
+    /** Advance capture (and attack, in subclasses) by one fixed simulation substep. */
+    virtual void SimStep(float StepSeconds);
+
     // --- Selection API ---
     void SetSelected(bool bNewSelected);
 
@@ -51,8 +56,14 @@ public:
     UFUNCTION(BlueprintPure, Category = "Tower|Capture")
     float GetCaptureProgress01() const;
 
+    FORCEINLINE int32 GetSimId() const { return SimId; }
+
+    /** True while the tower has work this step (capture in progress; targets in subclasses). */
+    virtual bool IsAwake() const;
+
 protected:
     virtual void BeginPlay() override;
+    virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
     virtual void TickCapture(float DeltaSeconds);
     
     // For drawing range, towers can override this in C++ or BP
@@ -70,6 +81,28 @@ protected:
     // NEW: update rings when selection/team changes
     void UpdateSelectionVisuals();
 
+    /** Cached simulation clock (steps us in fixed substeps). */
+    UPROPERTY(Transient)
+    USTSimulationClock* SimClock = nullptr;
+
+    /** Slot in USTSimulationClock's tower list. */
+    int32 SimIndex = INDEX_NONE;
+
+    /** Counted in USTSimulationClock's awake towers (IsAwake as of the last update). */
+    bool bCountedAwake = false;
+
+    /** Call after changing anything IsAwake reads. */
+    void NotifyAwakeChanged();
+
+    /** Stable id for rewind snapshots. */
+    int32 SimId = INDEX_NONE;
+
+    /** Game time the current capture of this tower started (match stats). */
+    double CaptureStartGameTime = 0.0;
+
+    friend class USTSimulationClock;
+    friend class USTRewindHistory;
+
 public:
 
     // Components
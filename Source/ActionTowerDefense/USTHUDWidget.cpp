@@ -5,27 +5,25 @@
 
 #include "Components/TextBlock.h"
 #include "Components/Button.h"
-#include "Kismet/GameplayStatics.h"
+#include "Components/Slider.h"
 
 #include "STGameState.h"
 #include "STGameController.h"
+#include "STSimulationClock.h"
+#include "STCosmeticGovernor.h"
+#include "STTrace.h"
+#include "STStatGroup.h"
+#include "STMemoryTags.h"
 
 void USTHUDWidget::NativeConstruct()
 {
+    ST_LLM_SCOPE(UI);
+
     Super::NativeConstruct();
 
     // Cache GameState and GameController
-    if (UWorld* World = GetWorld())
-    {
-        GameStateRef = World->GetGameState<ASTGameState>();
-
-        TArray<AActor*> Controllers;
-        UGameplayStatics::GetAllActorsOfClass(World, ASTGameController::StaticClass(), Controllers);
-        if (Controllers.Num() > 0)
-        {
-            GameControllerRef = Cast<ASTGameController>(Controllers[0]);
-        }
-    }
+    GameStateRef = ASTGameState::Get(this);
+    GameControllerRef = ASTGameController::Get(this);
 
     // Bind buttons
     if (SpeedReverseButton)
@@ -45,41 +43,68 @@ void USTHUDWidget::NativeConstruct()
     {
         Speed5xButton->OnClicked.AddDynamic(this, &USTHUDWidget::HandleSpeed5xClicked);
     }
+    if (Speed20xButton)
+    {
+        Speed20xButton->OnClicked.AddDynamic(this, &USTHUDWidget::HandleSpeed20xClicked);
+    }
+    if (Speed50xButton)
+    {
+        Speed50xButton->OnClicked.AddDynamic(this, &USTHUDWidget::HandleSpeed50xClicked);
+    }
+    if (SpeedMaxButton)
+    {
+        SpeedMaxButton->OnClicked.AddDynamic(this, &USTHUDWidget::HandleSpeedMaxClicked);
+    }
     if (CallNextWaveButton)
     {
         CallNextWaveButton->OnClicked.AddDynamic(this, &USTHUDWidget::HandleCallNextWaveClicked);
     }
+    if (TimelineSlider)
+    {
+        TimelineSlider->SetMinValue(0.f);
+        TimelineSlider->SetMaxValue(1.f);
+        TimelineSlider->OnMouseCaptureBegin.AddDynamic(this, &USTHUDWidget::HandleTimelineScrubStarted);
+        TimelineSlider->OnMouseCaptureEnd.AddDynamic(this, &USTHUDWidget::HandleTimelineScrubEnded);
+    }
 }
 
 void USTHUDWidget::NativeTick(const FGeometry& MyGeometry, float InDeltaTime)
 {
+    ST_TRACE_CPUSCOPE(ActionTD_HUD_NativeTick);
+    ST_SCOPE_TIMER(HUDTick);
+    ST_LLM_SCOPE(UI);
+
     Super::NativeTick(MyGeometry, InDeltaTime);
 
     // If GameState disappeared (map reload etc.), try to reacquire
     if (!GameStateRef)
     {
-        if (UWorld* World = GetWorld())
-        {
-            GameStateRef = World->GetGameState<ASTGameState>();
-        }
+        GameStateRef = ASTGameState::Get(this);
     }
 
-    // If GameController disappeared, try to reacquire
+    // If GameController disappeared, try to reacquire (registry lookup, O(1))
     if (!GameControllerRef)
     {
-        if (UWorld* World = GetWorld())
-        {
-            TArray<AActor*> Controllers;
-            UGameplayStatics::GetAllActorsOfClass(World, ASTGameController::StaticClass(), Controllers);
-            if (Controllers.Num() > 0)
-            {
-                GameControllerRef = Cast<ASTGameController>(Controllers[0]);
-            }
-        }
+        GameControllerRef = ASTGameController::Get(this);
+    }
+
+    // Fast-forward: refresh only on frames that are drawn
+    const USTSimulationClock* Clock = USTSimulationClock::Get(this);
+    if (Clock && !Clock->IsPresentationFrame())
+    {
+        return;
+    }
+
+    // Under frame pressure the cosmetic governor lowers the refresh rate
+    const USTCosmeticGovernor* Governor = USTCosmeticGovernor::Get(this);
+    if (Governor && !Governor->ShouldRefreshHUD())
+    {
+        return;
     }
 
     RefreshFromGameState();
     RefreshSpeedButtons();
+    RefreshTimeline();
 }
 
 void USTHUDWidget::RefreshFromGameState()
@@ -160,6 +185,30 @@ void USTHUDWidget::HandleSpeed5xClicked()
     }
 }
 
+void USTHUDWidget::HandleSpeed20xClicked()
+{
+    if (GameControllerRef)
+    {
+        GameControllerRef->SetSpeedMode(EGameSpeedMode::Ultra20);
+    }
+}
+
+void USTHUDWidget::HandleSpeed50xClicked()
+{
+    if (GameControllerRef)
+    {
+        GameControllerRef->SetSpeedMode(EGameSpeedMode::Ultra50);
+    }
+}
+
+void USTHUDWidget::HandleSpeedMaxClicked()
+{
+    if (GameControllerRef)
+    {
+        GameControllerRef->SetSpeedMode(EGameSpeedMode::Unlimited);
+    }
+}
+
 void USTHUDWidget::HandleCallNextWaveClicked()
 {
     if (GameControllerRef)
@@ -196,6 +245,9 @@ void USTHUDWidget::RefreshSpeedButtons()
     SetButtonOpacity(Speed1xButton, Mode == EGameSpeedMode::Normal);
     SetButtonOpacity(Speed3xButton, Mode == EGameSpeedMode::Fast);
     SetButtonOpacity(Speed5xButton, Mode == EGameSpeedMode::VeryFast);
+    SetButtonOpacity(Speed20xButton, Mode == EGameSpeedMode::Ultra20);
+    SetButtonOpacity(Speed50xButton, Mode == EGameSpeedMode::Ultra50);
+    SetButtonOpacity(SpeedMaxButton, Mode == EGameSpeedMode::Unlimited);
 }
 
 void USTHUDWidget::HandleReversePressed()
@@ -212,4 +264,71 @@ void USTHUDWidget::HandleReverseReleased()
     {
         GameControllerRef->StopReverse();
     }
+}
+
+// --- timeline bar ---
+
+float USTHUDWidget::GetTimelineTargetTime() const
+{
+    float StartTime = 0.f;
+    float EndTime = 0.f;
+    if (GameControllerRef)
+    {
+        GameControllerRef->GetTimelineRange(StartTime, EndTime);
+    }
+
+    const float Fraction = TimelineSlider ? TimelineSlider->GetValue() : 1.f;
+    return FMath::Lerp(StartTime, EndTime, Fraction);
+}
+
+void USTHUDWidget::RefreshTimeline()
+{
+    if (!GameControllerRef)
+    {
+        return;
+    }
+
+    float StartTime = 0.f;
+    float EndTime = 0.f;
+    GameControllerRef->GetTimelineRange(StartTime, EndTime);
+
+    if (TimelineSlider)
+    {
+        // Nothing to seek into yet / after the match: show the bar, but don't allow drags
+        TimelineSlider->SetIsEnabled(!GameControllerRef->bIsGameOver && EndTime > StartTime);
+
+        // Between drags the handle sits at "now"
+        if (!bScrubbingTimeline)
+        {
+            TimelineSlider->SetValue(1.f);
+        }
+    }
+
+    if (TimelineText)
+    {
+        const float ShownTime = bScrubbingTimeline ? GetTimelineTargetTime() : EndTime;
+        const FString S = FString::Printf(TEXT("%s / %s"), *FormatSeconds(ShownTime), *FormatSeconds(EndTime));
+        TimelineText->SetText(FText::FromString(S));
+    }
+}
+
+void USTHUDWidget::HandleTimelineScrubStarted()
+{
+    bScrubbingTimeline = true;
+}
+
+void USTHUDWidget::HandleTimelineScrubEnded()
+{
+    if (!bScrubbingTimeline)
+    {
+        return;
+    }
+
+    bScrubbingTimeline = false;
+
+    // Released at the far end: nothing to do
+    if (GameControllerRef && TimelineSlider && TimelineSlider->GetValue() < 1.f)
+    {
+        GameControllerRef->SeekToGameTime(GetTimelineTargetTime());
+    }
 }
\ No newline at end of file
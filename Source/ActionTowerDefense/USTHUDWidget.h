@@ -8,6 +8,7 @@
 
 class UTextBlock;
 class UButton;
+class USlider;
 class ASTGameState;
 class ASTGameController;
 
@@ -50,9 +51,26 @@ protected:
     UPROPERTY(meta = (BindWidget))
     UButton* Speed5xButton;
 
+    // Fast-forward test modes (optional in the layout)
+    UPROPERTY(meta = (BindWidgetOptional))
+    UButton* Speed20xButton;
+
+    UPROPERTY(meta = (BindWidgetOptional))
+    UButton* Speed50xButton;
+
+    UPROPERTY(meta = (BindWidgetOptional))
+    UButton* SpeedMaxButton;
+
     UPROPERTY(meta = (BindWidget))
     UButton* CallNextWaveButton;
 
+    // Timeline bar: 0 = start of the match, 1 = now. Drag and release to seek.
+    UPROPERTY(meta = (BindWidgetOptional))
+    USlider* TimelineSlider;
+
+    UPROPERTY(meta = (BindWidgetOptional))
+    UTextBlock* TimelineText;
+
     // --- references to game objects (read-only / commands) ---
     UPROPERTY()
     ASTGameState* GameStateRef = nullptr;
@@ -74,6 +92,15 @@ protected:
     UFUNCTION()
     void HandleSpeed5xClicked();
 
+    UFUNCTION()
+    void HandleSpeed20xClicked();
+
+    UFUNCTION()
+    void HandleSpeed50xClicked();
+
+    UFUNCTION()
+    void HandleSpeedMaxClicked();
+
     UFUNCTION()
     void HandleCallNextWaveClicked();
 
@@ -83,8 +110,21 @@ protected:
     UFUNCTION()
     void HandleReverseReleased();
 
+    UFUNCTION()
+    void HandleTimelineScrubStarted();
+
+    UFUNCTION()
+    void HandleTimelineScrubEnded();
+
+    /** True while the timeline handle is held (the bar stops following the clock). */
+    bool bScrubbingTimeline = false;
+
     // --- helpers ---
     FString FormatSeconds(float Seconds) const;
     void RefreshFromGameState();
     void RefreshSpeedButtons();   // new: highlights active speed 
+    void RefreshTimeline();
+
+    /** Game time under the timeline handle. */
+    float GetTimelineTargetTime() const;
 };
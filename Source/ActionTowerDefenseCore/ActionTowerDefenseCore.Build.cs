@@ -0,0 +1,20 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+using UnrealBuildTool;
+
+// Deterministic match rules in plain C++: no UObjects, no engine.
+// Linked by the game module and by the ActionTDSim program.
+public class ActionTowerDefenseCore : ModuleRules
+{
+    public ActionTowerDefenseCore(ReadOnlyTargetRules Target) : base(Target)
+    {
+        PCHUsage = PCHUsageMode.UseExplicitOrSharedPCHs;
+
+        PublicDependencyModuleNames.AddRange(
+            new string[]
+            {
+                "Core"
+            }
+        );
+    }
+}
@@ -0,0 +1,73 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "STCorePath.h"
+#include "Algo/BinarySearch.h"
+
+namespace STCore
+{
+    FPath::FPath(TArray<FVector> InPoints)
+        : Points(MoveTemp(InPoints))
+    {
+        CumulativeDistances.Reserve(Points.Num());
+
+        float Total = 0.f;
+        for (int32 Index = 0; Index < Points.Num(); ++Index)
+        {
+            if (Index > 0)
+            {
+                Total += FVector::Dist(Points[Index - 1], Points[Index]);
+            }
+            CumulativeDistances.Add(Total);
+        }
+    }
+
+    int32 FPath::FindSegment(float Distance, float& OutAlpha) const
+    {
+        OutAlpha = 0.f;
+
+        if (Points.Num() < 2)
+        {
+            return INDEX_NONE;
+        }
+
+        Distance = FMath::Clamp(Distance, 0.f, GetLength());
+
+        // First point past Distance ends the segment
+        const int32 End = FMath::Clamp(
+            static_cast<int32>(Algo::UpperBound(CumulativeDistances, Distance)),
+            1,
+            Points.Num() - 1);
+
+        const int32 Start = End - 1;
+        const float SegmentLength = CumulativeDistances[End] - CumulativeDistances[Start];
+        OutAlpha = SegmentLength > KINDA_SMALL_NUMBER
+            ? (Distance - CumulativeDistances[Start]) / SegmentLength
+            : 0.f;
+
+        return Start;
+    }
+
+    FVector FPath::GetLocationAtDistance(float Distance) const
+    {
+        float Alpha = 0.f;
+        const int32 Segment = FindSegment(Distance, Alpha);
+        if (Segment == INDEX_NONE)
+        {
+            return Points.Num() > 0 ? Points[0] : FVector::ZeroVector;
+        }
+
+        return FMath::Lerp(Points[Segment], Points[Segment + 1], Alpha);
+    }
+
+    FVector FPath::GetDirectionAtDistance(float Distance) const
+    {
+        float Alpha = 0.f;
+        const int32 Segment = FindSegment(Distance, Alpha);
+        if (Segment == INDEX_NONE)
+        {
+            return FVector::ForwardVector;
+        }
+
+        return (Points[Segment + 1] - Points[Segment]).GetSafeNormal(UE_SMALL_NUMBER, FVector::ForwardVector);
+    }
+}
@@ -0,0 +1,115 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "STCoreRules.h"
+#include "Math/RandomStream.h"
+
+namespace STCore
+{
+    void StartLane(const FLaneSpec& Lane, FLaneState& State)
+    {
+        State.SpawnsDone = 0;
+        State.NextSpawnTime = Lane.FirstSpawnDelay;
+    }
+
+    bool ConsumeLaneSpawn(const FLaneSpec& Lane, FLaneState& State, float WaveClock, FRandomStream& Random)
+    {
+        if (State.SpawnsDone >= Lane.NumToSpawn || WaveClock < State.NextSpawnTime)
+        {
+            return false;
+        }
+
+        State.SpawnsDone++;
+
+        const float RandomJitter =
+            (Lane.Jitter != 0.0f)
+            ? Random.FRandRange(-Lane.Jitter, Lane.Jitter)
+            : 0.0f;
+
+        const float Step = FMath::Max(Lane.Interval + RandomJitter, 0.01f);
+        const float Base = FMath::Max(WaveClock, State.NextSpawnTime);
+        State.NextSpawnTime = Base + Step;
+
+        return true;
+    }
+
+    bool AdvanceAlongPath(float& Distance, float Speed, float DeltaSeconds, float PathLength)
+    {
+        // Clamp so we never go below 0 or beyond the path length
+        Distance = FMath::Clamp(Distance + Speed * DeltaSeconds, 0.f, PathLength);
+
+        return Distance >= PathLength - KINDA_SMALL_NUMBER;
+    }
+
+    bool TickCooldown(float& Cooldown, float Rate, float DeltaSeconds)
+    {
+        Cooldown -= DeltaSeconds;
+        if (Cooldown > 0.f)
+        {
+            return false;
+        }
+
+        Cooldown = (Rate > 0.f) ? (1.f / Rate) : 0.f;
+        return true;
+    }
+
+    FDamageResult ApplyDamage(float& Health, float Amount)
+    {
+        FDamageResult Result;
+
+        // Nothing to deal, or already dead
+        if (Amount <= 0.f || Health <= 0.f)
+        {
+            return Result;
+        }
+
+        Result.Dealt = FMath::Min(Amount, Health);
+        Health -= Amount;
+        Result.bKilled = Health <= 0.f;
+
+        return Result;
+    }
+
+    FCaptureResult ApplyCaptureDamage(float& CaptureHP, float CaptureHPMax, float Amount)
+    {
+        FCaptureResult Result;
+        Result.bStarted = CaptureHP >= CaptureHPMax;
+
+        CaptureHP = FMath::Clamp(CaptureHP - Amount, 0.f, CaptureHPMax);
+        Result.bCaptured = CaptureHP <= 0.f;
+
+        return Result;
+    }
+
+    bool ComputeKillScore(float BaseScore, float GameSpeed, float MaxSpeedFactor, float& OutScore)
+    {
+        OutScore = 0.f;
+
+        if (BaseScore <= 0.f)
+        {
+            return false;
+        }
+
+        // No score when rewinding or paused
+        const float SpeedFactor = FMath::Min(GameSpeed, MaxSpeedFactor);
+        if (SpeedFactor <= 0.f)
+        {
+            return false;
+        }
+
+        OutScore = BaseScore * SpeedFactor;
+        return true;
+    }
+
+    bool DrainMeter(float& Meter, float DrainPerSecond, float DeltaSeconds)
+    {
+        Meter -= DrainPerSecond * DeltaSeconds;
+
+        if (Meter <= 0.f)
+        {
+            Meter = 0.f;
+            return true;
+        }
+
+        return false;
+    }
+}
@@ -0,0 +1,252 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "STCoreSim.h"
+#include "Misc/Crc.h"
+
+namespace STCore
+{
+    FSim::FSim(FSimConfig InConfig)
+        : Config(MoveTemp(InConfig))
+        , RandomStream(Config.RandomSeed)
+        , Lives(Config.Lives)
+    {
+        Towers.SetNum(Config.Towers.Num());
+        for (int32 Index = 0; Index < Towers.Num(); ++Index)
+        {
+            Towers[Index].bNeutral = Config.Towers[Index].bNeutral;
+            Towers[Index].CaptureHP = Config.Towers[Index].CaptureHPMax;
+        }
+
+        if (Config.Waves.Num() > 0)
+        {
+            TimeUntilNextWave = Config.Waves[0].TimeBeforeWave;
+        }
+    }
+
+    void FSim::Step()
+    {
+        if (IsFinished())
+        {
+            return;
+        }
+
+        // Same order as the clock's substep: spawners, enemies, towers
+        StepSpawner();
+        StepEnemies();
+        StepTowers();
+        RemoveDeadEnemies();
+
+        ++StepNumber;
+    }
+
+    bool FSim::IsFinished() const
+    {
+        if (Lives <= 0)
+        {
+            return true;
+        }
+
+        const bool bMoreWaves = WaveIndex + 1 < Config.Waves.Num();
+        return !bWaveRunning && !bMoreWaves && Enemies.Num() == 0;
+    }
+
+    void FSim::StartWave(int32 Index)
+    {
+        WaveIndex = Index;
+        WaveClock = 0.f;
+        bWaveRunning = true;
+
+        const FWaveSpec& Wave = Config.Waves[WaveIndex];
+        LaneStates.SetNum(Wave.Lanes.Num());
+
+        for (int32 LaneIndex = 0; LaneIndex < Wave.Lanes.Num(); ++LaneIndex)
+        {
+            StartLane(Wave.Lanes[LaneIndex], LaneStates[LaneIndex]);
+        }
+    }
+
+    void FSim::StepSpawner()
+    {
+        const float StepSeconds = Config.StepSeconds;
+
+        if (!bWaveRunning)
+        {
+            if (WaveIndex + 1 >= Config.Waves.Num())
+            {
+                return;
+            }
+
+            TimeUntilNextWave = FMath::Max(0.f, TimeUntilNextWave - StepSeconds);
+            if (TimeUntilNextWave > 0.f)
+            {
+                return;
+            }
+
+            StartWave(WaveIndex + 1);
+        }
+
+        const FWaveSpec& Wave = Config.Waves[WaveIndex];
+
+        WaveClock += StepSeconds;
+
+        bool bFinished = true;
+        for (int32 LaneIndex = 0; LaneIndex < Wave.Lanes.Num(); ++LaneIndex)
+        {
+            const FLaneSpec& Lane = Wave.Lanes[LaneIndex];
+            FLaneState& State = LaneStates[LaneIndex];
+
+            while (ConsumeLaneSpawn(Lane, State, WaveClock, RandomStream))
+            {
+                FEnemy& Enemy = Enemies.AddDefaulted_GetRef();
+                Enemy.Id = NextEnemyId++;
+                Enemy.Health = Config.Enemy.MaxHealth;
+                Enemy.Location = Config.Path.GetLocationAtDistance(0.f);
+                ++NumSpawned;
+            }
+
+            bFinished &= IsLaneFinished(Lane, State);
+        }
+
+        if (bFinished)
+        {
+            bWaveRunning = false;
+
+            if (WaveIndex + 1 < Config.Waves.Num())
+            {
+                TimeUntilNextWave = Config.Waves[WaveIndex + 1].TimeBeforeWave;
+            }
+        }
+    }
+
+    void FSim::StepEnemies()
+    {
+        const float PathLength = Config.Path.GetLength();
+
+        for (FEnemy& Enemy : Enemies)
+        {
+            if (AdvanceAlongPath(Enemy.Distance, Config.Enemy.MoveSpeed, Config.StepSeconds, PathLength))
+            {
+                // Leaked: removed with the dead at the end of the step
+                Enemy.Health = 0.f;
+                ++NumLeaked;
+                --Lives;
+                continue;
+            }
+
+            Enemy.Location = Config.Path.GetLocationAtDistance(Enemy.Distance);
+        }
+    }
+
+    FSim::FEnemy* FSim::FindEnemy(int32 Id)
+    {
+        return Enemies.FindByPredicate([Id](const FEnemy& Enemy) { return Enemy.Id == Id; });
+    }
+
+    void FSim::StepTowers()
+    {
+        const float Radius = Config.Enemy.CollisionRadius;
+
+        for (int32 Index = 0; Index < Towers.Num(); ++Index)
+        {
+            const FTowerSpec& Spec = Config.Towers[Index];
+            FTower& Tower = Towers[Index];
+
+            if (Tower.bNeutral)
+            {
+                continue;
+            }
+
+            // Capture
+            if (Spec.CaptureTarget != INDEX_NONE && Spec.CaptureDPS > 0.f && Towers.IsValidIndex(Spec.CaptureTarget))
+            {
+                FTower& Target = Towers[Spec.CaptureTarget];
+                if (Target.bNeutral)
+                {
+                    const FCaptureResult Capture = ApplyCaptureDamage(
+                        Target.CaptureHP,
+                        Config.Towers[Spec.CaptureTarget].CaptureHPMax,
+                        Spec.CaptureDPS * Config.StepSeconds);
+
+                    if (Capture.bCaptured)
+                    {
+                        Target.bNeutral = false;
+                        Target.CaptureHP = Config.Towers[Spec.CaptureTarget].CaptureHPMax;
+                    }
+                }
+            }
+
+            // Keep the current target while it lives and stays in reach
+            FEnemy* Target = Tower.TargetId != INDEX_NONE ? FindEnemy(Tower.TargetId) : nullptr;
+            if (Target && (Target->Health <= 0.f || !IsInReach(Spec.Location, Spec.Range, Target->Location, Radius)))
+            {
+                Target = nullptr;
+            }
+
+            // Otherwise the oldest enemy in reach (the component's queue order)
+            if (!Target)
+            {
+                for (FEnemy& Enemy : Enemies)
+                {
+                    if (Enemy.Health > 0.f && IsInReach(Spec.Location, Spec.Range, Enemy.Location, Radius))
+                    {
+                        Target = &Enemy;
+                        break;
+                    }
+                }
+            }
+
+            Tower.TargetId = Target ? Target->Id : INDEX_NONE;
+            if (!Target || !TickCooldown(Tower.Cooldown, Spec.FireRate, Config.StepSeconds))
+            {
+                continue;
+            }
+
+            ++NumShots;
+
+            const FDamageResult Damage = ApplyDamage(Target->Health, Spec.Damage);
+            if (!Damage.bKilled)
+            {
+                continue;
+            }
+
+            ++NumKilled;
+
+            float KillScore = 0.f;
+            if (ComputeKillScore(Config.Enemy.BaseScore, Config.GameSpeed, Config.MaxScoreSpeedFactor, KillScore))
+            {
+                Score += KillScore;
+                ReverseMeter = AddMeterKills(ReverseMeter, Config.ReverseGainPerKill, 1, Config.MaxReverseMeter);
+            }
+        }
+    }
+
+    void FSim::RemoveDeadEnemies()
+    {
+        Enemies.RemoveAll([](const FEnemy& Enemy) { return Enemy.Health <= 0.f; });
+    }
+
+    uint32 FSim::GetStateHash() const
+    {
+        uint32 Crc = FCrc::MemCrc32(&StepNumber, sizeof(StepNumber));
+
+        for (const FEnemy& Enemy : Enemies)
+        {
+            Crc = FCrc::MemCrc32(&Enemy.Id, sizeof(Enemy.Id), Crc);
+            Crc = FCrc::MemCrc32(&Enemy.Distance, sizeof(Enemy.Distance), Crc);
+            Crc = FCrc::MemCrc32(&Enemy.Health, sizeof(Enemy.Health), Crc);
+        }
+
+        for (const FTower& Tower : Towers)
+        {
+            Crc = FCrc::MemCrc32(&Tower.Cooldown, sizeof(Tower.Cooldown), Crc);
+            Crc = FCrc::MemCrc32(&Tower.CaptureHP, sizeof(Tower.CaptureHP), Crc);
+            Crc = FCrc::MemCrc32(&Tower.TargetId, sizeof(Tower.TargetId), Crc);
+        }
+
+        Crc = FCrc::MemCrc32(&Score, sizeof(Score), Crc);
+        Crc = FCrc::MemCrc32(&ReverseMeter, sizeof(ReverseMeter), Crc);
+        Crc = FCrc::MemCrc32(&Lives, sizeof(Lives), Crc);
+
+        return Crc;
+    }
+}
@@ -0,0 +1,40 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+namespace STCore
+{
+    /**
+     * Enemy path as a polyline, sampled by distance from its start.
+     *
+     * The game samples its USplineComponent directly; this is what runs without
+     * one (ActionTDSim, tests). Build it from points sampled along a spline to get
+     * the same path within the sampling error.
+     */
+    class ACTIONTOWERDEFENSECORE_API FPath
+    {
+    public:
+        FPath() = default;
+        explicit FPath(TArray<FVector> InPoints);
+
+        FORCEINLINE float GetLength() const { return CumulativeDistances.Num() > 0 ? CumulativeDistances.Last() : 0.f; }
+        FORCEINLINE const TArray<FVector>& GetPoints() const { return Points; }
+
+        /** Location Distance along the path (clamped to its ends). */
+        FVector GetLocationAtDistance(float Distance) const;
+
+        /** Unit direction of travel Distance along the path. */
+        FVector GetDirectionAtDistance(float Distance) const;
+
+    private:
+        /** Segment containing Distance and how far into it (0..1). */
+        int32 FindSegment(float Distance, float& OutAlpha) const;
+
+        TArray<FVector> Points;
+
+        /** Distance from the start to each point. */
+        TArray<float> CumulativeDistances;
+    };
+}
@@ -0,0 +1,137 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+// ========================================================
+// Match rules (UObject-free)
+// ========================================================
+//
+// The deterministic part of a match as plain functions over plain state:
+// wave timeline, enemy movement, targeting reach, cooldowns, damage, capture,
+// kill score and the reverse meter. The actors (ASTSpawner, ASTEnemyBase,
+// AAttackTowerBase, ATowerBase, ASTGameController) keep their state and
+// presentation and call these for the rule itself; STCore::FSim runs the same
+// rules without any actor for the ActionTDSim program.
+//
+// Everything here only depends on Core, so it builds into programs that do not
+// link the engine.
+
+struct FRandomStream;
+
+namespace STCore
+{
+    // --------------------------------------------------------
+    // Wave timeline
+    // --------------------------------------------------------
+
+    /** One spawn lane of a wave (FSTSpawnLane without the enemy class). */
+    struct FLaneSpec
+    {
+        int32 NumToSpawn = 0;
+        float FirstSpawnDelay = 0.f;
+        float Interval = 1.f;
+        float Jitter = 0.f;
+    };
+
+    /** Runtime state of one lane while its wave runs. */
+    struct FLaneState
+    {
+        int32 SpawnsDone = 0;
+        float NextSpawnTime = 0.f;
+    };
+
+    ACTIONTOWERDEFENSECORE_API void StartLane(const FLaneSpec& Lane, FLaneState& State);
+
+    /**
+     * Is the lane's next spawn due at WaveClock? If so counts it and schedules the
+     * one after (one jitter draw from Random). Call until it returns false.
+     */
+    ACTIONTOWERDEFENSECORE_API bool ConsumeLaneSpawn(const FLaneSpec& Lane, FLaneState& State, float WaveClock, FRandomStream& Random);
+
+    FORCEINLINE bool IsLaneFinished(const FLaneSpec& Lane, const FLaneState& State)
+    {
+        return State.SpawnsDone >= Lane.NumToSpawn;
+    }
+
+    // --------------------------------------------------------
+    // Enemy movement
+    // --------------------------------------------------------
+
+    /**
+     * Move Distance by Speed * DeltaSeconds (backwards for negative steps), kept
+     * within the path. Returns true when it reached the end (a leak).
+     */
+    ACTIONTOWERDEFENSECORE_API bool AdvanceAlongPath(float& Distance, float Speed, float DeltaSeconds, float PathLength);
+
+    /** Distance along the path Seconds from now (never backwards). */
+    FORCEINLINE float PredictDistance(float Distance, float Speed, float Seconds, float PathLength)
+    {
+        return FMath::Clamp(Distance + Speed * FMath::Max(Seconds, 0.f), 0.f, PathLength);
+    }
+
+    // --------------------------------------------------------
+    // Targeting
+    // --------------------------------------------------------
+
+    /** In range as soon as the range sphere touches the target's bounds. */
+    FORCEINLINE bool IsInReach(const FVector& Center, float Range, const FVector& Location, float Radius)
+    {
+        const float Reach = Range + Radius;
+        return FVector::DistSquared(Location, Center) <= Reach * Reach;
+    }
+
+    // --------------------------------------------------------
+    // Cooldowns
+    // --------------------------------------------------------
+
+    /**
+     * Count Cooldown down by DeltaSeconds. Returns true when a shot is due, with
+     * Cooldown re-armed for Rate shots per second.
+     */
+    ACTIONTOWERDEFENSECORE_API bool TickCooldown(float& Cooldown, float Rate, float DeltaSeconds);
+
+    // --------------------------------------------------------
+    // Damage and capture
+    // --------------------------------------------------------
+
+    struct FDamageResult
+    {
+        /** Damage that actually landed (overkill is not damage dealt); 0 if none did. */
+        float Dealt = 0.f;
+        bool bKilled = false;
+    };
+
+    /** Take Amount off a living target's Health. */
+    ACTIONTOWERDEFENSECORE_API FDamageResult ApplyDamage(float& Health, float Amount);
+
+    struct FCaptureResult
+    {
+        /** First damage of a capture (the tower was at full capture HP). */
+        bool bStarted = false;
+        bool bCaptured = false;
+    };
+
+    /** Take Amount off a neutral tower's capture HP. */
+    ACTIONTOWERDEFENSECORE_API FCaptureResult ApplyCaptureDamage(float& CaptureHP, float CaptureHPMax, float Amount);
+
+    // --------------------------------------------------------
+    // Score and reverse meter
+    // --------------------------------------------------------
+
+    /**
+     * Score for a kill worth BaseScore at GameSpeed (1x / 3x / 5x ..., capped at
+     * MaxSpeedFactor). False when none is awarded: worthless enemy, paused or rewinding.
+     */
+    ACTIONTOWERDEFENSECORE_API bool ComputeKillScore(float BaseScore, float GameSpeed, float MaxSpeedFactor, float& OutScore);
+
+    /** Meter after NumKills refills of GainPerKill. */
+    FORCEINLINE float AddMeterKills(float Meter, float GainPerKill, int32 NumKills, float MaxMeter)
+    {
+        return FMath::Clamp(Meter + GainPerKill * NumKills, 0.f, MaxMeter);
+    }
+
+    /** Drain the meter while reversing. Returns true when it ran empty. */
+    ACTIONTOWERDEFENSECORE_API bool DrainMeter(float& Meter, float DrainPerSecond, float DeltaSeconds);
+}
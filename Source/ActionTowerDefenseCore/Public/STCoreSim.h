@@ -0,0 +1,151 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Math/RandomStream.h"
+#include "STCorePath.h"
+#include "STCoreRules.h"
+
+namespace STCore
+{
+    struct FWaveSpec
+    {
+        /** Wave 0: delay from the start. Wave N: delay after the previous wave's last spawn. */
+        float TimeBeforeWave = 0.f;
+
+        TArray<FLaneSpec> Lanes;
+    };
+
+    struct FEnemySpec
+    {
+        float MaxHealth = 100.f;
+        float MoveSpeed = 300.f;
+        float CollisionRadius = 40.f;
+        float BaseScore = 10.f;
+    };
+
+    struct FTowerSpec
+    {
+        FVector Location = FVector::ZeroVector;
+
+        /** Neutral towers neither fire nor capture until a player tower captures them. */
+        bool bNeutral = false;
+
+        float Range = 800.f;
+        float FireRate = 1.f;
+        float Damage = 25.f;
+
+        float CaptureHPMax = 100.f;
+        float CaptureDPS = 0.f;
+
+        /** Index of the neutral tower this one captures (INDEX_NONE: none). */
+        int32 CaptureTarget = INDEX_NONE;
+    };
+
+    struct FSimConfig
+    {
+        FPath Path;
+        TArray<FWaveSpec> Waves;
+        TArray<FTowerSpec> Towers;
+        FEnemySpec Enemy;
+
+        /** Game seconds per Step (the clock's fixed substep). */
+        float StepSeconds = 1.f / 60.f;
+
+        /** Only scales score, like the game's speed modes do. */
+        float GameSpeed = 1.f;
+        float MaxScoreSpeedFactor = 5.f;
+
+        float ReverseGainPerKill = 5.f;
+        float MaxReverseMeter = 100.f;
+
+        int32 Lives = 20;
+        int32 RandomSeed = 0;
+    };
+
+    /**
+     * A whole match on the core rules, no actors: the spawner's wave timeline,
+     * enemies walking an FPath, towers acquiring the oldest enemy in reach and
+     * firing on cooldown, capture of neutral towers, score and reverse meter.
+     *
+     * Shots hit instantly (the game flies projectiles), so kill times differ from
+     * the game's by the projectiles' flight time. Same config and seed: same
+     * match, bit for bit (see GetStateHash).
+     */
+    class ACTIONTOWERDEFENSECORE_API FSim
+    {
+    public:
+        explicit FSim(FSimConfig InConfig);
+
+        /** Advance the match by one StepSeconds. */
+        void Step();
+
+        /** Defeat, or every wave spawned and every enemy gone. */
+        bool IsFinished() const;
+
+        FORCEINLINE bool IsVictory() const { return IsFinished() && Lives > 0; }
+
+        FORCEINLINE int64 GetStepNumber() const { return StepNumber; }
+        FORCEINLINE double GetGameTime() const { return StepNumber * static_cast<double>(Config.StepSeconds); }
+        FORCEINLINE int32 GetNumEnemiesAlive() const { return Enemies.Num(); }
+        FORCEINLINE int32 GetNumSpawned() const { return NumSpawned; }
+        FORCEINLINE int32 GetNumKilled() const { return NumKilled; }
+        FORCEINLINE int32 GetNumLeaked() const { return NumLeaked; }
+        FORCEINLINE int32 GetNumShots() const { return NumShots; }
+        FORCEINLINE int32 GetLives() const { return Lives; }
+        FORCEINLINE float GetScore() const { return Score; }
+        FORCEINLINE float GetReverseMeter() const { return ReverseMeter; }
+        FORCEINLINE int32 GetWaveIndex() const { return WaveIndex; }
+
+        /** CRC of everything the rules decide; equal hashes mean equal matches so far. */
+        uint32 GetStateHash() const;
+
+    private:
+        struct FEnemy
+        {
+            int32 Id = 0;
+            float Distance = 0.f;
+            float Health = 0.f;
+            FVector Location = FVector::ZeroVector;
+        };
+
+        struct FTower
+        {
+            bool bNeutral = false;
+            float Cooldown = 0.f;
+            float CaptureHP = 0.f;
+            int32 TargetId = INDEX_NONE;
+        };
+
+        void StepSpawner();
+        void StepEnemies();
+        void StepTowers();
+        void RemoveDeadEnemies();
+
+        void StartWave(int32 Index);
+        FEnemy* FindEnemy(int32 Id);
+
+        FSimConfig Config;
+        FRandomStream RandomStream;
+
+        TArray<FEnemy> Enemies;
+        TArray<FTower> Towers;
+        TArray<FLaneState> LaneStates;
+
+        int32 WaveIndex = INDEX_NONE;
+        bool bWaveRunning = false;
+        float WaveClock = 0.f;
+        float TimeUntilNextWave = 0.f;
+
+        int64 StepNumber = 0;
+        int32 NextEnemyId = 0;
+        int32 NumSpawned = 0;
+        int32 NumKilled = 0;
+        int32 NumLeaked = 0;
+        int32 NumShots = 0;
+        int32 Lives = 0;
+        float Score = 0.f;
+        float ReverseMeter = 0.f;
+    };
+}